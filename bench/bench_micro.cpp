@@ -0,0 +1,135 @@
+#include "matching_engine.hpp"
+#include "latency_histogram.hpp"
+#include "spsc_ring_buffer.hpp"
+#include "depth_profile.hpp"
+#include <benchmark/benchmark.h>
+#include <memory>
+#include <random>
+
+using namespace OrderBook;
+
+namespace {
+
+constexpr int64_t MID_PRICE = (PRICE_MIN + PRICE_MAX) / 2;
+
+/**
+ * Engine driven directly through process_burst() on the benchmark thread
+ */
+struct EngineFixture {
+    std::unique_ptr<SPSCRingBuffer> ring = std::make_unique<SPSCRingBuffer>();
+    std::unique_ptr<MatchingEngine> engine = std::make_unique<MatchingEngine>(ring.get());
+
+    void push(CommandType type, uint64_t order_id, Side side, int64_t price, uint32_t quantity) noexcept {
+        Command* slot = ring->try_claim();
+        slot->type = type;
+        slot->order_type = OrderType::LIMIT;
+        slot->order_id = order_id;
+        slot->side = side;
+        slot->price = static_cast<int32_t>(price);
+        slot->quantity = quantity;
+        slot->instrument_id = 0;
+        slot->producer_timestamp = 0;  // Not a queueing sample
+        ring->commit();
+    }
+
+    void drain() noexcept {
+        while (engine->process_burst() > 0) {}
+    }
+};
+
+void BM_HistogramRecord(benchmark::State& state) {
+    LatencyHistogram histogram;
+    std::mt19937_64 rng(1);
+    uint64_t values[1024];
+    for (uint64_t& value : values) value = 50 + rng() % 100'000;
+
+    size_t i = 0;
+    for (auto _ : state) {
+        histogram.record(values[i++ & 1023]);
+    }
+    benchmark::DoNotOptimize(histogram.count());
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_HistogramRecord);
+
+/**
+ * A burst of passive adds followed by cancels of the same orders
+ */
+void BM_AddCancel(benchmark::State& state) {
+    EngineFixture fixture;
+    constexpr uint64_t BURST = ENGINE_BURST_SIZE / 2;
+    uint64_t order_id = 1;
+
+    for (auto _ : state) {
+        const uint64_t first = order_id;
+        for (uint64_t i = 0; i < BURST; ++i, ++order_id) {
+            const Side side = (order_id & 1) ? Side::BUY : Side::SELL;
+            const int64_t offset = 1 + static_cast<int64_t>(order_id % 50);
+            fixture.push(CommandType::NEW, order_id, side,
+                         side == Side::BUY ? MID_PRICE - offset : MID_PRICE + offset, 100);
+        }
+        for (uint64_t id = first; id < order_id; ++id) {
+            fixture.push(CommandType::CANCEL, id, Side::BUY, 0, 0);
+        }
+        fixture.drain();
+    }
+    state.SetItemsProcessed(state.iterations() * BURST * 2);
+}
+BENCHMARK(BM_AddCancel);
+
+/**
+ * Rest one order on each of range(0) ask levels, then sweep them all with a
+ * single buy
+ */
+void BM_SweepLevels(benchmark::State& state) {
+    EngineFixture fixture;
+    const int64_t levels = state.range(0);
+    uint64_t order_id = 1;
+
+    for (auto _ : state) {
+        for (int64_t level = 1; level <= levels; ++level) {
+            fixture.push(CommandType::NEW, order_id++, Side::SELL, MID_PRICE + level, 10);
+            if (level % ENGINE_BURST_SIZE == 0) fixture.drain();
+        }
+        fixture.push(CommandType::NEW, order_id++, Side::BUY, MID_PRICE + levels,
+                     static_cast<uint32_t>(levels * 10));
+        fixture.drain();
+    }
+    state.SetItemsProcessed(state.iterations() * (levels + 1));
+}
+BENCHMARK(BM_SweepLevels)->Arg(1)->Arg(8)->Arg(64)->Arg(512);
+
+/**
+ * A pricing tick over full depth: rebuild the profile, then VWAP-to-size
+ * and imbalance. range(0) is the DepthKernel.
+ */
+void BM_DepthProfile(benchmark::State& state) {
+    const auto kernel = static_cast<DepthKernel>(state.range(0));
+    if (kernel == DepthKernel::AVX2 && DepthProfile::best_kernel() != DepthKernel::AVX2) {
+        state.SkipWithError("No AVX2 on this CPU");
+        return;
+    }
+
+    Level2Snapshot snapshot(1);
+    for (uint32_t i = 0; i < MARKET_DEPTH_LEVELS; ++i) {
+        snapshot.bids.emplace_back(MID_PRICE - i, 100 + i * 7, 1 + i % 5);
+        snapshot.asks.emplace_back(MID_PRICE + 1 + i, 100 + i * 11, 1 + i % 3);
+    }
+    DepthProfile profile(kernel);
+    uint64_t size = 1;
+
+    for (auto _ : state) {
+        profile.load(snapshot);
+        double price = 0.0;
+        benchmark::DoNotOptimize(profile.vwap(Side::SELL, size, price));
+        benchmark::DoNotOptimize(price);
+        benchmark::DoNotOptimize(profile.imbalance(5));
+        size = size % 2000 + 1;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_DepthProfile)->Arg(static_cast<int>(DepthKernel::SCALAR))->Arg(static_cast<int>(DepthKernel::AVX2));
+
+} // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,707 @@
+#include "matching_engine.hpp"
+#include "enhanced_matching_engine.hpp"
+#include "multi_instrument_engine.hpp"
+#include "feed_handler.hpp"
+#include "feed_capture.hpp"
+#include "output_stage.hpp"
+#include "risk_stage.hpp"
+#include "latency_histogram.hpp"
+#include "numa_placement.hpp"
+#include "tsc_clock.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+using namespace OrderBook;
+
+namespace {
+
+constexpr int64_t MID_PRICE = (PRICE_MIN + PRICE_MAX) / 2;
+
+struct SuiteConfig {
+    uint64_t commands = 2'000'000;                        // Per run
+    uint64_t seed = 1;
+    std::vector<uint64_t> loads{250'000, 500'000, 1'000'000, 0};  // Offered orders/s for "mixed", 0 = max
+    std::vector<std::string> scenarios{"mixed", "deep_sweep", "cancel_heavy", "fok_heavy", "multi_instrument", "risk",
+                                       "quote_replace", "mass_quote"};
+    std::vector<RiskTopology> risk_topologies{RiskTopology::INLINE, RiskTopology::STAGED};  // "risk" runs
+    WaitConfig engine_wait;                               // MatchingEngine and risk stage runs
+    int matching_cpu = -1;
+    int feed_cpu = -1;
+    int publisher_cpu = -1;
+    int risk_cpu = -1;
+    std::string workdir = std::filesystem::temp_directory_path().string();
+    std::string json_path;                                // Empty = stdout
+};
+
+/**
+ * One engine run over one capture
+ */
+struct RunResult {
+    std::string scenario;
+    std::string engine;
+    std::string risk = "none";  // Risk topology, "risk" scenario only
+    uint64_t offered_load = 0;  // orders/s, 0 = as fast as the ring accepts them
+    uint64_t commands = 0;
+    uint64_t trades = 0;
+    uint64_t rejected = 0;
+    double elapsed_ms = 0.0;
+    LatencyHistogram queueing;  // Feed enqueue -> engine dequeue
+    LatencyHistogram risk_queueing;  // Feed enqueue -> risk stage dequeue, staged risk only
+    LatencyHistogram matching;  // Engine dequeue -> fill
+    LatencyHistogram publish;   // Engine emit -> publisher pickup
+
+    double throughput() const noexcept { return elapsed_ms > 0.0 ? commands * 1000.0 / elapsed_ms : 0.0; }
+};
+
+/**
+ * Capture being written at a steady offered load
+ */
+class PacedCapture {
+private:
+    FeedCaptureWriter writer_;
+    uint64_t rate_;
+
+public:
+    PacedCapture(const std::string& path, uint64_t rate, uint64_t seed) : writer_(path, seed), rate_(rate) {}
+
+    void add(const Command& cmd) noexcept {
+        const uint64_t index = writer_.command_count();
+        writer_.append(cmd, rate_ ? index * 1'000'000'000ull / rate_ : 0);
+    }
+
+    uint64_t size() const noexcept { return writer_.command_count(); }
+    bool finish() noexcept { return writer_.finish(); }
+};
+
+Command new_order(uint64_t order_id, Side side, int64_t price, uint64_t quantity,
+                  OrderType type = OrderType::LIMIT, uint32_t instrument_id = 0) noexcept {
+    Command cmd{};
+    cmd.type = CommandType::NEW;
+    cmd.order_type = type;
+    cmd.order_id = order_id;
+    cmd.side = side;
+    cmd.price = static_cast<int32_t>(std::clamp<int64_t>(price, PRICE_MIN, PRICE_MAX));
+    cmd.quantity = static_cast<uint32_t>(quantity);
+    cmd.instrument_id = instrument_id;
+    return cmd;
+}
+
+Command cancel_order(uint64_t order_id, uint32_t instrument_id = 0) noexcept {
+    Command cmd{};
+    cmd.type = CommandType::CANCEL;
+    cmd.order_type = OrderType::LIMIT;
+    cmd.order_id = order_id;
+    cmd.instrument_id = instrument_id;
+    return cmd;
+}
+
+/**
+ * Resting order ids a generator may cancel, picked uniformly
+ */
+class LiveOrders {
+private:
+    std::vector<std::pair<uint64_t, uint32_t>> orders_;  // order id, instrument
+
+public:
+    void add(uint64_t order_id, uint32_t instrument_id = 0) { orders_.emplace_back(order_id, instrument_id); }
+    bool empty() const noexcept { return orders_.empty(); }
+
+    std::pair<uint64_t, uint32_t> take(std::mt19937_64& rng) noexcept {
+        const size_t index = rng() % orders_.size();
+        const auto order = orders_[index];
+        orders_[index] = orders_.back();
+        orders_.pop_back();
+        return order;
+    }
+};
+
+/**
+ * Ladders of DEPTH levels x ORDERS_PER_LEVEL resting orders, each taken out
+ * by one aggressor that sweeps every level - the worst case for a match
+ */
+void generate_deep_sweep(PacedCapture& out, uint64_t count, uint64_t seed) {
+    constexpr int64_t DEPTH = 64;
+    constexpr int ORDERS_PER_LEVEL = 4;
+    std::mt19937_64 rng(seed);
+    uint64_t order_id = 1;
+
+    for (uint64_t cycle = 0; out.size() < count; ++cycle) {
+        const Side resting = (cycle % 2 == 0) ? Side::SELL : Side::BUY;
+        const int64_t direction = (resting == Side::SELL) ? 1 : -1;
+        uint64_t resting_quantity = 0;
+
+        for (int64_t level = 1; level <= DEPTH && out.size() < count; ++level) {
+            for (int k = 0; k < ORDERS_PER_LEVEL && out.size() < count; ++k) {
+                const uint64_t quantity = 1 + rng() % 100;
+                out.add(new_order(order_id++, resting, MID_PRICE + direction * level, quantity));
+                resting_quantity += quantity;
+            }
+        }
+        if (out.size() < count) {
+            const Side aggressor = (resting == Side::SELL) ? Side::BUY : Side::SELL;
+            out.add(new_order(order_id++, aggressor, MID_PRICE + direction * DEPTH, resting_quantity));
+        }
+    }
+}
+
+/**
+ * Quote churn: about as many cancels as adds against a standing book, with
+ * a trickle of marketable orders
+ */
+void generate_cancel_heavy(PacedCapture& out, uint64_t count, uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    std::uniform_real_distribution<double> action(0.0, 1.0);
+    LiveOrders live;
+    uint64_t order_id = 1;
+    const uint64_t prefill = std::min<uint64_t>(count / 10, 100'000);
+
+    while (out.size() < count) {
+        const double roll = out.size() < prefill ? 0.0 : action(rng);
+        const Side side = (rng() & 1) ? Side::BUY : Side::SELL;
+        const int64_t direction = (side == Side::BUY) ? -1 : 1;
+
+        if (roll < 0.47 || live.empty()) {
+            out.add(new_order(order_id, side, MID_PRICE + direction * static_cast<int64_t>(1 + rng() % 50),
+                              1 + rng() % 1000));
+            live.add(order_id++);
+        } else if (roll < 0.97) {
+            out.add(cancel_order(live.take(rng).first));
+        } else {
+            out.add(new_order(order_id++, side, MID_PRICE - direction * 5, 1 + rng() % 1000));
+        }
+    }
+}
+
+/**
+ * Fill-or-kill takers against a passive book; the larger ones can't be
+ * filled within their limit and are killed after a depth check
+ */
+void generate_fok_heavy(PacedCapture& out, uint64_t count, uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    std::uniform_real_distribution<double> action(0.0, 1.0);
+    LiveOrders live;
+    uint64_t order_id = 1;
+    const uint64_t prefill = std::min<uint64_t>(count / 10, 20'000);
+
+    while (out.size() < count) {
+        const double roll = out.size() < prefill ? 0.0 : action(rng);
+        const Side side = (rng() & 1) ? Side::BUY : Side::SELL;
+        const int64_t direction = (side == Side::BUY) ? -1 : 1;
+
+        if (roll < 0.45 || live.empty()) {
+            out.add(new_order(order_id, side, MID_PRICE + direction * static_cast<int64_t>(1 + rng() % 20),
+                              1 + rng() % 500));
+            live.add(order_id++);
+        } else if (roll < 0.60) {
+            out.add(cancel_order(live.take(rng).first));
+        } else {
+            // Limit 1-5 ticks through the touch - size decides fill or kill
+            const int64_t reach = 1 + static_cast<int64_t>(rng() % 5);
+            out.add(new_order(order_id++, side, MID_PRICE - direction * reach, 1 + rng() % 3000, OrderType::FOK));
+        }
+    }
+}
+
+constexpr uint32_t MULTI_INSTRUMENT_COUNT = 64;
+constexpr uint32_t RISK_ACCOUNT_COUNT = 16;
+
+/**
+ * Owner of an order in the "risk" scenario - derived from the id, so a
+ * cancel carries the same account as the order it cancels
+ */
+AccountId account_of(uint64_t order_id) noexcept {
+    return static_cast<AccountId>(1 + order_id % RISK_ACCOUNT_COUNT);
+}
+
+/**
+ * A passive-heavy mix spread evenly over MULTI_INSTRUMENT_COUNT books,
+ * optionally owned by RISK_ACCOUNT_COUNT accounts
+ */
+void generate_multi_instrument(PacedCapture& out, uint64_t count, uint64_t seed, bool with_accounts = false) {
+    std::mt19937_64 rng(seed);
+    std::uniform_real_distribution<double> action(0.0, 1.0);
+    LiveOrders live;
+    uint64_t order_id = 1;
+
+    while (out.size() < count) {
+        const double roll = action(rng);
+        const uint32_t instrument = 1 + static_cast<uint32_t>(rng() % MULTI_INSTRUMENT_COUNT);
+        const Side side = (rng() & 1) ? Side::BUY : Side::SELL;
+        const int64_t direction = (side == Side::BUY) ? -1 : 1;
+
+        Command cmd;
+        if (roll < 0.55 || live.empty()) {
+            cmd = new_order(order_id, side, MID_PRICE + direction * static_cast<int64_t>(1 + rng() % 50),
+                            1 + rng() % 1000, OrderType::LIMIT, instrument);
+            live.add(order_id++, instrument);
+        } else if (roll < 0.70) {
+            cmd = new_order(order_id++, side, MID_PRICE - direction * static_cast<int64_t>(rng() % 20),
+                            1 + rng() % 1000, OrderType::LIMIT, instrument);
+        } else {
+            const auto [cancel_id, cancel_instrument] = live.take(rng);
+            cmd = cancel_order(cancel_id, cancel_instrument);
+        }
+        if (with_accounts) cmd.account_id = account_of(cmd.order_id);
+        out.add(cmd);
+    }
+}
+
+constexpr uint32_t QUOTE_LEVELS = 5;  // Per side, per market maker and instrument
+
+/**
+ * Market makers (the scenario accounts) re-quoting QUOTE_LEVELS a side on
+ * every instrument. Each update moves the spread and resizes every level
+ * of one maker's quote, as a MASS_QUOTE with a leg per level or as a
+ * CANCEL + NEW pair per level. Both variants carry the same updates -
+ * count / (4 * QUOTE_LEVELS) of them - so their elapsed times compare
+ * directly. Quotes never cross, so neither variant trades.
+ */
+void generate_quote_updates(PacedCapture& out, uint64_t count, uint64_t seed, bool mass_quote) {
+    std::mt19937_64 rng(seed);
+    const uint64_t updates = count / (4 * QUOTE_LEVELS);
+    std::vector<bool> quoted(MULTI_INSTRUMENT_COUNT * RISK_ACCOUNT_COUNT, false);
+
+    for (uint64_t update = 0; update < updates; ++update) {
+        const uint32_t instrument = 1 + static_cast<uint32_t>(rng() % MULTI_INSTRUMENT_COUNT);
+        const AccountId account = static_cast<AccountId>(1 + rng() % RISK_ACCOUNT_COUNT);
+        const uint64_t maker = (instrument - 1) * RISK_ACCOUNT_COUNT + (account - 1);
+        const int64_t half_spread = 1 + static_cast<int64_t>(rng() % 3);
+
+        if (mass_quote) {
+            Command header = cancel_order(0, instrument);
+            header.type = CommandType::MASS_QUOTE;
+            header.quantity = 2 * QUOTE_LEVELS;
+            header.account_id = account;
+            out.add(header);
+        }
+        for (uint32_t level = 0; level < 2 * QUOTE_LEVELS; ++level) {
+            // Stable id per maker and level - legs amend, the cancel/new variant reuses it
+            const uint64_t order_id = 1 + maker * 2 * QUOTE_LEVELS + level;
+            const Side side = (level < QUOTE_LEVELS) ? Side::BUY : Side::SELL;
+            const int64_t direction = (side == Side::BUY) ? -1 : 1;
+            Command cmd = new_order(order_id, side, MID_PRICE + direction * (half_spread + level % QUOTE_LEVELS),
+                                    1 + rng() % 1000, OrderType::LIMIT, instrument);
+            cmd.account_id = account;
+
+            if (mass_quote) {
+                cmd.type = CommandType::QUOTE_LEG;
+            } else if (quoted[maker]) {
+                Command cancel = cancel_order(order_id, instrument);
+                cancel.account_id = account;
+                out.add(cancel);
+            }
+            out.add(cmd);
+        }
+        quoted[maker] = true;
+    }
+}
+
+uint64_t trades_of(const MatchingEngine& engine) noexcept { return engine.trades_executed(); }
+uint64_t trades_of(const EnhancedMatchingEngine& engine) noexcept { return engine.trades_executed(); }
+uint64_t trades_of(const MultiInstrumentEngine& engine) noexcept { return engine.total_trades_executed(); }
+
+/**
+ * Replay capture into a fresh Engine on its Ring with a publisher-less
+ * output stage attached, so the publish hop is measured without I/O
+ */
+template <typename Engine, typename Ring, typename Setup>
+void replay_into(RunResult& result, const SuiteConfig& config, const FeedCapture& capture, Setup setup) {
+    auto ring = std::make_unique<Ring>();
+    auto engine = std::make_unique<Engine>(ring.get());
+    OutputStage output(nullptr);
+    setup(*engine);
+    engine->set_output_stage(&output);
+    output.start(config.publisher_cpu);
+
+    const ReplayPacing pacing = result.offered_load ? ReplayPacing::RECORDED : ReplayPacing::MAX_RATE;
+    const uint64_t command_count = capture.size();
+
+    const auto start_time = std::chrono::steady_clock::now();
+    std::thread feed_thread([&ring, &capture, pacing, cpu = config.feed_cpu] {
+        if (cpu >= 0) NumaPlacement::pin_current_thread(cpu);
+        FeedHandler::replay(ring.get(), capture, pacing);
+    });
+    std::thread matching_thread([&engine, command_count, cpu = config.matching_cpu] {
+        if (cpu >= 0) NumaPlacement::pin_current_thread(cpu);
+        engine->run(command_count);
+    });
+    feed_thread.join();
+    matching_thread.join();
+    const auto end_time = std::chrono::steady_clock::now();
+    output.stop();
+
+    result.commands = engine->orders_processed();
+    result.trades = trades_of(*engine);
+    result.rejected = engine->orders_rejected();
+    result.elapsed_ms = std::chrono::duration<double, std::milli>(end_time - start_time).count();
+    result.queueing = engine->queue_latency();
+    result.matching = engine->trade_latency();
+    result.publish = output.publish_latency();
+}
+
+void add_multi_instruments(MultiInstrumentEngine& engine) {
+    for (uint32_t id = 1; id <= MULTI_INSTRUMENT_COUNT; ++id) {
+        engine.add_instrument(Instrument(id, "SYM" + std::to_string(id)));
+    }
+}
+
+/**
+ * Log every scenario account on with limits wide enough that the checks
+ * run in full but the flow is not throttled
+ */
+void logon_accounts(RiskManager& risk) {
+    RiskLimits limits;
+    limits.max_orders_per_second = 0;
+    limits.max_cancels_per_second = 0;
+    limits.max_position = std::numeric_limits<int32_t>::max();
+    limits.max_gross_exposure = std::numeric_limits<uint64_t>::max() / 2;
+    limits.max_daily_volume = std::numeric_limits<uint64_t>::max() / 2;
+    for (uint32_t i = 1; i <= RISK_ACCOUNT_COUNT; ++i) {
+        risk.logon("ACCT" + std::to_string(i), limits);
+    }
+}
+
+/**
+ * Replay capture into a MultiInstrumentEngine with pre-trade risk either
+ * inline on the matching thread or as a RiskStage on its own thread
+ * between the feed's ring and the engine's
+ */
+void replay_with_risk(RunResult& result, const SuiteConfig& config, const FeedCapture& capture,
+                      RiskTopology topology) {
+    RiskManager risk;
+    logon_accounts(risk);
+
+    auto engine_ring = std::make_unique<MultiInstrumentRingBuffer>();
+    std::unique_ptr<MultiInstrumentRingBuffer> gateway_ring;
+    std::unique_ptr<RiskStage> stage;
+    auto engine = std::make_unique<MultiInstrumentEngine>(engine_ring.get());
+    add_multi_instruments(*engine);
+    if (topology == RiskTopology::STAGED) {
+        gateway_ring = std::make_unique<MultiInstrumentRingBuffer>();
+        stage = std::make_unique<RiskStage>(risk, *gateway_ring, *engine_ring, config.engine_wait);
+        engine->set_risk_stage(stage.get());
+    } else {
+        engine->set_risk_manager(&risk);
+    }
+    OutputStage output(nullptr);
+    engine->set_output_stage(&output);
+    output.start(config.publisher_cpu);
+
+    const ReplayPacing pacing = result.offered_load ? ReplayPacing::RECORDED : ReplayPacing::MAX_RATE;
+    const uint64_t command_count = capture.size();
+    MultiInstrumentRingBuffer* feed_ring = stage ? gateway_ring.get() : engine_ring.get();
+
+    const auto start_time = std::chrono::steady_clock::now();
+    if (stage) stage->start(config.risk_cpu);
+    std::thread feed_thread([feed_ring, &capture, pacing, cpu = config.feed_cpu] {
+        if (cpu >= 0) NumaPlacement::pin_current_thread(cpu);
+        FeedHandler::replay(feed_ring, capture, pacing);
+    });
+    std::thread matching_thread([&engine, &stage, command_count, cpu = config.matching_cpu] {
+        if (cpu >= 0) NumaPlacement::pin_current_thread(cpu);
+        if (!stage) {
+            engine->run(command_count);
+            return;
+        }
+        // Rejected commands never arrive - done once everything forwarded is processed
+        while (stage->commands_consumed() < command_count ||
+               engine->orders_processed() < stage->commands_forwarded()) {
+            engine->process_burst();
+        }
+    });
+    feed_thread.join();
+    matching_thread.join();
+    const auto end_time = std::chrono::steady_clock::now();
+    if (stage) stage->stop();
+    output.stop();
+
+    result.commands = command_count;
+    result.trades = engine->total_trades_executed();
+    result.rejected = engine->orders_rejected() + risk.statistics().orders_rejected
+                      + risk.statistics().cancels_rejected;
+    result.elapsed_ms = std::chrono::duration<double, std::milli>(end_time - start_time).count();
+    result.queueing = engine->queue_latency();
+    result.matching = engine->trade_latency();
+    result.publish = output.publish_latency();
+    if (stage) result.risk_queueing = stage->queue_latency();
+}
+
+/**
+ * One-line summary of a run on stderr
+ */
+void report(const RunResult& run) {
+    std::cerr << run.scenario;
+    if (run.risk != "none") std::cerr << " (" << run.risk << " risk)";
+    std::cerr << " @ " << (run.offered_load ? std::to_string(run.offered_load) + "/s" : std::string("max"))
+              << ": " << run.commands << " commands in " << static_cast<uint64_t>(run.elapsed_ms) << " ms ("
+              << static_cast<uint64_t>(run.throughput()) << "/s), " << run.trades << " trades, P99 queue "
+              << run.queueing.percentile(99.0) << " / match " << run.matching.percentile(99.0) << " / publish "
+              << run.publish.percentile(99.0) << " ns\n";
+}
+
+/**
+ * Generate the scenario's capture at offered_load, replay it and clean up.
+ * "risk" replays the same capture once per configured topology.
+ */
+bool run_scenario(const std::string& scenario, uint64_t offered_load, const SuiteConfig& config,
+                  std::vector<std::unique_ptr<RunResult>>& results) {
+    const std::string path = config.workdir + "/bench_" + scenario + "_" + std::to_string(::getpid()) + ".cap";
+
+    bool written = false;
+    if (scenario == "mixed") {
+        written = FeedHandler::record(path, config.commands, config.seed, offered_load);
+    } else {
+        PacedCapture out(path, offered_load, config.seed);
+        if (scenario == "deep_sweep") {
+            generate_deep_sweep(out, config.commands, config.seed);
+        } else if (scenario == "cancel_heavy") {
+            generate_cancel_heavy(out, config.commands, config.seed);
+        } else if (scenario == "fok_heavy") {
+            generate_fok_heavy(out, config.commands, config.seed);
+        } else if (scenario == "multi_instrument") {
+            generate_multi_instrument(out, config.commands, config.seed);
+        } else if (scenario == "risk") {
+            generate_multi_instrument(out, config.commands, config.seed, true);
+        } else if (scenario == "quote_replace" || scenario == "mass_quote") {
+            generate_quote_updates(out, config.commands, config.seed, scenario == "mass_quote");
+        } else {
+            std::cerr << "Unknown scenario " << scenario << "\n";
+            return false;
+        }
+        written = out.finish();
+    }
+
+    FeedCapture capture(path);
+    std::filesystem::remove(path);  // Mapping stays valid until the capture goes away
+    if (!written || !capture.is_open()) {
+        std::cerr << "Failed writing capture " << path << "\n";
+        return false;
+    }
+
+    if (scenario == "risk") {
+        for (RiskTopology topology : config.risk_topologies) {
+            auto result = std::make_unique<RunResult>();
+            result->scenario = scenario;
+            result->offered_load = offered_load;
+            result->engine = "MultiInstrumentEngine";
+            result->risk = to_string(topology);
+            replay_with_risk(*result, config, capture, topology);
+            report(*result);
+            results.push_back(std::move(result));
+        }
+        return true;
+    }
+
+    auto result = std::make_unique<RunResult>();
+    result->scenario = scenario;
+    result->offered_load = offered_load;
+
+    if (scenario == "fok_heavy") {
+        result->engine = "EnhancedMatchingEngine";
+        replay_into<EnhancedMatchingEngine, SPSCRingBuffer>(*result, config, capture,
+            [](EnhancedMatchingEngine& engine) {
+                // Order type counters are not reported - compile them out of the kernel
+                EnhancedMatchingEngine::MatchFeatures features;
+                features.order_statistics = false;
+                engine.set_match_features(features);
+            });
+    } else if (scenario == "multi_instrument" || scenario == "quote_replace" || scenario == "mass_quote") {
+        result->engine = "MultiInstrumentEngine";
+        replay_into<MultiInstrumentEngine, MultiInstrumentRingBuffer>(*result, config, capture,
+            [](MultiInstrumentEngine& engine) { add_multi_instruments(engine); });
+    } else {
+        result->engine = "MatchingEngine";
+        replay_into<MatchingEngine, SPSCRingBuffer>(*result, config, capture,
+            [&config](MatchingEngine& engine) { engine.set_wait_strategy(config.engine_wait); });
+    }
+
+    report(*result);
+    results.push_back(std::move(result));
+    return true;
+}
+
+void write_histogram(std::ostream& out, const char* name, const LatencyHistogram& histogram) {
+    out << "\"" << name << "\": {\"count\": " << histogram.count()
+        << ", \"min\": " << histogram.min()
+        << ", \"mean\": " << static_cast<uint64_t>(histogram.mean())
+        << ", \"p50\": " << histogram.percentile(50.0)
+        << ", \"p90\": " << histogram.percentile(90.0)
+        << ", \"p99\": " << histogram.percentile(99.0)
+        << ", \"p99_9\": " << histogram.percentile(99.9)
+        << ", \"p99_99\": " << histogram.percentile(99.99)
+        << ", \"max\": " << histogram.max()
+        << ", \"clamped\": " << histogram.clamped_count() << "}";
+}
+
+/**
+ * Results as one JSON document - names are plain identifiers, so nothing
+ * needs escaping
+ */
+void write_json(std::ostream& out, const SuiteConfig& config, const std::vector<std::unique_ptr<RunResult>>& results) {
+    out << "{\n";
+    out << "  \"benchmark\": \"order_matching_engine\",\n";
+    out << "  \"format_version\": 2,\n";
+    out << "  \"commands_per_run\": " << config.commands << ",\n";
+    out << "  \"seed\": " << config.seed << ",\n";
+    out << "  \"tsc_ticks_per_ns\": " << TscClock::ticks_per_ns() << ",\n";
+    out << "  \"engine_wait\": \"" << to_string(config.engine_wait.policy) << "\",\n";
+    out << "  \"results\": [\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const RunResult& run = *results[i];
+        out << "    {\"scenario\": \"" << run.scenario << "\", \"engine\": \"" << run.engine
+            << "\", \"risk\": \"" << run.risk
+            << "\", \"offered_load\": " << run.offered_load
+            << ", \"commands\": " << run.commands
+            << ", \"elapsed_ms\": " << run.elapsed_ms
+            << ", \"throughput\": " << static_cast<uint64_t>(run.throughput())
+            << ", \"trades\": " << run.trades
+            << ", \"rejected\": " << run.rejected << ",\n";
+        out << "     \"latency_ns\": {";
+        write_histogram(out, "queueing", run.queueing);
+        out << ",\n                    ";
+        write_histogram(out, "matching", run.matching);
+        out << ",\n                    ";
+        write_histogram(out, "publish", run.publish);
+        if (run.risk_queueing.count() > 0) {
+            out << ",\n                    ";
+            write_histogram(out, "risk_queueing", run.risk_queueing);
+        }
+        out << "}}" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n";
+    out << "}\n";
+}
+
+template <typename T, typename Parse>
+std::vector<T> parse_list(const char* list, Parse parse) {
+    std::vector<T> values;
+    std::string item;
+    for (const char* p = list;; ++p) {
+        if (*p == ',' || *p == '\0') {
+            if (!item.empty()) values.push_back(parse(item));
+            item.clear();
+            if (*p == '\0') break;
+        } else {
+            item += *p;
+        }
+    }
+    return values;
+}
+
+} // namespace
+
+/**
+ * Standalone benchmark suite: each scenario is generated into a feed
+ * capture with a fixed seed and replayed through the engine that serves
+ * it, with feed, matching and publisher on their own threads. Reports
+ * throughput and per-stage HDR latency (enqueue -> dequeue -> fill ->
+ * publisher) as JSON; a one-line summary per run goes to stderr.
+ *
+ * Usage:
+ *   bench_suite [--commands N] [--seed S] [--loads 250000,500000,0]
+ *               [--scenarios mixed,deep_sweep,cancel_heavy,fok_heavy,multi_instrument,risk,
+ *                            quote_replace,mass_quote]
+ *               [--risk inline,staged] [--wait spin|pause|yield|park|timed] [--workdir DIR] [--json FILE]
+ *               [--matching-cpu N] [--feed-cpu N] [--publisher-cpu N] [--risk-cpu N]
+ *
+ * "mixed" (the FeedHandler flow) runs once per offered load, 0 meaning as
+ * fast as the ring accepts; the other scenarios run at maximum rate.
+ * "risk" is the multi-instrument flow with account-owned orders, run once
+ * per risk topology: checks inline on the matching core, or staged on
+ * their own core (--risk-cpu) between feed and engine. "quote_replace" and
+ * "mass_quote" are the same market-maker re-quotes sent as cancel + new
+ * pairs and as mass quotes.
+ */
+int main(int argc, char** argv) {
+    SuiteConfig config;
+    for (int i = 1; i < argc; ++i) {
+        const bool has_value = i + 1 < argc;
+        if (std::strcmp(argv[i], "--commands") == 0 && has_value) {
+            config.commands = std::strtoull(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--seed") == 0 && has_value) {
+            config.seed = std::strtoull(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--loads") == 0 && has_value) {
+            config.loads = parse_list<uint64_t>(argv[++i], [](const std::string& s) {
+                return std::strtoull(s.c_str(), nullptr, 10);
+            });
+        } else if (std::strcmp(argv[i], "--scenarios") == 0 && has_value) {
+            config.scenarios = parse_list<std::string>(argv[++i], [](const std::string& s) { return s; });
+        } else if (std::strcmp(argv[i], "--wait") == 0 && has_value) {
+            WaitPolicy policy;
+            if (!parse_wait_policy(argv[++i], policy)) {
+                std::cerr << "Unknown wait policy " << argv[i] << " (spin, pause, yield, park, timed)\n";
+                return 1;
+            }
+            config.engine_wait = WaitConfig(policy);
+        } else if (std::strcmp(argv[i], "--risk") == 0 && has_value) {
+            bool known = true;
+            config.risk_topologies = parse_list<RiskTopology>(argv[++i], [&known](const std::string& s) {
+                RiskTopology topology = RiskTopology::INLINE;
+                known = parse_risk_topology(s.c_str(), topology) && known;
+                return topology;
+            });
+            if (!known) {
+                std::cerr << "Unknown risk topology in " << argv[i] << " (inline, staged)\n";
+                return 1;
+            }
+        } else if (std::strcmp(argv[i], "--workdir") == 0 && has_value) {
+            config.workdir = argv[++i];
+        } else if (std::strcmp(argv[i], "--json") == 0 && has_value) {
+            config.json_path = argv[++i];
+        } else if (std::strcmp(argv[i], "--matching-cpu") == 0 && has_value) {
+            config.matching_cpu = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--feed-cpu") == 0 && has_value) {
+            config.feed_cpu = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--publisher-cpu") == 0 && has_value) {
+            config.publisher_cpu = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--risk-cpu") == 0 && has_value) {
+            config.risk_cpu = std::atoi(argv[++i]);
+        } else {
+            std::cerr << "Unknown option " << argv[i] << "\n";
+            return 1;
+        }
+    }
+    if (config.seed == FeedHandler::RANDOM_SEED) {
+        std::cerr << "Seed " << FeedHandler::RANDOM_SEED << " means random - runs would not be comparable\n";
+        return 1;
+    }
+
+    TscClock::calibrate();
+
+    std::vector<std::unique_ptr<RunResult>> results;
+    for (const std::string& scenario : config.scenarios) {
+        if (scenario == "mixed") {
+            for (uint64_t load : config.loads) {
+                if (!run_scenario(scenario, load, config, results)) return 1;
+            }
+        } else if (!run_scenario(scenario, 0, config, results)) {
+            return 1;
+        }
+    }
+
+    if (config.json_path.empty()) {
+        write_json(std::cout, config, results);
+    } else {
+        std::ofstream out(config.json_path);
+        write_json(out, config, results);
+        if (!out) {
+            std::cerr << "Failed writing " << config.json_path << "\n";
+            return 1;
+        }
+        std::cerr << "Results written to " << config.json_path << "\n";
+    }
+    return 0;
+}
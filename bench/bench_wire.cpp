@@ -0,0 +1,290 @@
+#include "multi_instrument_engine.hpp"
+#include "order_gateway.hpp"
+#include "multicast_publisher.hpp"
+#include "output_stage.hpp"
+#include "risk_manager.hpp"
+#include "latency_histogram.hpp"
+#include "numa_placement.hpp"
+#include "tsc_clock.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <thread>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+using namespace OrderBook;
+using namespace OrderEntry;
+
+namespace {
+
+constexpr uint32_t WIRE_INSTRUMENT_ID = 1;
+constexpr int32_t WIRE_PRICE = 5000;
+
+struct WireConfig {
+    uint64_t round_trips = 100'000;
+    uint64_t warmup = 1'000;  // Round trips run before measuring
+    int gateway_cpu = -1;
+    int matching_cpu = -1;
+    int publisher_cpu = -1;
+    int client_cpu = -1;
+};
+
+void print_stage_latency(const char* name, const LatencyHistogram& histogram) {
+    std::cout << name << ": P50 " << histogram.percentile(50.0) << " / P99 " << histogram.percentile(99.0)
+              << " / P99.9 " << histogram.percentile(99.9) << " / max " << histogram.max() << " ns ("
+              << histogram.count() << " samples)\n";
+}
+
+uint64_t now_ns() noexcept {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+/**
+ * Client end of the loop: one order-entry session and the market data feed
+ */
+class WireClient {
+private:
+    int session_fd_ = -1;
+    int feed_fd_ = -1;
+    uint16_t feed_port_ = 0;
+    SessionId session_ = 0;
+    char packet_[2048];
+
+public:
+    ~WireClient() {
+        if (session_fd_ >= 0) ::close(session_fd_);
+        if (feed_fd_ >= 0) ::close(feed_fd_);
+    }
+
+    /**
+     * Bind the feed socket on a free loopback port, see feed_port()
+     */
+    bool open_feed() {
+        feed_fd_ = socket(AF_INET, SOCK_DGRAM, 0);
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        socklen_t length = sizeof(address);
+        if (feed_fd_ < 0 || bind(feed_fd_, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+            getsockname(feed_fd_, reinterpret_cast<sockaddr*>(&address), &length) != 0) {
+            return false;
+        }
+        feed_port_ = ntohs(address.sin_port);
+        timeval timeout{5, 0};
+        return setsockopt(feed_fd_, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout)) == 0;
+    }
+
+    uint16_t feed_port() const noexcept { return feed_port_; }
+    SessionId session() const noexcept { return session_; }
+
+    bool logon(uint16_t gateway_port, const char* account) {
+        session_fd_ = socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(gateway_port);
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        const int on = 1;
+        if (session_fd_ < 0 || connect(session_fd_, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+            setsockopt(session_fd_, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on)) != 0) {
+            return false;
+        }
+        const LogonMessage logon = make_logon(account);
+        LogonResponseMessage response{};
+        if (!send_bytes(&logon, sizeof(logon)) ||
+            ::recv(session_fd_, &response, sizeof(response), MSG_WAITALL) != static_cast<ssize_t>(sizeof(response)) ||
+            response.header.type != MessageType::LOGON_ACK) {
+            return false;
+        }
+        session_ = response.session_id;
+        return true;
+    }
+
+    bool send_bytes(const void* data, size_t size) {
+        return ::send(session_fd_, data, size, 0) == static_cast<ssize_t>(size);
+    }
+
+    /**
+     * A resting sell and the buy crossing it, in one write
+     */
+    bool send_pair(uint64_t resting_id, uint64_t aggressor_id) {
+        NewOrderMessage orders[2] = {make_message<NewOrderMessage>(), make_message<NewOrderMessage>()};
+        for (NewOrderMessage& order : orders) {
+            order.instrument_id = WIRE_INSTRUMENT_ID;
+            order.order_type = OrderType::LIMIT;
+            order.price = WIRE_PRICE;
+            order.quantity = 1;
+        }
+        orders[0].order_id = resting_id;
+        orders[0].side = Side::SELL;
+        orders[1].order_id = aggressor_id;
+        orders[1].side = Side::BUY;
+        return send_bytes(orders, sizeof(orders));
+    }
+
+    /**
+     * Read feed packets until one satisfies match(message type, message bytes).
+     * false on a receive timeout.
+     */
+    template <typename Match>
+    bool await(Match&& match) {
+        while (true) {
+            const ssize_t size = ::recv(feed_fd_, packet_, sizeof(packet_), 0);
+            if (size < static_cast<ssize_t>(sizeof(MarketDataPacketHeader))) return false;
+
+            size_t offset = sizeof(MarketDataPacketHeader);
+            bool matched = false;
+            while (offset < static_cast<size_t>(size)) {
+                const auto type = static_cast<MarketDataMessageType>(packet_[offset]);
+                matched = match(type, packet_ + offset) || matched;
+                offset += type == MarketDataMessageType::TRADE ? sizeof(TradeMessage)
+                        : type == MarketDataMessageType::SNAPSHOT ? sizeof(SnapshotHeaderMessage)
+                        : sizeof(LevelMessage);
+            }
+            if (matched) return true;
+        }
+    }
+};
+
+} // namespace
+
+/**
+ * Wire-to-wire benchmark of the network path, in one process over loopback:
+ *
+ *   client --TCP--> OrderGateway --ring--> MultiInstrumentEngine --> OutputStage
+ *          <--UDP-- MulticastMarketDataPublisher <-------------------------'
+ *
+ * Each round trip writes a sell and the buy that crosses it in one send()
+ * and times from just before the send to the trade's datagram arriving, so
+ * it covers both orders through the gateway and engine. The session is
+ * logged on to a RiskManager account, so the engine's inline pre-trade
+ * checks run on every order. Idle stages yield, so the numbers only mean
+ * much with each stage pinned to a core of its own.
+ *
+ * Usage:
+ *   bench_wire [--round-trips N] [--warmup N]
+ *              [--gateway-cpu N] [--matching-cpu N] [--publisher-cpu N] [--client-cpu N]
+ */
+int main(int argc, char** argv) {
+    WireConfig config;
+    for (int i = 1; i < argc; ++i) {
+        const bool has_value = i + 1 < argc;
+        if (std::strcmp(argv[i], "--round-trips") == 0 && has_value) {
+            config.round_trips = std::strtoull(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--warmup") == 0 && has_value) {
+            config.warmup = std::strtoull(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--gateway-cpu") == 0 && has_value) {
+            config.gateway_cpu = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--matching-cpu") == 0 && has_value) {
+            config.matching_cpu = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--publisher-cpu") == 0 && has_value) {
+            config.publisher_cpu = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--client-cpu") == 0 && has_value) {
+            config.client_cpu = std::atoi(argv[++i]);
+        } else {
+            std::cerr << "Unknown option " << argv[i] << "\n";
+            return 1;
+        }
+    }
+
+    TscClock::calibrate();
+
+    RiskManager risk;
+    RiskLimits limits;
+    limits.max_orders_per_second = 0;
+    limits.max_cancels_per_second = 0;
+    limits.max_daily_volume = std::numeric_limits<uint64_t>::max() / 2;
+    risk.logon("WIRE", limits);
+
+    WireClient client;
+    if (!client.open_feed()) {
+        std::cerr << "Cannot open the market data socket\n";
+        return 1;
+    }
+
+    // Egress: engine -> output stage -> UDP
+    auto publisher = std::make_unique<MulticastMarketDataPublisher>("127.0.0.1", client.feed_port());
+    if (!publisher->is_open()) {
+        std::cerr << publisher->error() << "\n";
+        return 1;
+    }
+    const MulticastMarketDataPublisher& feed = *publisher;
+    MarketDataManager market_data;
+    market_data.add_publisher(std::move(publisher));
+    OutputStage output(&market_data);
+
+    auto ring = std::make_unique<MultiInstrumentRingBuffer>();
+    auto engine = std::make_unique<MultiInstrumentEngine>(ring.get());
+    engine->add_instrument(Instrument(WIRE_INSTRUMENT_ID, "WIRE"));
+    engine->set_risk_manager(&risk);
+    engine->set_output_stage(&output);
+
+    // Ingress: TCP -> gateway -> engine ring
+    EpollTcpTransport transport(0, "127.0.0.1");
+    if (!transport.is_open()) {
+        std::cerr << transport.error() << "\n";
+        return 1;
+    }
+    OrderGateway gateway(&transport, ring.get(), risk);
+
+    std::atomic<bool> matching(true);
+    output.start(config.publisher_cpu);
+    gateway.start(config.gateway_cpu);
+    std::thread matching_thread([&engine, &matching, cpu = config.matching_cpu] {
+        if (cpu >= 0) NumaPlacement::pin_current_thread(cpu);
+        while (matching.load(std::memory_order_relaxed)) {
+            if (engine->process_burst() == 0) std::this_thread::yield();
+        }
+    });
+
+    if (config.client_cpu >= 0) NumaPlacement::pin_current_thread(config.client_cpu);
+    LatencyHistogram wire_to_wire;
+    bool ok = client.logon(transport.port(), "WIRE");
+    if (!ok) std::cerr << "Logon failed\n";
+
+    const uint64_t total = config.warmup + config.round_trips;
+    uint64_t order_id = 0;
+    for (uint64_t trip = 0; ok && trip < total; ++trip) {
+        const uint64_t resting_id = ++order_id;
+        const uint64_t aggressor_id = ++order_id;
+
+        const uint64_t sent = now_ns();
+        ok = client.send_pair(resting_id, aggressor_id) &&
+             client.await([aggressor = engine_order_id(client.session(), aggressor_id)](
+                              MarketDataMessageType type, const char* bytes) {
+                 if (type != MarketDataMessageType::TRADE) return false;
+                 TradeMessage trade;
+                 std::memcpy(&trade, bytes, sizeof(trade));
+                 return trade.aggressor_order_id == aggressor;
+             });
+        if (ok && trip >= config.warmup) wire_to_wire.record(now_ns() - sent);
+    }
+    if (!ok) std::cerr << "Round trip " << order_id / 2 << " did not complete\n";
+
+    gateway.stop();
+    matching.store(false, std::memory_order_relaxed);
+    matching_thread.join();
+    output.stop();
+
+    const GatewayStatistics& sessions = gateway.statistics();
+    std::cout << "=== Wire-to-Wire (TCP order entry -> UDP market data, loopback) ===\n";
+    std::cout << "Round trips: " << wire_to_wire.count() << " measured after " << config.warmup << " warm-up\n";
+    std::cout << "Gateway: " << sessions.commands << " commands, " << sessions.ring_stalls << " ring stalls, "
+              << sessions.protocol_errors << " protocol errors\n";
+    std::cout << "Engine: " << engine->orders_processed() << " processed, " << engine->orders_rejected()
+              << " rejected\n";
+    std::cout << "Feed: " << feed.packets_sent() << " packets, " << feed.send_failures() << " send failures\n";
+    print_stage_latency("Wire-to-wire (client send -> trade datagram)", wire_to_wire);
+    print_stage_latency("Queueing (gateway decode -> engine dequeue)", engine->queue_latency());
+    print_stage_latency("Matching (engine dequeue -> fill)", engine->trade_latency());
+    print_stage_latency("Publish (engine emit -> publisher pickup)", output.publish_latency());
+    return ok ? 0 : 1;
+}
@@ -1,50 +1,120 @@
 #pragma once
 
 #include "types.hpp"
-#include <vector>
+#include "instrument.hpp"
+#include "price_ladder.hpp"
+#include "order_pool.hpp"
 
 namespace OrderBook {
 
 /**
- * Order Book implementation using direct-mapped price grid for O(1) lookup.
- * 
+ * Order Book implementation using a direct-mapped price window for O(1) lookup.
+ *
  * Instead of std::map<price, PriceLevel> which has O(log n) lookup,
- * we use std::vector<PriceLevel> with direct indexing for O(1) access.
- * This assumes a bounded price range but provides significant performance benefits.
+ * each side is a PriceLadder: a dense window of levels around the touch
+ * indexed directly by tick, backed by a sparse store for far-away levels.
+ * The ladder is sized from the instrument's price range and tick size, so
+ * wide-range or sub-tick-priced instruments no longer pay for (or are limited
+ * to) the global PRICE_LEVELS grid.
+ *
+ * A hierarchical occupancy bitmap per side tracks which levels are non-empty, so
+ * recovering the best price after the touch is swept (and stepping to the next
+ * occupied level while matching) takes a few ctz/clz instructions, not a scan.
  */
 class Book {
 private:
-    std::vector<PriceLevel> bid_levels_;    // Index = price, higher indices = higher prices
-    std::vector<PriceLevel> ask_levels_;    // Index = price, lower indices = lower prices
+    OrderPool& orders_;  // Pool every resting order comes from; level links index into it
+    PriceLadder bids_;
+    PriceLadder asks_;
     int64_t best_bid_price_;
     int64_t best_ask_price_;
-    
+    bool batching_;       // Inside begin_batch() / end_batch()
+    bool best_bid_stale_; // Best level emptied during the batch
+    bool best_ask_stale_;
+
     void update_best_bid() noexcept;
     void update_best_ask() noexcept;
-    
+
 public:
-    Book();
-    
+    /**
+     * Default book over the global PRICE_MIN..PRICE_MAX range with unit ticks.
+     * Orders added to the book must be allocated from orders.
+     */
+    explicit Book(OrderPool& orders);
+    Book(OrderPool& orders, const LadderConfig& config);
+    Book(OrderPool& orders, const Instrument& instrument, uint64_t window_levels = PRICE_WINDOW_LEVELS);
+
     /**
      * Add order to appropriate price level and side
-     * Updates best bid/ask tracking for O(1) top-of-book access
+     * Updates best bid/ask tracking for O(1) top-of-book access.
+     * false, leaving the book untouched, if the price is outside the
+     * ladder's range or off its tick grid - the caller still owns order.
      */
-    void add_order(Order* order) noexcept;
-    
+    bool add_order(Order* order) noexcept;
+
     /**
      * Remove order from book (used for cancellations)
      * Updates best bid/ask if necessary
      */
     void remove_order(Order* order) noexcept;
-    
+
+    /**
+     * Fill quantity of a resting order at level, as returned by
+     * get_price_level() for the order's side. Keeps the level's volume and
+     * the side's cumulative depth in step.
+     */
+    void fill_order(PriceLevel* level, Order* order, uint64_t quantity) noexcept;
+
+    /**
+     * Shrink a resting order by quantity, leaving at least one, in place -
+     * it keeps its time priority
+     */
+    void reduce_order(Order* order, uint64_t quantity) noexcept;
+
+    /**
+     * Batch of adds and removes with a single best bid / ask recovery:
+     * between begin_batch() and end_batch() emptying the best level only
+     * marks it stale, so best_bid() / best_ask() may name an empty level
+     * and nothing may match against the book. end_batch() restores both.
+     */
+    void begin_batch() noexcept;
+    void end_batch() noexcept;
+
+    /**
+     * Volume an aggressor limited at price could trade against: asks at or
+     * below it, bids at or above it. O(log window) near the touch; the count
+     * may stop early once it reaches enough.
+     */
+    uint64_t ask_volume_through(int64_t price, uint64_t enough = UINT64_MAX) const noexcept;
+    uint64_t bid_volume_through(int64_t price, uint64_t enough = UINT64_MAX) const noexcept;
+
     /**
      * Get price level for specific price and side
-     * O(1) direct array access
+     * O(1) inside the window around the touch. Returns nullptr for prices off
+     * the tick grid or out of range, and for empty levels outside the window.
      */
     PriceLevel* get_price_level(int64_t price, Side side) noexcept;
-    
+    const PriceLevel* get_price_level(int64_t price, Side side) const noexcept;
+
     int64_t best_bid() const noexcept;
     int64_t best_ask() const noexcept;
+
+    /**
+     * Next occupied level strictly beyond price, moving away from the touch
+     * (higher for asks, lower for bids). Returns -1 if there is none.
+     */
+    int64_t next_ask_price(int64_t price) const noexcept;
+    int64_t next_bid_price(int64_t price) const noexcept;
+
+    const PriceLadder& bid_ladder() const noexcept;
+    const PriceLadder& ask_ladder() const noexcept;
+
+    /**
+     * Snapshot support: both ladders and the touch. The pool the levels link
+     * into is saved separately by its owner.
+     */
+    void save(SnapshotWriter& out) const noexcept;
+    bool load(SnapshotReader& in) noexcept;
 };
 
-} // namespace OrderBook
\ No newline at end of file
+} // namespace OrderBook
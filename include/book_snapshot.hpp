@@ -0,0 +1,73 @@
+#pragma once
+
+#include "types.hpp"
+#include "market_data.hpp"
+#include <array>
+#include <atomic>
+
+namespace OrderBook {
+
+class Book;
+
+/**
+ * Best bid and ask of a published book, -1 / 0 for an empty side
+ */
+struct BookTop {
+    int64_t bid_price = -1;
+    uint64_t bid_quantity = 0;
+    int64_t ask_price = -1;
+    uint64_t ask_quantity = 0;
+};
+
+/**
+ * Top-of-book and top-N depth of one book, published by the matching thread
+ * and read consistently from any number of other threads.
+ *
+ * A seqlock over a private copy: publish() never waits for readers, and
+ * readers never touch the Book or its cache lines - they retry if a
+ * publication overlapped their copy. The block is cache-line aligned so a
+ * busy reader only ever shares the snapshot's lines with the writer.
+ */
+class alignas(CACHE_LINE_SIZE) BookSnapshot {
+private:
+    static constexpr size_t TOP_WORDS = sizeof(BookTop) / sizeof(uint64_t);
+    static constexpr size_t DEPTH_WORDS = sizeof(Level2Snapshot) / sizeof(uint64_t);
+    static_assert(sizeof(BookTop) == TOP_WORDS * sizeof(uint64_t), "BookTop is copied by word");
+    static_assert(sizeof(Level2Snapshot) == DEPTH_WORDS * sizeof(uint64_t), "Level2Snapshot is copied by word");
+
+    std::atomic<uint64_t> sequence_{0};  // Odd while a publication is in progress
+    std::array<std::atomic<uint64_t>, TOP_WORDS> top_{};
+    std::array<std::atomic<uint64_t>, DEPTH_WORDS> depth_{};
+
+    template <size_t Words>
+    bool read_words(const std::array<std::atomic<uint64_t>, Words>& from, uint64_t* to) const noexcept;
+
+public:
+    BookSnapshot() noexcept = default;
+    BookSnapshot(const BookSnapshot&) = delete;
+    BookSnapshot& operator=(const BookSnapshot&) = delete;
+
+    /**
+     * Writer: publish depth, top of book taken from its first levels.
+     * Single writer (the matching thread).
+     */
+    void publish(const Level2Snapshot& snapshot) noexcept;
+
+    /**
+     * Writer: publish the best MARKET_DEPTH_LEVELS levels of book a side
+     */
+    void publish(const Book& book, uint32_t instrument_id) noexcept;
+
+    /**
+     * Reader: copy of the last publication. false if nothing was published yet.
+     */
+    bool read(Level2Snapshot& snapshot) const noexcept;
+    bool read_top(BookTop& top) const noexcept;
+
+    /**
+     * Publications so far - changes whenever the book published anew
+     */
+    uint64_t version() const noexcept { return sequence_.load(std::memory_order_acquire) / 2; }
+};
+
+} // namespace OrderBook
@@ -0,0 +1,203 @@
+#pragma once
+
+#include "types.hpp"
+#include "spsc_queue.hpp"
+#include <atomic>
+#include <string>
+#include <thread>
+
+namespace OrderBook {
+
+/**
+ * One journaled input: a command and its position in the engine's order of
+ * consumption. Sequences start at 1, so an all-zero record is unwritten space.
+ */
+struct CommandJournalRecord {
+    uint64_t sequence;
+    Command command;
+};
+
+static_assert(sizeof(CommandJournalRecord) == 40, "CommandJournalRecord is an on-disk format");
+
+/**
+ * Append-only memory-mapped journal of sequenced engine input.
+ *
+ * Same segment layout as MarketDataJournal (pre-allocated, pre-faulted
+ * segments <base>.000000.cmj, ...; JournalSegmentHeader at offset 0; closing
+ * trims the tail) with 40-byte CommandJournalRecords. If the process dies
+ * the zero tail marks the end of valid records. Appending is a copy into
+ * the mapping, so the journal survives a process crash as soon as append()
+ * returns; sync() schedules write-back for machine crashes.
+ */
+class CommandJournal {
+private:
+    std::string base_path_;
+    uint64_t segment_bytes_;
+    uint64_t segment_index_;
+    int fd_;
+    char* map_;
+    uint64_t write_offset_;
+    uint64_t segment_records_;
+    uint64_t records_written_;
+    uint64_t last_sequence_;
+
+    bool open_segment(uint64_t index) noexcept;
+    void close_segment() noexcept;
+
+public:
+    explicit CommandJournal(const std::string& base_path,
+                            uint64_t segment_bytes = JOURNAL_SEGMENT_SIZE);
+    ~CommandJournal();
+
+    CommandJournal(const CommandJournal&) = delete;
+    CommandJournal& operator=(const CommandJournal&) = delete;
+
+    bool is_open() const noexcept;
+
+    /**
+     * Copy one record into the mapped segment, rolling over when full.
+     * Records are dropped if the journal could not be opened.
+     */
+    void append(const CommandJournalRecord& record) noexcept;
+
+    /**
+     * Schedule write-back of the mapped pages without blocking on I/O
+     */
+    void sync() noexcept;
+
+    void close() noexcept;
+
+    uint64_t records_written() const noexcept;
+    uint64_t segment_count() const noexcept;
+    uint64_t last_sequence() const noexcept;
+
+    static std::string segment_path(const std::string& base_path, uint64_t index);
+};
+
+/**
+ * Sequential reader over all segments of a command journal, in write order
+ */
+class CommandJournalReader {
+private:
+    std::string base_path_;
+    uint64_t segment_index_;
+    int fd_;
+    const char* map_;
+    uint64_t map_size_;
+    uint64_t read_offset_;
+
+    bool open_segment(uint64_t index) noexcept;
+    void close_segment() noexcept;
+
+public:
+    explicit CommandJournalReader(const std::string& base_path);
+    ~CommandJournalReader();
+
+    CommandJournalReader(const CommandJournalReader&) = delete;
+    CommandJournalReader& operator=(const CommandJournalReader&) = delete;
+
+    /**
+     * Read the next record. Returns false at the end of the journal.
+     */
+    bool next(CommandJournalRecord& record) noexcept;
+
+    /**
+     * Position the reader so next() returns the record for sequence (or the
+     * first one after it). Sequences are consecutive within a segment, so
+     * this jumps by offset and only touches the pages it lands on - skipping
+     * the part of a journal a snapshot already covers costs no reading.
+     */
+    void skip_to(uint64_t sequence) noexcept;
+};
+
+/**
+ * Write-ahead input journal between the matching engine and the disk.
+ *
+ * The engine calls record() for every command it consumes, before
+ * applying it: a copy of the command and its sequence into a dedicated SPSC
+ * ring. A journal thread drains the ring in batches into a
+ * CommandJournal, so the matching thread never touches the file. When the
+ * ring is full the engine yields until the writer catches up - input is
+ * never dropped, since recovery depends on every command being there.
+ *
+ * The journal trails the engine by at most the ring's contents: after a
+ * crash, the engine state that can be rebuilt is the snapshot plus
+ * everything up to journaled_sequence().
+ */
+class JournalStage {
+private:
+    SPSCQueue<CommandJournalRecord> ring_;
+    CommandJournal journal_;
+
+    std::thread writer_thread_;
+    std::atomic<bool> running_;
+
+    // Producer-side state (matching thread)
+    uint64_t recorded_sequence_;
+    uint64_t producer_stalls_;
+
+    // Consumer-side state (journal thread)
+    std::atomic<uint64_t> journaled_sequence_;
+
+    void run();
+
+public:
+    explicit JournalStage(const std::string& base_path, uint64_t capacity = COMMAND_JOURNAL_RING_SIZE,
+                          uint64_t segment_bytes = JOURNAL_SEGMENT_SIZE);
+    ~JournalStage();
+
+    JournalStage(const JournalStage&) = delete;
+    JournalStage& operator=(const JournalStage&) = delete;
+
+    bool is_open() const noexcept;
+
+    /**
+     * Launch the journal thread, pinned to cpu unless it is -1
+     */
+    void start(int cpu = -1);
+
+    /**
+     * Write everything still queued, then join the journal thread and close
+     * the journal. The engine must have stopped recording before this is called.
+     */
+    void stop();
+
+    /**
+     * Producer: journal cmd as the engine's command number sequence.
+     * Matching thread only.
+     */
+    void record(uint64_t sequence, const Command& cmd) noexcept {
+        CommandJournalRecord* slot = ring_.try_claim();
+        if (!slot) {
+            ++producer_stalls_;
+            while (!(slot = ring_.try_claim())) {
+                // Journal ring full - wait for the writer rather than lose input
+                std::this_thread::yield();
+            }
+        }
+        slot->sequence = sequence;
+        slot->command = cmd;
+        ring_.commit();
+        recorded_sequence_ = sequence;
+    }
+
+    /**
+     * Consumer: write one batch of queued records to the journal. Called by
+     * the journal thread; can be driven directly when the stage is not started.
+     * Returns the number of records written.
+     */
+    size_t drain() noexcept;
+
+    /**
+     * Sequence of the last command handed to the stage / safely in the journal
+     */
+    uint64_t recorded_sequence() const noexcept { return recorded_sequence_; }
+    uint64_t journaled_sequence() const noexcept {
+        return journaled_sequence_.load(std::memory_order_acquire);
+    }
+
+    uint64_t producer_stalls() const noexcept { return producer_stalls_; }
+    const CommandJournal& journal() const noexcept { return journal_; }
+};
+
+} // namespace OrderBook
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace OrderBook {
+
+/**
+ * Fenwick (binary indexed) tree of resting volume over a fixed range of
+ * price slots.
+ *
+ * Each node covers a power-of-two run of slots ending at its own index, so
+ * changing one slot's volume touches log2(size) nodes and the volume of any
+ * prefix or range of slots is log2(size) additions - an FOK feasibility
+ * check no longer walks the levels it is about to match.
+ *
+ * Header-only so updates inline into the ladder's add / remove / fill paths.
+ */
+class CumulativeDepth {
+private:
+    std::vector<uint64_t> tree_;  // 1-based; tree_[0] unused
+
+public:
+    explicit CumulativeDepth(uint64_t size) : tree_(size + 1, 0) {}
+
+    uint64_t size() const noexcept { return tree_.size() - 1; }
+
+    /**
+     * Volume at slot grows / shrinks by quantity. Unsigned wrap-around makes
+     * a shrink exact as long as the slot never goes below zero.
+     */
+    void add(uint64_t slot, uint64_t quantity) noexcept {
+        for (uint64_t i = slot + 1; i < tree_.size(); i += i & (~i + 1)) tree_[i] += quantity;
+    }
+
+    void subtract(uint64_t slot, uint64_t quantity) noexcept {
+        for (uint64_t i = slot + 1; i < tree_.size(); i += i & (~i + 1)) tree_[i] -= quantity;
+    }
+
+    /**
+     * Total volume of slots [0, count)
+     */
+    uint64_t prefix(uint64_t count) const noexcept {
+        uint64_t sum = 0;
+        for (uint64_t i = count < tree_.size() ? count : tree_.size() - 1; i > 0; i &= i - 1) sum += tree_[i];
+        return sum;
+    }
+
+    /**
+     * Total volume of slots [first, last)
+     */
+    uint64_t range(uint64_t first, uint64_t last) const noexcept {
+        return last > first ? prefix(last) - prefix(first) : 0;
+    }
+
+    void reset() noexcept {
+        std::fill(tree_.begin(), tree_.end(), 0);
+    }
+
+    /**
+     * Rebuild from volume(slot) for every slot in O(size) - each node pushes
+     * its partial sum to its parent once
+     */
+    template <typename Volume>
+    void rebuild(Volume&& volume) noexcept {
+        for (uint64_t i = 1; i < tree_.size(); ++i) tree_[i] = volume(i - 1);
+        for (uint64_t i = 1; i < tree_.size(); ++i) {
+            const uint64_t parent = i + (i & (~i + 1));
+            if (parent < tree_.size()) tree_[parent] += tree_[i];
+        }
+    }
+};
+
+} // namespace OrderBook
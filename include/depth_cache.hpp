@@ -0,0 +1,58 @@
+#pragma once
+
+#include "types.hpp"
+#include "book.hpp"
+#include "market_data.hpp"
+#include <array>
+#include <span>
+
+namespace OrderBook {
+
+/**
+ * Incremental top-N depth for one book.
+ *
+ * Keeps the best MARKET_DEPTH_LEVELS levels per side in fixed sorted arrays
+ * and patches them in place as individual levels change, instead of walking
+ * the ladder to rebuild depth for every snapshot. When a level inside the
+ * depth empties, the next one is pulled in from the book's occupancy index.
+ *
+ * Changes to levels deeper than the cached depth are not visible and are
+ * reported as such, so callers only publish deltas that matter to a top-N feed.
+ */
+class DepthCache {
+private:
+    struct DepthSide {
+        std::array<PriceLevelData, MARKET_DEPTH_LEVELS> levels;
+        uint32_t count = 0;
+    };
+
+    const Book& book_;
+    DepthSide bids_;
+    DepthSide asks_;
+
+    void refill(DepthSide& depth, Side side) noexcept;
+
+public:
+    explicit DepthCache(const Book& book) noexcept;
+
+    /**
+     * Re-read the level at price from the book after it changed.
+     * Returns true if the cached depth changed (i.e. a delta should be published).
+     */
+    bool on_level_change(Side side, int64_t price) noexcept;
+
+    /**
+     * Rebuild both sides from the book
+     */
+    void rebuild() noexcept;
+
+    std::span<const PriceLevelData> bids() const noexcept;
+    std::span<const PriceLevelData> asks() const noexcept;
+
+    /**
+     * Replace snapshot depth with the cached levels - a straight copy
+     */
+    void copy_into(Level2Snapshot& snapshot) const;
+};
+
+} // namespace OrderBook
@@ -0,0 +1,108 @@
+#pragma once
+
+#include "types.hpp"
+#include "market_data.hpp"
+#include <array>
+
+namespace OrderBook {
+
+class BookSnapshot;
+
+/**
+ * Column length of a DepthColumns: MARKET_DEPTH_LEVELS rounded up to whole
+ * 256-bit vectors of 32-bit lanes, so kernels never handle a tail
+ */
+constexpr size_t DEPTH_PROFILE_CAPACITY = (MARKET_DEPTH_LEVELS + 7) & ~size_t{7};
+
+enum class DepthKernel : uint8_t {
+    SCALAR,
+    AVX2
+};
+
+/**
+ * One side of a DepthProfile as structure-of-arrays columns, best level
+ * first. Entries past count are zero, and the running totals carry their
+ * last value through them.
+ */
+struct DepthColumns {
+    alignas(CACHE_LINE_SIZE) std::array<int64_t, DEPTH_PROFILE_CAPACITY> prices;
+    alignas(CACHE_LINE_SIZE) std::array<uint64_t, DEPTH_PROFILE_CAPACITY> quantities;
+    alignas(CACHE_LINE_SIZE) std::array<uint32_t, DEPTH_PROFILE_CAPACITY> order_counts;
+    alignas(CACHE_LINE_SIZE) std::array<uint64_t, DEPTH_PROFILE_CAPACITY> cumulative_quantity;  // Levels [0, i]
+    alignas(CACHE_LINE_SIZE) std::array<double, DEPTH_PROFILE_CAPACITY> cumulative_notional;    // Sum of price * quantity over [0, i]
+    uint32_t count;
+};
+
+/**
+ * Top-N depth analytics for pricing, computed off the matching thread.
+ *
+ * refresh() copies a book's BookSnapshot - a seqlock read that never touches
+ * the matching thread's lines - transposes it into per-side columns and
+ * builds the running quantity and notional totals in one vector pass per
+ * side. Depth up to a level, the levels a sweep of some size would take,
+ * the VWAP to fill it and the bid / ask imbalance are then a load or a
+ * compare pass over at most DEPTH_PROFILE_CAPACITY lanes.
+ *
+ * The AVX2 kernel converts to double with the 2^52 bias trick, exact for
+ * prices and level volumes below 2^51; best_kernel() picks it when the CPU
+ * has AVX2. Queries take the resting side being swept: vwap(Side::SELL, q)
+ * is what a buyer of q pays.
+ */
+class DepthProfile {
+private:
+    DepthColumns bids_;
+    DepthColumns asks_;
+    uint32_t instrument_id_;
+    uint64_t version_;  // BookSnapshot version last loaded, 0 = none
+    DepthKernel kernel_;
+
+    void load_side(const DepthLevels& levels, DepthColumns& columns) noexcept;
+
+public:
+    explicit DepthProfile(DepthKernel kernel = best_kernel()) noexcept;
+
+    /**
+     * AVX2 if this CPU has it, else SCALAR
+     */
+    static DepthKernel best_kernel() noexcept;
+
+    /**
+     * Rebuild from a depth snapshot
+     */
+    void load(const Level2Snapshot& snapshot) noexcept;
+
+    /**
+     * Rebuild from snapshot if it has published since the last refresh.
+     * Returns true if the profile changed.
+     */
+    bool refresh(const BookSnapshot& snapshot) noexcept;
+
+    const DepthColumns& side(Side side) const noexcept { return side == Side::BUY ? bids_ : asks_; }
+    uint32_t instrument_id() const noexcept { return instrument_id_; }
+    DepthKernel kernel() const noexcept { return kernel_; }
+
+    /**
+     * Resting quantity on the best levels of side
+     */
+    uint64_t volume(Side side, size_t levels = MARKET_DEPTH_LEVELS) const noexcept;
+
+    /**
+     * Levels of side a sweep of quantity would take, the last possibly in
+     * part; 0 if the visible depth can't fill it
+     */
+    size_t levels_to_fill(Side side, uint64_t quantity) const noexcept;
+
+    /**
+     * Average price of sweeping quantity from side. false if the visible
+     * depth can't fill it.
+     */
+    bool vwap(Side side, uint64_t quantity, double& price) const noexcept;
+
+    /**
+     * (bid - ask) / (bid + ask) volume over the best levels of each side, in
+     * [-1, 1]; 0 for an empty book
+     */
+    double imbalance(size_t levels = MARKET_DEPTH_LEVELS) const noexcept;
+};
+
+} // namespace OrderBook
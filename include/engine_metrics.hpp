@@ -0,0 +1,108 @@
+#pragma once
+
+#include "types.hpp"
+#include "latency_histogram.hpp"
+#include "tsc_clock.hpp"
+#include <atomic>
+
+namespace OrderBook {
+
+/**
+ * rdtsc span timer that times one call in period. The calls in between
+ * cost a decrement and a predictable branch.
+ *
+ *     const uint64_t span = span_.begin();
+ *     ...
+ *     span_.end(span);
+ */
+class SpanSampler {
+private:
+    uint32_t period_;
+    uint32_t countdown_;
+    LatencyHistogram histogram_;  // ns per sampled span
+
+public:
+    explicit SpanSampler(uint32_t period = METRICS_SPAN_SAMPLE_PERIOD) noexcept
+        : period_(period ? period : 1), countdown_(period_) {}
+
+    /**
+     * Start tick of a sampled call, 0 for the others
+     */
+    uint64_t begin() noexcept {
+        if (--countdown_ != 0) return 0;
+        countdown_ = period_;
+        return rdtsc();
+    }
+
+    void end(uint64_t start) noexcept {
+        if (start != 0) histogram_.record(TscClock::to_ns(rdtsc() - start));
+    }
+
+    const LatencyHistogram& histogram() const noexcept { return histogram_; }
+};
+
+/**
+ * What a matching engine reports to a metrics scraper
+ */
+struct EngineMetrics {
+    uint64_t orders_processed = 0;
+    uint64_t trades_executed = 0;
+    uint64_t orders_rejected = 0;
+
+    // Order pool utilisation
+    uint64_t pool_allocated = 0;
+    uint64_t pool_capacity = 0;      // Slabs mapped so far
+    uint64_t pool_max_capacity = 0;
+    uint64_t pool_exhaustions = 0;
+
+    LatencyHistogram queue_latency;   // Producer enqueue -> engine dequeue
+    LatencyHistogram trade_latency;   // Engine dequeue -> fill
+    LatencyHistogram new_order_span;  // handle_new_order, sampled
+    LatencyHistogram match_span;      // match_order, sampled
+};
+
+/**
+ * Request / answer handshake that lets a scraper thread read state a
+ * single owner thread keeps in plain, non-atomic fields.
+ *
+ * The scraper posts a ticket with request(). The owner calls serve() at a
+ * point where its state is consistent - the engines do so once per burst,
+ * at the cost of one load when no one asked - copies the state into the
+ * mailbox and answers the ticket. Once answered(ticket) is true the scraper
+ * may read value() until it posts its next request; the owner only writes
+ * the value while a ticket is outstanding, so the two never overlap.
+ */
+template <typename T>
+class MetricsMailbox {
+private:
+    alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> requested_{0};  // Scraper writes
+    alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> answered_{0};   // Owner writes
+    T value_{};
+
+public:
+    // ---- Owner thread ----
+
+    template <typename Fill>
+    void serve(Fill&& fill) noexcept {
+        const uint64_t requested = requested_.load(std::memory_order_acquire);
+        if (requested == answered_.load(std::memory_order_relaxed)) return;
+        fill(value_);
+        answered_.store(requested, std::memory_order_release);
+    }
+
+    // ---- Scraper thread ----
+
+    uint64_t request() noexcept {
+        const uint64_t ticket = requested_.load(std::memory_order_relaxed) + 1;
+        requested_.store(ticket, std::memory_order_release);
+        return ticket;
+    }
+
+    bool answered(uint64_t ticket) const noexcept {
+        return answered_.load(std::memory_order_acquire) == ticket;
+    }
+
+    const T& value() const noexcept { return value_; }
+};
+
+} // namespace OrderBook
@@ -0,0 +1,114 @@
+#pragma once
+
+#include "types.hpp"
+#include <cstring>
+#include <string>
+
+namespace OrderBook {
+
+/**
+ * Header at offset 0 of an engine snapshot file
+ */
+struct EngineSnapshotHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t order_size;          // sizeof(Order), sizeof(OrderInfo) - layouts are dumped raw
+    uint32_t info_size;
+    uint32_t reserved0;
+    uint64_t sequence;            // Commands applied - replay the journal from sequence + 1
+    uint64_t trades_executed;
+    uint64_t orders_rejected;
+    uint64_t total_buy_quantity_matched;
+    uint64_t total_sell_quantity_matched;
+};
+
+static_assert(sizeof(EngineSnapshotHeader) == 64, "EngineSnapshotHeader is an on-disk format");
+
+/**
+ * Sequential writer for an engine snapshot.
+ *
+ * Components append their state as a few large raw sections (pool arrays,
+ * index table) plus compact per-level records. Everything goes to
+ * <path>.tmp, which commit() renames over path, so a crash mid-snapshot
+ * leaves the previous snapshot in place.
+ */
+class SnapshotWriter {
+private:
+    std::string path_;
+    std::string tmp_path_;
+    int fd_;
+    bool ok_;
+    uint64_t bytes_written_;
+
+public:
+    explicit SnapshotWriter(const std::string& path);
+    ~SnapshotWriter();
+
+    SnapshotWriter(const SnapshotWriter&) = delete;
+    SnapshotWriter& operator=(const SnapshotWriter&) = delete;
+
+    void write(const void* data, uint64_t bytes) noexcept;
+
+    template <typename T>
+    void put(const T& value) noexcept { write(&value, sizeof(T)); }
+
+    /**
+     * Make the snapshot the one at path. false (and nothing replaced) if
+     * any write failed.
+     */
+    bool commit() noexcept;
+
+    bool ok() const noexcept { return ok_; }
+    uint64_t bytes_written() const noexcept { return bytes_written_; }
+};
+
+/**
+ * Sequential reader over a memory-mapped snapshot. Sections come back as
+ * pointers into the mapping, so bulk state is restored with one memcpy.
+ */
+class SnapshotReader {
+private:
+    const char* map_;
+    uint64_t size_;
+    uint64_t offset_;
+    bool ok_;
+
+public:
+    explicit SnapshotReader(const std::string& path);
+    ~SnapshotReader();
+
+    SnapshotReader(const SnapshotReader&) = delete;
+    SnapshotReader& operator=(const SnapshotReader&) = delete;
+
+    /**
+     * Next bytes of the snapshot, or nullptr (and !ok()) if it is truncated
+     */
+    const void* take(uint64_t bytes) noexcept;
+
+    template <typename T>
+    bool get(T& value) noexcept {
+        const void* data = take(sizeof(T));
+        if (data) std::memcpy(&value, data, sizeof(T));
+        return data != nullptr;
+    }
+
+    /**
+     * Copy the next bytes into out
+     */
+    bool read(void* out, uint64_t bytes) noexcept {
+        const void* data = take(bytes);
+        if (data) std::memcpy(out, data, bytes);
+        return data != nullptr;
+    }
+
+    bool ok() const noexcept { return ok_; }
+    bool at_end() const noexcept { return offset_ == size_; }
+};
+
+/**
+ * Magic and version for EngineSnapshotHeader
+ */
+void init_snapshot_header(EngineSnapshotHeader& header) noexcept;
+bool valid_snapshot_header(const EngineSnapshotHeader& header) noexcept;
+
+} // namespace OrderBook
@@ -2,28 +2,57 @@
 
 #include "types.hpp"
 #include "book.hpp"
+#include "depth_cache.hpp"
+#include "book_snapshot.hpp"
 #include "order_pool.hpp"
+#include "order_id_index.hpp"
 #include "spsc_ring_buffer.hpp"
 #include "market_data.hpp"
+#include "output_stage.hpp"
+#include "tsc_clock.hpp"
+#include "latency_histogram.hpp"
+#include <array>
+#include <string>
 #include <vector>
-#include <chrono>
-#include <memory>
 
 namespace OrderBook {
 
 /**
  * Enhanced matching engine with support for IOC/FOK orders
- * and market data publishing
+ * and market data publishing.
+ *
+ * Matching is one kernel templated on the aggressor's side, its order type
+ * and a compile-time MatchPolicy. run() picks the policy once from the
+ * MatchFeatures and whether an output stage is attached, and each new order
+ * then goes through an eight-entry (order type x side) jump table of that
+ * policy's kernels - six for LIMIT, IOC and FOK, and two for the unused
+ * order type value that reject the order. No per-fill branches on optional
+ * work, no runtime order type dispatch.
  */
 class EnhancedMatchingEngine {
+public:
+    /**
+     * Optional work in the match loop. Every combination is compiled as its
+     * own kernel, so a disabled feature costs nothing on the hot path.
+     * Market data is on exactly when an output stage is attached.
+     */
+    struct MatchFeatures {
+        bool order_statistics = true;  // Per order type counters and matched quantity totals
+        bool latency_capture = true;   // TSC reads per command, queue and trade latency histograms
+    };
+    
 private:
+    OrderPool order_pool_; // Declared first - the book resolves its order links through it
     Book book_;
-    OrderPool order_pool_;
+    DepthCache depth_;     // Incremental top-N depth for L2 deltas and snapshots
+    bool depth_changed_;   // Since the last snapshot publication
+    bool publish_snapshot_;
     SPSCRingBuffer* ring_buffer_;
-    std::unique_ptr<MarketDataManager> market_data_manager_;
+    OutputStage* output_;  // Trades and L2 updates; nullptr = silent
+    MatchFeatures features_;
     
-    // Order tracking for cancellations
-    std::vector<Order*> order_map_;
+    // Resting orders by client order_id, for cancellation
+    OrderIdIndex order_index_;
     
     // Enhanced statistics
     struct OrderTypeStats {
@@ -35,7 +64,9 @@ private:
     };
     
     std::array<OrderTypeStats, 3> order_type_stats_; // LIMIT, IOC, FOK
-    std::vector<long long> trade_latencies_ns_;
+    LatencyHistogram queue_latency_;  // Producer enqueue -> engine dequeue, ns per command
+    LatencyHistogram trade_latency_;  // Engine dequeue -> fill, ns per trade
+    BookSnapshot snapshot_;
     uint64_t orders_processed_;
     uint64_t trades_executed_;
     uint64_t orders_rejected_;
@@ -46,60 +77,106 @@ public:
     explicit EnhancedMatchingEngine(SPSCRingBuffer* ring_buffer);
     
     /**
-     * Set market data manager for publishing L2 data and trades
+     * Attach the output stage whose publisher thread drives the
+     * MarketDataManager. Must be set before run().
+     */
+    void set_output_stage(OutputStage* output) noexcept;
+    
+    /**
+     * Choose the optional work the match loop does (all on by default).
+     * Must be set before run().
      */
-    void set_market_data_manager(std::unique_ptr<MarketDataManager> manager);
+    void set_match_features(const MatchFeatures& features) noexcept;
     
     /**
-     * Main processing loop with enhanced order type support
+     * Main processing loop with enhanced order type support, until
+     * orders_processed() reaches command_count
      */
-    void run() noexcept;
+    void run(uint64_t command_count = TOTAL_ORDERS_TO_GENERATE) noexcept;
     
     // Statistics getters
     uint64_t orders_processed() const noexcept;
     uint64_t trades_executed() const noexcept;
     uint64_t orders_rejected() const noexcept;
-    const std::vector<long long>& trade_latencies() const noexcept;
-    uint64_t total_buy_quantity_matched() const noexcept;
+    const OrderPool& order_pool() const noexcept;  // Capacity and exhaustion telemetry
+    const LatencyHistogram& queue_latency() const noexcept;  // Empty without latency_capture
+    const LatencyHistogram& trade_latency() const noexcept;
+    uint64_t total_buy_quantity_matched() const noexcept;    // 0 without order_statistics
     uint64_t total_sell_quantity_matched() const noexcept;
     
-    // Order type statistics
+    // Order type statistics - all zero without order_statistics
     const OrderTypeStats& get_order_type_stats(OrderType type) const noexcept;
     void print_order_type_statistics() const noexcept;
     
-    // Market data
+    // Market data - copied from the incremental depth cache, no ladder walk.
+    // The cache is kept current whether or not market data is published.
+    // Matching thread only; other threads read book_snapshot().
     Level2Snapshot create_level2_snapshot() const noexcept;
     
+    /**
+     * Publish the depth cache to book_snapshot() at the end of every burst
+     * that changed it. Must be called before run().
+     */
+    void enable_book_snapshot() noexcept;
+    
+    /**
+     * Seqlock copy of the depth as of the last burst, readable from any thread
+     */
+    const BookSnapshot& book_snapshot() const noexcept;
+    
 private:
-    void handle_new_order(const Command& cmd, const std::chrono::high_resolution_clock::time_point& processing_start) noexcept;
+    /**
+     * Compile-time policy bundle for the match kernel
+     */
+    template <bool Statistics, bool MarketData, bool Latency>
+    struct MatchPolicy {
+        static constexpr bool statistics = Statistics;
+        static constexpr bool market_data = MarketData;
+        static constexpr bool latency = Latency;
+    };
+    
+    using RunLoop = void (EnhancedMatchingEngine::*)(uint64_t) noexcept;
+    using NewOrderHandler = void (EnhancedMatchingEngine::*)(Order*, uint64_t) noexcept;
+    using HandlerTable = std::array<NewOrderHandler, 8>;  // [order type * 2 + side]; type 3 is invalid
+    
+    template <typename Policy>
+    static constexpr HandlerTable make_handler_table() noexcept;
+    
+    template <typename Policy>
+    void run_loop(uint64_t command_count) noexcept;
+    
+    template <typename Policy>
+    void handle_new_order(const Command& cmd, uint64_t processing_start) noexcept;
+    
+    template <typename Policy>
     void handle_cancel_order(uint64_t order_id) noexcept;
     
-    // Enhanced matching with order type support
-    enum class MatchResult {
-        FULLY_MATCHED,
-        PARTIALLY_MATCHED, 
-        NO_MATCH,
-        REJECTED
-    };
+    /**
+     * Match, then rest / cancel / kill the remainder as order type T requires
+     */
+    template <Side S, OrderType T, typename Policy>
+    void process_new_order(Order* order, uint64_t processing_start) noexcept;
     
-    MatchResult match_order(Order* order, const std::chrono::high_resolution_clock::time_point& processing_start) noexcept;
-    MatchResult match_limit_order(Order* order, const std::chrono::high_resolution_clock::time_point& processing_start) noexcept;
-    MatchResult match_ioc_order(Order* order, const std::chrono::high_resolution_clock::time_point& processing_start) noexcept;
-    MatchResult match_fok_order(Order* order, const std::chrono::high_resolution_clock::time_point& processing_start) noexcept;
+    template <typename Policy>
+    void reject_invalid_order(Order* order, uint64_t processing_start) noexcept;
     
-    void match_against_asks(Order* buy_order, const std::chrono::high_resolution_clock::time_point& processing_start) noexcept;
-    void match_against_bids(Order* sell_order, const std::chrono::high_resolution_clock::time_point& processing_start) noexcept;
+    /**
+     * Match an aggressor on side S against the opposite side, touch first
+     */
+    template <Side S, typename Policy>
+    void match(Order* order, uint64_t processing_start) noexcept;
     
-    // FOK order validation - check if order can be fully filled
-    bool can_fill_completely(Order* order) const noexcept;
-    uint64_t calculate_fillable_quantity(Order* order) const noexcept;
+    // FOK order validation - check if order can be fully filled, from the
+    // book's cumulative depth in O(log levels)
+    template <Side S>
+    bool can_fill_completely(const Order* order) const noexcept;
     
-    void execute_trade(uint64_t aggressor_id, uint64_t resting_id, int64_t price, 
-                      uint64_t quantity, const std::chrono::high_resolution_clock::time_point& processing_start) noexcept;
+    template <typename Policy>
+    void execute_trade(uint64_t aggressor_id, uint64_t resting_id, Side aggressor_side, int64_t price, 
+                      uint64_t quantity, uint64_t processing_start) noexcept;
     
-    void update_order_status(Order* order) noexcept;
+    template <typename Policy>
     void publish_market_data_update(Side side, int64_t price) noexcept;
-    void reject_order(Order* order, const std::string& reason) noexcept;
 };
 
 } // namespace OrderBook
\ No newline at end of file
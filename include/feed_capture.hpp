@@ -0,0 +1,94 @@
+#pragma once
+
+#include "types.hpp"
+#include <cstdio>
+#include <string>
+
+namespace OrderBook {
+
+/**
+ * Header at offset 0 of a feed capture file
+ */
+struct FeedCaptureHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t record_size;         // sizeof(Command)
+    uint64_t command_count;       // Filled in by FeedCaptureWriter::finish()
+    uint64_t duration_ns;         // Offset of the last command
+    uint64_t seed;                // Generator seed for synthetic captures, 0 otherwise
+    uint8_t reserved[24];
+};
+
+static_assert(sizeof(FeedCaptureHeader) == 64, "FeedCaptureHeader is an on-disk format");
+
+/**
+ * Sequential writer for a feed capture: a header followed by a flat array
+ * of Commands. In a capture, Command::producer_timestamp holds the
+ * command's offset in ns from the start of the session rather than a TSC
+ * value, which is what replay paces against. Captures come from
+ * FeedHandler::record() (synthetic flow with a fixed seed) or from
+ * converting recorded exchange data.
+ */
+class FeedCaptureWriter {
+private:
+    std::FILE* file_;
+    uint64_t command_count_;
+    uint64_t last_offset_ns_;
+    uint64_t seed_;
+    bool ok_;
+
+public:
+    explicit FeedCaptureWriter(const std::string& path, uint64_t seed = 0);
+    ~FeedCaptureWriter();
+
+    FeedCaptureWriter(const FeedCaptureWriter&) = delete;
+    FeedCaptureWriter& operator=(const FeedCaptureWriter&) = delete;
+
+    /**
+     * Append cmd at offset_ns into the session. Offsets must not decrease.
+     */
+    void append(const Command& cmd, uint64_t offset_ns) noexcept;
+
+    /**
+     * Write the final header and close. false if any write failed.
+     */
+    bool finish() noexcept;
+
+    bool ok() const noexcept { return ok_; }
+    uint64_t command_count() const noexcept { return command_count_; }
+};
+
+/**
+ * Read-only view of a feed capture, memory-mapped and pre-faulted so a
+ * replay reads commands straight out of the page cache
+ */
+class FeedCapture {
+private:
+    const char* map_;
+    uint64_t map_size_;
+    const Command* commands_;
+    uint64_t command_count_;
+    uint64_t duration_ns_;
+    uint64_t seed_;
+
+public:
+    explicit FeedCapture(const std::string& path);
+    ~FeedCapture();
+
+    FeedCapture(const FeedCapture&) = delete;
+    FeedCapture& operator=(const FeedCapture&) = delete;
+
+    /**
+     * false if the file is missing, truncated or not a capture
+     */
+    bool is_open() const noexcept { return map_ != nullptr; }
+
+    const Command* commands() const noexcept { return commands_; }
+    uint64_t size() const noexcept { return command_count_; }
+    const Command& operator[](uint64_t index) const noexcept { return commands_[index]; }
+
+    uint64_t duration_ns() const noexcept { return duration_ns_; }
+    uint64_t seed() const noexcept { return seed_; }
+};
+
+} // namespace OrderBook
@@ -1,19 +1,71 @@
 #pragma once
 
 #include "spsc_ring_buffer.hpp"
+#include "wait_strategy.hpp"
+#include "feed_capture.hpp"
+#include <string>
 
 namespace OrderBook {
 
+class ShardedMatchingEngine;
+
+/**
+ * How FeedHandler::replay() spaces commands out
+ */
+enum class ReplayPacing : uint8_t {
+    MAX_RATE,   // As fast as the ring accepts them
+    RECORDED    // At the capture's recorded offsets from the start of the replay
+};
+
 /**
  * Feed handler simulates realistic market activity
  * Generates orders with appropriate distribution:
  * - 50% passive orders (near current bid/ask)
  * - 20% aggressive orders (cross the spread) 
  * - 30% cancellation requests
+ *
+ * The flow is generated live (run) or pre-generated into a FeedCapture
+ * with a fixed seed (record) and pushed back out later (replay), so
+ * engine changes can be compared on identical input without RNG cost on
+ * the producer thread.
  */
 class FeedHandler {
 public:
-    static void run(SPSCRingBuffer* ring_buffer) noexcept;
+    static constexpr uint64_t RANDOM_SEED = 0;  // Seed the generator from std::random_device
+    
+    /**
+     * Generate count commands into one ring - the engine's own, or one
+     * gateway's lane of an IngressFanIn - waiting per wait while it is
+     * full. Pass the engine's signals for SPIN_PARK.
+     */
+    static void run(SPSCQueue<Command>* ring_buffer, uint64_t count = TOTAL_ORDERS_TO_GENERATE,
+                    const WaitConfig& wait = WaitConfig(WaitPolicy::YIELD),
+                    WaitSignals* signals = nullptr, uint64_t seed = RANDOM_SEED) noexcept;
+    
+    /**
+     * Same flow spread over instruments 1..instrument_count by order id and
+     * routed into a sharded engine, acting as its ingress thread
+     */
+    static void run(ShardedMatchingEngine* engine, uint32_t instrument_count,
+                    uint64_t seed = RANDOM_SEED) noexcept;
+    
+    /**
+     * Pre-generate count commands of the flow into a capture at path. The
+     * same seed always yields the same capture. With orders_per_second set,
+     * commands are stamped at that steady rate for RECORDED replay; otherwise
+     * every offset is 0. Returns false if the file could not be written.
+     */
+    static bool record(const std::string& path, uint64_t count, uint64_t seed,
+                       uint64_t orders_per_second = 0);
+    
+    /**
+     * Push every command of capture into ring, stamping producer_timestamp
+     * at enqueue as run() does. Returns the number of commands pushed.
+     */
+    static uint64_t replay(SPSCQueue<Command>* ring_buffer, const FeedCapture& capture,
+                           ReplayPacing pacing = ReplayPacing::MAX_RATE,
+                           const WaitConfig& wait = WaitConfig(WaitPolicy::YIELD),
+                           WaitSignals* signals = nullptr) noexcept;
 };
 
 } // namespace OrderBook
\ No newline at end of file
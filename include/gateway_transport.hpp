@@ -0,0 +1,120 @@
+#pragma once
+
+#include "types.hpp"
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace OrderBook {
+
+/**
+ * Session of a transport, a dense index reused once the session closes
+ */
+using ConnectionId = uint32_t;
+
+/**
+ * Receiver of a transport's session events, called on the polling thread
+ */
+class GatewaySessionHandler {
+public:
+    virtual ~GatewaySessionHandler() = default;
+
+    virtual void on_connect(ConnectionId connection) = 0;
+
+    /**
+     * Bytes received on connection. Returns how many were consumed; the rest
+     * - a partial message - is handed back with the next bytes appended.
+     */
+    virtual size_t on_data(ConnectionId connection, const char* data, size_t size) = 0;
+
+    /**
+     * The peer closed connection or it failed. Not called for close().
+     */
+    virtual void on_disconnect(ConnectionId connection) = 0;
+};
+
+/**
+ * Byte-stream transport under an OrderGateway.
+ *
+ * The gateway only sees sessions and buffers, so a kernel-bypass stack
+ * (a user-space TCP library over the NIC's own rings) drops in as another
+ * implementation: poll() its receive queues and hand their buffers to
+ * on_data() in place, as EpollTcpTransport does with its own.
+ */
+class GatewayTransport {
+public:
+    virtual ~GatewayTransport() = default;
+
+    /**
+     * Wait up to timeout_ms (0 = don't wait, -1 = forever) for activity and
+     * deliver everything received since the last poll to handler, one
+     * on_data() per readable session. Returns the number of sessions served.
+     */
+    virtual size_t poll(GatewaySessionHandler& handler, int timeout_ms) = 0;
+
+    /**
+     * Send a whole message. false if it could not be queued at once - a
+     * client not reading its acknowledgements is closed rather than buffered for.
+     */
+    virtual bool send(ConnectionId connection, const void* data, size_t size) = 0;
+
+    /**
+     * Close connection. From inside on_data() the close takes effect once
+     * it returns.
+     */
+    virtual void close(ConnectionId connection) = 0;
+};
+
+/**
+ * GatewayTransport over kernel TCP sockets and level-triggered epoll.
+ *
+ * One thread polls the listening socket and every session. Each readable
+ * session is read until the kernel has nothing more or its
+ * GATEWAY_RECV_BUFFER_SIZE buffer is full, then delivered in one on_data()
+ * call, so a burst of messages costs one callback rather than one per
+ * message. Sessions run with TCP_NODELAY; at most GATEWAY_MAX_SESSIONS are
+ * accepted at a time.
+ */
+class EpollTcpTransport : public GatewayTransport {
+private:
+    struct Connection {
+        int fd = -1;
+        size_t filled = 0;  // Bytes held over in buffer
+        bool closing = false;  // close() called from inside on_data()
+        std::unique_ptr<char[]> buffer;
+    };
+
+    int listen_fd_;
+    int epoll_fd_;
+    uint16_t port_;
+    std::vector<Connection> connections_;  // By ConnectionId
+    ConnectionId delivering_;              // Session inside on_data(), or NO_CONNECTION
+    std::string error_;
+
+    static constexpr ConnectionId NO_CONNECTION = ~ConnectionId{0};
+
+    void accept_all(GatewaySessionHandler& handler);
+    void receive(ConnectionId connection, GatewaySessionHandler& handler);
+    void release(ConnectionId connection) noexcept;
+
+public:
+    /**
+     * Listen on bind_address:port; port 0 picks a free one, see port().
+     * Check is_open().
+     */
+    explicit EpollTcpTransport(uint16_t port, const std::string& bind_address = "0.0.0.0");
+    ~EpollTcpTransport() override;
+
+    EpollTcpTransport(const EpollTcpTransport&) = delete;
+    EpollTcpTransport& operator=(const EpollTcpTransport&) = delete;
+
+    bool is_open() const noexcept { return epoll_fd_ >= 0; }
+    const std::string& error() const noexcept { return error_; }
+    uint16_t port() const noexcept { return port_; }
+
+    size_t poll(GatewaySessionHandler& handler, int timeout_ms) override;
+    bool send(ConnectionId connection, const void* data, size_t size) override;
+    void close(ConnectionId connection) override;
+};
+
+} // namespace OrderBook
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstdint>
+
+namespace OrderBook {
+
+/**
+ * What actually backs a HugePageRegion. Ordered weakest first.
+ */
+enum class PageBacking : uint8_t {
+    NONE,              // Nothing committed yet
+    TRANSPARENT_HUGE,  // Regular pages with MADV_HUGEPAGE - khugepaged may or may not promote them
+    HUGE_2MB,          // hugetlbfs 2 MB pages
+    HUGE_1GB           // hugetlbfs 1 GB pages
+};
+
+const char* to_string(PageBacking backing) noexcept;
+
+/**
+ * Contiguous virtual address range reserved up front and committed in
+ * huge-page-sized pieces.
+ *
+ * The whole range is reserved PROT_NONE at construction, so memory committed
+ * later lands directly after what is already there and pointers into the
+ * region stay valid. Each commit swaps part of the reservation for memory,
+ * trying explicit hugetlbfs pages first (MAP_HUGETLB; 1 GB pages when the
+ * reservation is at least that large, otherwise 2 MB) and falling back to
+ * regular pages with MADV_HUGEPAGE when none are reserved on the host. Committed memory is pre-faulted and
+ * zero-filled, so first touch never page-faults on the hot path.
+ */
+class HugePageRegion {
+private:
+    char* base_;
+    uint64_t reserved_;   // Bytes of address space, a multiple of page_size_
+    uint64_t committed_;  // Bytes backed by memory, a multiple of page_size_
+    uint64_t faulted_;    // Bytes pre-faulted
+    uint64_t page_size_;
+    PageBacking backing_;  // Weakest backing of any commit
+
+    bool map_at(uint64_t offset, uint64_t bytes, int flags) noexcept;
+
+public:
+    /**
+     * Reserve address space for max_bytes. data() is nullptr if even the
+     * reservation failed.
+     */
+    explicit HugePageRegion(uint64_t max_bytes) noexcept;
+    ~HugePageRegion();
+
+    HugePageRegion(const HugePageRegion&) = delete;
+    HugePageRegion& operator=(const HugePageRegion&) = delete;
+
+    /**
+     * Back and pre-fault the first bytes of the region. Returns false if
+     * that exceeds the reservation or the kernel refuses the memory.
+     */
+    bool commit(uint64_t bytes) noexcept;
+
+    char* data() const noexcept { return base_; }
+    uint64_t reserved_bytes() const noexcept { return reserved_; }
+    uint64_t committed_bytes() const noexcept { return committed_; }
+    uint64_t page_size() const noexcept { return page_size_; }
+    PageBacking backing() const noexcept { return backing_; }
+};
+
+} // namespace OrderBook
@@ -0,0 +1,113 @@
+#pragma once
+
+#include "types.hpp"
+#include "spsc_queue.hpp"
+#include <algorithm>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace OrderBook {
+
+/**
+ * Position of a command in the engine's single order of input
+ */
+struct IngressStamp {
+    uint64_t sequence;  // 1, 2, 3, ... in the order the engine consumed commands
+    uint32_t lane;      // Gateway lane the command arrived on
+};
+
+/**
+ * Many-producer ingress for one matching engine, built from SPSC lanes.
+ *
+ * Each gateway thread owns one lane - an SPSCQueue<Command> it fills with
+ * claim/commit exactly as a single feed fills the engine's ring - so
+ * producers never contend with each other and there is no mutex or CAS on
+ * the way in. The engine consumes through consume_bulk(), which visits the
+ * lanes round-robin taking at most `quantum` commands from each per pass
+ * (one tail publication per lane visit) until the burst is full or a whole
+ * pass finds nothing. The first lane visited rotates every call, so a busy
+ * gateway can delay the others by at most one quantum.
+ *
+ * The interleaving of lanes depends on arrival timing; the sequencer makes
+ * the one that was chosen explicit. Every command consumed gets the next
+ * IngressStamp sequence, and a handler taking (const Command&, const
+ * IngressStamp&) receives it - recording (sequence, command) and feeding
+ * that stream back in sequence order through a single lane reproduces the
+ * run exactly.
+ */
+class IngressFanIn {
+private:
+    std::vector<std::unique_ptr<SPSCQueue<Command>>> lanes_;
+    uint64_t quantum_;
+
+    // Consumer state
+    alignas(CACHE_LINE_SIZE) uint32_t next_lane_;
+    uint64_t next_sequence_;
+
+public:
+    /**
+     * lane_count gateway lanes of lane_capacity (a power of 2) commands each
+     */
+    explicit IngressFanIn(uint32_t lane_count, uint64_t lane_capacity = RING_BUFFER_SIZE,
+                          uint64_t quantum = INGRESS_LANE_QUANTUM);
+
+    IngressFanIn(const IngressFanIn&) = delete;
+    IngressFanIn& operator=(const IngressFanIn&) = delete;
+
+    /**
+     * Producer side of one gateway's lane. Each lane takes a single producer thread.
+     */
+    SPSCQueue<Command>& lane(uint32_t index) noexcept { return *lanes_[index]; }
+    const SPSCQueue<Command>& lane(uint32_t index) const noexcept { return *lanes_[index]; }
+    uint32_t lane_count() const noexcept { return static_cast<uint32_t>(lanes_.size()); }
+
+    /**
+     * Consumer: true if any lane has a command waiting
+     */
+    bool has_input() noexcept {
+        for (auto& lane : lanes_) {
+            if (lane->front()) return true;
+        }
+        return false;
+    }
+
+    /**
+     * Commands sequenced so far - the stamp of the most recent one
+     */
+    uint64_t last_sequence() const noexcept { return next_sequence_ - 1; }
+
+    /**
+     * Consumer: run handler on up to max commands in place, fairly across
+     * lanes, stamping each with the next sequence. Returns the number consumed.
+     */
+    template <typename Handler>
+    size_t consume_bulk(size_t max, Handler&& handler) noexcept {
+        const uint32_t lanes = lane_count();
+        const uint32_t first = next_lane_;
+        next_lane_ = (first + 1 == lanes) ? 0 : first + 1;
+
+        size_t consumed = 0;
+        bool progress = true;
+        while (consumed < max && progress) {
+            progress = false;
+            for (uint32_t i = 0; i < lanes && consumed < max; ++i) {
+                const uint32_t lane = (first + i < lanes) ? first + i : first + i - lanes;
+                const size_t taken = lanes_[lane]->consume_bulk(
+                    std::min<size_t>(quantum_, max - consumed), [&](const Command& cmd) {
+                        const IngressStamp stamp{next_sequence_++, lane};
+                        if constexpr (std::is_invocable_v<Handler&, const Command&, const IngressStamp&>) {
+                            handler(cmd, stamp);
+                        } else {
+                            handler(cmd);
+                        }
+                    });
+                consumed += taken;
+                progress |= (taken > 0);
+            }
+        }
+        return consumed;
+    }
+};
+
+} // namespace OrderBook
@@ -2,10 +2,14 @@
 
 #include "types.hpp"
 #include <string>
+#include <string_view>
 #include <cstdint>
+#include <vector>
 
 namespace OrderBook {
 
+constexpr uint32_t DEFAULT_INSTRUMENT_ID = 1;  // Target of commands that leave instrument_id unset
+
 /**
  * Instrument identifier and configuration
  */
@@ -24,10 +28,14 @@ struct Instrument {
         : instrument_id(id), symbol(sym), tick_size(tick), lot_size(lot),
           price_min(p_min), price_max(p_max), max_order_size(max_size) {}
     
+    /**
+     * In range and on the tick grid, which is counted from price_min - the
+     * same grid the instrument's PriceLadder uses
+     */
     bool is_valid_price(int64_t price) const noexcept {
         return price >= price_min && 
                price <= price_max && 
-               (price % tick_size) == 0;
+               ((price - price_min) % tick_size) == 0;
     }
     
     bool is_valid_quantity(uint64_t quantity) const noexcept {
@@ -37,4 +45,35 @@ struct Instrument {
     }
 };
 
+/**
+ * Interned instrument symbols.
+ * 
+ * Hot-path records (commands, output events, trades, snapshots) carry only
+ * instrument_id; symbols are resolved from this table when a publisher
+ * formats output. Ids are small and dense, so lookup is a vector index.
+ * 
+ * Populate before publishing starts - lookups from the publisher thread
+ * are not synchronised with add().
+ */
+class SymbolTable {
+private:
+    std::vector<std::string> symbols_;  // Indexed by instrument_id, empty = unregistered
+    
+public:
+    void add(uint32_t instrument_id, std::string_view symbol);
+    void add(const Instrument& instrument);
+    
+    /**
+     * Symbol for instrument_id, or an empty view if it isn't registered
+     */
+    std::string_view symbol(uint32_t instrument_id) const noexcept;
+    
+    /**
+     * Reverse lookup. Returns 0 (never a valid instrument id) if unknown.
+     */
+    uint32_t find(std::string_view symbol) const noexcept;
+    
+    size_t size() const noexcept;
+};
+
 } // namespace OrderBook
\ No newline at end of file
@@ -0,0 +1,192 @@
+#pragma once
+
+#include "types.hpp"
+#include "instrument.hpp"
+#include "book.hpp"
+#include "order_pool.hpp"
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace OrderBook {
+
+/**
+ * Dense directory of the instruments one engine trades.
+ *
+ * Each instrument owns one cache-line-aligned Entry - book inline, counters
+ * and limits beside it - in a flat slot array reserved up front, so entries
+ * never move and the matching thread reaches one with a bounds check, a
+ * load from the instrument_id -> slot map and an address computation.
+ *
+ * add() and remove() run on a single control thread while the matching
+ * thread keeps going. They never edit the map in place: each change copies
+ * it into a new immutable Snapshot with the next epoch and publishes it with
+ * one atomic store. The matching thread calls refresh() between bursts,
+ * which picks up the latest snapshot (a single load when nothing changed).
+ * The snapshot it holds is advertised through a hazard pointer, so the
+ * control side can reclaim every other superseded snapshot at once.
+ *
+ * A removed entry is first unpublished. Once the matching thread runs on a
+ * snapshot from that epoch or later nothing can reach it any more, and
+ * refresh() hands it to a drain callback - the engine returns its resting
+ * orders to the pool it owns - before the control side destroys it and
+ * reuses the slot.
+ */
+class InstrumentDirectory {
+public:
+    static constexpr uint32_t NO_SLOT = ~0u;
+
+    struct alignas(CACHE_LINE_SIZE) Entry {
+        Book book;          // Ladders sized from the instrument's range/tick
+        uint64_t trades;
+        uint64_t volume;
+        Instrument instrument;
+
+        Entry(const Instrument& inst, OrderPool& pool);
+    };
+
+private:
+    enum class SlotState : uint8_t {
+        FREE,       // No entry constructed
+        LIVE,       // Published
+        RETIRED,    // Unpublished at retire_epoch, may still be in use
+        DRAINED     // Orders released by the matching thread, ready to destroy
+    };
+
+    struct SlotControl {
+        std::atomic<SlotState> state{SlotState::FREE};
+        uint64_t retire_epoch = 0;  // Written before state becomes RETIRED
+    };
+
+    /**
+     * Immutable instrument_id -> slot map, replaced as a whole
+     */
+    struct Snapshot {
+        uint64_t epoch;
+        std::vector<uint32_t> slot_of;  // Indexed by instrument_id, NO_SLOT = not traded here
+    };
+
+    struct alignas(Entry) EntryStorage {
+        unsigned char bytes[sizeof(Entry)];
+    };
+
+    OrderPool& pool_;
+    uint32_t capacity_;
+    std::unique_ptr<EntryStorage[]> storage_;  // Untouched until a slot is first used
+    std::unique_ptr<SlotControl[]> control_;
+    Entry* entries_;
+
+    // Control thread
+    std::vector<uint32_t> free_slots_;                // Lowest slot on top
+    std::vector<std::unique_ptr<Snapshot>> snapshots_;  // Not yet reclaimed, newest last
+    uint32_t live_count_;
+    uint32_t retired_count_;                          // Retired, not yet destroyed
+
+    // Shared, written rarely
+    alignas(CACHE_LINE_SIZE) std::atomic<const Snapshot*> published_;
+    std::atomic<const Snapshot*> hazard_;   // Snapshot the matching thread may be reading
+    std::atomic<uint32_t> retired_pending_; // RETIRED slots not yet drained
+
+    // Matching thread
+    alignas(CACHE_LINE_SIZE) const Snapshot* current_;
+    const uint32_t* current_slots_;
+    uint32_t current_limit_;
+
+    void publish(std::unique_ptr<Snapshot> next);
+    void adopt(const Snapshot* snapshot) noexcept;
+    const Snapshot* latest() const noexcept { return published_.load(std::memory_order_relaxed); }
+    uint32_t slot_in(const Snapshot& snapshot, uint32_t instrument_id) const noexcept;
+
+public:
+    /**
+     * Directory of up to capacity instruments whose books allocate from pool
+     */
+    explicit InstrumentDirectory(OrderPool& pool, uint32_t capacity = MAX_INSTRUMENTS);
+    ~InstrumentDirectory();
+
+    InstrumentDirectory(const InstrumentDirectory&) = delete;
+    InstrumentDirectory& operator=(const InstrumentDirectory&) = delete;
+
+    // ---- Control thread ----
+
+    /**
+     * Construct and publish an entry. false if the id is already traded
+     * or every slot is in use.
+     */
+    bool add(const Instrument& instrument);
+
+    /**
+     * Unpublish an instrument. Its resting orders are released by the
+     * matching thread's next refresh(); the slot is reused after that.
+     */
+    bool remove(uint32_t instrument_id);
+
+    /**
+     * Destroy drained entries and free superseded snapshots. add() and
+     * remove() collect first, so this is only needed to reclaim eagerly.
+     */
+    void collect();
+
+    /**
+     * Entry as of the latest published snapshot. Its counters are only
+     * stable once the matching thread has stopped.
+     */
+    const Entry* lookup(uint32_t instrument_id) const noexcept;
+
+    /**
+     * Slot of an instrument as of the latest published snapshot, or NO_SLOT
+     */
+    uint32_t slot_of(uint32_t instrument_id) const noexcept { return slot_in(*latest(), instrument_id); }
+
+    uint32_t size() const noexcept { return live_count_; }
+    uint32_t capacity() const noexcept { return capacity_; }
+    uint64_t epoch() const noexcept { return latest()->epoch; }
+
+    // ---- Matching thread ----
+
+    /**
+     * Switch to the latest snapshot and pass every entry retired at or
+     * before it to drain(Entry&). Call between bursts.
+     */
+    template <typename Drain>
+    void refresh(Drain&& drain) noexcept {
+        const Snapshot* next = published_.load(std::memory_order_acquire);
+        if (next != current_) adopt(next);
+
+        if (retired_pending_.load(std::memory_order_relaxed) == 0) return;
+
+        const uint64_t epoch = current_->epoch;
+        for (uint32_t slot = 0; slot < capacity_; ++slot) {
+            SlotControl& control = control_[slot];
+            if (control.state.load(std::memory_order_acquire) != SlotState::RETIRED ||
+                control.retire_epoch > epoch) {
+                continue;
+            }
+            drain(entries_[slot]);
+            control.state.store(SlotState::DRAINED, std::memory_order_release);
+            retired_pending_.fetch_sub(1, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * Entry for instrument_id in the snapshot the matching thread holds,
+     * or nullptr if it isn't traded here
+     */
+    Entry* find(uint32_t instrument_id) noexcept {
+        if (instrument_id >= current_limit_) return nullptr;
+        const uint32_t slot = current_slots_[instrument_id];
+        return (slot != NO_SLOT) ? entries_ + slot : nullptr;
+    }
+
+    /**
+     * Slot entry lives in, for per-slot side tables
+     */
+    uint32_t slot_of(const Entry& entry) const noexcept { return static_cast<uint32_t>(&entry - entries_); }
+
+    /**
+     * Epoch of the snapshot the matching thread holds
+     */
+    uint64_t current_epoch() const noexcept { return current_->epoch; }
+};
+
+} // namespace OrderBook
@@ -0,0 +1,94 @@
+#pragma once
+
+#include "types.hpp"
+#include <array>
+#include <bit>
+
+namespace OrderBook {
+
+/**
+ * Fixed-memory log-linear latency histogram, HDR style.
+ *
+ * Values below 2^LATENCY_HISTOGRAM_SUB_BUCKET_BITS are counted exactly;
+ * above that every power of two is split into 2^(SUB_BUCKET_BITS - 1)
+ * equal steps, so a percentile is within 1 / 64 of the true value at any
+ * magnitude. Recording is a bit_width, a shift and an increment - no
+ * allocation and no sort, however many samples a run takes. Samples from
+ * 2^LATENCY_HISTOGRAM_MAX_VALUE_BITS up are clamped into the top bucket and
+ * counted in clamped_count().
+ *
+ * One writer at a time; read and merge once the writer has stopped.
+ */
+class LatencyHistogram {
+public:
+    static constexpr uint32_t SUB_BUCKET_BITS = LATENCY_HISTOGRAM_SUB_BUCKET_BITS;
+    static constexpr uint32_t MAX_VALUE_BITS = LATENCY_HISTOGRAM_MAX_VALUE_BITS;
+    static constexpr uint64_t MAX_VALUE = (1ull << MAX_VALUE_BITS) - 1;
+    static constexpr size_t BUCKET_COUNT = size_t{MAX_VALUE_BITS - SUB_BUCKET_BITS + 2} << (SUB_BUCKET_BITS - 1);
+
+    static_assert(SUB_BUCKET_BITS >= 2 && SUB_BUCKET_BITS < MAX_VALUE_BITS && MAX_VALUE_BITS < 64,
+                  "Histogram needs at least one log bucket above the linear range");
+
+private:
+    std::array<uint64_t, BUCKET_COUNT> counts_;
+    uint64_t count_;
+    uint64_t clamped_;
+    uint64_t min_;
+    uint64_t max_;
+    uint64_t sum_;
+
+public:
+    LatencyHistogram() noexcept;
+
+    /**
+     * Bucket holding value; values above MAX_VALUE must be clamped first
+     */
+    static size_t bucket_of(uint64_t value) noexcept {
+        const uint32_t width = static_cast<uint32_t>(std::bit_width(value));
+        const uint32_t shift = width > SUB_BUCKET_BITS ? width - SUB_BUCKET_BITS : 0;
+        return (size_t{shift} << (SUB_BUCKET_BITS - 1)) + static_cast<size_t>(value >> shift);
+    }
+
+    /**
+     * Smallest / largest value counted in bucket
+     */
+    static uint64_t lowest_in_bucket(size_t bucket) noexcept;
+    static uint64_t highest_in_bucket(size_t bucket) noexcept;
+
+    void record(uint64_t value) noexcept {
+        if (value > MAX_VALUE) {
+            value = MAX_VALUE;
+            ++clamped_;
+        }
+        ++counts_[bucket_of(value)];
+        ++count_;
+        sum_ += value;
+        if (value < min_) min_ = value;
+        if (value > max_) max_ = value;
+    }
+
+    /**
+     * Add every sample of other, e.g. to combine per-shard histograms
+     */
+    void merge(const LatencyHistogram& other) noexcept;
+
+    void reset() noexcept;
+
+    /**
+     * Value at or below which percentile% of samples fall, reported as the
+     * top of its bucket (never above max()). 0 when empty.
+     */
+    uint64_t percentile(double percentile) const noexcept;
+
+    uint64_t count() const noexcept { return count_; }
+    uint64_t clamped_count() const noexcept { return clamped_; }
+    uint64_t min() const noexcept { return count_ ? min_ : 0; }
+    uint64_t max() const noexcept { return max_; }
+    uint64_t sum() const noexcept { return sum_; }
+    double mean() const noexcept;
+    bool empty() const noexcept { return count_ == 0; }
+
+    uint64_t count_in_bucket(size_t bucket) const noexcept { return counts_[bucket]; }
+};
+
+} // namespace OrderBook
@@ -1,9 +1,19 @@
 #pragma once
 
 #include "types.hpp"
-#include <vector>
+#include "instrument.hpp"
+#include "market_data_journal.hpp"
+#include <algorithm>
+#include <array>
 #include <chrono>
+#include <iterator>
+#include <ostream>
+#include <type_traits>
+#include <vector>
+#include <fstream>
+#include <memory>
 #include <string>
+#include <unordered_map>
 
 namespace OrderBook {
 
@@ -15,28 +25,67 @@ struct PriceLevelData {
     uint64_t quantity;
     uint32_t order_count;
     
+    PriceLevelData() noexcept : price(0), quantity(0), order_count(0) {}
     PriceLevelData(int64_t p, uint64_t q, uint32_t count) 
         : price(p), quantity(q), order_count(count) {}
 };
 
+/**
+ * Fixed-capacity inline depth for one side of a snapshot. No heap storage,
+ * so a Level2Snapshot is a flat record that copies with a memcpy.
+ */
+class DepthLevels {
+private:
+    std::array<PriceLevelData, MARKET_DEPTH_LEVELS> levels_;
+    uint32_t count_ = 0;
+    
+public:
+    using const_iterator = const PriceLevelData*;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+    
+    static constexpr size_t capacity() noexcept { return MARKET_DEPTH_LEVELS; }
+    size_t size() const noexcept { return count_; }
+    bool empty() const noexcept { return count_ == 0; }
+    void clear() noexcept { count_ = 0; }
+    
+    /**
+     * Append a level. Returns false (and drops it) once capacity is reached.
+     */
+    bool emplace_back(int64_t price, uint64_t quantity, uint32_t order_count) noexcept {
+        if (count_ == MARKET_DEPTH_LEVELS) return false;
+        levels_[count_++] = PriceLevelData(price, quantity, order_count);
+        return true;
+    }
+    
+    /**
+     * Replace contents with [first, last), truncated to capacity
+     */
+    void assign(const PriceLevelData* first, const PriceLevelData* last) noexcept {
+        count_ = static_cast<uint32_t>(std::min<size_t>(last - first, MARKET_DEPTH_LEVELS));
+        std::copy(first, first + count_, levels_.begin());
+    }
+    
+    const PriceLevelData& operator[](size_t index) const noexcept { return levels_[index]; }
+    const_iterator begin() const noexcept { return levels_.data(); }
+    const_iterator end() const noexcept { return levels_.data() + count_; }
+    const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+    const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+};
+
 struct Level2Snapshot {
     uint32_t instrument_id;
-    std::string symbol;
     std::chrono::high_resolution_clock::time_point timestamp;
-    std::vector<PriceLevelData> bids;  // Sorted highest to lowest
-    std::vector<PriceLevelData> asks;  // Sorted lowest to highest
-    
-    Level2Snapshot(uint32_t id, const std::string& sym) 
-        : instrument_id(id), symbol(sym), 
-          timestamp(std::chrono::high_resolution_clock::now()) {
-        bids.reserve(20);  // Top 20 levels
-        asks.reserve(20);
-    }
+    DepthLevels bids;  // Sorted highest to lowest
+    DepthLevels asks;  // Sorted lowest to highest
+    
+    explicit Level2Snapshot(uint32_t id) 
+        : instrument_id(id), timestamp(std::chrono::high_resolution_clock::now()) {}
 };
 
+static_assert(std::is_trivially_copyable_v<Level2Snapshot>, "Snapshots must stay allocation-free");
+
 struct Trade {
     uint32_t instrument_id;
-    std::string symbol;
     std::chrono::high_resolution_clock::time_point timestamp;
     uint64_t aggressor_order_id;
     uint64_t resting_order_id;
@@ -44,26 +93,53 @@ struct Trade {
     int64_t price;
     uint64_t quantity;
     
-    Trade(uint32_t id, const std::string& sym, uint64_t aggr_id, uint64_t rest_id,
+    Trade(uint32_t id, uint64_t aggr_id, uint64_t rest_id,
           Side side, int64_t p, uint64_t q)
-        : instrument_id(id), symbol(sym), 
+        : instrument_id(id), 
           timestamp(std::chrono::high_resolution_clock::now()),
           aggressor_order_id(aggr_id), resting_order_id(rest_id),
           aggressor_side(side), price(p), quantity(q) {}
 };
 
 /**
- * Market data publisher interface
+ * Instrument as printed by text publishers: its symbol, or "#<id>" when the
+ * id isn't registered. Streams without building a string.
+ */
+struct SymbolRef {
+    std::string_view symbol;
+    uint32_t instrument_id;
+};
+
+std::ostream& operator<<(std::ostream& os, const SymbolRef& ref);
+
+/**
+ * Market data publisher interface.
+ * Records carry instrument ids only; publishers that format text resolve
+ * symbols through the SymbolTable supplied by their MarketDataManager.
  */
 class MarketDataPublisher {
+protected:
+    const SymbolTable* symbols_ = nullptr;
+    
+    SymbolRef symbol_for(uint32_t instrument_id) const noexcept {
+        return {symbols_ ? symbols_->symbol(instrument_id) : std::string_view(), instrument_id};
+    }
+    
 public:
     virtual ~MarketDataPublisher() = default;
     
+    void set_symbol_table(const SymbolTable* symbols) noexcept { symbols_ = symbols; }
+    
     virtual void publish_trade(const Trade& trade) = 0;
     virtual void publish_level2_snapshot(const Level2Snapshot& snapshot) = 0;
-    virtual void publish_level2_update(uint32_t instrument_id, const std::string& symbol,
-                                     Side side, int64_t price, uint64_t new_quantity,
-                                     uint32_t new_order_count) = 0;
+    virtual void publish_level2_update(uint32_t instrument_id, Side side, int64_t price, 
+                                       uint64_t new_quantity, uint32_t new_order_count) = 0;
+    
+    /**
+     * Push buffered output downstream. Called once per output batch, so
+     * publishers should buffer per record and only write here.
+     */
+    virtual void flush() {}
 };
 
 /**
@@ -78,28 +154,46 @@ public:
     
     void publish_trade(const Trade& trade) override;
     void publish_level2_snapshot(const Level2Snapshot& snapshot) override;
-    void publish_level2_update(uint32_t instrument_id, const std::string& symbol,
-                              Side side, int64_t price, uint64_t new_quantity,
-                              uint32_t new_order_count) override;
+    void publish_level2_update(uint32_t instrument_id, Side side, int64_t price, 
+                               uint64_t new_quantity, uint32_t new_order_count) override;
+    void flush() override;
 };
 
 /**
- * File-based market data publisher for recording
+ * File-based market data publisher for recording.
+ * 
+ * Binary mode appends fixed-length JournalRecords to a pre-allocated,
+ * memory-mapped MarketDataJournal (<filename>.NNNNNN.mdj, rolled by size) -
+ * a copy into mapped memory per event. CSV mode keeps its files open and
+ * buffered, writing them out on flush().
  */
 class FileMarketDataPublisher : public MarketDataPublisher {
 private:
     std::string base_filename_;
     bool binary_format_;
     
+    std::unique_ptr<MarketDataJournal> journal_;
+    
+    std::ofstream trades_csv_;
+    std::ofstream updates_csv_;
+    std::unordered_map<uint32_t, std::ofstream> snapshot_csv_;  // Per instrument
+    
+    std::ofstream& csv_stream(std::ofstream& stream, const std::string& suffix);
+    
 public:
-    explicit FileMarketDataPublisher(const std::string& filename, bool binary = false)
-        : base_filename_(filename), binary_format_(binary) {}
+    explicit FileMarketDataPublisher(const std::string& filename, bool binary = false,
+                                     uint64_t segment_bytes = JOURNAL_SEGMENT_SIZE);
     
     void publish_trade(const Trade& trade) override;
     void publish_level2_snapshot(const Level2Snapshot& snapshot) override;
-    void publish_level2_update(uint32_t instrument_id, const std::string& symbol,
-                              Side side, int64_t price, uint64_t new_quantity,
-                              uint32_t new_order_count) override;
+    void publish_level2_update(uint32_t instrument_id, Side side, int64_t price, 
+                               uint64_t new_quantity, uint32_t new_order_count) override;
+    void flush() override;
+    
+    /**
+     * Binary mode journal, nullptr in CSV mode
+     */
+    const MarketDataJournal* journal() const noexcept;
 };
 
 /**
@@ -107,11 +201,66 @@ public:
  */
 class MarketDataManager {
 private:
+    struct LevelKey {
+        uint32_t instrument_id;
+        Side side;
+        int64_t price;
+        
+        bool operator==(const LevelKey& other) const noexcept {
+            return instrument_id == other.instrument_id && side == other.side && price == other.price;
+        }
+    };
+    
+    struct LevelKeyHash {
+        size_t operator()(const LevelKey& key) const noexcept {
+            return std::hash<int64_t>()(key.price) ^
+                   (static_cast<size_t>(key.instrument_id) << 1 | static_cast<size_t>(key.side)) * 0x9E3779B97F4A7C15ull;
+        }
+    };
+    
+    struct PendingUpdate {
+        uint32_t instrument_id;
+        Side side;
+        int64_t price;
+        uint64_t quantity;
+        uint32_t order_count;
+    };
+    
     std::vector<std::unique_ptr<MarketDataPublisher>> publishers_;
+    const SymbolTable* symbols_;
     bool enabled_;
     
+    // L2 conflation: latest state per level, emitted in first-change order
+    bool conflate_;
+    std::chrono::nanoseconds conflation_interval_;
+    std::chrono::steady_clock::time_point last_conflated_publish_;
+    std::vector<PendingUpdate> pending_updates_;
+    std::unordered_map<LevelKey, size_t, LevelKeyHash> pending_index_;
+    uint64_t updates_received_;
+    uint64_t updates_published_;
+    
+    void dispatch_level2_update(uint32_t instrument_id, Side side, int64_t price, 
+                                uint64_t new_quantity, uint32_t new_order_count);
+    void publish_pending_updates();
+    
 public:
-    MarketDataManager() : enabled_(true) {}
+    /**
+     * symbols resolves instrument ids for every publisher added; it must
+     * outlive the manager and is only read from the publishing thread
+     */
+    explicit MarketDataManager(const SymbolTable* symbols = nullptr)
+        : symbols_(symbols), enabled_(true), conflate_(false), conflation_interval_(0),
+          updates_received_(0), updates_published_(0) {}
+    
+    void set_symbol_table(const SymbolTable* symbols);
+    
+    /**
+     * Conflate L2 updates: repeated changes to the same level collapse into
+     * its latest state until the next flush(). A zero interval publishes
+     * the conflated deltas on every flush (once per output batch); otherwise
+     * at most once per interval.
+     */
+    void set_conflation(bool enabled, std::chrono::nanoseconds interval = std::chrono::nanoseconds(0));
     
     void add_publisher(std::unique_ptr<MarketDataPublisher> publisher);
     void remove_all_publishers();
@@ -123,9 +272,21 @@ public:
     // Publishing methods
     void publish_trade(const Trade& trade);
     void publish_level2_snapshot(const Level2Snapshot& snapshot);
-    void publish_level2_update(uint32_t instrument_id, const std::string& symbol,
-                              Side side, int64_t price, uint64_t new_quantity,
-                              uint32_t new_order_count);
+    void publish_level2_update(uint32_t instrument_id, Side side, int64_t price, 
+                               uint64_t new_quantity, uint32_t new_order_count);
+    
+    /**
+     * Publish conflated updates that are due, then flush the publishers
+     */
+    void flush();
+    
+    /**
+     * Publish every pending conflated update regardless of interval, then flush
+     */
+    void flush_all();
+    
+    uint64_t level2_updates_received() const { return updates_received_; }
+    uint64_t level2_updates_published() const { return updates_published_; }
 };
 
 } // namespace OrderBook
\ No newline at end of file
@@ -0,0 +1,142 @@
+#pragma once
+
+#include "types.hpp"
+#include <string>
+
+namespace OrderBook {
+
+class MarketDataManager;
+
+enum class JournalRecordType : uint8_t {
+    NONE,            // Unwritten (pre-allocated, zero-filled) space
+    TRADE,
+    LEVEL2_UPDATE,
+    SNAPSHOT_BEGIN,  // quantity = bid level count, order_count = ask level count
+    SNAPSHOT_LEVEL,  // One per level, bids first then asks
+    SNAPSHOT_END
+};
+
+/**
+ * Fixed-length binary market data record.
+ * Every event type shares one layout so the journal is a flat array of records.
+ */
+struct JournalRecord {
+    uint64_t timestamp_ns;        // Wall clock, ns since epoch
+    uint64_t aggressor_order_id;  // TRADE only
+    uint64_t resting_order_id;    // TRADE only
+    int64_t price;
+    uint64_t quantity;
+    uint32_t instrument_id;
+    uint32_t order_count;
+    JournalRecordType type;
+    Side side;
+    uint8_t reserved[6];
+
+    JournalRecord() noexcept;
+};
+
+static_assert(sizeof(JournalRecord) == 56, "JournalRecord is an on-disk format");
+
+/**
+ * Header at offset 0 of every journal segment
+ */
+struct JournalSegmentHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t record_size;
+    uint64_t segment_index;
+    uint64_t record_count;        // Filled in when the segment is closed cleanly
+    uint8_t reserved[32];
+};
+
+static_assert(sizeof(JournalSegmentHeader) == 64, "JournalSegmentHeader is an on-disk format");
+
+/**
+ * Append-only memory-mapped market data journal.
+ *
+ * Each segment file is pre-allocated to segment_bytes and mapped once, so
+ * appending a record is a bounds check and a 56-byte copy - no syscalls. When a
+ * segment fills up the journal rolls over to the next one
+ * (<base>.000001.mdj, ...). Closing trims the last segment to its used length.
+ * If the process dies, the zero-filled tail marks the end of valid records.
+ */
+class MarketDataJournal {
+private:
+    std::string base_path_;
+    uint64_t segment_bytes_;
+    uint64_t segment_index_;
+    int fd_;
+    char* map_;
+    uint64_t write_offset_;
+    uint64_t segment_records_;
+    uint64_t records_written_;
+
+    bool open_segment(uint64_t index) noexcept;
+    void close_segment() noexcept;
+
+public:
+    explicit MarketDataJournal(const std::string& base_path,
+                               uint64_t segment_bytes = JOURNAL_SEGMENT_SIZE);
+    ~MarketDataJournal();
+
+    MarketDataJournal(const MarketDataJournal&) = delete;
+    MarketDataJournal& operator=(const MarketDataJournal&) = delete;
+
+    bool is_open() const noexcept;
+
+    /**
+     * Copy one record into the mapped segment, rolling over when full.
+     * Records are dropped if the journal could not be opened.
+     */
+    void append(const JournalRecord& record) noexcept;
+
+    /**
+     * Schedule write-back of the mapped pages without blocking on I/O
+     */
+    void sync() noexcept;
+
+    void close() noexcept;
+
+    uint64_t records_written() const noexcept;
+    uint64_t segment_count() const noexcept;
+
+    static std::string segment_path(const std::string& base_path, uint64_t index);
+};
+
+/**
+ * Sequential reader over all segments of a journal, in write order
+ */
+class MarketDataJournalReader {
+private:
+    std::string base_path_;
+    uint64_t segment_index_;
+    int fd_;
+    const char* map_;
+    uint64_t map_size_;
+    uint64_t read_offset_;
+
+    bool open_segment(uint64_t index) noexcept;
+    void close_segment() noexcept;
+
+public:
+    explicit MarketDataJournalReader(const std::string& base_path);
+    ~MarketDataJournalReader();
+
+    MarketDataJournalReader(const MarketDataJournalReader&) = delete;
+    MarketDataJournalReader& operator=(const MarketDataJournalReader&) = delete;
+
+    /**
+     * Read the next record. Returns false at the end of the journal.
+     */
+    bool next(JournalRecord& record) noexcept;
+
+    /**
+     * Feed every remaining record to manager's publishers, reassembling
+     * snapshots. Stops at a snapshot missing its end record - a journal cut
+     * off mid-snapshot - without publishing it. Returns the number of
+     * records replayed.
+     */
+    uint64_t replay(MarketDataManager& manager);
+};
+
+} // namespace OrderBook
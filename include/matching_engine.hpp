@@ -2,61 +2,171 @@
 
 #include "types.hpp"
 #include "book.hpp"
+#include "depth_cache.hpp"
 #include "order_pool.hpp"
+#include "order_id_index.hpp"
 #include "spsc_ring_buffer.hpp"
-#include <vector>
-#include <chrono>
+#include "ingress_fan_in.hpp"
+#include "output_stage.hpp"
+#include "command_journal.hpp"
+#include "tsc_clock.hpp"
+#include "latency_histogram.hpp"
+#include "engine_metrics.hpp"
+#include "wait_strategy.hpp"
+#include <string>
 
 namespace OrderBook {
 
+/**
+ * Outcome of MatchingEngine::recover()
+ */
+struct RecoveryResult {
+    bool ok = false;                 // Snapshot (if any) loaded and journal replayed without a gap
+    bool snapshot_loaded = false;
+    uint64_t snapshot_sequence = 0;  // Commands already applied in the snapshot
+    uint64_t commands_replayed = 0;  // Journal records applied on top of it
+    uint64_t last_sequence = 0;      // Commands applied in total - orders_processed() afterwards
+};
+
 /**
  * Single-threaded matching engine that owns all order book data structures.
- * Processes commands from the lock-free ring buffer sequentially.
+ * Processes commands from the lock-free ring buffer sequentially - either
+ * one feed's SPSCRingBuffer or an IngressFanIn merging several gateways.
  * 
  * Key design principle: Single writer eliminates need for locks on the order book,
  * maximizing performance on the critical path.
  */
 class MatchingEngine {
 private:
+    OrderPool order_pool_; // Declared first - the book resolves its order links through it
     Book book_;
-    OrderPool order_pool_;
+    DepthCache depth_;     // Top-N depth, maintained only while an output stage is attached
     SPSCRingBuffer* ring_buffer_;
+    IngressFanIn* ingress_;  // Set instead of ring_buffer_ for multi-gateway input
+    OutputStage* output_;  // nullptr = silent, no execution reports
+    WaitConfig wait_config_;      // What run() does on an empty ring
+    WaitSignals* wait_signals_;   // Doorbells shared with the producers, nullptr = none
+    JournalStage* journal_;       // Write-ahead input journal, nullptr = none
+    
+    // Periodic snapshots taken by run() between bursts
+    std::string snapshot_path_;
+    uint64_t snapshot_interval_;  // Commands between snapshots, 0 = never
+    uint64_t next_snapshot_at_;
+    uint64_t snapshots_written_;
+    bool replaying_;              // Re-applying journaled input - no latency samples
     
-    // Order tracking for cancellations - maps order_id to Order*
-    std::vector<Order*> order_map_;
+    // Resting orders by client order_id, for cancellation
+    OrderIdIndex order_index_;
     
     // Statistics
-    std::vector<long long> trade_latencies_ns_;
+    LatencyHistogram queue_latency_;  // Producer enqueue -> engine dequeue, ns per command
+    LatencyHistogram trade_latency_;  // Engine dequeue -> fill, ns per trade
     uint64_t orders_processed_;
     uint64_t trades_executed_;
     uint64_t orders_rejected_;
     uint64_t total_buy_quantity_matched_;
     uint64_t total_sell_quantity_matched_;
+    SpanSampler new_order_span_;  // handle_new_order, one call in METRICS_SPAN_SAMPLE_PERIOD
+    SpanSampler match_span_;      // match_order, likewise
+    MetricsMailbox<EngineMetrics> metrics_;  // Served once per burst
     
-    void handle_new_order(const Command& cmd, const std::chrono::high_resolution_clock::time_point& processing_start) noexcept;
+    void apply(const Command& cmd, uint64_t processing_start) noexcept;
+    void handle_new_order(const Command& cmd, uint64_t processing_start) noexcept;
     void handle_cancel_order(uint64_t order_id) noexcept;
-    void match_order(Order* aggressor, const std::chrono::high_resolution_clock::time_point& processing_start) noexcept;
-    void match_against_asks(Order* buy_order, const std::chrono::high_resolution_clock::time_point& processing_start) noexcept;
-    void match_against_bids(Order* sell_order, const std::chrono::high_resolution_clock::time_point& processing_start) noexcept;
-    void execute_trade(uint64_t aggressor_id, uint64_t resting_id, int64_t price, 
-                      uint64_t quantity, const std::chrono::high_resolution_clock::time_point& processing_start) noexcept;
+    void match_order(Order* aggressor, uint64_t processing_start) noexcept;
+    void match_against_asks(Order* buy_order, uint64_t processing_start) noexcept;
+    void match_against_bids(Order* sell_order, uint64_t processing_start) noexcept;
+    void execute_trade(uint64_t aggressor_id, uint64_t resting_id, Side aggressor_side, int64_t price, 
+                      uint64_t quantity, uint64_t processing_start) noexcept;
+    void publish_level(Side side, int64_t price) noexcept;
+    bool has_input() noexcept;
+    void fill_metrics(EngineMetrics& metrics) const noexcept;
+    
+    MatchingEngine(SPSCRingBuffer* ring_buffer, IngressFanIn* ingress);
     
 public:
     explicit MatchingEngine(SPSCRingBuffer* ring_buffer);
     
+    /**
+     * Engine fed by several gateway threads, one per ingress lane
+     */
+    explicit MatchingEngine(IngressFanIn* ingress);
+    
+    /**
+     * Attach the stage that receives trades and L2 updates. Without one the
+     * engine runs silent. Must be set before run().
+     */
+    void set_output_stage(OutputStage* output) noexcept;
+    
+    /**
+     * How run() waits for input: busy-spin by default. SPIN_PARK needs the
+     * same signals passed to the producers so they can wake the engine.
+     * Must be set before run().
+     */
+    void set_wait_strategy(const WaitConfig& config, WaitSignals* signals = nullptr) noexcept;
+    
+    /**
+     * Journal every consumed command to journal before applying it, stamped
+     * with its sequence (orders_processed() once applied). Must be set before run().
+     */
+    void set_journal(JournalStage* journal) noexcept;
+    
+    /**
+     * Have run() write a snapshot to path every interval_commands commands,
+     * at the first burst boundary past each multiple. The snapshot is taken
+     * on the matching thread, which stalls for the copy (tens of ms for a
+     * 1M-order book). 0 disables. Must be set before run().
+     */
+    void set_snapshot_policy(const std::string& path, uint64_t interval_commands) noexcept;
+    
+    /**
+     * Write a consistent snapshot of the book, order index, pool and
+     * statistics to path (via a temporary file and rename). Call from the
+     * matching thread or while the engine is not running.
+     */
+    bool save_snapshot(const std::string& path) const noexcept;
+    
+    /**
+     * Rebuild state after a crash: load the snapshot at snapshot_path (if
+     * the file exists) and re-apply every journaled command after it, at
+     * full speed and with no output - trades, L2 updates and journaling are
+     * suppressed. Replay stops at the end of the journal or at the first gap
+     * in its sequence. Only valid on a freshly constructed engine, before
+     * run(); on failure the engine must be discarded.
+     */
+    RecoveryResult recover(const std::string& snapshot_path, const std::string& journal_base) noexcept;
+    
     /**
      * Main processing loop - runs on consumer thread
-     * Continuously dequeues commands and processes them
+     * Continuously drains bursts of commands and processes them, waiting
+     * per the configured WaitStrategy whenever the input is empty, until
+     * orders_processed() reaches command_count
+     */
+    void run(uint64_t command_count = TOTAL_ORDERS_TO_GENERATE) noexcept;
+    
+    /**
+     * Drain and process up to ENGINE_BURST_SIZE commands with a single
+     * consumer index publication. Returns the number of commands processed.
      */
-    void run() noexcept;
+    size_t process_burst() noexcept;
     
     // Getters for statistics
     uint64_t orders_processed() const noexcept;
     uint64_t trades_executed() const noexcept;
     uint64_t orders_rejected() const noexcept;
-    const std::vector<long long>& trade_latencies() const noexcept;
+    uint64_t snapshots_written() const noexcept;
+    const OrderPool& order_pool() const noexcept;  // Capacity and exhaustion telemetry
+    const OrderIdIndex& order_index() const noexcept;
+    const LatencyHistogram& queue_latency() const noexcept;
+    const LatencyHistogram& trade_latency() const noexcept;
     uint64_t total_buy_quantity_matched() const noexcept;
     uint64_t total_sell_quantity_matched() const noexcept;
+    
+    /**
+     * Counters, pool utilisation and histograms for a scraper thread
+     * (MetricsExporter), answered at the end of the next burst
+     */
+    MetricsMailbox<EngineMetrics>& metrics() noexcept;
 };
 
 } // namespace OrderBook
\ No newline at end of file
@@ -0,0 +1,105 @@
+#pragma once
+
+#include "types.hpp"
+#include "engine_metrics.hpp"
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace OrderBook {
+
+/**
+ * Background scraper that exports engine and pipeline metrics as Prometheus
+ * text exposition format.
+ *
+ * Every interval the scraper thread posts a request to each engine's
+ * MetricsMailbox, gives the engines up to answer_timeout to copy their
+ * counters, pool utilisation and histograms at a burst boundary, reads
+ * every registered gauge (ring occupancy, stage counters) and renders one
+ * text page. Histograms are exported as summaries (quantiles, _sum,
+ * _count). An engine that doesn't answer in time - parked on an empty
+ * ring, say - is reported from its last answer.
+ *
+ * The page is written to path through a temporary file and a rename, so a
+ * node_exporter textfile collector (or anything polling a file in
+ * /dev/shm) never sees it half written. Nothing runs on the matching
+ * threads but the per-burst mailbox check and the copy when asked.
+ *
+ * Register engines and gauges before start().
+ */
+class MetricsExporter {
+private:
+    struct EngineEntry {
+        std::string label;
+        MetricsMailbox<EngineMetrics>* mailbox;
+        EngineMetrics last;  // As of the last answer
+        bool answered = false;  // In the latest scrape
+        uint64_t ticket = 0;
+    };
+
+    struct Gauge {
+        std::string name;
+        std::string labels;  // Prometheus label list without braces, may be empty
+        std::string help;
+        std::function<double()> read;
+    };
+
+    std::string path_;
+    std::chrono::milliseconds interval_;
+    std::chrono::microseconds answer_timeout_;
+    std::vector<EngineEntry> engines_;
+    std::vector<Gauge> gauges_;
+
+    std::thread scraper_thread_;
+    std::atomic<bool> running_;
+    std::atomic<uint64_t> scrapes_;
+    std::atomic<uint64_t> stale_answers_;  // Engines reported from an earlier answer
+
+    void run();
+    bool write_file(const std::string& page) const;
+
+public:
+    /**
+     * Export to path every interval (empty path = render only, see scrape())
+     */
+    explicit MetricsExporter(std::string path, std::chrono::milliseconds interval = std::chrono::seconds(1),
+                             std::chrono::microseconds answer_timeout = std::chrono::milliseconds(10));
+    ~MetricsExporter();
+
+    MetricsExporter(const MetricsExporter&) = delete;
+    MetricsExporter& operator=(const MetricsExporter&) = delete;
+
+    /**
+     * Export an engine's mailbox (MatchingEngine::metrics(),
+     * MultiInstrumentEngine::metrics()) under engine="label"
+     */
+    void add_engine(const std::string& label, MetricsMailbox<EngineMetrics>& mailbox);
+
+    /**
+     * Export read() as a gauge. read runs on the scraper thread, so it may
+     * only touch state that is safe to read from there - atomics, or
+     * SPSCQueue::size() for ring occupancy.
+     */
+    void add_gauge(const std::string& name, const std::string& labels, const std::string& help,
+                   std::function<double()> read);
+
+    /**
+     * Launch the scraper thread, pinned to cpu unless it is -1
+     */
+    void start(int cpu = -1);
+    void stop();
+
+    /**
+     * Collect and render one page now, on the calling thread. Not while
+     * the scraper thread is running.
+     */
+    std::string scrape();
+
+    uint64_t scrapes() const noexcept { return scrapes_.load(std::memory_order_relaxed); }
+    uint64_t stale_answers() const noexcept { return stale_answers_.load(std::memory_order_relaxed); }
+};
+
+} // namespace OrderBook
@@ -4,108 +4,270 @@
 #include "instrument.hpp"
 #include "book.hpp"
 #include "order_pool.hpp"
+#include "order_id_index.hpp"
+#include "instrument_directory.hpp"
 #include "spsc_ring_buffer.hpp"
-#include <unordered_map>
+#include "spsc_queue.hpp"
+#include "tsc_clock.hpp"
+#include "latency_histogram.hpp"
+#include "engine_metrics.hpp"
+#include "output_stage.hpp"
+#include "risk_manager.hpp"
+#include "risk_stage.hpp"
+#include "book_snapshot.hpp"
 #include <memory>
 #include <vector>
 
 namespace OrderBook {
 
 /**
- * Enhanced command structure with instrument support
+ * Multi-instrument commands share the packed 32-byte Command wire format;
+ * instrument_id selects the book and price is in that instrument's ticks
  */
-struct MultiInstrumentCommand {
-    CommandType type;
-    uint32_t instrument_id;
-    uint64_t order_id;
-    Side side;
-    int64_t price;
-    uint64_t quantity;
-    std::chrono::high_resolution_clock::time_point producer_timestamp;
-    
-    MultiInstrumentCommand() noexcept = default;
-};
+using MultiInstrumentCommand = Command;
 
 /**
  * Multi-instrument matching engine that manages separate order books
- * for different instruments while sharing the same order pool
+ * for different instruments while sharing the same order pool.
+ *
+ * Instruments live in an InstrumentDirectory. add_instrument() and
+ * remove_instrument() may be called from one control thread while run()
+ * is going; the matching thread picks changes up between bursts.
+ *
+ * Runs standalone on one ring, or as one shard of a ShardedMatchingEngine
+ * that owns only the instruments routed to it.
+ *
+ * Besides NEW and CANCEL it takes the market-maker commands: REPLACE amends
+ * a resting order, MASS_CANCEL pulls all of an account's orders on one
+ * instrument, and a MASS_QUOTE header followed by its QUOTE_LEG commands
+ * re-quotes many levels with one best bid / ask recovery at the end.
  */
 class MultiInstrumentEngine {
 private:
-    std::unordered_map<uint32_t, std::unique_ptr<Book>> books_;
-    std::unordered_map<uint32_t, Instrument> instruments_;
+    using InstrumentState = InstrumentDirectory::Entry;
+    
+    SymbolTable symbols_;
     std::unique_ptr<OrderPool> order_pool_;
-    SPSCRingBuffer* ring_buffer_;
     
-    // Enhanced order tracking with instrument mapping
-    std::vector<std::pair<Order*, uint32_t>> order_map_;  // Order* -> instrument_id
+    // Per-instrument book, limits and counters; add/remove don't stop the matching loop
+    InstrumentDirectory directory_;
+    SPSCQueue<MultiInstrumentCommand>* ring_buffer_;
+    OutputStage* output_;
+    RiskManager* risk_;   // Pre-trade checks and positions, nullptr = none
+    RiskStage* risk_stage_;  // Fill sink when risk runs as its own stage, nullptr = none
+    
+    // Mass quote being applied; legs may straddle bursts but the batch never does
+    InstrumentState* quote_batch_;
+    uint32_t quote_legs_remaining_;
+    
+    // Resting orders by (account, client order_id); the instrument is kept in the order's OrderInfo
+    OrderIdIndex order_index_;
     
-    // Per-instrument statistics
-    std::unordered_map<uint32_t, uint64_t> trades_per_instrument_;
-    std::unordered_map<uint32_t, uint64_t> volume_per_instrument_;
+    // Seqlock depth per directory slot for other threads, republished once per burst
+    std::unique_ptr<BookSnapshot[]> snapshots_;  // nullptr = not published
+    std::vector<uint8_t> snapshot_dirty_;        // By slot
+    std::vector<InstrumentState*> dirty_books_;  // Live until the next refresh, so for the burst
     
     // Global statistics
-    std::vector<long long> trade_latencies_ns_;
+    LatencyHistogram queue_latency_;  // Producer enqueue -> engine dequeue, ns per command
+    LatencyHistogram trade_latency_;  // Engine dequeue -> fill, ns per trade
     uint64_t orders_processed_;
     uint64_t total_trades_executed_;
     uint64_t orders_rejected_;
+    SpanSampler new_order_span_;  // handle_new_order, one call in METRICS_SPAN_SAMPLE_PERIOD
+    SpanSampler match_span_;      // match_order, likewise
+    MetricsMailbox<EngineMetrics> metrics_;  // Served once per burst
     
 public:
-    explicit MultiInstrumentEngine(SPSCRingBuffer* ring_buffer);
+    /**
+     * Engine consuming ring_buffer, with an order pool of max_orders
+     * (growable to ORDER_POOL_MAX_SLABS times that)
+     */
+    explicit MultiInstrumentEngine(SPSCQueue<MultiInstrumentCommand>* ring_buffer,
+                                   uint64_t max_orders = MAX_ORDERS);
     
     /**
-     * Add a new instrument to the engine
+     * Add a new instrument to the engine. false if the id is taken or
+     * MAX_INSTRUMENTS are already traded.
      */
     bool add_instrument(const Instrument& instrument);
     
     /**
-     * Remove an instrument (after processing all pending orders)
+     * Stop trading an instrument. Commands for it still in the ring are
+     * dropped, and its resting orders go back to the pool at the start of
+     * the next burst.
      */
     bool remove_instrument(uint32_t instrument_id);
     
     /**
-     * Main processing loop for multi-instrument orders
+     * Main processing loop for multi-instrument orders, until
+     * orders_processed() reaches command_count
      */
-    void run() noexcept;
+    void run(uint64_t command_count = TOTAL_ORDERS_TO_GENERATE) noexcept;
     
     /**
-     * Get order book for specific instrument
+     * Drain and process up to ENGINE_BURST_SIZE commands with a single
+     * consumer index publication. Returns the number of commands processed.
+     */
+    size_t process_burst() noexcept;
+    
+    /**
+     * Get order book for specific instrument. Only safe to read on the
+     * matching thread or once it has stopped - other threads use book_snapshot().
      */
     const Book* get_book(uint32_t instrument_id) const noexcept;
     
+    /**
+     * Publish every changed book's top MARKET_DEPTH_LEVELS levels at the end
+     * of each burst, for book_snapshot() readers. Reserves one block per
+     * directory slot (about 1 KB each). Must be called before run().
+     */
+    void enable_book_snapshots();
+    
+    /**
+     * Published depth of an instrument, readable from any thread at any
+     * rate, or nullptr if snapshots are off or the instrument isn't traded.
+     * Resolve on the control thread like add / remove_instrument. The block
+     * lives as long as the engine; once the instrument is removed it is
+     * published empty, and a later instrument may reuse it - check
+     * Level2Snapshot::instrument_id.
+     */
+    const BookSnapshot* book_snapshot(uint32_t instrument_id) const noexcept;
+    
+    /**
+     * Symbols of every instrument added so far, for the market data publishers
+     */
+    const SymbolTable& symbols() const noexcept;
+    
+    /**
+     * Route execution reports to an asynchronous output stage (nullptr = silent)
+     */
+    void set_output_stage(OutputStage* output) noexcept;
+    
+    /**
+     * Run every new order and cancel through risk's pre-trade checks as
+     * part of validation, and feed it fills (nullptr = no risk checks).
+     * Commands must then carry the account_id risk assigned at logon. The
+     * engine publishes risk's statistics once per burst. Must be set before run().
+     */
+    void set_risk_manager(RiskManager* risk) noexcept;
+    
+    /**
+     * Staged topology: commands arrive already checked by stage, which gets
+     * every fill back for positions. Exclusive with set_risk_manager().
+     * Must be set before run().
+     */
+    void set_risk_stage(RiskStage* stage) noexcept;
+    
     // Statistics getters
     uint64_t orders_processed() const noexcept;
     uint64_t total_trades_executed() const noexcept;
     uint64_t orders_rejected() const noexcept;
+    const OrderPool& order_pool() const noexcept;  // Capacity and exhaustion telemetry
+    const OrderIdIndex& order_index() const noexcept;
     uint64_t trades_for_instrument(uint32_t instrument_id) const noexcept;
     uint64_t volume_for_instrument(uint32_t instrument_id) const noexcept;
-    const std::vector<long long>& trade_latencies() const noexcept;
+    const LatencyHistogram& queue_latency() const noexcept;
+    const LatencyHistogram& trade_latency() const noexcept;
+    
+    /**
+     * Counters, pool utilisation and histograms for a scraper thread
+     * (MetricsExporter), answered at the end of the next burst
+     */
+    MetricsMailbox<EngineMetrics>& metrics() noexcept;
     
 private:
-    void handle_new_order(const MultiInstrumentCommand& cmd, 
-                         const std::chrono::high_resolution_clock::time_point& processing_start) noexcept;
-    void handle_cancel_order(uint32_t instrument_id, uint64_t order_id) noexcept;
-    bool validate_order(const MultiInstrumentCommand& cmd) const noexcept;
-    void execute_trade(uint32_t instrument_id, uint64_t aggressor_id, uint64_t resting_id, 
-                      int64_t price, uint64_t quantity,
-                      const std::chrono::high_resolution_clock::time_point& processing_start) noexcept;
-    void match_order(uint32_t instrument_id, Order* order, 
-                    const std::chrono::high_resolution_clock::time_point& processing_start) noexcept;
+    /**
+     * Free every resting order of an instrument that has left the directory
+     */
+    void release_resting_orders(InstrumentState& state) noexcept;
+    
+    void fill_metrics(EngineMetrics& metrics) const noexcept;
+    
+    void handle_new_order(const MultiInstrumentCommand& cmd, uint32_t instrument_id,
+                         uint64_t processing_start) noexcept;
+    void handle_cancel_order(const MultiInstrumentCommand& cmd, uint32_t instrument_id) noexcept;
+    
+    /**
+     * Amend a resting order of the same account, instrument and side to the
+     * command's price and remaining quantity. At the same price with no more
+     * quantity it shrinks in place and keeps its priority; otherwise it goes
+     * to the back of the queue and may trade at the new price. Quantity 0
+     * cancels.
+     */
+    void handle_replace_order(const MultiInstrumentCommand& cmd, uint32_t instrument_id,
+                              uint64_t processing_start) noexcept;
+    void handle_mass_cancel(const MultiInstrumentCommand& cmd, uint32_t instrument_id) noexcept;
+    
+    /**
+     * Mass quote: the header opens a book batch for quantity legs, closed by
+     * the last leg, any other command, or the end of the burst. Legs are
+     * passive - one that would cross is rejected and its old quote pulled.
+     * A leg amends the account's resting order with the same order_id like
+     * REPLACE, adds a new one otherwise, and quantity 0 pulls it.
+     */
+    void begin_mass_quote(const MultiInstrumentCommand& cmd, uint32_t instrument_id) noexcept;
+    void handle_quote_leg(const MultiInstrumentCommand& cmd, uint32_t instrument_id) noexcept;
+    void end_mass_quote() noexcept;
+    void apply_quote_leg(InstrumentState& state, const MultiInstrumentCommand& cmd,
+                         uint32_t instrument_id) noexcept;
+    
+    /**
+     * Resting order of cmd's account on instrument_id with cmd's order_id, or nullptr
+     */
+    Order* find_owned_order(const MultiInstrumentCommand& cmd, uint32_t instrument_id) noexcept;
+    
+    /**
+     * Match a new or re-priced order, then rest what is left or free it
+     */
+    void enter_order(InstrumentState& state, Order* order, AccountId account_id,
+                     uint64_t processing_start) noexcept;
+    void cancel_resting_order(Book& book, Order* order) noexcept;
+    
+    /**
+     * Book of state changed this burst - republish its snapshot at the end
+     */
+    void mark_changed(InstrumentState& state) noexcept {
+        if (!snapshots_) return;
+        const uint32_t slot = directory_.slot_of(state);
+        if (!snapshot_dirty_[slot]) {
+            snapshot_dirty_[slot] = 1;
+            dirty_books_.push_back(&state);
+        }
+    }
+    void publish_snapshots() noexcept;
+    bool validate_order(const MultiInstrumentCommand& cmd, const Instrument& instrument,
+                        int64_t& price) noexcept;
+    void execute_trade(InstrumentState& state, uint64_t aggressor_id, uint64_t resting_id, 
+                      Side aggressor_side, int64_t price, uint64_t quantity,
+                      uint64_t processing_start) noexcept;
+    void match_order(InstrumentState& state, Order* order, 
+                    uint64_t processing_start) noexcept;
+    
+    /**
+     * Post-trade: one side of a fill, to the inline risk manager or the risk stage
+     */
+    void record_fill(AccountId account_id, Side side, uint64_t quantity) noexcept {
+        if (risk_) {
+            risk_->on_fill(account_id, side, quantity);
+        } else if (risk_stage_) {
+            risk_stage_->publish_fill(account_id, side, quantity);
+        }
+    }
 };
 
 /**
  * SPSC Ring Buffer for multi-instrument commands
+ * Same claim/commit and in-place consume API as SPSCRingBuffer
  */
-class MultiInstrumentRingBuffer {
-private:
-    alignas(64) std::atomic<uint64_t> head_;
-    alignas(64) std::atomic<uint64_t> tail_;
-    std::vector<MultiInstrumentCommand> buffer_;
-    
+class MultiInstrumentRingBuffer : public SPSCQueue<MultiInstrumentCommand> {
 public:
-    MultiInstrumentRingBuffer();
-    bool enqueue(const MultiInstrumentCommand& cmd) noexcept;
-    bool dequeue(MultiInstrumentCommand& cmd) noexcept;
+    explicit MultiInstrumentRingBuffer(uint64_t capacity = RING_BUFFER_SIZE);
+    
+    /**
+     * Ring over external storage - see SharedRing
+     */
+    MultiInstrumentRingBuffer(SPSCQueueIndices* indices, void* slots, uint64_t capacity) noexcept;
 };
 
 } // namespace OrderBook
\ No newline at end of file
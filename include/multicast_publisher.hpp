@@ -0,0 +1,120 @@
+#pragma once
+
+#include "market_data.hpp"
+#include <array>
+#include <string>
+
+namespace OrderBook {
+
+/**
+ * Datagram format of MulticastMarketDataPublisher: a packet header, then
+ * message_count messages back to back, each starting with its type byte.
+ * Little-endian, fixed layouts, no message crosses a packet.
+ */
+enum class MarketDataMessageType : uint8_t {
+    TRADE = 1,
+    LEVEL2_UPDATE = 2,
+    SNAPSHOT = 3,        // SnapshotHeaderMessage; its levels follow in the same packet
+    SNAPSHOT_LEVEL = 4   // LevelMessage
+};
+
+struct MarketDataPacketHeader {
+    uint64_t sequence;       // Per publisher, from 1; a gap is a lost packet
+    uint16_t message_count;
+    uint16_t length;         // Whole packet, header included
+    uint32_t reserved;
+};
+
+struct TradeMessage {
+    MarketDataMessageType type;
+    Side aggressor_side;
+    uint16_t reserved;
+    uint32_t instrument_id;
+    uint64_t timestamp_ns;   // Since the epoch
+    uint64_t aggressor_order_id;
+    uint64_t resting_order_id;
+    int64_t price;
+    uint64_t quantity;
+};
+
+struct LevelMessage {
+    MarketDataMessageType type;  // LEVEL2_UPDATE or SNAPSHOT_LEVEL
+    Side side;
+    uint16_t reserved;
+    uint32_t instrument_id;
+    int64_t price;
+    uint64_t quantity;           // 0 = level removed
+    uint32_t order_count;
+    uint32_t reserved2;
+};
+
+struct SnapshotHeaderMessage {
+    MarketDataMessageType type;
+    uint8_t reserved;
+    uint16_t bid_levels;         // SNAPSHOT_LEVEL messages that follow, bids first
+    uint32_t instrument_id;
+    uint16_t ask_levels;
+    uint16_t reserved2[3];
+};
+
+static_assert(sizeof(MarketDataPacketHeader) == 16 && sizeof(TradeMessage) == 48 && sizeof(LevelMessage) == 32 &&
+              sizeof(SnapshotHeaderMessage) == 16, "Market data messages are a wire format");
+static_assert(sizeof(MarketDataPacketHeader) + sizeof(SnapshotHeaderMessage) +
+              2 * MARKET_DEPTH_LEVELS * sizeof(LevelMessage) <= MARKET_DATA_PACKET_SIZE,
+              "A full snapshot must fit one packet");
+
+/**
+ * Market data egress over UDP multicast.
+ *
+ * Records are encoded into a MARKET_DATA_PACKET_SIZE datagram as they
+ * arrive and the datagram is sent when the next record doesn't fit or on
+ * flush() - once per output batch - so a burst of fills goes out in a few
+ * packets rather than one syscall each. Packets are sequenced for gap
+ * detection; there is no retransmission.
+ *
+ * The socket is connected to group:port, so a unicast address (a single
+ * consumer, or loopback in tests) works as well. For a multicast group
+ * the TTL, loopback and outgoing interface are set. Like the gateway's
+ * transport, a kernel-bypass sender only has to replace send_packet().
+ */
+class MulticastMarketDataPublisher : public MarketDataPublisher {
+private:
+    int fd_;
+    std::string error_;
+    alignas(CACHE_LINE_SIZE) std::array<char, MARKET_DATA_PACKET_SIZE> packet_;
+    size_t packet_length_;
+    uint16_t message_count_;
+    uint64_t sequence_;
+    uint64_t packets_sent_;
+    uint64_t send_failures_;
+
+    char* reserve(size_t size);
+    void send_packet() noexcept;
+
+public:
+    /**
+     * Publisher sending to group:port. interface_address selects the NIC for
+     * multicast (empty = the kernel's choice); ttl 1 keeps it on the subnet.
+     * Check is_open().
+     */
+    MulticastMarketDataPublisher(const std::string& group, uint16_t port,
+                                 const std::string& interface_address = "", int ttl = 1, bool loopback = true);
+    ~MulticastMarketDataPublisher() override;
+
+    MulticastMarketDataPublisher(const MulticastMarketDataPublisher&) = delete;
+    MulticastMarketDataPublisher& operator=(const MulticastMarketDataPublisher&) = delete;
+
+    bool is_open() const noexcept { return fd_ >= 0; }
+    const std::string& error() const noexcept { return error_; }
+
+    void publish_trade(const Trade& trade) override;
+    void publish_level2_snapshot(const Level2Snapshot& snapshot) override;
+    void publish_level2_update(uint32_t instrument_id, Side side, int64_t price,
+                               uint64_t new_quantity, uint32_t new_order_count) override;
+    void flush() override;
+
+    uint64_t packets_sent() const noexcept { return packets_sent_; }
+    uint64_t send_failures() const noexcept { return send_failures_; }
+};
+
+} // namespace OrderBook
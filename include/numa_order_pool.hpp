@@ -15,33 +15,33 @@ class NumaOrderPool {
 private:
     struct NumaOrderNode {
         numa_vector<Order> orders;
-        Order* free_head;
+        OrderIndex free_head;   // Node-local index
         uint64_t allocated_count;
         int numa_node_id;
         
         NumaOrderNode(NumaAllocator& allocator, int node_id, uint64_t capacity)
             : orders(make_numa_vector<Order>(allocator, node_id)),
-              free_head(nullptr), allocated_count(0), numa_node_id(node_id) {
+              free_head(NULL_ORDER), allocated_count(0), numa_node_id(node_id) {
             
             orders.resize(capacity);
             
             // Initialize free list
             for (uint64_t i = 0; i < capacity - 1; ++i) {
-                orders[i].next = &orders[i + 1];
+                orders[i].next = static_cast<OrderIndex>(i + 1);
             }
-            orders[capacity - 1].next = nullptr;
-            free_head = &orders[0];
+            orders[capacity - 1].next = NULL_ORDER;
+            free_head = 0;
         }
         
         Order* allocate() noexcept {
-            if (!free_head) return nullptr;
+            if (free_head == NULL_ORDER) return nullptr;
             
-            Order* order = free_head;
-            free_head = free_head->next;
+            Order* order = &orders[free_head];
+            free_head = order->next;
             
             // Clear for reuse
-            order->next = nullptr;
-            order->prev = nullptr;
+            order->next = NULL_ORDER;
+            order->prev = NULL_ORDER;
             ++allocated_count;
             
             return order;
@@ -51,7 +51,7 @@ private:
             if (!order) return;
             
             order->next = free_head;
-            free_head = order;
+            free_head = static_cast<OrderIndex>(order - orders.data());
             --allocated_count;
         }
         
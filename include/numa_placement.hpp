@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstdint>
+
+namespace OrderBook {
+
+/**
+ * CPUs to pin the pipeline's threads to. -1 leaves a thread to the scheduler.
+ */
+struct PlacementConfig {
+    int feed_cpu = -1;
+    int matching_cpu = -1;
+    int publisher_cpu = -1;
+    int journal_cpu = -1;
+};
+
+/**
+ * Pages of a memory range by where they are resident relative to one node
+ */
+struct PageCensus {
+    uint64_t local = 0;
+    uint64_t remote = 0;
+    uint64_t unknown = 0;  // Not resident, or the kernel has no NUMA support
+
+    PageCensus& operator+=(const PageCensus& other) noexcept;
+};
+
+/**
+ * Thread pinning and NUMA memory placement.
+ *
+ * Talks to the kernel directly (sched_setaffinity, set_mempolicy,
+ * move_pages) rather than through libnuma, so it builds everywhere and
+ * degrades to no-ops on kernels or hosts without NUMA.
+ *
+ * The engine's memory - order pool, order-id index, book and both rings - is
+ * all written by the matching thread, so it belongs on that thread's node.
+ * Every one of those is allocated and touched while it is constructed;
+ * constructing them inside a ScopedNodePreference places them there without
+ * every container needing its own allocator. Pool slabs committed later
+ * are faulted in by the (pinned) matching thread and land locally anyway.
+ */
+class NumaPlacement {
+public:
+    /**
+     * Online NUMA nodes, 1 on non-NUMA hosts
+     */
+    static int node_count() noexcept;
+
+    /**
+     * Node a CPU belongs to, or -1 if unknown
+     */
+    static int node_of_cpu(int cpu) noexcept;
+
+    /**
+     * Restrict the calling thread to one CPU. false if cpu is invalid or not permitted.
+     */
+    static bool pin_current_thread(int cpu) noexcept;
+
+    /**
+     * Sample up to max_samples pages of [address, address + bytes) and
+     * classify them against node
+     */
+    static PageCensus census(const void* address, uint64_t bytes, int node,
+                             uint64_t max_samples = 4096) noexcept;
+
+    /**
+     * While alive, memory the calling thread faults in is preferred on node
+     * (MPOL_PREFERRED - falls back to other nodes rather than failing).
+     * A negative node, or a host without NUMA, makes this a no-op.
+     */
+    class ScopedNodePreference {
+    private:
+        bool active_;
+
+    public:
+        explicit ScopedNodePreference(int node) noexcept;
+        ~ScopedNodePreference();
+
+        ScopedNodePreference(const ScopedNodePreference&) = delete;
+        ScopedNodePreference& operator=(const ScopedNodePreference&) = delete;
+
+        /**
+         * Back to the default (local) policy before the guard goes out of scope
+         */
+        void release() noexcept;
+
+        bool active() const noexcept { return active_; }
+    };
+};
+
+} // namespace OrderBook
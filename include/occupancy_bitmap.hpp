@@ -0,0 +1,142 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <vector>
+
+namespace OrderBook {
+
+/**
+ * Hierarchical occupancy bitmap over a fixed range of price slots.
+ *
+ * Level 0 holds one bit per slot. Each word of level N+1 summarises 64 words
+ * of level N (bit set = that word has at least one slot occupied), and the top
+ * level is a single summary word. Finding the next occupied slot in either
+ * direction therefore costs one ctz/clz per level instead of a linear scan
+ * over empty PriceLevels.
+ *
+ * Header-only so the bit operations inline into the Book and match loops.
+ */
+class OccupancyBitmap {
+private:
+    std::vector<std::vector<uint64_t>> levels_;  // levels_[0] = one bit per slot
+    uint64_t size_;
+
+public:
+    static constexpr uint64_t NOT_FOUND = ~uint64_t{0};
+
+    explicit OccupancyBitmap(uint64_t size) : size_(size) {
+        uint64_t words = (size + 63) / 64;
+        if (words == 0) words = 1;
+
+        levels_.emplace_back(words, 0);
+        while (words > 1) {
+            words = (words + 63) / 64;
+            levels_.emplace_back(words, 0);
+        }
+    }
+
+    /**
+     * Mark slot as occupied. Summary bits are only touched when a word
+     * transitions from empty to non-empty.
+     */
+    void set(uint64_t index) noexcept {
+        for (auto& level : levels_) {
+            uint64_t& word = level[index >> 6];
+            const bool was_empty = (word == 0);
+            word |= uint64_t{1} << (index & 63);
+            if (!was_empty) return;
+            index >>= 6;
+        }
+    }
+
+    /**
+     * Mark slot as empty. Summary bits are only touched when a word
+     * transitions from non-empty to empty.
+     */
+    void clear(uint64_t index) noexcept {
+        for (auto& level : levels_) {
+            uint64_t& word = level[index >> 6];
+            word &= ~(uint64_t{1} << (index & 63));
+            if (word != 0) return;
+            index >>= 6;
+        }
+    }
+
+    bool test(uint64_t index) const noexcept {
+        return (levels_[0][index >> 6] >> (index & 63)) & 1;
+    }
+
+    bool empty() const noexcept {
+        return levels_.back()[0] == 0;
+    }
+
+    uint64_t size() const noexcept {
+        return size_;
+    }
+
+    void reset() noexcept {
+        for (auto& level : levels_) {
+            std::fill(level.begin(), level.end(), 0);
+        }
+    }
+
+    /**
+     * Lowest occupied slot >= index, or NOT_FOUND
+     * Climbs until a summary word has a candidate, then descends with ctz.
+     */
+    uint64_t find_next(uint64_t index) const noexcept {
+        if (index >= size_) return NOT_FOUND;
+
+        uint64_t pos = index;
+        for (size_t lvl = 0; lvl < levels_.size(); ++lvl) {
+            const uint64_t word_index = pos >> 6;
+            if (word_index >= levels_[lvl].size()) return NOT_FOUND;
+
+            const uint64_t word = levels_[lvl][word_index] & (~uint64_t{0} << (pos & 63));
+            if (word) {
+                pos = (word_index << 6) | static_cast<uint64_t>(std::countr_zero(word));
+                for (size_t down = lvl; down > 0; --down) {
+                    pos = (pos << 6) | static_cast<uint64_t>(std::countr_zero(levels_[down - 1][pos]));
+                }
+                return pos;
+            }
+
+            // Nothing left in this word - continue from the next word one level up
+            pos = word_index + 1;
+        }
+        return NOT_FOUND;
+    }
+
+    /**
+     * Highest occupied slot <= index, or NOT_FOUND
+     * Mirror of find_next using clz.
+     */
+    uint64_t find_prev(uint64_t index) const noexcept {
+        if (size_ == 0) return NOT_FOUND;
+        if (index >= size_) index = size_ - 1;
+
+        uint64_t pos = index;
+        for (size_t lvl = 0; lvl < levels_.size(); ++lvl) {
+            const uint64_t word_index = pos >> 6;
+            const uint64_t bit = pos & 63;
+            const uint64_t mask = (bit == 63) ? ~uint64_t{0} : ((uint64_t{1} << (bit + 1)) - 1);
+
+            const uint64_t word = levels_[lvl][word_index] & mask;
+            if (word) {
+                pos = (word_index << 6) | static_cast<uint64_t>(63 - std::countl_zero(word));
+                for (size_t down = lvl; down > 0; --down) {
+                    pos = (pos << 6) | static_cast<uint64_t>(63 - std::countl_zero(levels_[down - 1][pos]));
+                }
+                return pos;
+            }
+
+            if (word_index == 0) return NOT_FOUND;
+            pos = word_index - 1;
+        }
+        return NOT_FOUND;
+    }
+};
+
+} // namespace OrderBook
@@ -0,0 +1,261 @@
+#pragma once
+
+#include "types.hpp"
+#include <algorithm>
+#include <cstring>
+#include <string_view>
+#include <type_traits>
+
+namespace OrderBook {
+
+/**
+ * Binary order-entry protocol spoken by OrderGateway.
+ *
+ * Fixed-layout little-endian messages, each starting with a MessageHeader
+ * whose length is the whole message. Every message type has exactly one
+ * length, so framing is a header peek and decoding is a handful of loads
+ * straight into the ring slot - no parsing, no allocation. A session logs on
+ * once with its account name and everything it sends after that is
+ * stamped with the account's id.
+ *
+ * Client order ids are scoped to the logon: the gateway numbers each
+ * accepted logon with a SessionId and puts it in the top bits of every
+ * order id it passes to the engine, so no session can name another's
+ * orders. Engine-side ids - the ones in trades on the market data feed -
+ * map back with session_of() and client_order_id().
+ */
+namespace OrderEntry {
+
+constexpr uint8_t PROTOCOL_VERSION = 1;
+
+using SessionId = uint32_t;
+
+constexpr uint32_t CLIENT_ORDER_ID_BITS = 40;
+constexpr uint64_t MAX_CLIENT_ORDER_ID = (1ull << CLIENT_ORDER_ID_BITS) - 1;
+constexpr SessionId MAX_SESSION_ID = (1u << (64 - CLIENT_ORDER_ID_BITS)) - 1;
+
+/**
+ * Engine order id for a session's client order id, which must be at most
+ * MAX_CLIENT_ORDER_ID
+ */
+constexpr uint64_t engine_order_id(SessionId session, uint64_t client_order_id) noexcept {
+    return (static_cast<uint64_t>(session) << CLIENT_ORDER_ID_BITS) | client_order_id;
+}
+
+constexpr SessionId session_of(uint64_t engine_order_id) noexcept {
+    return static_cast<SessionId>(engine_order_id >> CLIENT_ORDER_ID_BITS);
+}
+
+constexpr uint64_t client_order_id(uint64_t engine_order_id) noexcept {
+    return engine_order_id & MAX_CLIENT_ORDER_ID;
+}
+
+enum class MessageType : uint8_t {
+    // Client -> gateway
+    LOGON = 1,
+    NEW_ORDER = 2,
+    CANCEL = 3,
+    REPLACE = 4,
+    MASS_CANCEL = 5,
+
+    // Gateway -> client
+    LOGON_ACK = 0x81,
+    LOGON_REJECT = 0x82
+};
+
+struct MessageHeader {
+    uint16_t length;  // Whole message, header included
+    MessageType type;
+    uint8_t version;
+};
+
+struct LogonMessage {
+    static constexpr MessageType TYPE = MessageType::LOGON;
+    static constexpr size_t ACCOUNT_NAME_SIZE = 28;
+
+    MessageHeader header;
+    char account[ACCOUNT_NAME_SIZE];  // NUL-padded
+};
+
+struct NewOrderMessage {
+    static constexpr MessageType TYPE = MessageType::NEW_ORDER;
+
+    MessageHeader header;
+    uint32_t instrument_id;
+    uint64_t order_id;
+    int32_t price;       // Ticks
+    uint32_t quantity;
+    Side side;
+    OrderType order_type;
+    uint8_t reserved[6];
+};
+
+struct CancelMessage {
+    static constexpr MessageType TYPE = MessageType::CANCEL;
+
+    MessageHeader header;
+    uint32_t instrument_id;
+    uint64_t order_id;
+};
+
+struct ReplaceMessage {
+    static constexpr MessageType TYPE = MessageType::REPLACE;
+
+    MessageHeader header;
+    uint32_t instrument_id;
+    uint64_t order_id;
+    int32_t price;
+    uint32_t quantity;
+    Side side;  // Of the order being replaced - pre-trade risk signs the position change by it
+    uint8_t reserved[7];
+};
+
+struct MassCancelMessage {
+    static constexpr MessageType TYPE = MessageType::MASS_CANCEL;
+
+    MessageHeader header;
+    uint32_t instrument_id;
+};
+
+struct LogonResponseMessage {
+    MessageHeader header;  // LOGON_ACK or LOGON_REJECT
+    AccountId account_id;  // NO_ACCOUNT on reject
+    uint16_t reserved;
+    SessionId session_id;  // Namespace of this logon's order ids, 0 on reject
+    uint32_t reserved2;
+};
+
+static_assert(sizeof(MessageHeader) == 4 && sizeof(LogonMessage) == 32 && sizeof(NewOrderMessage) == 32 &&
+              sizeof(CancelMessage) == 16 && sizeof(ReplaceMessage) == 32 && sizeof(MassCancelMessage) == 8 &&
+              sizeof(LogonResponseMessage) == 16, "Order-entry messages are a wire format");
+
+constexpr size_t MAX_MESSAGE_SIZE = 32;
+
+/**
+ * The one valid length of a message of type, 0 for an unknown type
+ */
+constexpr uint16_t message_length(MessageType type) noexcept {
+    switch (type) {
+        case MessageType::LOGON: return sizeof(LogonMessage);
+        case MessageType::NEW_ORDER: return sizeof(NewOrderMessage);
+        case MessageType::CANCEL: return sizeof(CancelMessage);
+        case MessageType::REPLACE: return sizeof(ReplaceMessage);
+        case MessageType::MASS_CANCEL: return sizeof(MassCancelMessage);
+        case MessageType::LOGON_ACK:
+        case MessageType::LOGON_REJECT: return sizeof(LogonResponseMessage);
+    }
+    return 0;
+}
+
+/**
+ * Message of type Message with its header filled in and every other byte
+ * zero, for clients to fill and send as-is
+ */
+template <typename Message>
+Message make_message() noexcept {
+    static_assert(std::is_trivially_copyable_v<Message>, "Messages are sent as raw bytes");
+    Message message;
+    std::memset(&message, 0, sizeof(message));
+    message.header.length = sizeof(Message);
+    message.header.type = Message::TYPE;
+    message.header.version = PROTOCOL_VERSION;
+    return message;
+}
+
+inline LogonMessage make_logon(std::string_view account) noexcept {
+    LogonMessage message = make_message<LogonMessage>();
+    std::memcpy(message.account, account.data(), std::min(account.size(), LogonMessage::ACCOUNT_NAME_SIZE));
+    return message;
+}
+
+/**
+ * Account name of a logon, without its padding
+ */
+inline std::string_view account_name(const LogonMessage& message) noexcept {
+    return std::string_view(message.account, strnlen(message.account, LogonMessage::ACCOUNT_NAME_SIZE));
+}
+
+/**
+ * Read a complete message of a known length out of a receive buffer,
+ * which need not be aligned
+ */
+template <typename Message>
+Message read_message(const char* bytes) noexcept {
+    Message message;
+    std::memcpy(&message, bytes, sizeof(message));
+    return message;
+}
+
+/**
+ * Decode a complete NEW_ORDER, CANCEL, REPLACE or MASS_CANCEL message from
+ * session in place into a claimed ring slot, order ids mapped into the
+ * session's namespace. Every field but account_id and the timestamp, left
+ * to the caller, is written - the slot still holds an older command.
+ * false for any other type, an out-of-range enum field or an order id
+ * above MAX_CLIENT_ORDER_ID, in which case the slot is left partly written
+ * and must not be committed.
+ */
+inline bool decode_command(const char* bytes, MessageType type, SessionId session, Command& slot) noexcept {
+    switch (type) {
+        case MessageType::NEW_ORDER: {
+            const NewOrderMessage message = read_message<NewOrderMessage>(bytes);
+            if (static_cast<uint8_t>(message.side) > static_cast<uint8_t>(Side::SELL) ||
+                static_cast<uint8_t>(message.order_type) > static_cast<uint8_t>(OrderType::FOK) ||
+                message.order_id > MAX_CLIENT_ORDER_ID) {
+                return false;
+            }
+            slot.type = CommandType::NEW;
+            slot.instrument_id = message.instrument_id;
+            slot.order_id = engine_order_id(session, message.order_id);
+            slot.price = message.price;
+            slot.quantity = message.quantity;
+            slot.side = message.side;
+            slot.order_type = message.order_type;
+            return true;
+        }
+        case MessageType::CANCEL: {
+            const CancelMessage message = read_message<CancelMessage>(bytes);
+            if (message.order_id > MAX_CLIENT_ORDER_ID) return false;
+            slot.type = CommandType::CANCEL;
+            slot.instrument_id = message.instrument_id;
+            slot.order_id = engine_order_id(session, message.order_id);
+            slot.price = 0;
+            slot.quantity = 0;
+            slot.side = Side::BUY;
+            slot.order_type = OrderType::LIMIT;
+            return true;
+        }
+        case MessageType::REPLACE: {
+            const ReplaceMessage message = read_message<ReplaceMessage>(bytes);
+            if (static_cast<uint8_t>(message.side) > static_cast<uint8_t>(Side::SELL) ||
+                message.order_id > MAX_CLIENT_ORDER_ID) {
+                return false;
+            }
+            slot.type = CommandType::REPLACE;
+            slot.instrument_id = message.instrument_id;
+            slot.order_id = engine_order_id(session, message.order_id);
+            slot.price = message.price;
+            slot.quantity = message.quantity;
+            slot.side = message.side;
+            slot.order_type = OrderType::LIMIT;
+            return true;
+        }
+        case MessageType::MASS_CANCEL: {
+            const MassCancelMessage message = read_message<MassCancelMessage>(bytes);
+            slot.type = CommandType::MASS_CANCEL;
+            slot.instrument_id = message.instrument_id;
+            slot.order_id = 0;
+            slot.price = 0;
+            slot.quantity = 0;
+            slot.side = Side::BUY;
+            slot.order_type = OrderType::LIMIT;
+            return true;
+        }
+        default:
+            return false;
+    }
+}
+
+} // namespace OrderEntry
+
+} // namespace OrderBook
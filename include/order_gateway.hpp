@@ -0,0 +1,107 @@
+#pragma once
+
+#include "types.hpp"
+#include "spsc_queue.hpp"
+#include "gateway_transport.hpp"
+#include "order_entry_protocol.hpp"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace OrderBook {
+
+class RiskManager;
+
+struct GatewayStatistics {
+    uint64_t sessions_accepted = 0;
+    uint64_t logons = 0;
+    uint64_t logons_rejected = 0;
+    uint64_t commands = 0;         // Committed to the ring
+    uint64_t protocol_errors = 0;  // Sessions closed for a malformed message or an order before logon
+    uint64_t ring_stalls = 0;      // Commands that found the ring full
+};
+
+/**
+ * Network order entry in front of an engine's command ring.
+ *
+ * Sessions speak the OrderEntry protocol over a GatewayTransport. A session
+ * logs on with an account name, which the gateway resolves once through
+ * RiskManager::find_account() and then stamps into every Command the
+ * session sends - the engine's pre-trade checks see the account without
+ * any per-order lookup. Each accepted logon also gets the next SessionId,
+ * and the session's order ids reach the engine inside that namespace, so
+ * one session can't cancel or replace another's orders by guessing ids;
+ * MASS_CANCEL still covers every order of the account.
+ *
+ * Each complete message is decoded straight from the transport's receive
+ * buffer into a claimed ring slot and committed, so an order is copied
+ * exactly once between the socket and the engine.
+ *
+ * The gateway is the ring's only producer. When the ring is full it yields
+ * until the engine catches up, so accepted orders are never dropped; TCP
+ * flow control then pushes back on the clients. Malformed messages and
+ * orders before logon close the session.
+ *
+ * Accounts must be logged on to the RiskManager before the gateway starts;
+ * logons naming any other account are rejected.
+ */
+class OrderGateway : public GatewaySessionHandler {
+private:
+    struct Session {
+        bool logged_on = false;
+        AccountId account_id = NO_ACCOUNT;
+        OrderEntry::SessionId session_id = 0;
+    };
+
+    GatewayTransport* transport_;
+    SPSCQueue<Command>* ring_;
+    const RiskManager& accounts_;
+    std::vector<Session> sessions_;  // By ConnectionId
+    OrderEntry::SessionId last_session_id_;  // Never reused, so a new logon can't inherit old orders
+
+    std::thread thread_;
+    std::atomic<bool> running_;
+
+    GatewayStatistics statistics_;  // Gateway thread only
+
+    Command& claim() noexcept;
+    bool handle_logon(ConnectionId connection, Session& session, const char* bytes);
+    void protocol_error(ConnectionId connection, Session& session);
+    Session& session(ConnectionId connection);
+
+public:
+    /**
+     * Gateway producing into ring from transport's sessions, logging them on
+     * to accounts; all three must outlive it
+     */
+    OrderGateway(GatewayTransport* transport, SPSCQueue<Command>* ring, const RiskManager& accounts);
+    ~OrderGateway() override;
+
+    OrderGateway(const OrderGateway&) = delete;
+    OrderGateway& operator=(const OrderGateway&) = delete;
+
+    /**
+     * Launch the gateway thread, pinned to cpu unless it is -1. It busy-polls
+     * the transport, yielding when a poll finds nothing.
+     */
+    void start(int cpu = -1);
+    void stop();
+
+    /**
+     * Serve one transport poll. Called by the gateway thread; can be driven
+     * directly when the gateway is not started. Returns sessions served.
+     */
+    size_t poll_once(int timeout_ms = 0);
+
+    // GatewaySessionHandler - called from poll_once()
+    void on_connect(ConnectionId connection) override;
+    size_t on_data(ConnectionId connection, const char* data, size_t size) override;
+    void on_disconnect(ConnectionId connection) override;
+
+    /**
+     * Read once the gateway is stopped, or from the thread driving poll_once()
+     */
+    const GatewayStatistics& statistics() const noexcept;
+};
+
+} // namespace OrderBook
@@ -0,0 +1,251 @@
+#pragma once
+
+#include "types.hpp"
+#include "order_pool.hpp"
+#include "engine_snapshot.hpp"
+#include <algorithm>
+#include <bit>
+#include <vector>
+
+namespace OrderBook {
+
+/**
+ * Pre-sized open-addressing index from client order_id to resting order.
+ *
+ * Robin Hood hashing over 8-byte slots. Each slot holds the order's
+ * OrderPool index, its probe distance and a 16-bit fingerprint of the id.
+ * Slots come in cache-line groups of eight and consecutive ids share a
+ * group, so the recent, mostly sequential ids that make up the live book
+ * keep the locality a dense id-indexed table had; which group a block of
+ * ids lands in is randomised by Fibonacci hashing.
+ * The id itself is not stored: a fingerprint hit is confirmed against the
+ * order in the pool, which a cancel is about to touch anyway. Erase shifts
+ * the rest of the probe run back one slot, so there are no tombstones and
+ * probe lengths don't degrade under insert/erase churn.
+ *
+ * An index keyed by account (MultiInstrumentEngine) holds (account_id,
+ * order_id) pairs instead, so accounts that happen to pick the same id each
+ * find only their own order. The account is mixed into the hash and
+ * confirmed against the order's OrderInfo, which must carry it before the
+ * order is inserted.
+ *
+ * Capacity is fixed at construction at the power of two >= 2 * max_orders,
+ * so load never exceeds one half even with the order pool full, ids can be
+ * any sparse 64-bit value and the table never rehashes on the hot path.
+ * An entry must be erased before its order is returned to the pool.
+ *
+ * Header-only so probing inlines into the engines' new/cancel handlers.
+ */
+class OrderIdIndex {
+private:
+    struct Slot {
+        OrderIndex order;
+        uint16_t distance;  // Probe distance + 1, 0 = empty
+        uint16_t tag;       // Fingerprint of the order id
+    };
+
+    static_assert(sizeof(Slot) == 8, "Index slots must stay 8 bytes");
+
+    static constexpr uint32_t GROUP_BITS = 3;
+    static constexpr uint64_t GROUP_SLOTS = 1ull << GROUP_BITS;
+
+    struct alignas(CACHE_LINE_SIZE) SlotGroup {
+        Slot slots[GROUP_SLOTS];
+    };
+
+    static_assert(sizeof(SlotGroup) == CACHE_LINE_SIZE, "A slot group is one cache line");
+
+    static constexpr uint64_t HASH_MULTIPLIER = 0x9E3779B97F4A7C15ull;  // 2^64 / golden ratio
+    static constexpr uint64_t MIN_CAPACITY = 2 * GROUP_SLOTS;
+    static constexpr uint64_t NOT_FOUND = ~0ull;
+
+    const OrderPool& pool_;
+    std::vector<SlotGroup> groups_;
+    uint64_t capacity_;
+    uint64_t mask_;
+    uint32_t group_shift_;
+    uint64_t size_;
+    uint16_t max_distance_;  // Longest probe distance ever stored - bounds misses in a full table
+    bool keyed_by_account_;
+
+    Slot& slot_at(uint64_t pos) noexcept { return groups_[pos >> GROUP_BITS].slots[pos & (GROUP_SLOTS - 1)]; }
+    const Slot& slot_at(uint64_t pos) const noexcept {
+        return groups_[pos >> GROUP_BITS].slots[pos & (GROUP_SLOTS - 1)];
+    }
+
+    /**
+     * Hash key: the account goes in the top bits, clear of the low id bits
+     * that keep consecutive ids in one group
+     */
+    static uint64_t key(uint64_t order_id, AccountId account) noexcept {
+        return order_id ^ (static_cast<uint64_t>(account) << 48);
+    }
+
+    /**
+     * Home slot: the low key bits pick the slot within a group, Fibonacci
+     * hashing of the rest picks the group
+     */
+    uint64_t home(uint64_t key) const noexcept {
+        const uint64_t group = ((key >> GROUP_BITS) * HASH_MULTIPLIER) >> group_shift_;
+        return (group << GROUP_BITS) | (key & (GROUP_SLOTS - 1));
+    }
+
+    static uint16_t tag(uint64_t key) noexcept {
+        return static_cast<uint16_t>((key * HASH_MULTIPLIER) >> 48);
+    }
+
+    AccountId account_of(OrderIndex order) const noexcept {
+        return keyed_by_account_ ? pool_.info(pool_.at(order)).account_id : NO_ACCOUNT;
+    }
+
+    /**
+     * Slot holding order_id under account (and, unless NULL_ORDER, that
+     * exact order), or NOT_FOUND
+     */
+    uint64_t locate(uint64_t order_id, AccountId account, OrderIndex order) const noexcept {
+        const uint16_t fingerprint = tag(key(order_id, account));
+
+        uint64_t pos = home(key(order_id, account));
+        for (uint16_t distance = 1; distance <= max_distance_; ++distance, pos = (pos + 1) & mask_) {
+            const Slot& slot = slot_at(pos);
+            // Empty, or an entry closer to its home than we are to ours: not present
+            if (slot.distance < distance) return NOT_FOUND;
+
+            if (slot.tag == fingerprint && (order == NULL_ORDER || slot.order == order) &&
+                pool_.at(slot.order)->order_id == order_id &&
+                (!keyed_by_account_ || account_of(slot.order) == account)) {
+                return pos;
+            }
+        }
+        return NOT_FOUND;
+    }
+
+    /**
+     * Backward-shift deletion: pull displaced successors one slot towards home
+     */
+    void remove_at(uint64_t pos) noexcept {
+        uint64_t next = (pos + 1) & mask_;
+        while (slot_at(next).distance > 1) {
+            Slot& slot = slot_at(pos);
+            slot = slot_at(next);
+            --slot.distance;
+            pos = next;
+            next = (next + 1) & mask_;
+        }
+        slot_at(pos).distance = 0;
+        --size_;
+    }
+
+public:
+    OrderIdIndex(const OrderPool& pool, uint64_t max_orders, bool keyed_by_account = false)
+        : pool_(pool),
+          capacity_(std::bit_ceil(std::max(2 * max_orders, MIN_CAPACITY))),
+          mask_(capacity_ - 1),
+          group_shift_(64 - static_cast<uint32_t>(std::countr_zero(capacity_ >> GROUP_BITS))),
+          size_(0), max_distance_(0), keyed_by_account_(keyed_by_account) {
+        groups_.resize(capacity_ >> GROUP_BITS);
+        for (auto& group : groups_) {
+            for (auto& slot : group.slots) slot = Slot{NULL_ORDER, 0, 0};
+        }
+    }
+
+    /**
+     * Index a resting order under its client id (and, if keyed by account,
+     * its OrderInfo account). Returns false only if the table is full. Keys
+     * are expected to be unique among resting orders; a duplicate is
+     * indexed alongside the original.
+     */
+    bool insert(uint64_t order_id, OrderIndex order) noexcept {
+        if (size_ == capacity_) return false;
+
+        const uint64_t hashed = key(order_id, account_of(order));
+        Slot entry{order, 1, tag(hashed)};
+
+        for (uint64_t pos = home(hashed);; pos = (pos + 1) & mask_, ++entry.distance) {
+            Slot& slot = slot_at(pos);
+            if (slot.distance == 0) {
+                slot = entry;
+                max_distance_ = std::max(max_distance_, entry.distance);
+                ++size_;
+                return true;
+            }
+            // Take from the rich: the entry nearer its home moves on
+            if (slot.distance < entry.distance) {
+                max_distance_ = std::max(max_distance_, entry.distance);
+                std::swap(slot, entry);
+            }
+        }
+    }
+
+    /**
+     * Resting order for order_id, or NULL_ORDER. An index keyed by account
+     * only finds account's own order.
+     */
+    OrderIndex find(uint64_t order_id, AccountId account = NO_ACCOUNT) const noexcept {
+        const uint64_t pos = locate(order_id, account, NULL_ORDER);
+        return (pos == NOT_FOUND) ? NULL_ORDER : slot_at(pos).order;
+    }
+
+    /**
+     * Remove order_id and return the order it referred to (NULL_ORDER if absent).
+     * One probe for cancel instead of find + erase. For indices not keyed
+     * by account.
+     */
+    OrderIndex erase(uint64_t order_id) noexcept {
+        const uint64_t pos = locate(order_id, NO_ACCOUNT, NULL_ORDER);
+        if (pos == NOT_FOUND) return NULL_ORDER;
+
+        const OrderIndex order = slot_at(pos).order;
+        remove_at(pos);
+        return order;
+    }
+
+    /**
+     * Remove the entry for this specific order, e.g. once it has been filled
+     */
+    bool erase(uint64_t order_id, OrderIndex order) noexcept {
+        const uint64_t pos = locate(order_id, account_of(order), order);
+        if (pos == NOT_FOUND) return false;
+
+        remove_at(pos);
+        return true;
+    }
+
+    uint64_t size() const noexcept { return size_; }
+    uint64_t capacity() const noexcept { return capacity_; }
+    bool empty() const noexcept { return size_ == 0; }
+
+    /**
+     * Slot table, for placement diagnostics
+     */
+    const void* storage() const noexcept { return groups_.data(); }
+    uint64_t storage_bytes() const noexcept { return groups_.size() * sizeof(SlotGroup); }
+
+    /**
+     * Snapshot support: the slot table is written and restored as one block.
+     * Slots hold pool indices, so the pool must be restored alongside.
+     */
+    void save(SnapshotWriter& out) const noexcept {
+        out.put(capacity_);
+        out.put(size_);
+        out.put(max_distance_);
+        out.write(groups_.data(), storage_bytes());
+    }
+
+    /**
+     * false if the snapshot is truncated or was taken with another capacity
+     */
+    bool load(SnapshotReader& in) noexcept {
+        uint64_t capacity = 0, size = 0;
+        uint16_t max_distance = 0;
+        if (!in.get(capacity) || !in.get(size) || !in.get(max_distance) || capacity != capacity_) {
+            return false;
+        }
+        if (!in.read(groups_.data(), storage_bytes())) return false;
+        size_ = size;
+        max_distance_ = max_distance;
+        return true;
+    }
+};
+
+} // namespace OrderBook
@@ -1,38 +1,129 @@
 #pragma once
 
 #include "types.hpp"
-#include <vector>
+#include "huge_page_region.hpp"
 
 namespace OrderBook {
 
+class SnapshotWriter;
+class SnapshotReader;
+
+static_assert(MAX_ORDERS * ORDER_POOL_MAX_SLABS < NULL_ORDER, "Order indices must fit OrderIndex");
+
 /**
  * Object pool for Orders to eliminate dynamic allocation on critical path.
  * Uses an intrusive free list for O(1) allocation/deallocation.
- * Pre-allocates all Order objects at startup.
+ * Pre-allocates and pre-faults the first slab of Orders at startup.
+ *
+ * Orders are split into two parallel arrays indexed by OrderIndex: the 32-byte
+ * hot Order that matching touches, and the cold OrderInfo. Book links are
+ * indices into this pool, resolved with at() / index_of().
+ *
+ * Both arrays live in HugePageRegions, so a sweep across a deep book costs a
+ * handful of dTLB entries rather than one per 4K page. Address space for
+ * max_slabs slabs is reserved up front; when the free list runs dry the pool
+ * commits the next slab directly behind the last one instead of rejecting,
+ * so indices and Order pointers stay stable. Growing faults in a whole slab
+ * on the allocating thread - a one-off stall, but no order is lost to it.
+ * Once max_slabs are in use allocation fails and is counted in
+ * exhaustion_count().
  */
 class OrderPool {
 private:
-    std::vector<Order> pool_;
-    Order* free_head_;
+    HugePageRegion order_region_;
+    HugePageRegion info_region_;
+    Order* pool_;
+    OrderInfo* info_;
+    OrderIndex free_head_;
+    uint64_t slab_orders_;
+    uint32_t max_slabs_;
+    uint32_t slab_count_;
     uint64_t allocated_count_;
-    
+
+    // Telemetry, read by the owning engine's statistics
+    uint64_t high_water_mark_;
+    uint64_t exhaustion_count_;
+
+    /**
+     * Commit the next slab and put its orders on the free list
+     */
+    bool grow() noexcept;
+
 public:
-    explicit OrderPool(uint64_t max_orders) noexcept;
-    
     /**
-     * Allocate an Order from the pool. Returns nullptr if pool is exhausted.
+     * Pool of slab_orders orders, allowed to grow to max_slabs slabs.
+     * Throws std::bad_alloc if the first slab cannot be mapped.
+     */
+    explicit OrderPool(uint64_t slab_orders, uint32_t max_slabs = 1);
+
+    OrderPool(const OrderPool&) = delete;
+    OrderPool& operator=(const OrderPool&) = delete;
+
+    /**
+     * Allocate an Order from the pool. Grows by a slab if the free list is
+     * empty; returns nullptr if the pool is exhausted.
      * O(1) operation - just pop from free list head.
      */
     Order* allocate() noexcept;
-    
+
     /**
      * Return an Order to the pool for reuse.
      * O(1) operation - push to free list head.
      */
     void free(Order* order) noexcept;
-    
+
+    // Index <-> order translation, inline for the match loop
+    Order* at(OrderIndex index) noexcept { return pool_ + index; }
+    const Order* at(OrderIndex index) const noexcept { return pool_ + index; }
+    OrderIndex index_of(const Order* order) const noexcept {
+        return static_cast<OrderIndex>(order - pool_);
+    }
+
+    /**
+     * Cold data for an order allocated from this pool
+     */
+    OrderInfo& info(const Order* order) noexcept { return info_[index_of(order)]; }
+    const OrderInfo& info(const Order* order) const noexcept { return info_[index_of(order)]; }
+
     uint64_t allocated_count() const noexcept;
     uint64_t available_count() const noexcept;
+
+    /**
+     * Orders currently backed by memory / the most the pool will ever hold
+     */
+    uint64_t capacity() const noexcept { return slab_orders_ * slab_count_; }
+    uint64_t max_capacity() const noexcept { return slab_orders_ * max_slabs_; }
+    uint32_t slab_count() const noexcept { return slab_count_; }
+
+    /**
+     * Most orders ever allocated at once
+     */
+    uint64_t high_water_mark() const noexcept { return high_water_mark_; }
+
+    /**
+     * Allocations refused because the pool was at max_capacity()
+     */
+    uint64_t exhaustion_count() const noexcept { return exhaustion_count_; }
+
+    /**
+     * Weakest page backing of the order array
+     */
+    PageBacking page_backing() const noexcept { return order_region_.backing(); }
+
+    /**
+     * Memory behind the hot and cold arrays, for placement diagnostics
+     */
+    const HugePageRegion& order_memory() const noexcept { return order_region_; }
+    const HugePageRegion& info_memory() const noexcept { return info_region_; }
+
+    /**
+     * Snapshot support: the committed part of both arrays is written as two
+     * raw blocks, free list links included, so restoring is a bulk copy.
+     * load() commits as many slabs as the snapshot used and fails if the slab
+     * geometry differs or this pool has already grown past it.
+     */
+    void save(SnapshotWriter& out) const noexcept;
+    bool load(SnapshotReader& in) noexcept;
 };
 
-} // namespace OrderBook
\ No newline at end of file
+} // namespace OrderBook
@@ -0,0 +1,119 @@
+#pragma once
+
+#include "types.hpp"
+#include "spsc_queue.hpp"
+#include "market_data.hpp"
+#include "latency_histogram.hpp"
+#include <atomic>
+#include <memory>
+#include <thread>
+
+namespace OrderBook {
+
+enum class OutputEventType : uint8_t {
+    TRADE,
+    LEVEL2_UPDATE
+};
+
+/**
+ * Fixed-size execution / market data record handed from the matching thread
+ * to the publisher thread. Plain data only - no strings, no allocation.
+ */
+struct OutputEvent {
+    uint64_t timestamp;            // Raw TSC when the engine emitted the event
+    uint64_t aggressor_order_id;   // TRADE only
+    uint64_t resting_order_id;     // TRADE only
+    int64_t price;
+    uint64_t quantity;             // Trade size, or new level volume for LEVEL2_UPDATE
+    uint32_t instrument_id;
+    uint32_t order_count;          // LEVEL2_UPDATE only - orders left at the level
+    OutputEventType type;
+    Side side;                     // Aggressor side for trades, book side for updates
+
+    OutputEvent() noexcept = default;
+};
+
+/**
+ * Asynchronous output stage between the matching engine and MarketDataManager.
+ *
+ * The engine claims OutputEvent slots on a dedicated SPSC ring and fills them
+ * in place - no formatting, string building or syscalls on the matching thread.
+ * A publisher thread drains the ring in batches of OUTPUT_BATCH_SIZE, turns
+ * each record into a Trade / L2 update for the manager's publishers and
+ * flushes them once per batch. Records carry instrument ids only - symbols
+ * are resolved by the publishers, on the publisher thread.
+ *
+ * When the ring is full the engine yields until the publisher catches up, so
+ * execution reports are never dropped. An engine without an output stage
+ * attached emits nothing (silent benchmarking).
+ *
+ * The ring may also live in a SharedRing segment, with the two halves in
+ * different processes: the engine's stage only produces into it (never
+ * started, no manager) and the consumer process's stage drains it.
+ */
+class OutputStage {
+private:
+    std::unique_ptr<SPSCQueue<OutputEvent>> owned_ring_;  // nullptr for an external ring
+    SPSCQueue<OutputEvent>* ring_;
+    MarketDataManager* manager_;
+
+    std::thread publisher_thread_;
+    std::atomic<bool> running_;
+
+    // Producer-side statistics (matching thread)
+    uint64_t producer_stalls_;
+
+    // Consumer-side statistics (publisher thread)
+    uint64_t events_published_;
+    LatencyHistogram publish_latency_;  // Engine emit -> publisher pickup, ns per event
+
+    OutputEvent& claim() noexcept;
+    void dispatch(const OutputEvent& event);
+    void run();
+
+public:
+    explicit OutputStage(MarketDataManager* manager, uint64_t capacity = OUTPUT_RING_SIZE);
+    
+    /**
+     * Stage over a ring owned elsewhere, which must outlive it
+     */
+    OutputStage(MarketDataManager* manager, SPSCQueue<OutputEvent>* ring);
+    ~OutputStage();
+
+    OutputStage(const OutputStage&) = delete;
+    OutputStage& operator=(const OutputStage&) = delete;
+
+    /**
+     * Launch the publisher thread, pinned to cpu unless it is -1
+     */
+    void start(int cpu = -1);
+
+    /**
+     * Publish everything still queued, then join the publisher thread.
+     * The engine must have stopped emitting before this is called.
+     */
+    void stop();
+
+    // Producer API - matching thread only
+    void publish_trade(uint32_t instrument_id, uint64_t aggressor_id, uint64_t resting_id,
+                       Side aggressor_side, int64_t price, uint64_t quantity) noexcept;
+    void publish_level2_update(uint32_t instrument_id, Side side, int64_t price,
+                               uint64_t quantity, uint32_t order_count) noexcept;
+
+    /**
+     * Consumer: publish one batch of queued records and flush the publishers.
+     * Called by the publisher thread; can be driven directly when the stage is
+     * not started. Returns the number of records published.
+     */
+    size_t drain();
+
+    uint64_t producer_stalls() const noexcept;
+    uint64_t events_published() const noexcept;
+    
+    /**
+     * Time each event waited in the ring. Read once the stage is stopped.
+     */
+    const LatencyHistogram& publish_latency() const noexcept;
+};
+
+} // namespace OrderBook
@@ -0,0 +1,134 @@
+#pragma once
+
+#include "types.hpp"
+#include "occupancy_bitmap.hpp"
+#include "cumulative_depth.hpp"
+#include <map>
+#include <vector>
+
+namespace OrderBook {
+
+class SnapshotWriter;
+class SnapshotReader;
+
+/**
+ * Price range and tick grid for one side of a book
+ */
+struct LadderConfig {
+    int64_t price_min;
+    int64_t price_max;
+    int64_t tick_size;
+    uint64_t window_levels;     // Dense levels kept around the touch
+
+    LadderConfig(int64_t p_min = PRICE_MIN, int64_t p_max = PRICE_MAX,
+                 int64_t tick = 1, uint64_t window = PRICE_WINDOW_LEVELS) noexcept
+        : price_min(p_min), price_max(p_max), tick_size(tick), window_levels(window) {}
+};
+
+/**
+ * One side of the order book, sized per instrument.
+ *
+ * Prices map to tick indices via (price - price_min) / tick_size. Only a window
+ * of window_levels ticks around the touch is kept dense (plus its occupancy
+ * bitmap), so the hot part of the ladder stays in L1/L2 no matter how wide the
+ * instrument's price range is. Non-empty levels that fall outside the window
+ * live in a sparse ordered overflow store, and the window is recentred on the
+ * touch whenever the best price moves out of it.
+ *
+ * Instruments whose whole range fits in the window never touch the overflow.
+ *
+ * Resting volume per window level is also kept in a Fenwick tree, so the
+ * volume available up to a limit price costs O(log window) plus any
+ * overflow levels in range, rather than a walk over the levels.
+ */
+class PriceLadder {
+private:
+    int64_t price_min_;
+    int64_t tick_size_;
+    uint64_t tick_count_;                       // Ticks in [price_min, price_max]
+    uint64_t window_base_;                      // Tick index of window_[0]
+    std::vector<PriceLevel> window_;
+    OccupancyBitmap occupancy_;                 // Bit set = window level non-empty
+    CumulativeDepth depth_;                     // Volume per window level, prefix-summable
+    std::map<uint64_t, PriceLevel> overflow_;   // Non-empty levels outside the window
+
+    void rebuild_depth() noexcept;
+    uint64_t volume_between(uint64_t first, uint64_t last, uint64_t enough) const noexcept;
+
+public:
+    static constexpr uint64_t NO_TICK = OccupancyBitmap::NOT_FOUND;
+
+    explicit PriceLadder(const LadderConfig& config);
+
+    /**
+     * Convert price to tick index. Returns false if the price is outside
+     * the instrument's range or not on its tick grid.
+     */
+    bool to_tick(int64_t price, uint64_t& tick) const noexcept;
+    int64_t to_price(uint64_t tick) const noexcept;
+
+    /**
+     * Level for tick, or nullptr if it lies outside the window and has no
+     * resting orders. O(1) inside the window.
+     */
+    PriceLevel* find(uint64_t tick) noexcept;
+    const PriceLevel* find(uint64_t tick) const noexcept;
+
+    /**
+     * Append order to the level at tick, materialising an overflow level if
+     * the tick lies outside the window. pool is the OrderPool order came from.
+     */
+    void add_order(uint64_t tick, Order* order, OrderPool& pool) noexcept;
+
+    /**
+     * Unlink order from the level at tick. Returns true if the level is now empty.
+     */
+    bool remove_order(uint64_t tick, Order* order, OrderPool& pool) noexcept;
+
+    /**
+     * Fill quantity of a resting order at level, which must belong to this
+     * ladder, keeping the level's volume and the depth tree in step
+     */
+    void fill_order(PriceLevel* level, Order* order, uint64_t quantity) noexcept {
+        level->fill_order(order, quantity);
+        const uint64_t offset = reinterpret_cast<uintptr_t>(level) - reinterpret_cast<uintptr_t>(window_.data());
+        if (offset < window_.size() * sizeof(PriceLevel)) depth_.subtract(offset / sizeof(PriceLevel), quantity);
+    }
+
+    /**
+     * Resting volume on levels priced at or below / at or above price.
+     * Stops adding overflow levels once the total reaches enough, so a
+     * feasibility check pays only for what it needs.
+     */
+    uint64_t volume_at_or_below(int64_t price, uint64_t enough = UINT64_MAX) const noexcept;
+    uint64_t volume_at_or_above(int64_t price, uint64_t enough = UINT64_MAX) const noexcept;
+
+    /**
+     * Lowest occupied tick >= tick / highest occupied tick <= tick, or NO_TICK
+     */
+    uint64_t next_up(uint64_t tick) const noexcept;
+    uint64_t next_down(uint64_t tick) const noexcept;
+
+    /**
+     * Move the dense window so it is centred on tick. Levels leaving the
+     * window move to the overflow store and vice versa; cost is proportional
+     * to the number of non-empty levels moved.
+     */
+    void recenter(uint64_t tick) noexcept;
+
+    bool in_window(uint64_t tick) const noexcept;
+    uint64_t tick_count() const noexcept;
+    uint64_t window_size() const noexcept;
+    uint64_t overflow_levels() const noexcept;
+
+    /**
+     * Snapshot support: the window position plus one record per non-empty
+     * level. Level links are pool indices, so the pool is restored alongside.
+     * load() fails (leaving the ladder empty) if the snapshot came from a
+     * ladder with a different geometry.
+     */
+    void save(SnapshotWriter& out) const noexcept;
+    bool load(SnapshotReader& in) noexcept;
+};
+
+} // namespace OrderBook
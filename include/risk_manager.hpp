@@ -1,9 +1,13 @@
 #pragma once
 
 #include "types.hpp"
-#include <unordered_map>
+#include <array>
 #include <atomic>
 #include <cstdint>
+#include <limits>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 namespace OrderBook {
 
@@ -15,47 +19,75 @@ struct RiskLimits {
     int64_t max_position = 1000000;          // Maximum net position
     uint64_t max_order_size = 100000;        // Maximum single order size
     uint64_t max_order_value = 10000000;     // Maximum single order value (price * quantity)
-    
-    // Rate limits
+
+    // Rate limits - sustained rate, with up to one second's worth in a burst; 0 = unlimited
     uint32_t max_orders_per_second = 1000;   // Maximum orders per second
     uint32_t max_cancels_per_second = 500;   // Maximum cancels per second
-    
+
     // Exposure limits
     uint64_t max_gross_exposure = 5000000;   // Maximum total exposure (long + short)
     uint64_t max_daily_volume = 50000000;    // Maximum daily trading volume
-    
+
     // Price limits
     double max_price_deviation = 0.10;       // 10% from reference price
-    
+
     RiskLimits() = default;
 };
 
 /**
- * Trading session and account state
+ * Token bucket on the TSC, kept as a single theoretical arrival time (GCRA):
+ * a take is allowed while the arrival time is no more than a full bucket
+ * ahead of now, and pushes it out by one token's worth of ticks. One
+ * compare and one add per check, no clock read - now is the command's
+ * producer_timestamp.
+ */
+struct TokenBucket {
+    uint64_t arrival_ticks = 0;    // When the bucket would be full again
+    uint64_t ticks_per_token = 0;  // 0 = unlimited
+    uint64_t burst_ticks = 0;      // Credit a full bucket holds, less one token
+
+    /**
+     * Refill at tokens_per_second, holding at most that many. 0 = unlimited.
+     */
+    void configure(uint32_t tokens_per_second) noexcept;
+
+    bool try_take(uint64_t now) noexcept {
+        const uint64_t arrival = arrival_ticks > now ? arrival_ticks : now;
+        if (arrival - now > burst_ticks) return false;
+        arrival_ticks = arrival + ticks_per_token;
+        return true;
+    }
+};
+
+/**
+ * Pre-trade state of one account, owned by the matching thread. Limits are
+ * copied in already converted to what the checks compare against, so a
+ * check reads one entry and nothing else.
  */
-struct TradingAccount {
-    std::string account_id;
+struct alignas(CACHE_LINE_SIZE) TradingAccount {
+    // Limits
+    uint64_t max_order_size = 0;
+    uint64_t max_order_value = 0;
+    int64_t max_position = 0;
+    uint64_t max_gross_exposure = 0;
+    uint64_t max_daily_volume = 0;
+    int64_t price_floor = std::numeric_limits<int64_t>::min();  // Deviation band around the reference, in ticks
+    int64_t price_ceiling = std::numeric_limits<int64_t>::max();
+    bool enabled = false;
+
+    // Positions and rate limits
     int64_t net_position = 0;                // Current net position (positive = long)
     uint64_t gross_exposure = 0;             // Total exposure (|long| + |short|)
     uint64_t daily_volume = 0;               // Total volume traded today
     uint64_t daily_trade_count = 0;          // Number of trades today
-    
-    // Rate limiting
-    uint32_t orders_this_second = 0;
-    uint32_t cancels_this_second = 0;
-    std::chrono::high_resolution_clock::time_point last_second_reset;
-    
-    RiskLimits limits;
-    bool enabled = true;
-    
-    explicit TradingAccount(const std::string& id) 
-        : account_id(id), last_second_reset(std::chrono::high_resolution_clock::now()) {}
+    TokenBucket orders;
+    TokenBucket cancels;
 };
 
 /**
  * Risk check results
  */
-enum class RiskCheckResult {
+enum class RiskCheckResult : uint8_t {
     ACCEPTED,
     REJECTED_POSITION_LIMIT,
     REJECTED_ORDER_SIZE,
@@ -68,88 +100,218 @@ enum class RiskCheckResult {
     REJECTED_UNKNOWN_ACCOUNT
 };
 
+constexpr size_t RISK_CHECK_RESULT_COUNT = 10;
+
+const char* to_string(RiskCheckResult result) noexcept;
+
+/**
+ * Counters as of the last RiskManager::publish_statistics()
+ */
+struct RiskStatistics {
+    uint64_t orders_checked = 0;
+    uint64_t orders_rejected = 0;
+    uint64_t cancels_checked = 0;
+    uint64_t cancels_rejected = 0;
+    std::array<uint64_t, RISK_CHECK_RESULT_COUNT> rejections{};  // Orders and cancels, per reason
+};
+
 /**
- * Risk manager for pre-trade and post-trade risk checks
+ * Pre-trade and post-trade risk for a matching thread.
+ *
+ * Accounts are resolved once, at logon, from their name to a dense
+ * AccountId that the gateway stamps into every Command. Checks index a
+ * cache-aligned flat array of TradingAccounts by that id - no hashing, no
+ * strings, no allocation, no atomics on the order path. Rate limits are
+ * token buckets driven by the command's own TSC timestamp.
+ *
+ * The matching thread is the only writer of account state and counters.
+ * Counters are plain; publish_statistics() (the engine calls it once per
+ * burst) copies them under a seqlock, and statistics() reads that copy
+ * consistently from any thread. Account management, limit changes and
+ * set_reference_price() are for the control path before the engine
+ * starts or while it is stopped; enable() / disable() may be flipped at any
+ * time.
  */
 class RiskManager {
 private:
-    std::unordered_map<std::string, TradingAccount> accounts_;
+    std::vector<TradingAccount> accounts_;   // Indexed by AccountId; slot 0 (NO_ACCOUNT) is never enabled
+    std::vector<std::string> names_;         // Cold: logon names / limits as configured, by AccountId
+    std::vector<RiskLimits> limits_;
+    std::unordered_map<std::string, AccountId> ids_;  // Logon lookup only
     std::atomic<bool> enabled_{true};
     int64_t reference_price_ = 5000;  // Reference price for deviation checks
-    
-    // Risk statistics
-    std::atomic<uint64_t> total_orders_checked_{0};
-    std::atomic<uint64_t> total_orders_rejected_{0};
-    std::array<std::atomic<uint64_t>, 10> rejection_counts_{};  // Per rejection reason
-    
+
+    // Single-writer counters (matching thread)
+    RiskStatistics counters_;
+
+    // Seqlock-published copy of counters_
+    static constexpr size_t STATISTICS_WORDS = sizeof(RiskStatistics) / sizeof(uint64_t);
+    static_assert(sizeof(RiskStatistics) == STATISTICS_WORDS * sizeof(uint64_t), "RiskStatistics is copied by word");
+    alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> statistics_sequence_{0};
+    std::array<std::atomic<uint64_t>, STATISTICS_WORDS> published_{};
+
+    RiskCheckResult reject(RiskCheckResult reason) noexcept {
+        ++counters_.orders_rejected;
+        ++counters_.rejections[static_cast<size_t>(reason)];
+        return reason;
+    }
+
+    void apply_limits(TradingAccount& account, const RiskLimits& limits) noexcept;
+
 public:
-    RiskManager() = default;
-    
+    RiskManager();
+
     /**
-     * Account management
+     * Account management (control path)
      */
-    bool add_account(const std::string& account_id, const RiskLimits& limits);
-    bool remove_account(const std::string& account_id);
-    bool update_limits(const std::string& account_id, const RiskLimits& limits);
-    bool enable_account(const std::string& account_id, bool enabled);
-    
+
     /**
-     * Risk checking
+     * Register account_name with limits, enabled, and return its id for the
+     * gateway to stamp into Command::account_id. NO_ACCOUNT if the name is
+     * already logged on or MAX_ACCOUNTS - 1 accounts exist.
      */
-    RiskCheckResult check_new_order(const std::string& account_id, const Command& cmd) noexcept;
-    RiskCheckResult check_cancel_order(const std::string& account_id, uint64_t order_id) noexcept;
-    
+    AccountId logon(const std::string& account_name, const RiskLimits& limits);
+    AccountId find_account(const std::string& account_name) const noexcept;
+    bool update_limits(AccountId account_id, const RiskLimits& limits) noexcept;
+    bool enable_account(AccountId account_id, bool enabled) noexcept;
+
     /**
-     * Post-trade updates
+     * Pre-trade check of a new order (matching thread). Consumes a token of
+     * the account's order rate only if the order is accepted.
      */
-    void update_position(const std::string& account_id, Side side, uint64_t quantity, int64_t price) noexcept;
-    void update_daily_volume(const std::string& account_id, uint64_t volume) noexcept;
-    
+    RiskCheckResult check_new_order(const Command& cmd) noexcept {
+        ++counters_.orders_checked;
+        if (!enabled_.load(std::memory_order_relaxed)) return RiskCheckResult::ACCEPTED;
+
+        if (cmd.account_id >= accounts_.size()) return reject(RiskCheckResult::REJECTED_UNKNOWN_ACCOUNT);
+        TradingAccount& account = accounts_[cmd.account_id];
+        if (!account.enabled) {
+            return reject(cmd.account_id == NO_ACCOUNT ? RiskCheckResult::REJECTED_UNKNOWN_ACCOUNT
+                                                        : RiskCheckResult::REJECTED_ACCOUNT_DISABLED);
+        }
+
+        const uint64_t quantity = cmd.quantity;
+        if (quantity > account.max_order_size) return reject(RiskCheckResult::REJECTED_ORDER_SIZE);
+        if (static_cast<uint64_t>(cmd.price) * quantity > account.max_order_value) {
+            return reject(RiskCheckResult::REJECTED_ORDER_VALUE);
+        }
+        if (cmd.price < account.price_floor || cmd.price > account.price_ceiling) {
+            return reject(RiskCheckResult::REJECTED_PRICE_DEVIATION);
+        }
+
+        const int64_t change = (cmd.side == Side::BUY) ? static_cast<int64_t>(quantity) : -static_cast<int64_t>(quantity);
+        const int64_t position = account.net_position + change;
+        if (position > account.max_position || position < -account.max_position) {
+            return reject(RiskCheckResult::REJECTED_POSITION_LIMIT);
+        }
+        if (account.gross_exposure + quantity > account.max_gross_exposure) {
+            return reject(RiskCheckResult::REJECTED_EXPOSURE_LIMIT);
+        }
+        if (account.daily_volume + quantity > account.max_daily_volume) {
+            return reject(RiskCheckResult::REJECTED_DAILY_VOLUME);
+        }
+
+        // Last, so only accepted orders count against the rate
+        if (!account.orders.try_take(cmd.producer_timestamp)) return reject(RiskCheckResult::REJECTED_RATE_LIMIT);
+        return RiskCheckResult::ACCEPTED;
+    }
+
+    /**
+     * Pre-trade check of a cancel (matching thread): account and cancel rate
+     */
+    RiskCheckResult check_cancel_order(const Command& cmd) noexcept {
+        ++counters_.cancels_checked;
+        if (!enabled_.load(std::memory_order_relaxed)) return RiskCheckResult::ACCEPTED;
+
+        RiskCheckResult result = RiskCheckResult::ACCEPTED;
+        if (cmd.account_id >= accounts_.size() || cmd.account_id == NO_ACCOUNT) {
+            result = RiskCheckResult::REJECTED_UNKNOWN_ACCOUNT;
+        } else if (!accounts_[cmd.account_id].enabled) {
+            result = RiskCheckResult::REJECTED_ACCOUNT_DISABLED;
+        } else if (!accounts_[cmd.account_id].cancels.try_take(cmd.producer_timestamp)) {
+            result = RiskCheckResult::REJECTED_RATE_LIMIT;
+        }
+
+        if (result != RiskCheckResult::ACCEPTED) {
+            ++counters_.cancels_rejected;
+            ++counters_.rejections[static_cast<size_t>(result)];
+        }
+        return result;
+    }
+
     /**
-     * Reference price management for deviation checks
+     * Pre-trade check of any command: orders, replaces and quote legs that
+     * add quantity as new orders, cancels and pulled legs as cancels. A
+     * mass-quote header carries nothing to check.
      */
-    void set_reference_price(int64_t price) noexcept { reference_price_ = price; }
+    RiskCheckResult check_command(const Command& cmd) noexcept {
+        switch (cmd.type) {
+            case CommandType::NEW:
+                return check_new_order(cmd);
+            case CommandType::REPLACE:
+            case CommandType::QUOTE_LEG:
+                return cmd.quantity > 0 ? check_new_order(cmd) : check_cancel_order(cmd);
+            case CommandType::MASS_QUOTE:
+                return RiskCheckResult::ACCEPTED;
+            default:
+                return check_cancel_order(cmd);
+        }
+    }
+
+    /**
+     * Post-trade update for one side of a fill (matching thread)
+     */
+    void on_fill(AccountId account_id, Side side, uint64_t quantity) noexcept {
+        if (account_id == NO_ACCOUNT || account_id >= accounts_.size()) return;
+        TradingAccount& account = accounts_[account_id];
+        account.net_position += (side == Side::BUY) ? static_cast<int64_t>(quantity) : -static_cast<int64_t>(quantity);
+        account.gross_exposure += quantity;
+        account.daily_volume += quantity;
+        ++account.daily_trade_count;
+    }
+
+    /**
+     * Reference price management for deviation checks, in the same ticks as
+     * Command::price. 0 or less disables the deviation check.
+     */
+    void set_reference_price(int64_t price) noexcept;
     int64_t get_reference_price() const noexcept { return reference_price_; }
-    
+
     /**
      * Risk manager control
      */
     void enable() noexcept { enabled_ = true; }
     void disable() noexcept { enabled_ = false; }
     bool is_enabled() const noexcept { return enabled_; }
-    
+
     /**
      * Statistics
      */
-    uint64_t total_orders_checked() const noexcept { return total_orders_checked_; }
-    uint64_t total_orders_rejected() const noexcept { return total_orders_rejected_; }
+
+    /**
+     * Writer: make the current counters visible to statistics(). Matching thread.
+     */
+    void publish_statistics() noexcept;
+
+    /**
+     * Reader: consistent copy of the last published counters, any thread
+     */
+    RiskStatistics statistics() const noexcept;
+
+    uint64_t total_orders_checked() const noexcept { return statistics().orders_checked; }
+    uint64_t total_orders_rejected() const noexcept { return statistics().orders_rejected; }
     uint64_t rejection_count(RiskCheckResult reason) const noexcept;
     double rejection_rate() const noexcept;
-    
+
     void print_risk_statistics() const noexcept;
-    void reset_daily_limits() noexcept;  // Call at start of each trading day
-    
+    void reset_daily_limits() noexcept;  // Call at start of each trading day, engine stopped
+
     /**
      * Account queries
      */
-    const TradingAccount* get_account(const std::string& account_id) const noexcept;
-    std::vector<std::string> get_all_account_ids() const noexcept;
-    
-private:
-    void update_rate_limits(TradingAccount& account) noexcept;
-    bool check_price_deviation(int64_t order_price, double max_deviation) const noexcept;
-    const char* risk_result_to_string(RiskCheckResult result) const noexcept;
-};
-
-/**
- * Enhanced command with account information
- */
-struct RiskManagedCommand {
-    std::string account_id;
-    Command base_command;
-    
-    RiskManagedCommand(const std::string& account, const Command& cmd) 
-        : account_id(account), base_command(cmd) {}
+    const TradingAccount* get_account(AccountId account_id) const noexcept;
+    const std::string* account_name(AccountId account_id) const noexcept;
+    size_t account_count() const noexcept { return accounts_.size() - 1; }
 };
 
-} // namespace OrderBook
\ No newline at end of file
+} // namespace OrderBook
@@ -0,0 +1,128 @@
+#pragma once
+
+#include "types.hpp"
+#include "spsc_queue.hpp"
+#include "risk_manager.hpp"
+#include "wait_strategy.hpp"
+#include "latency_histogram.hpp"
+#include <atomic>
+#include <thread>
+
+namespace OrderBook {
+
+/**
+ * Where pre-trade risk runs
+ */
+enum class RiskTopology : uint8_t {
+    INLINE,   // On the matching thread, inside MultiInstrumentEngine::validate_order
+    STAGED    // On its own thread, a RiskStage between the gateway ring and the engine ring
+};
+
+const char* to_string(RiskTopology topology) noexcept;
+
+/**
+ * Parse "inline" or "staged". false if unknown.
+ */
+bool parse_risk_topology(const char* name, RiskTopology& topology) noexcept;
+
+/**
+ * One side of a fill, handed back from the matching thread to the risk stage
+ */
+struct FillUpdate {
+    uint64_t quantity;
+    AccountId account_id;
+    Side side;
+
+    FillUpdate() noexcept = default;
+};
+
+/**
+ * Pre-trade risk as a pipeline stage, for the STAGED topology.
+ *
+ * The stage thread owns the RiskManager. It drains the gateway ring a
+ * burst at a time, checks each command and forwards the accepted ones
+ * into the engine's ring with a single index publication per burst.
+ * Rejected commands never reach the matching core. Commands keep their
+ * producer_timestamp, so the engine's queue latency covers the extra hop.
+ *
+ * Fills come back on a dedicated SPSC ring (the engine calls
+ * publish_fill() when attached with set_risk_stage()) and are applied to
+ * positions before every burst and while waiting on a full engine ring, so
+ * the two stages can never block on each other. Checks see positions as of
+ * the last applied fill - orders still in flight to the engine are not
+ * counted, which is the price of taking risk off the matching core.
+ *
+ * The run is over once commands_consumed() reaches the feed's count and
+ * the engine has processed commands_forwarded(); stop() the stage after
+ * the engine has stopped emitting fills.
+ */
+class RiskStage {
+private:
+    RiskManager& risk_;
+    SPSCQueue<Command>& input_;    // Gateway -> risk
+    SPSCQueue<Command>& output_;   // Risk -> engine
+    SPSCQueue<FillUpdate> fills_;  // Engine -> risk
+    WaitConfig wait_;
+
+    std::thread stage_thread_;
+    std::atomic<bool> running_;
+
+    // Stage-side statistics (stage thread), published for the run's completion check
+    alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> commands_consumed_;
+    std::atomic<uint64_t> commands_forwarded_;
+    uint64_t commands_rejected_;
+    uint64_t output_stalls_;
+    LatencyHistogram queue_latency_;  // Producer enqueue -> risk dequeue, ns per command
+
+    // Engine-side statistics (matching thread)
+    alignas(CACHE_LINE_SIZE) uint64_t fill_stalls_;
+
+    void run() noexcept;
+    size_t drain_fills() noexcept;
+    void forward(const Command* commands, size_t count) noexcept;
+
+public:
+    /**
+     * Stage checking input against risk and forwarding into output, with
+     * wait applied while the gateway ring is empty
+     */
+    RiskStage(RiskManager& risk, SPSCQueue<Command>& input, SPSCQueue<Command>& output,
+              const WaitConfig& wait = WaitConfig(), uint64_t fill_capacity = RISK_FILL_RING_SIZE);
+    ~RiskStage();
+
+    RiskStage(const RiskStage&) = delete;
+    RiskStage& operator=(const RiskStage&) = delete;
+
+    /**
+     * Launch the stage thread, pinned to cpu unless it is -1
+     */
+    void start(int cpu = -1);
+
+    /**
+     * Apply the fills still queued, then join the stage thread
+     */
+    void stop();
+
+    /**
+     * Consumer: check and forward one burst of the gateway ring, after
+     * applying queued fills. Called by the stage thread; can be driven
+     * directly when the stage is not started. Returns the commands consumed.
+     */
+    size_t process_burst() noexcept;
+
+    // Producer API - matching thread only
+    void publish_fill(AccountId account_id, Side side, uint64_t quantity) noexcept;
+
+    uint64_t commands_consumed() const noexcept { return commands_consumed_.load(std::memory_order_acquire); }
+    uint64_t commands_forwarded() const noexcept { return commands_forwarded_.load(std::memory_order_acquire); }
+    uint64_t commands_rejected() const noexcept;
+    uint64_t output_stalls() const noexcept;
+    uint64_t fill_stalls() const noexcept;
+
+    /**
+     * Time each command waited in the gateway ring. Read once the stage is stopped.
+     */
+    const LatencyHistogram& queue_latency() const noexcept;
+};
+
+} // namespace OrderBook
@@ -0,0 +1,152 @@
+#pragma once
+
+#include "types.hpp"
+#include "instrument.hpp"
+#include "multi_instrument_engine.hpp"
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace OrderBook {
+
+/**
+ * Shape of a ShardedMatchingEngine
+ */
+struct ShardingConfig {
+    uint32_t shard_count;
+    std::vector<int> shard_cpus;       // Core per shard, -1 or missing = unpinned
+    uint64_t orders_per_shard;         // Initial order pool slab per shard
+    uint64_t ring_capacity;            // Router -> shard ring, power of 2
+
+    explicit ShardingConfig(uint32_t shards = 1, std::vector<int> cpus = {},
+                            uint64_t orders = MAX_ORDERS, uint64_t ring = RING_BUFFER_SIZE)
+        : shard_count(shards ? shards : 1), shard_cpus(std::move(cpus)),
+          orders_per_shard(orders), ring_capacity(ring) {}
+};
+
+/**
+ * Instruments partitioned across matching cores.
+ *
+ * Each shard is a MultiInstrumentEngine with its own books, OrderPool and
+ * order-id index, fed by its own MultiInstrumentRingBuffer and run on its
+ * own thread - every book still has exactly one writer and shards share no
+ * mutable state. The ingress thread calls route(), which picks the shard
+ * from the command's instrument_id with one vector lookup and copies the
+ * command into that shard's ring.
+ *
+ * A shard's engine and books are constructed under a NUMA preference for
+ * its core's node. Instruments are assigned round-robin unless a shard is
+ * given. They may be added and removed while running, from the ingress
+ * thread (the only reader of the routing table); the shard picks the
+ * change up between bursts without stopping. Order ids only need to be
+ * unique within a shard; a cancel carries its instrument_id and follows
+ * the same route as the order it cancels.
+ *
+ * Stop the ingress before stop(): shards drain their rings and exit, after
+ * which the statistics getters are safe to read.
+ */
+class ShardedMatchingEngine {
+public:
+    static constexpr uint32_t NO_SHARD = ~0u;
+
+private:
+    struct Shard {
+        MultiInstrumentRingBuffer ring;
+        MultiInstrumentEngine engine;
+        std::thread thread;
+        int cpu;
+        int node;
+
+        Shard(uint64_t ring_capacity, uint64_t max_orders, int cpu, int node);
+    };
+
+    std::vector<std::unique_ptr<Shard>> shards_;
+    std::vector<uint32_t> shard_of_;  // Indexed by instrument_id, NO_SHARD = not traded here
+    SymbolTable symbols_;
+    uint32_t next_shard_;
+    std::atomic<bool> running_;
+
+    // Router statistics (ingress thread)
+    uint64_t commands_routed_;
+    uint64_t commands_unroutable_;
+    uint64_t router_stalls_;
+
+    void run_shard(Shard& shard) noexcept;
+
+public:
+    explicit ShardedMatchingEngine(const ShardingConfig& config = ShardingConfig());
+    ~ShardedMatchingEngine();
+
+    ShardedMatchingEngine(const ShardedMatchingEngine&) = delete;
+    ShardedMatchingEngine& operator=(const ShardedMatchingEngine&) = delete;
+
+    /**
+     * Add an instrument to the next shard round-robin, or to a given shard.
+     * Returns the shard, or NO_SHARD if the id is taken or the shard invalid.
+     */
+    uint32_t add_instrument(const Instrument& instrument);
+    uint32_t add_instrument(const Instrument& instrument, uint32_t shard);
+    
+    /**
+     * Stop routing an instrument and retire it on its shard. Its resting
+     * orders are released by that shard. false if no shard trades it.
+     */
+    bool remove_instrument(uint32_t instrument_id);
+
+    /**
+     * Attach an output stage to one shard (nullptr = silent). Each stage has
+     * a single producer, so shards can't share one. Must be set before start().
+     */
+    void set_output_stage(uint32_t shard, OutputStage* output) noexcept;
+
+    /**
+     * Have every shard publish book snapshots (see
+     * MultiInstrumentEngine::enable_book_snapshots). Must be called before start().
+     */
+    void enable_book_snapshots();
+
+    /**
+     * Launch one matching thread per shard, pinned to its configured core
+     */
+    void start();
+
+    /**
+     * Let every shard drain its ring, then join the matching threads.
+     * The ingress must have stopped routing before this is called.
+     */
+    void stop();
+
+    /**
+     * Ingress: hand a command to the shard owning its instrument. Waits for
+     * space if that shard's ring is full. Returns false, dropping the
+     * command, if no shard trades the instrument. Single ingress thread only.
+     */
+    bool route(const MultiInstrumentCommand& cmd) noexcept;
+
+    uint32_t shard_of(uint32_t instrument_id) const noexcept;
+    
+    /**
+     * Published depth of an instrument from its shard, nullptr if untraded
+     * or snapshots are off. Control thread; the block is readable from any thread.
+     */
+    const BookSnapshot* book_snapshot(uint32_t instrument_id) const noexcept;
+    uint32_t shard_count() const noexcept;
+    const MultiInstrumentEngine& shard(uint32_t index) const noexcept;
+    const SymbolTable& symbols() const noexcept;
+
+    // Totals across shards - read once stopped
+    uint64_t orders_processed() const noexcept;
+    uint64_t total_trades_executed() const noexcept;
+    uint64_t orders_rejected() const noexcept;
+    LatencyHistogram queue_latency() const noexcept;  // Merged over shards
+    LatencyHistogram trade_latency() const noexcept;
+
+    // Router statistics
+    uint64_t commands_routed() const noexcept;
+    uint64_t commands_unroutable() const noexcept;
+    uint64_t router_stalls() const noexcept;
+};
+
+} // namespace OrderBook
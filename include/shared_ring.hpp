@@ -0,0 +1,160 @@
+#pragma once
+
+#include "types.hpp"
+#include "spsc_queue.hpp"
+#include <atomic>
+#include <optional>
+#include <string>
+#include <type_traits>
+
+namespace OrderBook {
+
+enum class RingEnd : uint8_t {
+    PRODUCER,
+    CONSUMER
+};
+
+enum class SharedRingState : uint32_t {
+    INITIALIZING,  // Being laid out by its creator - not attachable yet
+    READY,
+    CLOSED         // Creator detached, or a new segment replaced this one
+};
+
+/**
+ * Header at offset 0 of a shared ring segment. The SPSCQueueIndices follow
+ * on the next cache line, then the slots.
+ */
+struct alignas(CACHE_LINE_SIZE) SharedRingHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t record_size;     // sizeof(T), checked on attach
+    uint32_t slot_size;
+    uint32_t reserved;
+    uint64_t capacity;        // Slots, a power of 2
+    uint64_t segment_bytes;
+    std::atomic<SharedRingState> state;
+    int32_t creator_pid;
+    std::atomic<int32_t> end_pids[2];        // Attached process per RingEnd, 0 = none
+    std::atomic<uint32_t> attach_counts[2];  // Attaches per RingEnd, restarts included
+};
+
+static_assert(sizeof(SharedRingHeader) == CACHE_LINE_SIZE, "SharedRingHeader is a shared memory format");
+static_assert(std::atomic<SharedRingState>::is_always_lock_free && std::atomic<int32_t>::is_always_lock_free,
+              "SharedRingHeader atomics are shared between processes");
+
+/**
+ * POSIX shared memory segment (/dev/shm/<name>) holding one SPSC ring, with
+ * one process attached at each end.
+ *
+ * The creator - normally the engine - lays out a fresh segment, replacing
+ * any left by an earlier run, and takes its own end; the peer attaches to
+ * the other end by name. Attaching checks the header's magic, version,
+ * record and slot sizes, so mismatched builds are refused rather than
+ * misread. Each end is claimed by pid: a live holder keeps it, but the end
+ * of a process that died without detaching is taken over, so a crashed
+ * gateway or consumer can simply be restarted. The new process carries on
+ * from the shared indices - a producer's uncommitted claim is lost, and
+ * records a consumer was handling when it died are delivered again.
+ *
+ * When the creator goes away, or a restarted creator replaces the segment,
+ * the old one is marked CLOSED; peers see closed() and re-attach.
+ */
+class SharedRingSegment {
+private:
+    std::string name_;
+    char* map_;
+    uint64_t map_size_;
+    uint64_t inode_;  // Tells this segment from a replacement under the same name
+    RingEnd end_;
+    bool creator_;
+    std::string error_;
+
+    bool create(uint32_t record_size, uint32_t slot_size, uint64_t capacity);
+    bool attach(uint32_t record_size, uint32_t slot_size);
+    bool claim_end();
+    SharedRingHeader* header() const noexcept { return reinterpret_cast<SharedRingHeader*>(map_); }
+
+public:
+    /**
+     * Segment offsets - the slots start on a cache line of their own
+     */
+    static constexpr uint64_t INDICES_OFFSET = sizeof(SharedRingHeader);
+    static constexpr uint64_t SLOTS_OFFSET = INDICES_OFFSET + sizeof(SPSCQueueIndices);
+
+    /**
+     * Create the segment name with capacity slots (a power of 2), or
+     * attach to it when capacity is 0, and claim end. Check is_open().
+     */
+    SharedRingSegment(const std::string& name, RingEnd end, uint32_t record_size, uint32_t slot_size,
+                      uint64_t capacity);
+    ~SharedRingSegment();
+
+    SharedRingSegment(const SharedRingSegment&) = delete;
+    SharedRingSegment& operator=(const SharedRingSegment&) = delete;
+
+    bool is_open() const noexcept { return map_ != nullptr; }
+    const std::string& error() const noexcept { return error_; }
+    const std::string& name() const noexcept { return name_; }
+    bool creator() const noexcept { return creator_; }
+
+    SPSCQueueIndices* indices() const noexcept;
+    void* slots() const noexcept;
+    uint64_t capacity() const noexcept;
+
+    /**
+     * The creator has detached or replaced the segment; attach again
+     */
+    bool closed() const noexcept;
+
+    /**
+     * A live process holds the other end
+     */
+    bool peer_attached() const noexcept;
+
+    /**
+     * Times end has been attached, restarts included
+     */
+    uint32_t attach_count(RingEnd end) const noexcept;
+
+    /**
+     * Remove a segment by name, e.g. one left by a crashed creator
+     */
+    static bool remove(const std::string& name) noexcept;
+};
+
+/**
+ * A ring queue - SPSCRingBuffer, MultiInstrumentRingBuffer, or an
+ * SPSCQueue<OutputEvent> behind OutputStage - placed in a SharedRingSegment.
+ * queue() is an ordinary queue over the shared slots: pass it to the
+ * engine, a FeedHandler or an OutputStage as if it were in-process.
+ *
+ *     SharedRing<SPSCRingBuffer> ingress("ome.ingress", RingEnd::CONSUMER, RING_BUFFER_SIZE);  // engine
+ *     SharedRing<SPSCRingBuffer> ingress("ome.ingress", RingEnd::PRODUCER);                    // gateway
+ */
+template <typename Queue>
+class SharedRing {
+private:
+    using Record = typename Queue::value_type;
+    static_assert(std::is_trivially_copyable_v<Record>, "Shared ring records are copied between processes");
+
+    SharedRingSegment segment_;
+    std::optional<Queue> queue_;
+
+public:
+    /**
+     * capacity > 0 creates the segment, 0 attaches to an existing one
+     */
+    SharedRing(const std::string& name, RingEnd end, uint64_t capacity = 0)
+        : segment_(name, end, sizeof(Record), Queue::slot_size(), capacity) {
+        if (segment_.is_open()) queue_.emplace(segment_.indices(), segment_.slots(), segment_.capacity());
+    }
+
+    bool is_open() const noexcept { return queue_.has_value(); }
+    const std::string& error() const noexcept { return segment_.error(); }
+    Queue& queue() noexcept { return *queue_; }
+    const SharedRingSegment& segment() const noexcept { return segment_; }
+    bool closed() const noexcept { return segment_.closed(); }
+    bool peer_attached() const noexcept { return segment_.peer_attached(); }
+};
+
+} // namespace OrderBook
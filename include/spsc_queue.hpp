@@ -0,0 +1,258 @@
+#pragma once
+
+#include "types.hpp"
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace OrderBook {
+
+/**
+ * Producer and consumer indices of an SPSCQueue, each on its own cache
+ * line. Owned by the queue, or placed in a shared memory segment
+ * (SharedRing) for a producer and consumer in different processes.
+ */
+struct SPSCQueueIndices {
+    alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> head{0};  // Producer writes
+    alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> tail{0};  // Consumer writes
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "Shared indices need lock-free atomics");
+
+/**
+ * Single-Producer Single-Consumer lock-free queue of fixed-size records.
+ *
+ * Shared implementation behind SPSCRingBuffer and MultiInstrumentRingBuffer.
+ *
+ * Critical design choices for ultra-low latency:
+ * 1. Power-of-2 capacity allows bitwise masking instead of modulo operation
+ * 2. Separate cache lines for head/tail to avoid false sharing
+ * 3. Acquire-Release memory ordering provides necessary synchronization without seq_cst overhead
+ * 4. Each side caches the other side's index and only reloads it when the queue
+ *    looks full (producer) or empty (consumer)
+ * 5. Slots are aligned to the next power of two of sizeof(T), capped at a cache
+ *    line, so a record never straddles two lines while small records (the
+ *    32-byte Command) still pack several per line
+ * 6. Claim/commit and consume_bulk let both sides work on the slot in place,
+ *    avoiding a record copy on the way in and on the way out
+ * 7. Indices and slots are reached through pointers, so the same queue can
+ *    run over memory it owns or over a shared memory segment
+ */
+template <typename T>
+class SPSCQueue {
+private:
+    static constexpr size_t SLOT_ALIGNMENT =
+        std::min(CACHE_LINE_SIZE, std::max(alignof(T), std::bit_ceil(sizeof(T))));
+
+    struct alignas(SLOT_ALIGNMENT) Slot {
+        T value;
+    };
+
+    // In-process storage; empty when the queue runs over external memory
+    std::unique_ptr<SPSCQueueIndices> owned_indices_;
+    std::vector<Slot> owned_slots_;
+
+    // Read-only after construction, shared by both sides
+    SPSCQueueIndices* indices_;
+    Slot* slots_;
+    uint64_t mask_;
+
+    alignas(CACHE_LINE_SIZE) uint64_t cached_tail_;  // Producer's last view of the tail index
+    alignas(CACHE_LINE_SIZE) uint64_t cached_head_;  // Consumer's last view of the head index
+
+    uint64_t free_slots(uint64_t head) const noexcept {
+        // One slot is always left empty to distinguish full from empty
+        return (cached_tail_ - head - 1) & mask_;
+    }
+
+    uint64_t used_slots(uint64_t tail) const noexcept {
+        return (cached_head_ - tail) & mask_;
+    }
+
+public:
+    using value_type = T;
+
+    /**
+     * capacity must be a power of 2
+     */
+    explicit SPSCQueue(uint64_t capacity)
+        : owned_indices_(std::make_unique<SPSCQueueIndices>()), owned_slots_(capacity),
+          indices_(owned_indices_.get()), slots_(owned_slots_.data()), mask_(capacity - 1),
+          cached_tail_(0), cached_head_(0) {}
+
+    /**
+     * Queue over storage owned elsewhere: capacity slots of slot_size()
+     * bytes at slots, aligned to slot_alignment(), and the indices. Both
+     * must outlive the queue. The cached indices start from the current
+     * shared ones, so a side that attaches to a live queue carries on where
+     * its predecessor stopped.
+     */
+    SPSCQueue(SPSCQueueIndices* indices, void* slots, uint64_t capacity) noexcept
+        : indices_(indices), slots_(static_cast<Slot*>(slots)), mask_(capacity - 1),
+          cached_tail_(indices->tail.load(std::memory_order_acquire)),
+          cached_head_(indices->head.load(std::memory_order_acquire)) {}
+
+    SPSCQueue(const SPSCQueue&) = delete;
+    SPSCQueue& operator=(const SPSCQueue&) = delete;
+
+    static constexpr size_t slot_size() noexcept { return sizeof(Slot); }
+    static constexpr size_t slot_alignment() noexcept { return alignof(Slot); }
+
+    uint64_t capacity() const noexcept {
+        return mask_ + 1;
+    }
+
+    /**
+     * Entries queued, as of two relaxed index reads - a gauge for any
+     * thread, exact only when neither side is moving
+     */
+    uint64_t size() const noexcept {
+        return (indices_->head.load(std::memory_order_relaxed) -
+                indices_->tail.load(std::memory_order_relaxed)) & mask_;
+    }
+
+    /**
+     * Slot array, for placement diagnostics
+     */
+    const void* storage() const noexcept { return slots_; }
+    uint64_t storage_bytes() const noexcept { return capacity() * sizeof(Slot); }
+
+    /**
+     * Producer: reserve the next slot for in-place construction.
+     * Returns nullptr if the queue is full. Calling again before commit()
+     * returns the same slot.
+     */
+    T* try_claim() noexcept {
+        const uint64_t current_head = indices_->head.load(std::memory_order_relaxed);
+
+        // Only touch the consumer's line if the queue looks full
+        if (free_slots(current_head) == 0) {
+            cached_tail_ = indices_->tail.load(std::memory_order_acquire);
+            if (free_slots(current_head) == 0) {
+                return nullptr;
+            }
+        }
+
+        return &slots_[current_head].value;
+    }
+
+    /**
+     * Producer: publish the slot returned by try_claim(). Release ordering
+     * makes the slot contents visible before the new head index.
+     */
+    void commit() noexcept {
+        const uint64_t current_head = indices_->head.load(std::memory_order_relaxed);
+        indices_->head.store((current_head + 1) & mask_, std::memory_order_release);
+    }
+
+    /**
+     * Producer: copying enqueue
+     */
+    bool enqueue(const T& value) noexcept {
+        T* slot = try_claim();
+        if (!slot) return false;
+
+        *slot = value;
+        commit();
+        return true;
+    }
+
+    /**
+     * Producer bulk enqueue - copies as many records as fit and publishes
+     * them with a single release store. Returns the number enqueued.
+     */
+    size_t enqueue_bulk(std::span<const T> values) noexcept {
+        const uint64_t current_head = indices_->head.load(std::memory_order_relaxed);
+
+        if (free_slots(current_head) < values.size()) {
+            cached_tail_ = indices_->tail.load(std::memory_order_acquire);
+        }
+
+        const size_t count = std::min<size_t>(free_slots(current_head), values.size());
+        for (size_t i = 0; i < count; ++i) {
+            slots_[(current_head + i) & mask_].value = values[i];
+        }
+
+        if (count > 0) {
+            indices_->head.store((current_head + count) & mask_, std::memory_order_release);
+        }
+        return count;
+    }
+
+    /**
+     * Consumer: oldest unconsumed record, processed in place.
+     * Returns nullptr if the queue is empty. The slot stays owned by the
+     * consumer until pop().
+     */
+    T* front() noexcept {
+        const uint64_t current_tail = indices_->tail.load(std::memory_order_relaxed);
+
+        // Only touch the producer's line if the queue looks empty
+        if (used_slots(current_tail) == 0) {
+            cached_head_ = indices_->head.load(std::memory_order_acquire);
+            if (used_slots(current_tail) == 0) {
+                return nullptr;
+            }
+        }
+
+        return &slots_[current_tail].value;
+    }
+
+    /**
+     * Consumer: hand the slot returned by front() back to the producer
+     */
+    void pop() noexcept {
+        const uint64_t current_tail = indices_->tail.load(std::memory_order_relaxed);
+        indices_->tail.store((current_tail + 1) & mask_, std::memory_order_release);
+    }
+
+    /**
+     * Consumer: copying dequeue
+     */
+    bool dequeue(T& value) noexcept {
+        T* slot = front();
+        if (!slot) return false;
+
+        value = *slot;
+        pop();
+        return true;
+    }
+
+    /**
+     * Consumer bulk dequeue - copies up to out.size() records and releases
+     * them with a single store. Returns the number dequeued.
+     */
+    size_t dequeue_bulk(std::span<T> out) noexcept {
+        return consume_bulk(out.size(), [&out, i = size_t{0}](const T& value) mutable {
+            out[i++] = value;
+        });
+    }
+
+    /**
+     * Consumer: run handler on up to max records in place, oldest first, then
+     * release all of them with a single store. Returns the number consumed.
+     */
+    template <typename Handler>
+    size_t consume_bulk(size_t max, Handler&& handler) noexcept {
+        const uint64_t current_tail = indices_->tail.load(std::memory_order_relaxed);
+
+        if (used_slots(current_tail) < max) {
+            cached_head_ = indices_->head.load(std::memory_order_acquire);
+        }
+
+        const size_t count = std::min<size_t>(used_slots(current_tail), max);
+        for (size_t i = 0; i < count; ++i) {
+            handler(static_cast<const T&>(slots_[(current_tail + i) & mask_].value));
+        }
+
+        if (count > 0) {
+            indices_->tail.store((current_tail + count) & mask_, std::memory_order_release);
+        }
+        return count;
+    }
+};
+
+} // namespace OrderBook
@@ -1,42 +1,32 @@
 #pragma once
 
 #include "types.hpp"
-#include <atomic>
-#include <vector>
+#include "spsc_queue.hpp"
 
 namespace OrderBook {
 
 /**
- * Single-Producer Single-Consumer Lock-Free Ring Buffer
+ * Single-Producer Single-Consumer Lock-Free Ring Buffer of Commands
  * 
- * Critical design choices for ultra-low latency:
- * 1. Power-of-2 size allows bitwise masking instead of modulo operation
- * 2. Separate cache lines for head/tail to avoid false sharing
- * 3. Acquire-Release memory ordering provides necessary synchronization without seq_cst overhead
- * 4. Producer and consumer each own their respective indices to minimize contention
+ * RING_BUFFER_SIZE 32-byte slots between the feed and the engine, two
+ * Commands per cache line and none straddling two. See SPSCQueue for the
+ * slot packing, memory ordering and index caching scheme.
+ * 
+ * Hot path usage is zero-copy on both ends:
+ *   producer: Command* slot = ring.try_claim(); fill *slot; ring.commit();
+ *   consumer: ring.consume_bulk(ENGINE_BURST_SIZE, handler) processes
+ *             commands in place and releases the whole burst at once
+ * 
+ * enqueue/dequeue and their bulk variants remain for copying callers.
  */
-class SPSCRingBuffer {
-private:
-    alignas(64) std::atomic<uint64_t> head_;  // Producer writes here, separate cache line
-    alignas(64) std::atomic<uint64_t> tail_;  // Consumer reads from here, separate cache line
-    std::vector<Command> buffer_;
-    
+class SPSCRingBuffer : public SPSCQueue<Command> {
 public:
     SPSCRingBuffer();
     
     /**
-     * Producer enqueue operation
-     * Uses release memory ordering to ensure all writes to the command
-     * are visible to the consumer before the head index is updated
-     */
-    bool enqueue(const Command& cmd) noexcept;
-    
-    /**
-     * Consumer dequeue operation  
-     * Uses acquire memory ordering to ensure all writes from producer
-     * are visible before reading the command data
+     * Ring over external storage - see SharedRing
      */
-    bool dequeue(Command& cmd) noexcept;
+    SPSCRingBuffer(SPSCQueueIndices* indices, void* slots, uint64_t capacity) noexcept;
 };
 
-} // namespace OrderBook
\ No newline at end of file
+} // namespace OrderBook
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstdint>
+#include <chrono>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace OrderBook {
+
+/**
+ * Read the raw timestamp counter.
+ * A single rdtsc is ~20 cycles versus a vDSO clock_gettime call for
+ * high_resolution_clock::now(). Falls back to steady_clock ticks on
+ * non-x86 targets.
+ */
+inline uint64_t rdtsc() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+}
+
+/**
+ * Calibrated TSC -> nanosecond conversion.
+ * 
+ * Raw TSC values are carried on the hot path (Command::producer_timestamp,
+ * engine processing start) and only converted when a duration is recorded or
+ * reported. Assumes an invariant TSC, as on all modern x86 server parts.
+ */
+class TscClock {
+public:
+    /**
+     * Measure TSC frequency against steady_clock. Runs once; call at start-up
+     * so the first conversion on the matching thread doesn't pay for it.
+     */
+    static void calibrate() noexcept;
+    
+    static uint64_t now() noexcept { return rdtsc(); }
+    
+    /**
+     * Convert a TSC delta to nanoseconds
+     */
+    static int64_t to_ns(uint64_t ticks) noexcept;
+    
+    static double ns_per_tick() noexcept;
+    static double ticks_per_ns() noexcept;
+};
+
+} // namespace OrderBook
@@ -1,7 +1,8 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
-#include <chrono>
+#include <limits>
 
 namespace OrderBook {
 
@@ -9,9 +10,30 @@ namespace OrderBook {
 constexpr uint64_t PRICE_MIN = 0;
 constexpr uint64_t PRICE_MAX = 10000;
 constexpr uint64_t PRICE_LEVELS = PRICE_MAX - PRICE_MIN + 1;
+constexpr uint64_t PRICE_WINDOW_LEVELS = 1024;  // Dense levels per book side kept around the touch
 constexpr uint64_t MAX_ORDERS = 1000000;
+constexpr uint32_t ORDER_POOL_MAX_SLABS = 2;  // Order pool grows by MAX_ORDERS-sized slabs up to this many before rejecting
+constexpr uint32_t MAX_INSTRUMENTS = 8192;    // Instrument slots per engine directory
+constexpr uint32_t MAX_ACCOUNTS = 4096;       // Trading accounts per RiskManager, ids 1..MAX_ACCOUNTS - 1
 constexpr uint64_t RING_BUFFER_SIZE = 1 << 20;  // 1M entries, power of 2
 constexpr uint64_t RING_BUFFER_MASK = RING_BUFFER_SIZE - 1;
+constexpr uint64_t ENGINE_BURST_SIZE = 64;     // Max commands drained per ring index publication
+constexpr uint64_t INGRESS_LANE_QUANTUM = 16;  // Max commands taken from one gateway lane per fan-in pass
+constexpr uint64_t OUTPUT_RING_SIZE = 1 << 16;  // Engine -> publisher event ring, power of 2
+constexpr uint64_t OUTPUT_BATCH_SIZE = 256;     // Max events formatted per publisher flush
+constexpr uint64_t RISK_FILL_RING_SIZE = 1 << 16;  // Engine -> risk stage fill ring, power of 2
+constexpr uint32_t MARKET_DEPTH_LEVELS = 20;     // Levels per side in L2 depth and snapshots
+constexpr uint64_t JOURNAL_SEGMENT_SIZE = 64ull << 20;  // Pre-allocated bytes per market data / command journal file
+constexpr uint64_t COMMAND_JOURNAL_RING_SIZE = 1 << 16;  // Engine -> journal writer command ring, power of 2
+constexpr uint64_t COMMAND_JOURNAL_BATCH_SIZE = 1024;    // Max commands written per journal thread pass
+constexpr uint32_t LATENCY_HISTOGRAM_SUB_BUCKET_BITS = 7;  // 128 linear steps per power of two - under 1% error
+constexpr uint32_t LATENCY_HISTOGRAM_MAX_VALUE_BITS = 36;  // Samples clamp at 2^36 ns (~68 s)
+constexpr uint32_t METRICS_SPAN_SAMPLE_PERIOD = 1024;  // One hot-path span timed per this many calls
+constexpr uint64_t GATEWAY_RECV_BUFFER_SIZE = 64 << 10;  // Per-session receive buffer, bytes
+constexpr uint32_t GATEWAY_MAX_SESSIONS = 1024;         // Concurrent order-entry connections per gateway
+constexpr uint32_t GATEWAY_POLL_EVENTS = 64;            // Readiness events taken per gateway poll
+constexpr uint32_t MARKET_DATA_PACKET_SIZE = 1400;      // Multicast datagram payload, under a 1500-byte MTU
+constexpr size_t CACHE_LINE_SIZE = 64;
 constexpr uint64_t TOTAL_ORDERS_TO_GENERATE = 20000000;
 
 // Enumerations
@@ -22,7 +44,11 @@ enum class Side : uint8_t {
 
 enum class CommandType : uint8_t {
     NEW,
-    CANCEL
+    CANCEL,
+    REPLACE,      // Amend a resting order to price / quantity (MultiInstrumentEngine)
+    MASS_CANCEL,  // Cancel every resting order of the account on the instrument
+    MASS_QUOTE,   // Header: quantity QUOTE_LEG commands follow, applied as one batch
+    QUOTE_LEG     // One passive level of a mass quote
 };
 
 enum class OrderType : uint8_t {
@@ -46,44 +72,99 @@ class OrderPool;
 class Book;
 class MatchingEngine;
 
+/**
+ * Orders are linked by their index in the owning OrderPool rather than by
+ * pointer - half the size, and a single pool of MAX_ORDERS always fits.
+ */
+using OrderIndex = uint32_t;
+constexpr OrderIndex NULL_ORDER = std::numeric_limits<OrderIndex>::max();
+
 // Core data structures
-struct Order {
+
+/**
+ * Hot part of a resting order: everything a sweep reads or writes, packed
+ * into 32 bytes so two orders share a cache line. Fields only touched when
+ * an order enters or leaves the book live in OrderInfo, a parallel array
+ * in the OrderPool.
+ */
+struct alignas(32) Order {
     uint64_t order_id;
+    int64_t price;
+    uint32_t quantity;           // Remaining quantity
+    
+    // Intrusive linked list, as OrderPool indices
+    OrderIndex next;
+    OrderIndex prev;
+    
     Side side;
     OrderType order_type;
-    int64_t price;
-    uint64_t quantity;
-    uint64_t original_quantity;  // For tracking partial fills
     OrderStatus status;
-    std::chrono::high_resolution_clock::time_point timestamp;
-    
-    // Intrusive linked list pointers
-    Order* next;
-    Order* prev;
     
     Order() noexcept;
 };
 
+static_assert(sizeof(Order) == 32, "Order hot fields must stay within half a cache line");
+
+/**
+ * Dense trading account id, assigned by RiskManager::logon()
+ */
+using AccountId = uint16_t;
+constexpr AccountId NO_ACCOUNT = 0;
+
+/**
+ * Cold part of an order, stored at the same index as its Order
+ */
+struct OrderInfo {
+    uint64_t original_quantity;  // For tracking partial fills
+    uint64_t timestamp;          // Raw TSC of the originating command
+    uint32_t instrument_id;      // Book the order rests in (MultiInstrumentEngine)
+    AccountId account_id;        // Owner, for post-trade risk (MultiInstrumentEngine)
+    
+    OrderInfo() noexcept;
+};
+
+/**
+ * Packed 32-byte wire command, two per cache line.
+ * 
+ * Price is in instrument ticks (tick size 1 for the default book, so ticks
+ * equal prices there) and the timestamp is a raw TSC read - see TscClock for
+ * conversion. Type, side and order type share a single byte; the account
+ * sits in what would otherwise be tail padding.
+ */
 struct Command {
-    CommandType type;
     uint64_t order_id;
-    Side side;
-    OrderType order_type;
-    int64_t price;
-    uint64_t quantity;
-    std::chrono::high_resolution_clock::time_point producer_timestamp;
+    uint64_t producer_timestamp;    // Raw TSC at enqueue
+    uint32_t instrument_id;         // 0 = engine's default instrument
+    int32_t price;                  // Price in ticks
+    uint32_t quantity;
+    CommandType type : 3;
+    Side side : 1;
+    OrderType order_type : 2;
+    AccountId account_id;           // NO_ACCOUNT unless the gateway resolved a logon
     
     Command() noexcept = default;
 };
 
+static_assert(sizeof(Command) == 32, "Command must stay a 32-byte wire record");
+
+/**
+ * FIFO queue of orders at one price. Links are indices into the OrderPool
+ * the orders came from, so linking and unlinking need that pool.
+ */
 struct PriceLevel {
     uint64_t total_volume;
-    Order* head;  // First order (oldest)
-    Order* tail;  // Last order (newest)
+    OrderIndex head;  // First order (oldest)
+    OrderIndex tail;  // Last order (newest)
+    uint32_t order_count;  // Resting orders, for L2 depth without walking the list
     
     PriceLevel() noexcept;
-    void add_order(Order* order) noexcept;
-    void remove_order(Order* order) noexcept;
+    void add_order(Order* order, OrderPool& pool) noexcept;
+    void remove_order(Order* order, OrderPool& pool) noexcept;
+    
+    /**
+     * Fill quantity of a resting order, keeping the level's volume in step
+     */
+    void fill_order(Order* order, uint64_t quantity) noexcept;
     bool empty() const noexcept;
 };
 
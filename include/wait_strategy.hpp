@@ -0,0 +1,221 @@
+#pragma once
+
+#include "types.hpp"
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+namespace OrderBook {
+
+/**
+ * Spin-wait hint: tells an SMT sibling it can have the core's execution
+ * resources and stops the pipeline flooding with speculative loads
+ */
+inline void cpu_relax() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+    _mm_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield");
+#endif
+}
+
+/**
+ * What a thread does when its ring is empty (consumer) or full (producer)
+ */
+enum class WaitPolicy : uint8_t {
+    BUSY_SPIN,    // Re-poll immediately - lowest latency, burns the core
+    SPIN_PAUSE,   // Pause between polls, backing off exponentially
+    YIELD,        // sched_yield between polls
+    SPIN_PARK,    // Pause for a while, then sleep on a futex until the peer rings
+    TIMED_PARK    // Pause for a while, then sleep for a fixed interval
+};
+
+const char* to_string(WaitPolicy policy) noexcept;
+
+/**
+ * Parse "spin", "pause", "yield", "park" or "timed". false if unknown.
+ */
+bool parse_wait_policy(const char* name, WaitPolicy& policy) noexcept;
+
+/**
+ * Tuning for one side of a ring
+ */
+struct WaitConfig {
+    WaitPolicy policy = WaitPolicy::BUSY_SPIN;
+    uint32_t spin_polls = 4096;             // Empty polls before SPIN_PARK / TIMED_PARK sleep
+    uint32_t max_pause_batch = 64;          // Pauses per poll once fully backed off
+    uint64_t timed_park_ns = 50'000;        // TIMED_PARK sleep
+    uint64_t park_backstop_ns = 10'000'000; // SPIN_PARK sleep if the peer never rings
+
+    WaitConfig() = default;
+    explicit WaitConfig(WaitPolicy wait_policy) : policy(wait_policy) {}
+};
+
+/**
+ * Futex-backed wake-up channel from one side of a ring to the other.
+ *
+ * A waiter announces itself, re-checks its condition and only then sleeps;
+ * the peer rings after publishing. Sequentially consistent fences on both
+ * sides mean either the waiter sees the new data or the peer sees the
+ * waiter, so no wake-up is lost. ring() is one fence and one load when
+ * nobody is waiting.
+ */
+class Doorbell {
+private:
+    alignas(CACHE_LINE_SIZE) std::atomic<uint32_t> epoch_;
+    std::atomic<uint32_t> waiters_;
+
+public:
+    Doorbell() noexcept : epoch_(0), waiters_(0) {}
+
+    Doorbell(const Doorbell&) = delete;
+    Doorbell& operator=(const Doorbell&) = delete;
+
+    /**
+     * Waiter: sleep for up to timeout_ns unless ready() already holds or
+     * the doorbell rings. Returns ready()'s final value.
+     */
+    template <typename Ready>
+    bool wait(Ready&& ready, uint64_t timeout_ns) noexcept {
+        waiters_.fetch_add(1, std::memory_order_seq_cst);
+        const uint32_t ticket = epoch_.load(std::memory_order_seq_cst);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        bool result = ready();
+        if (!result) {
+            sleep(ticket, timeout_ns);
+            result = ready();
+        }
+        waiters_.fetch_sub(1, std::memory_order_relaxed);
+        return result;
+    }
+
+    /**
+     * Peer: wake every waiter, after the data it waits for is published
+     */
+    void ring() noexcept {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (waiters_.load(std::memory_order_relaxed) != 0) wake();
+    }
+
+    uint32_t waiters() const noexcept { return waiters_.load(std::memory_order_relaxed); }
+
+private:
+    void sleep(uint32_t ticket, uint64_t timeout_ns) noexcept;
+    void wake() noexcept;
+};
+
+/**
+ * The two doorbells of one ring, shared by its producers and consumer
+ */
+struct WaitSignals {
+    Doorbell input_ready;   // Rung by producers, consumer sleeps on it while empty
+    Doorbell space_ready;   // Rung by the consumer, producers sleep on it while full
+};
+
+/**
+ * One thread's waiting behaviour on one side of a ring.
+ *
+ *   while (running) {
+ *       if (poll()) { wait.reset(); wait.notify(); }   // published - wake the peer
+ *       else wait.idle([&] { return work_available(); });
+ *   }
+ *
+ * idle() is called once per empty poll and escalates according to the
+ * policy. Only SPIN_PARK needs the peer to ring: notify() is a no-op for
+ * every other policy, so spinning deployments pay nothing for it. Without
+ * doorbells the parking policies fall back to timed sleeps.
+ */
+class WaitStrategy {
+private:
+    WaitConfig config_;
+    Doorbell* park_on_;   // Rung by the peer when there is work again
+    Doorbell* wake_;      // Rung by us after publishing
+    uint32_t idle_polls_;
+    uint32_t pause_batch_;
+
+    void back_off() noexcept {
+        for (uint32_t i = 0; i < pause_batch_; ++i) cpu_relax();
+        if (pause_batch_ < config_.max_pause_batch) pause_batch_ <<= 1;
+    }
+
+    void sleep_for_ns(uint64_t ns) noexcept;
+
+public:
+    explicit WaitStrategy(const WaitConfig& config, Doorbell* park_on = nullptr, Doorbell* wake = nullptr) noexcept
+        : config_(config), park_on_(park_on), wake_(wake), idle_polls_(0), pause_batch_(1) {}
+
+    /**
+     * Consumer side: sleeps on input_ready, rings space_ready
+     */
+    static WaitStrategy consumer(const WaitConfig& config, WaitSignals* signals) noexcept {
+        return WaitStrategy(config, signals ? &signals->input_ready : nullptr,
+                            signals ? &signals->space_ready : nullptr);
+    }
+
+    /**
+     * Producer side: sleeps on space_ready, rings input_ready
+     */
+    static WaitStrategy producer(const WaitConfig& config, WaitSignals* signals) noexcept {
+        return WaitStrategy(config, signals ? &signals->space_ready : nullptr,
+                            signals ? &signals->input_ready : nullptr);
+    }
+
+    /**
+     * One empty (or full) poll. ready() re-checks the condition before
+     * sleeping and must be safe to call from this thread.
+     */
+    template <typename Ready>
+    void idle(Ready&& ready) noexcept {
+        switch (config_.policy) {
+        case WaitPolicy::BUSY_SPIN:
+            return;
+        case WaitPolicy::SPIN_PAUSE:
+            back_off();
+            return;
+        case WaitPolicy::YIELD:
+            std::this_thread::yield();
+            return;
+        case WaitPolicy::SPIN_PARK:
+        case WaitPolicy::TIMED_PARK:
+            break;
+        }
+
+        if (idle_polls_ < config_.spin_polls) {
+            ++idle_polls_;
+            back_off();
+            return;
+        }
+
+        const uint64_t timeout_ns = (config_.policy == WaitPolicy::SPIN_PARK) ? config_.park_backstop_ns
+                                                                               : config_.timed_park_ns;
+        if (park_on_) {
+            park_on_->wait(ready, timeout_ns);
+        } else {
+            sleep_for_ns(timeout_ns);
+        }
+    }
+
+    /**
+     * Made progress - the next idle() starts from a fresh spin
+     */
+    void reset() noexcept {
+        idle_polls_ = 0;
+        pause_batch_ = 1;
+    }
+
+    /**
+     * Just published: wake the peer if it may be parked
+     */
+    void notify() noexcept {
+        if (config_.policy == WaitPolicy::SPIN_PARK && wake_) wake_->ring();
+    }
+
+    const WaitConfig& config() const noexcept { return config_; }
+};
+
+} // namespace OrderBook
@@ -374,8 +374,10 @@ private:
     // Order tracking for cancellations - maps order_id to Order*
     std::vector<Order*> order_map_;
     
-    // Statistics
+    // Statistics - latency ring keeps the most recent TRADE_LATENCY_SAMPLES trades
+    static constexpr size_t TRADE_LATENCY_SAMPLES = 1 << 20;
     std::vector<long long> trade_latencies_ns_;
+    uint64_t trade_latency_samples_;
     uint64_t orders_processed_;
     uint64_t trades_executed_;
     uint64_t orders_rejected_;
@@ -385,13 +387,11 @@ private:
 public:
     MatchingEngine(SPSCRingBuffer* ring_buffer) 
         : order_pool_(MAX_ORDERS), ring_buffer_(ring_buffer), 
-          order_map_(MAX_ORDERS, nullptr), orders_processed_(0),
+          order_map_(MAX_ORDERS, nullptr), trade_latencies_ns_(TRADE_LATENCY_SAMPLES),
+          trade_latency_samples_(0), orders_processed_(0),
           trades_executed_(0), orders_rejected_(0),
           total_buy_quantity_matched_(0),
-          total_sell_quantity_matched_(0) {
-        
-        trade_latencies_ns_.reserve(TOTAL_ORDERS_TO_GENERATE / 10);  // Estimate 10% will trade
-    }
+          total_sell_quantity_matched_(0) {}
     
     /*
      * Main processing loop - runs on consumer thread
@@ -420,7 +420,10 @@ public:
     uint64_t orders_processed() const noexcept { return orders_processed_; }
     uint64_t trades_executed() const noexcept { return trades_executed_; }
     uint64_t orders_rejected() const noexcept { return orders_rejected_; }
-    const std::vector<long long>& trade_latencies() const noexcept { return trade_latencies_ns_; }
+    std::vector<long long> trade_latencies() const {
+        const size_t filled = std::min<uint64_t>(trade_latency_samples_, TRADE_LATENCY_SAMPLES);
+        return std::vector<long long>(trade_latencies_ns_.begin(), trade_latencies_ns_.begin() + filled);
+    }
     uint64_t total_buy_quantity_matched() const noexcept { return total_buy_quantity_matched_; }
     uint64_t total_sell_quantity_matched() const noexcept { return total_sell_quantity_matched_; }
     
@@ -577,7 +580,8 @@ private:
         const auto latency_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
             std::chrono::high_resolution_clock::now() - processing_start).count();
 
-        trade_latencies_ns_.push_back(latency_ns);
+        // Overwrite the oldest sample - no allocation on the trade path
+        trade_latencies_ns_[trade_latency_samples_++ & (TRADE_LATENCY_SAMPLES - 1)] = latency_ns;
         
         // Update statistics
         ++trades_executed_;
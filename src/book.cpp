@@ -1,80 +1,203 @@
 #include "book.hpp"
+#include "engine_snapshot.hpp"
 
 namespace OrderBook {
 
-Book::Book() 
-    : bid_levels_(PRICE_LEVELS), ask_levels_(PRICE_LEVELS), 
-      best_bid_price_(-1), best_ask_price_(-1) {}
+Book::Book(OrderPool& orders)
+    : Book(orders, LadderConfig()) {}
 
-void Book::add_order(Order* order) noexcept {
-    const uint64_t price_index = static_cast<uint64_t>(order->price - PRICE_MIN);
-    
+Book::Book(OrderPool& orders, const LadderConfig& config)
+    : orders_(orders), bids_(config), asks_(config),
+      best_bid_price_(-1), best_ask_price_(-1),
+      batching_(false), best_bid_stale_(false), best_ask_stale_(false) {}
+
+Book::Book(OrderPool& orders, const Instrument& instrument, uint64_t window_levels)
+    : Book(orders, LadderConfig(instrument.price_min, instrument.price_max,
+                                instrument.tick_size, window_levels)) {}
+
+bool Book::add_order(Order* order) noexcept {
+    uint64_t tick;
     if (order->side == Side::BUY) {
-        bid_levels_[price_index].add_order(order);
+        if (!bids_.to_tick(order->price, tick)) return false;
+
+        bids_.add_order(tick, order, orders_);
         if (best_bid_price_ < order->price) {
             best_bid_price_ = order->price;
+            // Keep the dense window on the touch
+            if (!bids_.in_window(tick)) bids_.recenter(tick);
         }
     } else {
-        ask_levels_[price_index].add_order(order);
+        if (!asks_.to_tick(order->price, tick)) return false;
+
+        asks_.add_order(tick, order, orders_);
         if (best_ask_price_ == -1 || best_ask_price_ > order->price) {
             best_ask_price_ = order->price;
+            // Keep the dense window on the touch
+            if (!asks_.in_window(tick)) asks_.recenter(tick);
         }
     }
+    return true;
 }
 
 void Book::remove_order(Order* order) noexcept {
-    const uint64_t price_index = static_cast<uint64_t>(order->price - PRICE_MIN);
-    
+    uint64_t tick;
     if (order->side == Side::BUY) {
-        bid_levels_[price_index].remove_order(order);
+        if (!bids_.to_tick(order->price, tick)) return;
+
         // Update best bid if this level is now empty and was the best
-        if (bid_levels_[price_index].empty() && order->price == best_bid_price_) {
-            update_best_bid();
+        if (bids_.remove_order(tick, order, orders_) && order->price == best_bid_price_) {
+            if (batching_) {
+                best_bid_stale_ = true;
+            } else {
+                update_best_bid();
+            }
         }
     } else {
-        ask_levels_[price_index].remove_order(order);
+        if (!asks_.to_tick(order->price, tick)) return;
+
         // Update best ask if this level is now empty and was the best
-        if (ask_levels_[price_index].empty() && order->price == best_ask_price_) {
-            update_best_ask();
+        if (asks_.remove_order(tick, order, orders_) && order->price == best_ask_price_) {
+            if (batching_) {
+                best_ask_stale_ = true;
+            } else {
+                update_best_ask();
+            }
         }
     }
 }
 
+void Book::fill_order(PriceLevel* level, Order* order, uint64_t quantity) noexcept {
+    ((order->side == Side::BUY) ? bids_ : asks_).fill_order(level, order, quantity);
+}
+
+void Book::reduce_order(Order* order, uint64_t quantity) noexcept {
+    PriceLevel* level = get_price_level(order->price, order->side);
+    if (level && quantity < order->quantity) fill_order(level, order, quantity);
+}
+
+void Book::begin_batch() noexcept {
+    batching_ = true;
+}
+
+void Book::end_batch() noexcept {
+    batching_ = false;
+
+    // Adds never leave an occupied level beyond the best, so searching on from it is enough
+    if (best_bid_stale_) {
+        best_bid_stale_ = false;
+        update_best_bid();
+    }
+    if (best_ask_stale_) {
+        best_ask_stale_ = false;
+        update_best_ask();
+    }
+}
+
+uint64_t Book::ask_volume_through(int64_t price, uint64_t enough) const noexcept {
+    return asks_.volume_at_or_below(price, enough);
+}
+
+uint64_t Book::bid_volume_through(int64_t price, uint64_t enough) const noexcept {
+    return bids_.volume_at_or_above(price, enough);
+}
+
 PriceLevel* Book::get_price_level(int64_t price, Side side) noexcept {
-    if (price < static_cast<int64_t>(PRICE_MIN) || price > static_cast<int64_t>(PRICE_MAX)) return nullptr;
-    
-    const uint64_t price_index = static_cast<uint64_t>(price - PRICE_MIN);
-    return (side == Side::BUY) ? &bid_levels_[price_index] : &ask_levels_[price_index];
+    PriceLadder& ladder = (side == Side::BUY) ? bids_ : asks_;
+
+    uint64_t tick;
+    if (!ladder.to_tick(price, tick)) return nullptr;
+    return ladder.find(tick);
+}
+
+const PriceLevel* Book::get_price_level(int64_t price, Side side) const noexcept {
+    const PriceLadder& ladder = (side == Side::BUY) ? bids_ : asks_;
+
+    uint64_t tick;
+    if (!ladder.to_tick(price, tick)) return nullptr;
+    return ladder.find(tick);
 }
 
-int64_t Book::best_bid() const noexcept { 
-    return best_bid_price_; 
+int64_t Book::best_bid() const noexcept {
+    return best_bid_price_;
 }
 
-int64_t Book::best_ask() const noexcept { 
-    return best_ask_price_; 
+int64_t Book::best_ask() const noexcept {
+    return best_ask_price_;
+}
+
+int64_t Book::next_ask_price(int64_t price) const noexcept {
+    uint64_t tick;
+    if (!asks_.to_tick(price, tick)) return -1;
+
+    const uint64_t next = asks_.next_up(tick + 1);
+    return (next == PriceLadder::NO_TICK) ? -1 : asks_.to_price(next);
+}
+
+int64_t Book::next_bid_price(int64_t price) const noexcept {
+    uint64_t tick;
+    if (!bids_.to_tick(price, tick) || tick == 0) return -1;
+
+    const uint64_t next = bids_.next_down(tick - 1);
+    return (next == PriceLadder::NO_TICK) ? -1 : bids_.to_price(next);
+}
+
+const PriceLadder& Book::bid_ladder() const noexcept {
+    return bids_;
+}
+
+const PriceLadder& Book::ask_ladder() const noexcept {
+    return asks_;
 }
 
 void Book::update_best_bid() noexcept {
-    best_bid_price_ = -1;
-    for (int64_t price = static_cast<int64_t>(PRICE_MAX); price >= static_cast<int64_t>(PRICE_MIN); --price) {
-        const uint64_t price_index = static_cast<uint64_t>(price - PRICE_MIN);
-        if (!bid_levels_[price_index].empty()) {
-            best_bid_price_ = price;
-            break;
-        }
+    // Old best level is empty now, so searching from it finds the next one down
+    uint64_t tick;
+    if (best_bid_price_ == -1 || !bids_.to_tick(best_bid_price_, tick)) {
+        tick = bids_.tick_count() - 1;
+    }
+    tick = bids_.next_down(tick);
+    if (tick == PriceLadder::NO_TICK) {
+        best_bid_price_ = -1;
+        return;
     }
+
+    best_bid_price_ = bids_.to_price(tick);
+    if (!bids_.in_window(tick)) bids_.recenter(tick);
 }
 
 void Book::update_best_ask() noexcept {
-    best_ask_price_ = -1;
-    for (int64_t price = static_cast<int64_t>(PRICE_MIN); price <= static_cast<int64_t>(PRICE_MAX); ++price) {
-        const uint64_t price_index = static_cast<uint64_t>(price - PRICE_MIN);
-        if (!ask_levels_[price_index].empty()) {
-            best_ask_price_ = price;
-            break;
-        }
+    // Old best level is empty now, so searching from it finds the next one up
+    uint64_t tick;
+    if (best_ask_price_ == -1 || !asks_.to_tick(best_ask_price_, tick)) {
+        tick = 0;
+    }
+    tick = asks_.next_up(tick);
+    if (tick == PriceLadder::NO_TICK) {
+        best_ask_price_ = -1;
+        return;
     }
+
+    best_ask_price_ = asks_.to_price(tick);
+    if (!asks_.in_window(tick)) asks_.recenter(tick);
+}
+
+void Book::save(SnapshotWriter& out) const noexcept {
+    out.put(best_bid_price_);
+    out.put(best_ask_price_);
+    bids_.save(out);
+    asks_.save(out);
+}
+
+bool Book::load(SnapshotReader& in) noexcept {
+    best_bid_price_ = -1;
+    best_ask_price_ = -1;
+
+    int64_t best_bid = -1, best_ask = -1;
+    if (!in.get(best_bid) || !in.get(best_ask) || !bids_.load(in) || !asks_.load(in)) return false;
+
+    best_bid_price_ = best_bid;
+    best_ask_price_ = best_ask;
+    return true;
 }
 
-} // namespace OrderBook
\ No newline at end of file
+} // namespace OrderBook
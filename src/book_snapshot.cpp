@@ -0,0 +1,76 @@
+#include "book_snapshot.hpp"
+#include "book.hpp"
+#include "wait_strategy.hpp"
+#include <cstring>
+
+namespace OrderBook {
+
+void BookSnapshot::publish(const Level2Snapshot& snapshot) noexcept {
+    BookTop top;
+    if (!snapshot.bids.empty()) {
+        top.bid_price = snapshot.bids[0].price;
+        top.bid_quantity = snapshot.bids[0].quantity;
+    }
+    if (!snapshot.asks.empty()) {
+        top.ask_price = snapshot.asks[0].price;
+        top.ask_quantity = snapshot.asks[0].quantity;
+    }
+
+    uint64_t top_words[TOP_WORDS];
+    uint64_t depth_words[DEPTH_WORDS];
+    std::memcpy(top_words, &top, sizeof(top_words));
+    std::memcpy(depth_words, &snapshot, sizeof(depth_words));
+
+    const uint64_t sequence = sequence_.load(std::memory_order_relaxed);
+    sequence_.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for (size_t i = 0; i < TOP_WORDS; ++i) top_[i].store(top_words[i], std::memory_order_relaxed);
+    for (size_t i = 0; i < DEPTH_WORDS; ++i) depth_[i].store(depth_words[i], std::memory_order_relaxed);
+    sequence_.store(sequence + 2, std::memory_order_release);
+}
+
+void BookSnapshot::publish(const Book& book, uint32_t instrument_id) noexcept {
+    Level2Snapshot snapshot(instrument_id);
+    for (int64_t price = book.best_bid(); price != -1 && snapshot.bids.size() < DepthLevels::capacity();
+         price = book.next_bid_price(price)) {
+        const PriceLevel* level = book.get_price_level(price, Side::BUY);
+        snapshot.bids.emplace_back(price, level->total_volume, level->order_count);
+    }
+    for (int64_t price = book.best_ask(); price != -1 && snapshot.asks.size() < DepthLevels::capacity();
+         price = book.next_ask_price(price)) {
+        const PriceLevel* level = book.get_price_level(price, Side::SELL);
+        snapshot.asks.emplace_back(price, level->total_volume, level->order_count);
+    }
+    publish(snapshot);
+}
+
+template <size_t Words>
+bool BookSnapshot::read_words(const std::array<std::atomic<uint64_t>, Words>& from, uint64_t* to) const noexcept {
+    while (true) {
+        const uint64_t before = sequence_.load(std::memory_order_acquire);
+        if (before == 0) return false;
+        if (before & 1) {
+            cpu_relax();  // Writer mid-copy
+            continue;
+        }
+        for (size_t i = 0; i < Words; ++i) to[i] = from[i].load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (sequence_.load(std::memory_order_relaxed) == before) return true;
+    }
+}
+
+bool BookSnapshot::read(Level2Snapshot& snapshot) const noexcept {
+    uint64_t words[DEPTH_WORDS];
+    if (!read_words(depth_, words)) return false;
+    std::memcpy(static_cast<void*>(&snapshot), words, sizeof(words));
+    return true;
+}
+
+bool BookSnapshot::read_top(BookTop& top) const noexcept {
+    uint64_t words[TOP_WORDS];
+    if (!read_words(top_, words)) return false;
+    std::memcpy(&top, words, sizeof(words));
+    return true;
+}
+
+} // namespace OrderBook
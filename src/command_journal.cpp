@@ -0,0 +1,303 @@
+#include "command_journal.hpp"
+#include "market_data_journal.hpp"
+#include "numa_placement.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace OrderBook {
+
+namespace {
+
+constexpr char COMMAND_JOURNAL_MAGIC[8] = {'O', 'B', 'C', 'M', 'J', 'N', 'L', '\0'};
+constexpr uint32_t COMMAND_JOURNAL_VERSION = 1;
+
+} // namespace
+
+// Journal writer
+
+CommandJournal::CommandJournal(const std::string& base_path, uint64_t segment_bytes)
+    : base_path_(base_path),
+      segment_bytes_(std::max<uint64_t>(segment_bytes, sizeof(JournalSegmentHeader) + sizeof(CommandJournalRecord))),
+      segment_index_(0), fd_(-1), map_(nullptr), write_offset_(0),
+      segment_records_(0), records_written_(0), last_sequence_(0) {
+    open_segment(0);
+}
+
+CommandJournal::~CommandJournal() {
+    close();
+}
+
+std::string CommandJournal::segment_path(const std::string& base_path, uint64_t index) {
+    char suffix[32];
+    std::snprintf(suffix, sizeof(suffix), ".%06llu.cmj", static_cast<unsigned long long>(index));
+    return base_path + suffix;
+}
+
+bool CommandJournal::open_segment(uint64_t index) noexcept {
+    const std::string path = segment_path(base_path_, index);
+    fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd_ < 0) return false;
+
+    // Reserve the blocks up front so appends never hit ENOSPC or extend the file
+    if (posix_fallocate(fd_, 0, static_cast<off_t>(segment_bytes_)) != 0 &&
+        ftruncate(fd_, static_cast<off_t>(segment_bytes_)) != 0) {
+        ::close(fd_);
+        fd_ = -1;
+        return false;
+    }
+
+    // Pre-fault the mapping so appends don't take page faults
+    void* map = mmap(nullptr, segment_bytes_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, 0);
+    if (map == MAP_FAILED) {
+        ::close(fd_);
+        fd_ = -1;
+        return false;
+    }
+    map_ = static_cast<char*>(map);
+    madvise(map_, segment_bytes_, MADV_SEQUENTIAL);
+
+    JournalSegmentHeader header{};
+    std::memcpy(header.magic, COMMAND_JOURNAL_MAGIC, sizeof(header.magic));
+    header.version = COMMAND_JOURNAL_VERSION;
+    header.record_size = sizeof(CommandJournalRecord);
+    header.segment_index = index;
+    std::memcpy(map_, &header, sizeof(header));
+
+    segment_index_ = index;
+    write_offset_ = sizeof(JournalSegmentHeader);
+    segment_records_ = 0;
+    return true;
+}
+
+void CommandJournal::close_segment() noexcept {
+    if (!map_) return;
+
+    // Record count in the header, then trim the unused pre-allocated tail
+    auto* header = reinterpret_cast<JournalSegmentHeader*>(map_);
+    header->record_count = segment_records_;
+
+    munmap(map_, segment_bytes_);
+    map_ = nullptr;
+    if (ftruncate(fd_, static_cast<off_t>(write_offset_)) != 0) {
+        // Tail stays zero-filled - readers stop at the first zero sequence
+    }
+    ::close(fd_);
+    fd_ = -1;
+}
+
+bool CommandJournal::is_open() const noexcept {
+    return map_ != nullptr;
+}
+
+void CommandJournal::append(const CommandJournalRecord& record) noexcept {
+    if (!map_) return;
+
+    if (write_offset_ + sizeof(CommandJournalRecord) > segment_bytes_) {
+        close_segment();
+        if (!open_segment(segment_index_ + 1)) return;
+    }
+
+    std::memcpy(map_ + write_offset_, &record, sizeof(CommandJournalRecord));
+    write_offset_ += sizeof(CommandJournalRecord);
+    ++segment_records_;
+    ++records_written_;
+    last_sequence_ = record.sequence;
+}
+
+void CommandJournal::sync() noexcept {
+    if (map_) msync(map_, write_offset_, MS_ASYNC);
+}
+
+void CommandJournal::close() noexcept {
+    close_segment();
+}
+
+uint64_t CommandJournal::records_written() const noexcept {
+    return records_written_;
+}
+
+uint64_t CommandJournal::segment_count() const noexcept {
+    return segment_index_ + 1;
+}
+
+uint64_t CommandJournal::last_sequence() const noexcept {
+    return last_sequence_;
+}
+
+// Journal reader
+
+CommandJournalReader::CommandJournalReader(const std::string& base_path)
+    : base_path_(base_path), segment_index_(0), fd_(-1), map_(nullptr),
+      map_size_(0), read_offset_(0) {
+    open_segment(0);
+}
+
+CommandJournalReader::~CommandJournalReader() {
+    close_segment();
+}
+
+bool CommandJournalReader::open_segment(uint64_t index) noexcept {
+    const std::string path = CommandJournal::segment_path(base_path_, index);
+    fd_ = ::open(path.c_str(), O_RDONLY);
+    if (fd_ < 0) return false;
+
+    struct stat st;
+    if (fstat(fd_, &st) != 0 || static_cast<uint64_t>(st.st_size) < sizeof(JournalSegmentHeader)) {
+        close_segment();
+        return false;
+    }
+
+    map_size_ = static_cast<uint64_t>(st.st_size);
+    // Not pre-faulted: recovery skips whole segments the snapshot covers
+    void* map = mmap(nullptr, map_size_, PROT_READ, MAP_PRIVATE, fd_, 0);
+    if (map == MAP_FAILED) {
+        map_ = nullptr;
+        close_segment();
+        return false;
+    }
+    map_ = static_cast<const char*>(map);
+    madvise(const_cast<char*>(map_), map_size_, MADV_SEQUENTIAL);
+
+    const auto* header = reinterpret_cast<const JournalSegmentHeader*>(map_);
+    if (std::memcmp(header->magic, COMMAND_JOURNAL_MAGIC, sizeof(header->magic)) != 0 ||
+        header->version != COMMAND_JOURNAL_VERSION || header->record_size != sizeof(CommandJournalRecord)) {
+        close_segment();
+        return false;
+    }
+
+    segment_index_ = index;
+    read_offset_ = sizeof(JournalSegmentHeader);
+    return true;
+}
+
+void CommandJournalReader::close_segment() noexcept {
+    if (map_) munmap(const_cast<char*>(map_), map_size_);
+    if (fd_ >= 0) ::close(fd_);
+    map_ = nullptr;
+    fd_ = -1;
+    map_size_ = 0;
+}
+
+bool CommandJournalReader::next(CommandJournalRecord& record) noexcept {
+    while (map_) {
+        if (read_offset_ + sizeof(CommandJournalRecord) <= map_size_) {
+            std::memcpy(&record, map_ + read_offset_, sizeof(CommandJournalRecord));
+            if (record.sequence != 0) {
+                read_offset_ += sizeof(CommandJournalRecord);
+                return true;
+            }
+        }
+
+        // End of this segment (or its unwritten tail) - move on to the next one
+        const uint64_t next_index = segment_index_ + 1;
+        close_segment();
+        if (!open_segment(next_index)) return false;
+    }
+    return false;
+}
+
+void CommandJournalReader::skip_to(uint64_t sequence) noexcept {
+    constexpr uint64_t record_size = sizeof(CommandJournalRecord);
+
+    while (map_) {
+        if (read_offset_ + record_size > map_size_) {
+            const uint64_t next_index = segment_index_ + 1;
+            close_segment();
+            open_segment(next_index);
+            continue;
+        }
+
+        CommandJournalRecord record;
+        std::memcpy(&record, map_ + read_offset_, record_size);
+        if (record.sequence == 0 || record.sequence >= sequence) return;
+
+        // Where sequence would sit if this segment runs on without a break
+        const uint64_t target = read_offset_ + (sequence - record.sequence) * record_size;
+        if (target + record_size <= map_size_) {
+            CommandJournalRecord landed;
+            std::memcpy(&landed, map_ + target, record_size);
+            if (landed.sequence == sequence) {
+                read_offset_ = target;
+                return;
+            }
+            // Unwritten tail or a break in the sequence - walk it
+            read_offset_ += record_size;
+            continue;
+        }
+
+        // Sequence lies beyond this segment
+        const uint64_t next_index = segment_index_ + 1;
+        close_segment();
+        open_segment(next_index);
+    }
+}
+
+// Journal stage
+
+JournalStage::JournalStage(const std::string& base_path, uint64_t capacity, uint64_t segment_bytes)
+    : ring_(capacity), journal_(base_path, segment_bytes), running_(false),
+      recorded_sequence_(0), producer_stalls_(0), journaled_sequence_(0) {}
+
+JournalStage::~JournalStage() {
+    stop();
+    // Not started, or driven by hand: whatever is still queued goes out now
+    while (drain() > 0) {}
+    journal_.close();
+}
+
+bool JournalStage::is_open() const noexcept {
+    return journal_.is_open();
+}
+
+void JournalStage::start(int cpu) {
+    if (running_.exchange(true)) return;
+    writer_thread_ = std::thread([this, cpu] {
+        if (cpu >= 0) NumaPlacement::pin_current_thread(cpu);
+        run();
+    });
+}
+
+void JournalStage::stop() {
+    if (!running_.exchange(false)) return;
+    writer_thread_.join();
+    journal_.close();
+}
+
+void JournalStage::run() {
+    bool dirty = false;
+
+    // Keep draining after stop() is requested until the ring is empty
+    while (true) {
+        const bool stopping = !running_.load(std::memory_order_acquire);
+        if (drain() > 0) {
+            dirty = true;
+            continue;
+        }
+        if (stopping) break;
+
+        // Caught up - start write-back of what we have while the engine is quiet
+        if (dirty) {
+            journal_.sync();
+            dirty = false;
+        }
+        std::this_thread::yield();  // Idle - the writer is off the critical path
+    }
+}
+
+size_t JournalStage::drain() noexcept {
+    const size_t count = ring_.consume_bulk(COMMAND_JOURNAL_BATCH_SIZE, [this](const CommandJournalRecord& record) {
+        journal_.append(record);
+    });
+
+    if (count > 0) {
+        journaled_sequence_.store(journal_.last_sequence(), std::memory_order_release);
+    }
+    return count;
+}
+
+} // namespace OrderBook
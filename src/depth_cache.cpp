@@ -0,0 +1,85 @@
+#include "depth_cache.hpp"
+#include <algorithm>
+
+namespace OrderBook {
+
+DepthCache::DepthCache(const Book& book) noexcept
+    : book_(book) {
+    rebuild();
+}
+
+bool DepthCache::on_level_change(Side side, int64_t price) noexcept {
+    DepthSide& depth = (side == Side::BUY) ? bids_ : asks_;
+    auto* levels = depth.levels.data();
+
+    // Bids are cached highest first, asks lowest first - skip strictly better levels
+    uint32_t pos = 0;
+    if (side == Side::BUY) {
+        while (pos < depth.count && levels[pos].price > price) ++pos;
+    } else {
+        while (pos < depth.count && levels[pos].price < price) ++pos;
+    }
+
+    const PriceLevel* level = book_.get_price_level(price, side);
+    const bool present = level && !level->empty();
+
+    if (pos < depth.count && levels[pos].price == price) {
+        if (present) {
+            levels[pos].quantity = level->total_volume;
+            levels[pos].order_count = level->order_count;
+        } else {
+            // Level emptied - close the gap and pull the next level in from the book
+            std::copy(levels + pos + 1, levels + depth.count, levels + pos);
+            --depth.count;
+            refill(depth, side);
+        }
+        return true;
+    }
+
+    // New level - only visible if it lands inside the cached depth
+    if (!present || pos >= MARKET_DEPTH_LEVELS) return false;
+
+    const uint32_t last = std::min<uint32_t>(depth.count, MARKET_DEPTH_LEVELS - 1);
+    std::copy_backward(levels + pos, levels + last, levels + last + 1);
+    levels[pos] = PriceLevelData(price, level->total_volume, level->order_count);
+    depth.count = last + 1;
+    return true;
+}
+
+void DepthCache::refill(DepthSide& depth, Side side) noexcept {
+    while (depth.count < MARKET_DEPTH_LEVELS) {
+        int64_t next;
+        if (depth.count == 0) {
+            next = (side == Side::BUY) ? book_.best_bid() : book_.best_ask();
+        } else {
+            const int64_t worst = depth.levels[depth.count - 1].price;
+            next = (side == Side::BUY) ? book_.next_bid_price(worst) : book_.next_ask_price(worst);
+        }
+        if (next == -1) return;
+
+        const PriceLevel* level = book_.get_price_level(next, side);
+        depth.levels[depth.count++] = PriceLevelData(next, level->total_volume, level->order_count);
+    }
+}
+
+void DepthCache::rebuild() noexcept {
+    bids_.count = 0;
+    asks_.count = 0;
+    refill(bids_, Side::BUY);
+    refill(asks_, Side::SELL);
+}
+
+std::span<const PriceLevelData> DepthCache::bids() const noexcept {
+    return {bids_.levels.data(), bids_.count};
+}
+
+std::span<const PriceLevelData> DepthCache::asks() const noexcept {
+    return {asks_.levels.data(), asks_.count};
+}
+
+void DepthCache::copy_into(Level2Snapshot& snapshot) const {
+    snapshot.bids.assign(bids_.levels.data(), bids_.levels.data() + bids_.count);
+    snapshot.asks.assign(asks_.levels.data(), asks_.levels.data() + asks_.count);
+}
+
+} // namespace OrderBook
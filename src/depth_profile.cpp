@@ -0,0 +1,182 @@
+#include "depth_profile.hpp"
+#include "book_snapshot.hpp"
+#include <algorithm>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+namespace OrderBook {
+
+namespace {
+
+void accumulate_scalar(DepthColumns& columns) noexcept {
+    uint64_t quantity = 0;
+    double notional = 0.0;
+    for (size_t i = 0; i < DEPTH_PROFILE_CAPACITY; ++i) {
+        quantity += columns.quantities[i];
+        notional += static_cast<double>(columns.prices[i]) * static_cast<double>(columns.quantities[i]);
+        columns.cumulative_quantity[i] = quantity;
+        columns.cumulative_notional[i] = notional;
+    }
+}
+
+/**
+ * Levels whose running quantity is still below quantity
+ */
+size_t count_below_scalar(const DepthColumns& columns, uint64_t quantity) noexcept {
+    const auto& cumulative = columns.cumulative_quantity;
+    return std::lower_bound(cumulative.begin(), cumulative.end(), quantity) - cumulative.begin();
+}
+
+#if defined(__x86_64__)
+
+/**
+ * Inclusive prefix sum across the four lanes: two shifted adds
+ */
+__attribute__((target("avx2"))) inline __m256i prefix_epi64(__m256i x) noexcept {
+    const __m256i zero = _mm256_setzero_si256();
+    x = _mm256_add_epi64(x, _mm256_blend_epi32(_mm256_permute4x64_epi64(x, _MM_SHUFFLE(2, 1, 0, 0)), zero, 0x03));
+    return _mm256_add_epi64(x, _mm256_blend_epi32(_mm256_permute4x64_epi64(x, _MM_SHUFFLE(1, 0, 0, 0)), zero, 0x0F));
+}
+
+__attribute__((target("avx2"))) inline __m256d prefix_pd(__m256d x) noexcept {
+    const __m256d zero = _mm256_setzero_pd();
+    x = _mm256_add_pd(x, _mm256_blend_pd(_mm256_permute4x64_pd(x, _MM_SHUFFLE(2, 1, 0, 0)), zero, 0x1));
+    return _mm256_add_pd(x, _mm256_blend_pd(_mm256_permute4x64_pd(x, _MM_SHUFFLE(1, 0, 0, 0)), zero, 0x3));
+}
+
+/**
+ * int64 lanes to double, exact for |x| < 2^51: bias into the mantissa of 1.5 * 2^52
+ */
+__attribute__((target("avx2"))) inline __m256d to_double(__m256i x) noexcept {
+    const __m256i bias = _mm256_set1_epi64x(0x4338000000000000);
+    return _mm256_sub_pd(_mm256_castsi256_pd(_mm256_add_epi64(x, bias)), _mm256_set1_pd(0x1.8p52));
+}
+
+__attribute__((target("avx2"))) void accumulate_avx2(DepthColumns& columns) noexcept {
+    __m256i quantity_carry = _mm256_setzero_si256();
+    __m256d notional_carry = _mm256_setzero_pd();
+    for (size_t i = 0; i < DEPTH_PROFILE_CAPACITY; i += 4) {
+        const __m256i quantities = _mm256_load_si256(reinterpret_cast<const __m256i*>(&columns.quantities[i]));
+        const __m256i prices = _mm256_load_si256(reinterpret_cast<const __m256i*>(&columns.prices[i]));
+
+        const __m256i quantity = _mm256_add_epi64(prefix_epi64(quantities), quantity_carry);
+        const __m256d notional = _mm256_add_pd(prefix_pd(_mm256_mul_pd(to_double(prices), to_double(quantities))),
+                                               notional_carry);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(&columns.cumulative_quantity[i]), quantity);
+        _mm256_store_pd(&columns.cumulative_notional[i], notional);
+
+        quantity_carry = _mm256_permute4x64_epi64(quantity, _MM_SHUFFLE(3, 3, 3, 3));
+        notional_carry = _mm256_permute4x64_pd(notional, _MM_SHUFFLE(3, 3, 3, 3));
+    }
+}
+
+/**
+ * Running totals are ascending, so one compare per lane and a popcount.
+ * Signed compare - totals stay below 2^63.
+ */
+__attribute__((target("avx2"))) size_t count_below_avx2(const DepthColumns& columns, uint64_t quantity) noexcept {
+    const __m256i target = _mm256_set1_epi64x(static_cast<int64_t>(quantity));
+    size_t below = 0;
+    for (size_t i = 0; i < DEPTH_PROFILE_CAPACITY; i += 4) {
+        const __m256i cumulative =
+            _mm256_load_si256(reinterpret_cast<const __m256i*>(&columns.cumulative_quantity[i]));
+        const int mask = _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(target, cumulative)));
+        below += static_cast<size_t>(__builtin_popcount(static_cast<unsigned>(mask)));
+    }
+    return below;
+}
+
+#endif
+
+} // namespace
+
+DepthProfile::DepthProfile(DepthKernel kernel) noexcept
+    : bids_{}, asks_{}, instrument_id_(0), version_(0), kernel_(kernel) {
+#if !defined(__x86_64__)
+    kernel_ = DepthKernel::SCALAR;
+#endif
+}
+
+DepthKernel DepthProfile::best_kernel() noexcept {
+#if defined(__x86_64__)
+    return __builtin_cpu_supports("avx2") ? DepthKernel::AVX2 : DepthKernel::SCALAR;
+#else
+    return DepthKernel::SCALAR;
+#endif
+}
+
+void DepthProfile::load_side(const DepthLevels& levels, DepthColumns& columns) noexcept {
+    // Transpose into the columns, zeroing the lanes past the last level
+    columns.count = static_cast<uint32_t>(levels.size());
+    for (size_t i = 0; i < DEPTH_PROFILE_CAPACITY; ++i) {
+        const bool present = i < levels.size();
+        columns.prices[i] = present ? levels[i].price : 0;
+        columns.quantities[i] = present ? levels[i].quantity : 0;
+        columns.order_counts[i] = present ? levels[i].order_count : 0;
+    }
+
+#if defined(__x86_64__)
+    if (kernel_ == DepthKernel::AVX2) {
+        accumulate_avx2(columns);
+        return;
+    }
+#endif
+    accumulate_scalar(columns);
+}
+
+void DepthProfile::load(const Level2Snapshot& snapshot) noexcept {
+    instrument_id_ = snapshot.instrument_id;
+    load_side(snapshot.bids, bids_);
+    load_side(snapshot.asks, asks_);
+}
+
+bool DepthProfile::refresh(const BookSnapshot& snapshot) noexcept {
+    const uint64_t version = snapshot.version();
+    if (version == version_) return false;
+
+    Level2Snapshot depth(0);
+    if (!snapshot.read(depth)) return false;
+    load(depth);
+    version_ = version;
+    return true;
+}
+
+uint64_t DepthProfile::volume(Side side, size_t levels) const noexcept {
+    const DepthColumns& columns = this->side(side);
+    const size_t last = std::min<size_t>(levels, columns.count);
+    return last > 0 ? columns.cumulative_quantity[last - 1] : 0;
+}
+
+size_t DepthProfile::levels_to_fill(Side side, uint64_t quantity) const noexcept {
+    const DepthColumns& columns = this->side(side);
+    if (quantity == 0 || columns.count == 0 || quantity > columns.cumulative_quantity[columns.count - 1]) return 0;
+
+#if defined(__x86_64__)
+    if (kernel_ == DepthKernel::AVX2) return count_below_avx2(columns, quantity) + 1;
+#endif
+    return count_below_scalar(columns, quantity) + 1;
+}
+
+bool DepthProfile::vwap(Side side, uint64_t quantity, double& price) const noexcept {
+    const size_t levels = levels_to_fill(side, quantity);
+    if (levels == 0) return false;
+
+    // Whole levels before the last, then the part of the last one needed
+    const DepthColumns& columns = this->side(side);
+    const size_t last = levels - 1;
+    const uint64_t filled = last > 0 ? columns.cumulative_quantity[last - 1] : 0;
+    const double notional = last > 0 ? columns.cumulative_notional[last - 1] : 0.0;
+    price = (notional + static_cast<double>(quantity - filled) * static_cast<double>(columns.prices[last])) /
+            static_cast<double>(quantity);
+    return true;
+}
+
+double DepthProfile::imbalance(size_t levels) const noexcept {
+    const double bid = static_cast<double>(volume(Side::BUY, levels));
+    const double ask = static_cast<double>(volume(Side::SELL, levels));
+    return bid + ask > 0.0 ? (bid - ask) / (bid + ask) : 0.0;
+}
+
+} // namespace OrderBook
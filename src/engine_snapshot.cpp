@@ -0,0 +1,113 @@
+#include "engine_snapshot.hpp"
+#include <cerrno>
+#include <cstdio>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace OrderBook {
+
+namespace {
+
+constexpr char SNAPSHOT_MAGIC[8] = {'O', 'B', 'E', 'N', 'G', 'S', 'N', 'P'};
+constexpr uint32_t SNAPSHOT_VERSION = 1;
+
+} // namespace
+
+void init_snapshot_header(EngineSnapshotHeader& header) noexcept {
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.version = SNAPSHOT_VERSION;
+    header.order_size = sizeof(Order);
+    header.info_size = sizeof(OrderInfo);
+}
+
+bool valid_snapshot_header(const EngineSnapshotHeader& header) noexcept {
+    return std::memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic)) == 0 &&
+           header.version == SNAPSHOT_VERSION &&
+           header.order_size == sizeof(Order) && header.info_size == sizeof(OrderInfo);
+}
+
+// Snapshot writer
+
+SnapshotWriter::SnapshotWriter(const std::string& path)
+    : path_(path), tmp_path_(path + ".tmp"), fd_(-1), ok_(false), bytes_written_(0) {
+    fd_ = ::open(tmp_path_.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    ok_ = fd_ >= 0;
+}
+
+SnapshotWriter::~SnapshotWriter() {
+    if (fd_ >= 0) {
+        // Never committed - drop the partial file
+        ::close(fd_);
+        ::unlink(tmp_path_.c_str());
+    }
+}
+
+void SnapshotWriter::write(const void* data, uint64_t bytes) noexcept {
+    if (!ok_) return;
+
+    const char* cursor = static_cast<const char*>(data);
+    while (bytes > 0) {
+        const ssize_t written = ::write(fd_, cursor, bytes);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            ok_ = false;
+            return;
+        }
+        cursor += written;
+        bytes -= static_cast<uint64_t>(written);
+        bytes_written_ += static_cast<uint64_t>(written);
+    }
+}
+
+bool SnapshotWriter::commit() noexcept {
+    if (fd_ < 0) return false;
+
+    // Process-crash durability: the page cache survives us, rename is atomic
+    const bool closed = ::close(fd_) == 0;
+    fd_ = -1;
+    if (!ok_ || !closed || std::rename(tmp_path_.c_str(), path_.c_str()) != 0) {
+        ::unlink(tmp_path_.c_str());
+        ok_ = false;
+    }
+    return ok_;
+}
+
+// Snapshot reader
+
+SnapshotReader::SnapshotReader(const std::string& path)
+    : map_(nullptr), size_(0), offset_(0), ok_(false) {
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return;
+
+    struct stat st;
+    if (fstat(fd, &st) == 0 && st.st_size > 0) {
+        size_ = static_cast<uint64_t>(st.st_size);
+        // Fault the whole file in up front - restore is one sequential copy
+        void* map = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE | MAP_POPULATE, fd, 0);
+        if (map != MAP_FAILED) {
+            map_ = static_cast<const char*>(map);
+            madvise(const_cast<char*>(map_), size_, MADV_SEQUENTIAL);
+            ok_ = true;
+        }
+    }
+    ::close(fd);
+}
+
+SnapshotReader::~SnapshotReader() {
+    if (map_) munmap(const_cast<char*>(map_), size_);
+}
+
+const void* SnapshotReader::take(uint64_t bytes) noexcept {
+    if (!ok_ || bytes > size_ - offset_) {
+        ok_ = false;
+        return nullptr;
+    }
+    const void* data = map_ + offset_;
+    offset_ += bytes;
+    return data;
+}
+
+} // namespace OrderBook
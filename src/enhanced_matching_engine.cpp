@@ -1,42 +1,75 @@
 #include "enhanced_matching_engine.hpp"
+#include "instrument.hpp"
 #include <iostream>
+#include <iomanip>
 #include <algorithm>
 
 namespace OrderBook {
 
 EnhancedMatchingEngine::EnhancedMatchingEngine(SPSCRingBuffer* ring_buffer) 
-    : order_pool_(MAX_ORDERS), ring_buffer_(ring_buffer),
-      order_map_(MAX_ORDERS, nullptr), orders_processed_(0),
+    : order_pool_(MAX_ORDERS, ORDER_POOL_MAX_SLABS), book_(order_pool_), depth_(book_),
+      depth_changed_(false), publish_snapshot_(false), ring_buffer_(ring_buffer), output_(nullptr),
+      features_(), order_index_(order_pool_, order_pool_.max_capacity()), orders_processed_(0),
       trades_executed_(0), orders_rejected_(0),
       total_buy_quantity_matched_(0),
       total_sell_quantity_matched_(0) {
     
-    trade_latencies_ns_.reserve(TOTAL_ORDERS_TO_GENERATE / 10);
-    
     // Initialize order type statistics
     for (auto& stats : order_type_stats_) {
         stats = OrderTypeStats{};
     }
 }
 
-void EnhancedMatchingEngine::set_market_data_manager(std::unique_ptr<MarketDataManager> manager) {
-    market_data_manager_ = std::move(manager);
+void EnhancedMatchingEngine::set_output_stage(OutputStage* output) noexcept {
+    output_ = output;
 }
 
-void EnhancedMatchingEngine::run() noexcept {
-    Command cmd;
-    
-    while (orders_processed_ < TOTAL_ORDERS_TO_GENERATE) {
-        if (ring_buffer_->dequeue(cmd)) {
-            const auto processing_start = std::chrono::high_resolution_clock::now();
+void EnhancedMatchingEngine::set_match_features(const MatchFeatures& features) noexcept {
+    features_ = features;
+}
+
+void EnhancedMatchingEngine::run(uint64_t command_count) noexcept {
+    // One compiled loop per feature combination, picked once per run
+    static constexpr RunLoop loops[8] = {
+        &EnhancedMatchingEngine::run_loop<MatchPolicy<false, false, false>>,
+        &EnhancedMatchingEngine::run_loop<MatchPolicy<false, false, true>>,
+        &EnhancedMatchingEngine::run_loop<MatchPolicy<false, true, false>>,
+        &EnhancedMatchingEngine::run_loop<MatchPolicy<false, true, true>>,
+        &EnhancedMatchingEngine::run_loop<MatchPolicy<true, false, false>>,
+        &EnhancedMatchingEngine::run_loop<MatchPolicy<true, false, true>>,
+        &EnhancedMatchingEngine::run_loop<MatchPolicy<true, true, false>>,
+        &EnhancedMatchingEngine::run_loop<MatchPolicy<true, true, true>>,
+    };
+    const size_t selector = (features_.order_statistics ? 4 : 0) | (output_ ? 2 : 0) |
+                            (features_.latency_capture ? 1 : 0);
+    (this->*loops[selector])(command_count);
+}
+
+template <typename Policy>
+void EnhancedMatchingEngine::run_loop(uint64_t command_count) noexcept {
+    while (orders_processed_ < command_count) {
+        // Commands are processed in place in their ring slots - no copy out
+        ring_buffer_->consume_bulk(ENGINE_BURST_SIZE, [this](const Command& cmd) {
+            uint64_t processing_start = 0;
+            if constexpr (Policy::latency) {
+                processing_start = rdtsc();
+                if (cmd.producer_timestamp != 0 && cmd.producer_timestamp < processing_start) {
+                    queue_latency_.record(TscClock::to_ns(processing_start - cmd.producer_timestamp));
+                }
+            }
             
             if (cmd.type == CommandType::NEW) {
-                handle_new_order(cmd, processing_start);
-            } else {
-                handle_cancel_order(cmd.order_id);
+                handle_new_order<Policy>(cmd, processing_start);
+            } else if (cmd.type == CommandType::CANCEL) {
+                handle_cancel_order<Policy>(cmd.order_id);
             }
             
             ++orders_processed_;
+        });
+        
+        if (depth_changed_ && publish_snapshot_) {
+            snapshot_.publish(create_level2_snapshot());
+            depth_changed_ = false;
         }
     }
 }
@@ -53,8 +86,16 @@ uint64_t EnhancedMatchingEngine::orders_rejected() const noexcept {
     return orders_rejected_;
 }
 
-const std::vector<long long>& EnhancedMatchingEngine::trade_latencies() const noexcept {
-    return trade_latencies_ns_;
+const OrderPool& EnhancedMatchingEngine::order_pool() const noexcept {
+    return order_pool_;
+}
+
+const LatencyHistogram& EnhancedMatchingEngine::queue_latency() const noexcept {
+    return queue_latency_;
+}
+
+const LatencyHistogram& EnhancedMatchingEngine::trade_latency() const noexcept {
+    return trade_latency_;
 }
 
 uint64_t EnhancedMatchingEngine::total_buy_quantity_matched() const noexcept {
@@ -91,48 +132,43 @@ void EnhancedMatchingEngine::print_order_type_statistics() const noexcept {
 }
 
 Level2Snapshot EnhancedMatchingEngine::create_level2_snapshot() const noexcept {
-    Level2Snapshot snapshot(1, "DEFAULT");
-    
-    // Collect bid levels (highest to lowest)
-    for (int64_t price = PRICE_MAX; price >= PRICE_MIN; --price) {
-        PriceLevel* level = book_.get_price_level(price, Side::BUY);
-        if (level && !level->empty()) {
-            uint32_t order_count = 0;
-            Order* order = level->head;
-            while (order) {
-                ++order_count;
-                order = order->next;
-            }
-            snapshot.bids.emplace_back(price, level->total_volume, order_count);
-            
-            if (snapshot.bids.size() >= 20) break; // Top 20 levels
-        }
-    }
-    
-    // Collect ask levels (lowest to highest)
-    for (int64_t price = PRICE_MIN; price <= PRICE_MAX; ++price) {
-        PriceLevel* level = book_.get_price_level(price, Side::SELL);
-        if (level && !level->empty()) {
-            uint32_t order_count = 0;
-            Order* order = level->head;
-            while (order) {
-                ++order_count;
-                order = order->next;
-            }
-            snapshot.asks.emplace_back(price, level->total_volume, order_count);
-            
-            if (snapshot.asks.size() >= 20) break; // Top 20 levels
-        }
-    }
+    Level2Snapshot snapshot(DEFAULT_INSTRUMENT_ID);
     
+    depth_.copy_into(snapshot);
     return snapshot;
 }
 
-void EnhancedMatchingEngine::handle_new_order(const Command& cmd, const std::chrono::high_resolution_clock::time_point& processing_start) noexcept {
+void EnhancedMatchingEngine::enable_book_snapshot() noexcept {
+    publish_snapshot_ = true;
+    snapshot_.publish(create_level2_snapshot());
+}
+
+const BookSnapshot& EnhancedMatchingEngine::book_snapshot() const noexcept {
+    return snapshot_;
+}
+
+template <typename Policy>
+constexpr EnhancedMatchingEngine::HandlerTable EnhancedMatchingEngine::make_handler_table() noexcept {
+    return {
+        &EnhancedMatchingEngine::process_new_order<Side::BUY, OrderType::LIMIT, Policy>,
+        &EnhancedMatchingEngine::process_new_order<Side::SELL, OrderType::LIMIT, Policy>,
+        &EnhancedMatchingEngine::process_new_order<Side::BUY, OrderType::IOC, Policy>,
+        &EnhancedMatchingEngine::process_new_order<Side::SELL, OrderType::IOC, Policy>,
+        &EnhancedMatchingEngine::process_new_order<Side::BUY, OrderType::FOK, Policy>,
+        &EnhancedMatchingEngine::process_new_order<Side::SELL, OrderType::FOK, Policy>,
+        &EnhancedMatchingEngine::reject_invalid_order<Policy>,
+        &EnhancedMatchingEngine::reject_invalid_order<Policy>,
+    };
+}
+
+template <typename Policy>
+void EnhancedMatchingEngine::handle_new_order(const Command& cmd, uint64_t processing_start) noexcept {
+    static constexpr HandlerTable handlers = make_handler_table<Policy>();
+    
     Order* order = order_pool_.allocate();
     if (!order) {
+        // Pool at max capacity - the pool counts it in exhaustion_count()
         ++orders_rejected_;
-        std::cerr << "WARNING: Order pool exhausted, rejecting order_id=" << cmd.order_id << "\n";
         return;
     }
     
@@ -142,299 +178,198 @@ void EnhancedMatchingEngine::handle_new_order(const Command& cmd, const std::chr
     order->order_type = cmd.order_type;
     order->price = cmd.price;
     order->quantity = cmd.quantity;
-    order->original_quantity = cmd.quantity;
     order->status = OrderStatus::PENDING;
-    order->timestamp = cmd.producer_timestamp;
-    
-    // Update statistics
-    order_type_stats_[static_cast<size_t>(cmd.order_type)].submitted++;
     
-    // Store in order map for cancellation lookup
-    if (order->order_id < order_map_.size()) {
-        order_map_[order->order_id] = order;
-    }
+    OrderInfo& info = order_pool_.info(order);
+    info.original_quantity = cmd.quantity;
+    info.timestamp = cmd.producer_timestamp;
     
-    // Try to match order based on type
-    MatchResult result = match_order(order, processing_start);
+    const size_t handler = static_cast<size_t>(cmd.order_type) * 2 + static_cast<size_t>(cmd.side);
+    (this->*handlers[handler])(order, processing_start);
+}
+
+template <Side S, OrderType T, typename Policy>
+void EnhancedMatchingEngine::process_new_order(Order* order, uint64_t processing_start) noexcept {
+    OrderTypeStats& stats = order_type_stats_[static_cast<size_t>(T)];
+    if constexpr (Policy::statistics) ++stats.submitted;
     
-    // Handle result based on order type
-    switch (order->order_type) {
-        case OrderType::LIMIT:
-            if (result == MatchResult::PARTIALLY_MATCHED || result == MatchResult::NO_MATCH) {
-                // Add remainder to book
-                if (order->quantity > 0) {
-                    book_.add_order(order);
-                    order->status = (result == MatchResult::PARTIALLY_MATCHED) ? 
-                        OrderStatus::PARTIAL_FILL : OrderStatus::PENDING;
-                }
-            }
-            break;
-            
-        case OrderType::IOC:
-            // IOC orders: match what we can, cancel the rest
-            if (order->quantity > 0) {
-                order->status = OrderStatus::CANCELLED;
-                order_type_stats_[static_cast<size_t>(OrderType::IOC)].cancelled++;
-                order_pool_.free(order);
-                if (order->order_id < order_map_.size()) {
-                    order_map_[order->order_id] = nullptr;
-                }
-            }
-            break;
-            
-        case OrderType::FOK:
-            // FOK orders: already handled in match_fok_order
-            if (result == MatchResult::REJECTED) {
-                order_pool_.free(order);
-                if (order->order_id < order_map_.size()) {
-                    order_map_[order->order_id] = nullptr;
-                }
-            }
-            break;
+    if constexpr (T == OrderType::FOK) {
+        // FOK: fill completely or kill without touching the book
+        if (!can_fill_completely<S>(order)) {
+            // Counted only - a killed FOK is routine, not worth a write on the matching thread
+            order->status = OrderStatus::REJECTED;
+            if constexpr (Policy::statistics) ++stats.rejected;
+            order_pool_.free(order);
+            return;
+        }
     }
     
-    // Update final status if order was fully matched
-    if (order->quantity == 0 && order->status != OrderStatus::CANCELLED && 
-        order->status != OrderStatus::REJECTED) {
+    const uint64_t original_quantity = order->quantity;
+    match<S, Policy>(order, processing_start);
+    
+    if (order->quantity == 0) {
         order->status = OrderStatus::FILLED;
-        order_type_stats_[static_cast<size_t>(order->order_type)].filled++;
+        if constexpr (Policy::statistics) ++stats.filled;
         
-        // Remove from book and return to pool
-        if (order->order_id < order_map_.size()) {
-            order_map_[order->order_id] = nullptr;
-        }
+        // Never rested, so never indexed - straight back to the pool
         order_pool_.free(order);
-    } else if (result == MatchResult::PARTIALLY_MATCHED) {
-        order_type_stats_[static_cast<size_t>(order->order_type)].partial_fills++;
-    }
-}
-
-void EnhancedMatchingEngine::handle_cancel_order(uint64_t order_id) noexcept {
-    if (order_id >= order_map_.size()) return;
-    
-    Order* order = order_map_[order_id];
-    if (!order) return;
-    
-    book_.remove_order(order);
-    order->status = OrderStatus::CANCELLED;
-    order_type_stats_[static_cast<size_t>(order->order_type)].cancelled++;
-    
-    order_map_[order_id] = nullptr;
-    order_pool_.free(order);
-}
-
-EnhancedMatchingEngine::MatchResult EnhancedMatchingEngine::match_order(Order* order, const std::chrono::high_resolution_clock::time_point& processing_start) noexcept {
-    switch (order->order_type) {
-        case OrderType::LIMIT:
-            return match_limit_order(order, processing_start);
-        case OrderType::IOC:
-            return match_ioc_order(order, processing_start);
-        case OrderType::FOK:
-            return match_fok_order(order, processing_start);
-        default:
-            return MatchResult::REJECTED;
+        return;
     }
-}
-
-EnhancedMatchingEngine::MatchResult EnhancedMatchingEngine::match_limit_order(Order* order, const std::chrono::high_resolution_clock::time_point& processing_start) noexcept {
-    uint64_t original_quantity = order->quantity;
     
-    if (order->side == Side::BUY) {
-        match_against_asks(order, processing_start);
-    } else {
-        match_against_bids(order, processing_start);
+    const bool partially_matched = order->quantity < original_quantity;
+    if constexpr (Policy::statistics) {
+        if (partially_matched) ++stats.partial_fills;
     }
     
-    if (order->quantity == 0) {
-        return MatchResult::FULLY_MATCHED;
-    } else if (order->quantity < original_quantity) {
-        return MatchResult::PARTIALLY_MATCHED;
+    if constexpr (T == OrderType::LIMIT) {
+        // Add remainder to book; one priced outside the ladder can't rest
+        if (!book_.add_order(order)) {
+            order->status = OrderStatus::REJECTED;
+            ++orders_rejected_;
+            if constexpr (Policy::statistics) ++stats.rejected;
+            order_pool_.free(order);
+            return;
+        }
+        publish_market_data_update<Policy>(S, order->price);
+        order->status = partially_matched ? OrderStatus::PARTIAL_FILL : OrderStatus::PENDING;
+        
+        // Only resting orders can be cancelled, so only they are indexed
+        order_index_.insert(order->order_id, order_pool_.index_of(order));
+    } else if constexpr (T == OrderType::IOC) {
+        // IOC orders: match what we can, cancel the rest
+        order->status = OrderStatus::CANCELLED;
+        if constexpr (Policy::statistics) ++stats.cancelled;
+        order_pool_.free(order);
     } else {
-        return MatchResult::NO_MATCH;
+        // Depth was checked, so only an inconsistent book gets here
+        order->status = OrderStatus::REJECTED;
+        if constexpr (Policy::statistics) ++stats.rejected;
+        order_pool_.free(order);
     }
 }
 
-EnhancedMatchingEngine::MatchResult EnhancedMatchingEngine::match_ioc_order(Order* order, const std::chrono::high_resolution_clock::time_point& processing_start) noexcept {
-    // IOC: Match immediately, cancel remainder
-    return match_limit_order(order, processing_start);
+template <typename Policy>
+void EnhancedMatchingEngine::reject_invalid_order(Order* order, uint64_t) noexcept {
+    order->status = OrderStatus::REJECTED;
+    ++orders_rejected_;
+    order_pool_.free(order);
 }
 
-EnhancedMatchingEngine::MatchResult EnhancedMatchingEngine::match_fok_order(Order* order, const std::chrono::high_resolution_clock::time_point& processing_start) noexcept {
-    // FOK: Fill completely or reject
-    if (!can_fill_completely(order)) {
-        reject_order(order, "FOK order cannot be completely filled");
-        return MatchResult::REJECTED;
-    }
-    
-    // If we can fill completely, match like a normal order
-    MatchResult result = match_limit_order(order, processing_start);
+template <typename Policy>
+void EnhancedMatchingEngine::handle_cancel_order(uint64_t order_id) noexcept {
+    const OrderIndex index = order_index_.erase(order_id);
+    if (index == NULL_ORDER) return;
     
-    if (result != MatchResult::FULLY_MATCHED) {
-        // This shouldn't happen if can_fill_completely worked correctly
-        reject_order(order, "FOK order partially filled - algorithmic error");
-        return MatchResult::REJECTED;
+    Order* order = order_pool_.at(index);
+    book_.remove_order(order);
+    publish_market_data_update<Policy>(order->side, order->price);
+    order->status = OrderStatus::CANCELLED;
+    if constexpr (Policy::statistics) {
+        order_type_stats_[static_cast<size_t>(order->order_type)].cancelled++;
     }
     
-    return MatchResult::FULLY_MATCHED;
-}
-
-bool EnhancedMatchingEngine::can_fill_completely(Order* order) const noexcept {
-    uint64_t fillable_quantity = calculate_fillable_quantity(order);
-    return fillable_quantity >= order->quantity;
+    order_pool_.free(order);
 }
 
-uint64_t EnhancedMatchingEngine::calculate_fillable_quantity(Order* order) const noexcept {
-    uint64_t fillable = 0;
-    
-    if (order->side == Side::BUY) {
-        // Check ask side
-        for (int64_t price = book_.best_ask(); price <= order->price && price != -1; ++price) {
-            PriceLevel* level = book_.get_price_level(price, Side::SELL);
-            if (level && !level->empty()) {
-                fillable += level->total_volume;
-                if (fillable >= order->quantity) {
-                    return fillable;
-                }
-            }
-        }
+template <Side S>
+bool EnhancedMatchingEngine::can_fill_completely(const Order* order) const noexcept {
+    // Cumulative depth up to the limit - no level walk ahead of the match
+    if constexpr (S == Side::BUY) {
+        return book_.ask_volume_through(order->price, order->quantity) >= order->quantity;
     } else {
-        // Check bid side
-        for (int64_t price = book_.best_bid(); price >= order->price && price != -1; --price) {
-            PriceLevel* level = book_.get_price_level(price, Side::BUY);
-            if (level && !level->empty()) {
-                fillable += level->total_volume;
-                if (fillable >= order->quantity) {
-                    return fillable;
-                }
-            }
-        }
+        return book_.bid_volume_through(order->price, order->quantity) >= order->quantity;
     }
-    
-    return fillable;
 }
 
-void EnhancedMatchingEngine::match_against_asks(Order* buy_order, const std::chrono::high_resolution_clock::time_point& processing_start) noexcept {
-    for (int64_t price = book_.best_ask(); price <= buy_order->price && price != -1; ++price) {
-        PriceLevel* level = book_.get_price_level(price, Side::SELL);
-        if (!level || level->empty()) continue;
-        
-        Order* ask_order = level->head;
-        while (ask_order && buy_order->quantity > 0) {
-            Order* next_ask = ask_order->next;
-            
-            const uint64_t trade_quantity = std::min(buy_order->quantity, ask_order->quantity);
-            execute_trade(buy_order->order_id, ask_order->order_id, price, trade_quantity, processing_start);
-            
-            buy_order->quantity -= trade_quantity;
-            ask_order->quantity -= trade_quantity;
-            
-            if (ask_order->quantity == 0) {
-                level->remove_order(ask_order);
-                ask_order->status = OrderStatus::FILLED;
-                if (ask_order->order_id < order_map_.size()) {
-                    order_map_[ask_order->order_id] = nullptr;
-                }
-                order_pool_.free(ask_order);
-            } else {
-                ask_order->status = OrderStatus::PARTIAL_FILL;
-            }
-            
-            ask_order = next_ask;
-        }
-        
-        // Publish market data update for this price level
-        publish_market_data_update(Side::SELL, price);
-        
-        if (buy_order->quantity == 0) break;
-    }
-}
-
-void EnhancedMatchingEngine::match_against_bids(Order* sell_order, const std::chrono::high_resolution_clock::time_point& processing_start) noexcept {
-    for (int64_t price = book_.best_bid(); price >= sell_order->price && price != -1; --price) {
-        PriceLevel* level = book_.get_price_level(price, Side::BUY);
-        if (!level || level->empty()) continue;
+template <Side S, typename Policy>
+void EnhancedMatchingEngine::match(Order* order, uint64_t processing_start) noexcept {
+    constexpr Side resting_side = (S == Side::BUY) ? Side::SELL : Side::BUY;
+    
+    // Touch first, moving away from it; the limit decides how far
+    const auto first = [this]() noexcept {
+        if constexpr (S == Side::BUY) return book_.best_ask(); else return book_.best_bid();
+    };
+    const auto next = [this](int64_t price) noexcept {
+        if constexpr (S == Side::BUY) return book_.next_ask_price(price); else return book_.next_bid_price(price);
+    };
+    const auto crosses = [order](int64_t price) noexcept {
+        if constexpr (S == Side::BUY) return price <= order->price; else return price >= order->price;
+    };
+    
+    // Jump through occupied levels only
+    for (int64_t price = first(); price != -1 && crosses(price); price = next(price)) {
+        PriceLevel* level = book_.get_price_level(price, resting_side);
         
-        Order* bid_order = level->head;
-        while (bid_order && sell_order->quantity > 0) {
-            Order* next_bid = bid_order->next;
+        OrderIndex next_resting = level->head;
+        while (next_resting != NULL_ORDER && order->quantity > 0) {
+            Order* resting = order_pool_.at(next_resting);
+            next_resting = resting->next;
             
-            const uint64_t trade_quantity = std::min(sell_order->quantity, bid_order->quantity);
-            execute_trade(sell_order->order_id, bid_order->order_id, price, trade_quantity, processing_start);
+            const uint64_t trade_quantity = std::min(order->quantity, resting->quantity);
+            execute_trade<Policy>(order->order_id, resting->order_id, S, price, trade_quantity,
+                                  processing_start);
             
-            sell_order->quantity -= trade_quantity;
-            bid_order->quantity -= trade_quantity;
+            order->quantity -= trade_quantity;
+            book_.fill_order(level, resting, trade_quantity);
             
-            if (bid_order->quantity == 0) {
-                level->remove_order(bid_order);
-                bid_order->status = OrderStatus::FILLED;
-                if (bid_order->order_id < order_map_.size()) {
-                    order_map_[bid_order->order_id] = nullptr;
-                }
-                order_pool_.free(bid_order);
+            if (resting->quantity == 0) {
+                // Through the book so occupancy and the touch stay current
+                book_.remove_order(resting);
+                resting->status = OrderStatus::FILLED;
+                order_index_.erase(resting->order_id, order_pool_.index_of(resting));
+                order_pool_.free(resting);
             } else {
-                bid_order->status = OrderStatus::PARTIAL_FILL;
+                resting->status = OrderStatus::PARTIAL_FILL;
             }
-            
-            bid_order = next_bid;
         }
         
         // Publish market data update for this price level
-        publish_market_data_update(Side::BUY, price);
+        publish_market_data_update<Policy>(resting_side, price);
         
-        if (sell_order->quantity == 0) break;
+        if (order->quantity == 0) break;
     }
 }
 
-void EnhancedMatchingEngine::execute_trade(uint64_t aggressor_id, uint64_t resting_id, int64_t price, 
-                                          uint64_t quantity, const std::chrono::high_resolution_clock::time_point& processing_start) noexcept {
+template <typename Policy>
+void EnhancedMatchingEngine::execute_trade(uint64_t aggressor_id, uint64_t resting_id, Side aggressor_side, int64_t price, 
+                                          uint64_t quantity, uint64_t processing_start) noexcept {
     // Calculate latency from processing start to trade execution
-    const auto latency_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
-        std::chrono::high_resolution_clock::now() - processing_start).count();
-
-    trade_latencies_ns_.push_back(latency_ns);
+    if constexpr (Policy::latency) {
+        trade_latency_.record(TscClock::to_ns(rdtsc() - processing_start));
+    }
     
     // Update statistics
     ++trades_executed_;
-    total_buy_quantity_matched_ += quantity;
-    total_sell_quantity_matched_ += quantity;
-    
-    // Print trade details
-    std::cout << "TRADE: aggressor=" << aggressor_id << " resting=" << resting_id 
-              << " price=" << price << " qty=" << quantity << "\n";
+    if constexpr (Policy::statistics) {
+        total_buy_quantity_matched_ += quantity;
+        total_sell_quantity_matched_ += quantity;
+    }
     
-    // Publish to market data if available
-    if (market_data_manager_) {
-        Trade trade(1, "DEFAULT", aggressor_id, resting_id, Side::BUY, price, quantity);
-        market_data_manager_->publish_trade(trade);
+    // Hand the execution report to the output stage - formatting happens off this thread
+    if constexpr (Policy::market_data) {
+        output_->publish_trade(DEFAULT_INSTRUMENT_ID, aggressor_id, resting_id, aggressor_side, 
+                               price, quantity);
     }
 }
 
+template <typename Policy>
 void EnhancedMatchingEngine::publish_market_data_update(Side side, int64_t price) noexcept {
-    if (!market_data_manager_) return;
-    
-    PriceLevel* level = book_.get_price_level(price, side);
-    uint32_t order_count = 0;
-    
-    if (level) {
-        Order* order = level->head;
-        while (order) {
-            ++order_count;
-            order = order->next;
-        }
+    // Depth is kept current even when silent so snapshots stay valid;
+    // only changes inside the published depth produce a delta
+    const bool published_level = depth_.on_level_change(side, price);
+    depth_changed_ |= published_level;
+    if constexpr (Policy::market_data) {
+        if (!published_level) return;
         
-        market_data_manager_->publish_level2_update(1, "DEFAULT", side, price, 
-                                                   level->total_volume, order_count);
-    } else {
-        // Level is empty
-        market_data_manager_->publish_level2_update(1, "DEFAULT", side, price, 0, 0);
+        const PriceLevel* level = book_.get_price_level(price, side);
+        if (level) {
+            output_->publish_level2_update(DEFAULT_INSTRUMENT_ID, side, price, 
+                                           level->total_volume, level->order_count);
+        } else {
+            // Level is empty
+            output_->publish_level2_update(DEFAULT_INSTRUMENT_ID, side, price, 0, 0);
+        }
     }
 }
 
-void EnhancedMatchingEngine::reject_order(Order* order, const std::string& reason) noexcept {
-    order->status = OrderStatus::REJECTED;
-    order_type_stats_[static_cast<size_t>(order->order_type)].rejected++;
-    
-    std::cout << "ORDER REJECTED: id=" << order->order_id << " reason=" << reason << std::endl;
-}
-
-} // namespace OrderBook
\ No newline at end of file
+} // namespace OrderBook
@@ -0,0 +1,111 @@
+#include "feed_capture.hpp"
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace OrderBook {
+
+namespace {
+
+constexpr char CAPTURE_MAGIC[8] = {'O', 'B', 'F', 'E', 'E', 'D', 'C', 'P'};
+constexpr uint32_t CAPTURE_VERSION = 1;
+
+FeedCaptureHeader make_header(uint64_t command_count, uint64_t duration_ns, uint64_t seed) noexcept {
+    FeedCaptureHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, CAPTURE_MAGIC, sizeof(header.magic));
+    header.version = CAPTURE_VERSION;
+    header.record_size = sizeof(Command);
+    header.command_count = command_count;
+    header.duration_ns = duration_ns;
+    header.seed = seed;
+    return header;
+}
+
+} // namespace
+
+// Capture writer
+
+FeedCaptureWriter::FeedCaptureWriter(const std::string& path, uint64_t seed)
+    : file_(std::fopen(path.c_str(), "wb")), command_count_(0), last_offset_ns_(0), seed_(seed),
+      ok_(file_ != nullptr) {
+    if (!file_) return;
+
+    // Placeholder - the count is only known at finish()
+    const FeedCaptureHeader header = make_header(0, 0, seed_);
+    ok_ = std::fwrite(&header, sizeof(header), 1, file_) == 1;
+}
+
+FeedCaptureWriter::~FeedCaptureWriter() {
+    finish();
+}
+
+void FeedCaptureWriter::append(const Command& cmd, uint64_t offset_ns) noexcept {
+    if (!ok_) return;
+
+    Command record = cmd;
+    last_offset_ns_ = std::max(last_offset_ns_, offset_ns);
+    record.producer_timestamp = last_offset_ns_;
+    if (std::fwrite(&record, sizeof(record), 1, file_) != 1) {
+        ok_ = false;
+        return;
+    }
+    ++command_count_;
+}
+
+bool FeedCaptureWriter::finish() noexcept {
+    if (!file_) return ok_;
+
+    const FeedCaptureHeader header = make_header(command_count_, last_offset_ns_, seed_);
+    if (ok_) {
+        ok_ = std::fseek(file_, 0, SEEK_SET) == 0 && std::fwrite(&header, sizeof(header), 1, file_) == 1;
+    }
+    ok_ = (std::fclose(file_) == 0) && ok_;
+    file_ = nullptr;
+    return ok_;
+}
+
+// Capture reader
+
+FeedCapture::FeedCapture(const std::string& path)
+    : map_(nullptr), map_size_(0), commands_(nullptr), command_count_(0), duration_ns_(0), seed_(0) {
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || static_cast<uint64_t>(st.st_size) < sizeof(FeedCaptureHeader)) {
+        ::close(fd);
+        return;
+    }
+
+    map_size_ = static_cast<uint64_t>(st.st_size);
+    // Fault the whole capture in before the clock starts
+    void* map = mmap(nullptr, map_size_, PROT_READ, MAP_PRIVATE | MAP_POPULATE, fd, 0);
+    ::close(fd);
+    if (map == MAP_FAILED) return;
+
+    const auto* header = static_cast<const FeedCaptureHeader*>(map);
+    const uint64_t capacity = (map_size_ - sizeof(FeedCaptureHeader)) / sizeof(Command);
+    if (std::memcmp(header->magic, CAPTURE_MAGIC, sizeof(header->magic)) != 0 ||
+        header->version != CAPTURE_VERSION || header->record_size != sizeof(Command) ||
+        header->command_count > capacity) {
+        munmap(map, map_size_);
+        return;
+    }
+
+    map_ = static_cast<const char*>(map);
+    madvise(const_cast<char*>(map_), map_size_, MADV_SEQUENTIAL);
+    commands_ = reinterpret_cast<const Command*>(map_ + sizeof(FeedCaptureHeader));
+    command_count_ = header->command_count;
+    duration_ns_ = header->duration_ns;
+    seed_ = header->seed;
+}
+
+FeedCapture::~FeedCapture() {
+    if (map_) munmap(const_cast<char*>(map_), map_size_);
+}
+
+} // namespace OrderBook
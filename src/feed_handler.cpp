@@ -1,76 +1,177 @@
 #include "feed_handler.hpp"
 #include "types.hpp"
+#include "tsc_clock.hpp"
+#include "sharded_matching_engine.hpp"
 #include <random>
 #include <thread>
 #include <algorithm>
 
 namespace OrderBook {
 
-void FeedHandler::run(SPSCRingBuffer* ring_buffer) noexcept {
-    std::random_device rd;
-    std::mt19937_64 gen(rd());
+namespace {
+
+/**
+ * The simulated order flow, one command at a time
+ */
+class CommandGenerator {
+private:
+    std::mt19937_64 gen_;
     
     // Price distribution around mid-market
-    std::uniform_int_distribution<int64_t> price_dist(PRICE_MIN + 100, PRICE_MAX - 100);
-    std::uniform_int_distribution<uint64_t> quantity_dist(1, 1000);
-    std::uniform_int_distribution<uint64_t> order_id_dist(1, MAX_ORDERS - 1);
-    std::uniform_real_distribution<double> action_dist(0.0, 1.0);
-    std::uniform_int_distribution<int> side_dist(0, 1);
+    std::uniform_int_distribution<int64_t> price_dist_{PRICE_MIN + 100, PRICE_MAX - 100};
+    std::uniform_int_distribution<uint64_t> quantity_dist_{1, 1000};
+    std::uniform_int_distribution<uint64_t> order_id_dist_{1, MAX_ORDERS - 1};
+    std::uniform_real_distribution<double> action_dist_{0.0, 1.0};
+    std::uniform_int_distribution<int> side_dist_{0, 1};
+    
+    uint64_t orders_generated_ = 0;
+    int64_t current_mid_ = (PRICE_MIN + PRICE_MAX) / 2;  // Simulated mid-market price
     
-    uint64_t orders_generated = 0;
-    int64_t current_mid = (PRICE_MIN + PRICE_MAX) / 2;  // Simulated mid-market price
+public:
+    explicit CommandGenerator(uint64_t seed)
+        : gen_(seed == FeedHandler::RANDOM_SEED ? std::random_device{}() : seed) {}
     
-    while (orders_generated < TOTAL_ORDERS_TO_GENERATE) {
-        Command cmd;
-        cmd.producer_timestamp = std::chrono::high_resolution_clock::now();
+    /**
+     * Fill every field of cmd except the timestamp and instrument_id
+     */
+    void next(Command& cmd) noexcept {
+        // Slots are reused - every field is written for every command
+        cmd.order_type = OrderType::LIMIT;
+        cmd.account_id = NO_ACCOUNT;
+        cmd.quantity = 0;
+        cmd.side = Side::BUY;
+        int64_t price = 0;
         
-        const double action = action_dist(gen);
+        const double action = action_dist_(gen_);
         
         if (action < 0.7) {  // 70% new orders
             cmd.type = CommandType::NEW;
-            cmd.order_id = order_id_dist(gen);
-            cmd.side = (side_dist(gen) == 0) ? Side::BUY : Side::SELL;
-            cmd.quantity = quantity_dist(gen);
+            cmd.order_id = order_id_dist_(gen_);
+            cmd.side = (side_dist_(gen_) == 0) ? Side::BUY : Side::SELL;
+            cmd.quantity = quantity_dist_(gen_);
             
             if (action < 0.5) {  // 50% passive orders
                 // Place orders away from mid to avoid immediate matching
                 if (cmd.side == Side::BUY) {
-                    cmd.price = current_mid - (1 + (price_dist(gen) % 50));  // Below mid
+                    price = current_mid_ - (1 + (price_dist_(gen_) % 50));  // Below mid
                 } else {
-                    cmd.price = current_mid + (1 + (price_dist(gen) % 50));  // Above mid
+                    price = current_mid_ + (1 + (price_dist_(gen_) % 50));  // Above mid
                 }
             } else {  // 20% aggressive orders
                 // Place orders that cross the spread
                 if (cmd.side == Side::BUY) {
-                    cmd.price = current_mid + (price_dist(gen) % 20);  // Above mid
+                    price = current_mid_ + (price_dist_(gen_) % 20);  // Above mid
                 } else {
-                    cmd.price = current_mid - (price_dist(gen) % 20);  // Below mid
+                    price = current_mid_ - (price_dist_(gen_) % 20);  // Below mid
                 }
             }
         } else {  // 30% cancellations
             cmd.type = CommandType::CANCEL;
-            cmd.order_id = order_id_dist(gen);
+            cmd.order_id = order_id_dist_(gen_);
         }
         
         // Ensure price is within bounds
-        cmd.price = std::max(static_cast<int64_t>(PRICE_MIN), 
-                            std::min(static_cast<int64_t>(PRICE_MAX), cmd.price));
+        price = std::max(static_cast<int64_t>(PRICE_MIN), 
+                         std::min(static_cast<int64_t>(PRICE_MAX), price));
+        cmd.price = static_cast<int32_t>(price);  // Unit ticks on the default book
         
-        // Enqueue with backpressure handling
-        while (!ring_buffer->enqueue(cmd)) {
-            // Ring buffer full, busy wait (could yield here if needed)
-            std::this_thread::yield();
+        ++orders_generated_;
+        
+        // Occasionally update simulated mid price to create market movement
+        if (orders_generated_ % 10000 == 0) {
+            current_mid_ += (gen_() % 21) - 10;  // Random walk ±10
+            current_mid_ = std::max(static_cast<int64_t>(PRICE_MIN + 100), 
+                                    std::min(static_cast<int64_t>(PRICE_MAX - 100), current_mid_));
+        }
+    }
+};
+
+} // namespace
+
+void FeedHandler::run(SPSCQueue<Command>* ring_buffer, uint64_t count,
+                      const WaitConfig& wait_config, WaitSignals* signals, uint64_t seed) noexcept {
+    CommandGenerator generator(seed);
+    WaitStrategy wait = WaitStrategy::producer(wait_config, signals);
+    
+    for (uint64_t orders_generated = 0; orders_generated < count; ++orders_generated) {
+        // Claim the next ring slot and build the command directly in it
+        Command* slot;
+        while (!(slot = ring_buffer->try_claim())) {
+            // Ring buffer full - wait for the engine to free slots
+            wait.idle([ring_buffer] { return ring_buffer->try_claim() != nullptr; });
         }
+        wait.reset();
+        Command& cmd = *slot;
         
-        ++orders_generated;
+        cmd.instrument_id = 0;  // Engine's default instrument
+        generator.next(cmd);
         
-        // Occasionally update simulated mid price to create market movement
-        if (orders_generated % 10000 == 0) {
-            current_mid += (gen() % 21) - 10;  // Random walk ±10
-            current_mid = std::max(static_cast<int64_t>(PRICE_MIN + 100), 
-                                  std::min(static_cast<int64_t>(PRICE_MAX - 100), current_mid));
+        // Timestamp as late as possible, then publish the slot
+        cmd.producer_timestamp = rdtsc();
+        ring_buffer->commit();
+        wait.notify();  // Wakes the engine if it is parked on an empty ring
+    }
+}
+
+void FeedHandler::run(ShardedMatchingEngine* engine, uint32_t instrument_count, uint64_t seed) noexcept {
+    CommandGenerator generator(seed);
+    Command cmd;
+    
+    for (uint64_t orders_generated = 0; orders_generated < TOTAL_ORDERS_TO_GENERATE; ++orders_generated) {
+        // The order id picks the instrument, so a cancel goes where its order went
+        generator.next(cmd);
+        cmd.instrument_id = 1 + static_cast<uint32_t>(cmd.order_id % instrument_count);
+        
+        cmd.producer_timestamp = rdtsc();
+        engine->route(cmd);
+    }
+}
+
+bool FeedHandler::record(const std::string& path, uint64_t count, uint64_t seed,
+                         uint64_t orders_per_second) {
+    CommandGenerator generator(seed);
+    FeedCaptureWriter capture(path, seed);
+    Command cmd{};
+    
+    for (uint64_t i = 0; i < count; ++i) {
+        cmd.instrument_id = 0;  // Engine's default instrument
+        generator.next(cmd);
+        const uint64_t offset_ns = orders_per_second ? i * 1'000'000'000ull / orders_per_second : 0;
+        capture.append(cmd, offset_ns);
+    }
+    return capture.finish();
+}
+
+uint64_t FeedHandler::replay(SPSCQueue<Command>* ring_buffer, const FeedCapture& capture,
+                             ReplayPacing pacing, const WaitConfig& wait_config, WaitSignals* signals) noexcept {
+    WaitStrategy wait = WaitStrategy::producer(wait_config, signals);
+    const bool paced = (pacing == ReplayPacing::RECORDED);
+    const double ticks_per_ns = TscClock::ticks_per_ns();
+    const uint64_t start = rdtsc();
+    
+    const uint64_t count = capture.size();
+    for (uint64_t i = 0; i < count; ++i) {
+        const Command& recorded = capture[i];
+        
+        // Recorded pacing: hold the command until its offset into the session
+        if (paced) {
+            const uint64_t due = start + static_cast<uint64_t>(recorded.producer_timestamp * ticks_per_ns);
+            while (rdtsc() < due) std::this_thread::yield();
         }
+        
+        Command* slot;
+        while (!(slot = ring_buffer->try_claim())) {
+            // Ring buffer full - wait for the engine to free slots
+            wait.idle([ring_buffer] { return ring_buffer->try_claim() != nullptr; });
+        }
+        wait.reset();
+        
+        *slot = recorded;
+        slot->producer_timestamp = rdtsc();
+        ring_buffer->commit();
+        wait.notify();  // Wakes the engine if it is parked on an empty ring
     }
+    return count;
 }
 
-} // namespace OrderBook
\ No newline at end of file
+} // namespace OrderBook
@@ -0,0 +1,169 @@
+#include "gateway_transport.hpp"
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace OrderBook {
+
+EpollTcpTransport::EpollTcpTransport(uint16_t port, const std::string& bind_address)
+    : listen_fd_(-1), epoll_fd_(-1), port_(0), connections_(GATEWAY_MAX_SESSIONS), delivering_(NO_CONNECTION) {
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    if (inet_pton(AF_INET, bind_address.c_str(), &address.sin_addr) != 1) {
+        error_ = "invalid bind address " + bind_address;
+        return;
+    }
+
+    listen_fd_ = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    const int on = 1;
+    socklen_t length = sizeof(address);
+    if (listen_fd_ < 0 || setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on)) != 0 ||
+        bind(listen_fd_, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+        listen(listen_fd_, SOMAXCONN) != 0 ||
+        getsockname(listen_fd_, reinterpret_cast<sockaddr*>(&address), &length) != 0) {
+        error_ = "listen on " + bind_address + ":" + std::to_string(port) + ": " + std::strerror(errno);
+        return;
+    }
+    port_ = ntohs(address.sin_port);
+
+    const int epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.u32 = NO_CONNECTION;
+    if (epoll_fd < 0 || epoll_ctl(epoll_fd, EPOLL_CTL_ADD, listen_fd_, &event) != 0) {
+        error_ = std::string("epoll: ") + std::strerror(errno);
+        if (epoll_fd >= 0) ::close(epoll_fd);
+        return;
+    }
+    epoll_fd_ = epoll_fd;
+}
+
+EpollTcpTransport::~EpollTcpTransport() {
+    for (ConnectionId id = 0; id < connections_.size(); ++id) release(id);
+    if (epoll_fd_ >= 0) ::close(epoll_fd_);
+    if (listen_fd_ >= 0) ::close(listen_fd_);
+}
+
+size_t EpollTcpTransport::poll(GatewaySessionHandler& handler, int timeout_ms) {
+    std::array<epoll_event, GATEWAY_POLL_EVENTS> events;
+    const int ready = epoll_wait(epoll_fd_, events.data(), static_cast<int>(events.size()), timeout_ms);
+    if (ready <= 0) return 0;
+
+    size_t served = 0;
+    for (int i = 0; i < ready; ++i) {
+        const ConnectionId id = events[i].data.u32;
+        if (id == NO_CONNECTION) {
+            accept_all(handler);
+        } else if (connections_[id].fd >= 0) {
+            receive(id, handler);
+            ++served;
+        }
+    }
+    return served;
+}
+
+void EpollTcpTransport::accept_all(GatewaySessionHandler& handler) {
+    while (true) {
+        const int fd = accept4(listen_fd_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) return;  // EAGAIN once the backlog is empty
+
+        ConnectionId id = 0;
+        while (id < connections_.size() && connections_[id].fd >= 0) ++id;
+        if (id == connections_.size()) {
+            ::close(fd);  // At GATEWAY_MAX_SESSIONS
+            continue;
+        }
+
+        const int on = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+        epoll_event event{};
+        event.events = EPOLLIN | EPOLLRDHUP;
+        event.data.u32 = id;
+        if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &event) != 0) {
+            ::close(fd);
+            continue;
+        }
+
+        Connection& connection = connections_[id];
+        if (!connection.buffer) connection.buffer = std::make_unique<char[]>(GATEWAY_RECV_BUFFER_SIZE);
+        connection.fd = fd;
+        connection.filled = 0;
+        connection.closing = false;
+        handler.on_connect(id);
+    }
+}
+
+void EpollTcpTransport::receive(ConnectionId id, GatewaySessionHandler& handler) {
+    Connection& connection = connections_[id];
+
+    // Read until the socket is drained or the buffer is full, then deliver in one call
+    bool peer_gone = false;
+    while (connection.filled < GATEWAY_RECV_BUFFER_SIZE) {
+        const ssize_t received = ::recv(connection.fd, connection.buffer.get() + connection.filled,
+                                        GATEWAY_RECV_BUFFER_SIZE - connection.filled, 0);
+        if (received > 0) {
+            connection.filled += static_cast<size_t>(received);
+        } else if (received < 0 && errno == EINTR) {
+            continue;
+        } else {
+            peer_gone = received == 0 || (errno != EAGAIN && errno != EWOULDBLOCK);
+            break;
+        }
+    }
+
+    if (connection.filled > 0) {
+        delivering_ = id;
+        const size_t consumed = handler.on_data(id, connection.buffer.get(), connection.filled);
+        delivering_ = NO_CONNECTION;
+        if (connection.closing) {
+            release(id);
+            return;
+        }
+
+        // Keep the partial message at the front for the next delivery
+        connection.filled -= consumed;
+        if (connection.filled > 0) {
+            std::memmove(connection.buffer.get(), connection.buffer.get() + consumed, connection.filled);
+        }
+    }
+
+    if (peer_gone) {
+        release(id);
+        handler.on_disconnect(id);
+    }
+}
+
+bool EpollTcpTransport::send(ConnectionId id, const void* data, size_t size) {
+    if (id >= connections_.size() || connections_[id].fd < 0 || connections_[id].closing) return false;
+    const ssize_t sent = ::send(connections_[id].fd, data, size, MSG_NOSIGNAL | MSG_DONTWAIT);
+    return sent == static_cast<ssize_t>(size);
+}
+
+void EpollTcpTransport::close(ConnectionId id) {
+    if (id >= connections_.size() || connections_[id].fd < 0) return;
+    if (id == delivering_) {
+        connections_[id].closing = true;
+    } else {
+        release(id);
+    }
+}
+
+void EpollTcpTransport::release(ConnectionId id) noexcept {
+    Connection& connection = connections_[id];
+    if (connection.fd < 0) return;
+    epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, connection.fd, nullptr);
+    ::close(connection.fd);
+    connection.fd = -1;
+    connection.filled = 0;
+    connection.closing = false;
+}
+
+} // namespace OrderBook
@@ -0,0 +1,120 @@
+#include "huge_page_region.hpp"
+#include <sys/mman.h>
+#include <algorithm>
+#include <cstdint>
+
+#ifndef MAP_HUGE_SHIFT
+#define MAP_HUGE_SHIFT 26
+#endif
+
+#ifndef MAP_FIXED_NOREPLACE
+#define MAP_FIXED_NOREPLACE 0x100000
+#endif
+
+namespace OrderBook {
+
+namespace {
+
+constexpr uint64_t SMALL_PAGE_SIZE = 4096;
+constexpr uint64_t HUGE_PAGE_SIZE = 2ull << 20;
+constexpr uint64_t GIGANTIC_PAGE_SIZE = 1ull << 30;
+
+uint64_t round_up(uint64_t bytes, uint64_t alignment) noexcept {
+    return (bytes + alignment - 1) & ~(alignment - 1);
+}
+
+} // namespace
+
+const char* to_string(PageBacking backing) noexcept {
+    switch (backing) {
+        case PageBacking::NONE: return "none";
+        case PageBacking::TRANSPARENT_HUGE: return "transparent huge pages";
+        case PageBacking::HUGE_2MB: return "2 MB huge pages";
+        case PageBacking::HUGE_1GB: return "1 GB huge pages";
+    }
+    return "unknown";
+}
+
+HugePageRegion::HugePageRegion(uint64_t max_bytes) noexcept
+    : base_(nullptr), reserved_(0), committed_(0), faulted_(0),
+      page_size_(max_bytes >= GIGANTIC_PAGE_SIZE ? GIGANTIC_PAGE_SIZE : HUGE_PAGE_SIZE),
+      backing_(PageBacking::NONE) {
+
+    const uint64_t reserved = round_up(std::max<uint64_t>(max_bytes, 1), page_size_);
+
+    // Over-reserve by a page so the base can be aligned for hugetlbfs mappings
+    void* raw = mmap(nullptr, reserved + page_size_, PROT_NONE,
+                     MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (raw == MAP_FAILED) return;
+
+    char* start = static_cast<char*>(raw);
+    char* aligned = reinterpret_cast<char*>(round_up(reinterpret_cast<uintptr_t>(start), page_size_));
+    if (aligned > start) munmap(start, aligned - start);
+    char* tail = aligned + reserved;
+    if (tail < start + reserved + page_size_) munmap(tail, start + reserved + page_size_ - tail);
+
+    base_ = aligned;
+    reserved_ = reserved;
+}
+
+HugePageRegion::~HugePageRegion() {
+    if (base_) munmap(base_, reserved_);
+}
+
+bool HugePageRegion::map_at(uint64_t offset, uint64_t bytes, int flags) noexcept {
+    char* target = base_ + offset;
+    void* map = mmap(target, bytes, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE | flags, -1, 0);
+    if (map == MAP_FAILED) return false;
+    if (map != target) {
+        // Pre-4.17 kernels treat MAP_FIXED_NOREPLACE as a hint only
+        munmap(map, bytes);
+        return false;
+    }
+    return true;
+}
+
+bool HugePageRegion::commit(uint64_t bytes) noexcept {
+    if (!base_ || bytes > reserved_) return false;
+
+    if (bytes > committed_) {
+        const uint64_t end = round_up(bytes, page_size_);
+        const uint64_t length = end - committed_;
+
+        // A failed MAP_HUGETLB | MAP_FIXED unmaps the range it was meant to
+        // replace, so the reservation is released first and both attempts
+        // refuse to map over anything else that might have landed there
+        munmap(base_ + committed_, length);
+
+        const int page_shift = (page_size_ == GIGANTIC_PAGE_SIZE) ? 30 : 21;
+        PageBacking backing;
+        if (map_at(committed_, length, MAP_HUGETLB | MAP_POPULATE | (page_shift << MAP_HUGE_SHIFT))) {
+            backing = (page_size_ == GIGANTIC_PAGE_SIZE) ? PageBacking::HUGE_1GB : PageBacking::HUGE_2MB;
+        } else if (map_at(committed_, length, 0)) {
+            madvise(base_ + committed_, length, MADV_HUGEPAGE);  // Best effort - THP may be disabled
+            backing = PageBacking::TRANSPARENT_HUGE;
+        } else {
+            // Put the reservation back. If something else has taken the range,
+            // stop here for good so neither commit() nor the destructor touch it
+            void* map = mmap(base_ + committed_, length, PROT_NONE,
+                             MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE | MAP_FIXED_NOREPLACE, -1, 0);
+            if (map != base_ + committed_) {
+                if (map != MAP_FAILED) munmap(map, length);
+                reserved_ = committed_;
+            }
+            return false;
+        }
+
+        backing_ = (backing_ == PageBacking::NONE) ? backing : std::min(backing_, backing);
+        committed_ = end;
+    }
+
+    // Fault in what the caller asked for now rather than on first use
+    for (uint64_t offset = faulted_; offset < bytes; offset += SMALL_PAGE_SIZE) {
+        static_cast<volatile char*>(base_)[offset] = 0;
+    }
+    faulted_ = std::max(faulted_, bytes);
+    return true;
+}
+
+} // namespace OrderBook
@@ -0,0 +1,13 @@
+#include "ingress_fan_in.hpp"
+
+namespace OrderBook {
+
+IngressFanIn::IngressFanIn(uint32_t lane_count, uint64_t lane_capacity, uint64_t quantum)
+    : quantum_(quantum ? quantum : 1), next_lane_(0), next_sequence_(1) {
+    lanes_.reserve(lane_count ? lane_count : 1);
+    for (uint32_t i = 0; i < std::max<uint32_t>(lane_count, 1); ++i) {
+        lanes_.push_back(std::make_unique<SPSCQueue<Command>>(lane_capacity));
+    }
+}
+
+} // namespace OrderBook
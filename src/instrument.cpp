@@ -0,0 +1,37 @@
+#include "instrument.hpp"
+
+namespace OrderBook {
+
+void SymbolTable::add(uint32_t instrument_id, std::string_view symbol) {
+    if (instrument_id >= symbols_.size()) {
+        symbols_.resize(instrument_id + 1);
+    }
+    symbols_[instrument_id] = symbol;
+}
+
+void SymbolTable::add(const Instrument& instrument) {
+    add(instrument.instrument_id, instrument.symbol);
+}
+
+std::string_view SymbolTable::symbol(uint32_t instrument_id) const noexcept {
+    return (instrument_id < symbols_.size()) ? std::string_view(symbols_[instrument_id]) : std::string_view();
+}
+
+uint32_t SymbolTable::find(std::string_view symbol) const noexcept {
+    if (symbol.empty()) return 0;
+    
+    for (uint32_t id = 0; id < symbols_.size(); ++id) {
+        if (symbols_[id] == symbol) return id;
+    }
+    return 0;
+}
+
+size_t SymbolTable::size() const noexcept {
+    size_t count = 0;
+    for (const auto& symbol : symbols_) {
+        if (!symbol.empty()) ++count;
+    }
+    return count;
+}
+
+} // namespace OrderBook
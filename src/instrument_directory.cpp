@@ -0,0 +1,153 @@
+#include "instrument_directory.hpp"
+#include <algorithm>
+#include <functional>
+#include <new>
+
+namespace OrderBook {
+
+InstrumentDirectory::Entry::Entry(const Instrument& inst, OrderPool& pool)
+    : book(pool, inst), trades(0), volume(0), instrument(inst) {}
+
+InstrumentDirectory::InstrumentDirectory(OrderPool& pool, uint32_t capacity)
+    : pool_(pool),
+      capacity_(capacity),
+      storage_(new EntryStorage[capacity]),
+      control_(new SlotControl[capacity]),
+      entries_(reinterpret_cast<Entry*>(storage_.get())),
+      live_count_(0),
+      retired_count_(0),
+      published_(nullptr),
+      hazard_(nullptr),
+      retired_pending_(0),
+      current_(nullptr),
+      current_slots_(nullptr),
+      current_limit_(0) {
+
+    free_slots_.reserve(capacity);
+    for (uint32_t slot = capacity; slot > 0; --slot) {
+        free_slots_.push_back(slot - 1);
+    }
+
+    auto empty = std::make_unique<Snapshot>();
+    empty->epoch = 0;
+    const Snapshot* first = empty.get();
+    snapshots_.push_back(std::move(empty));
+    published_.store(first, std::memory_order_release);
+    adopt(first);
+}
+
+InstrumentDirectory::~InstrumentDirectory() {
+    for (uint32_t slot = 0; slot < capacity_; ++slot) {
+        if (control_[slot].state.load(std::memory_order_relaxed) != SlotState::FREE) {
+            entries_[slot].~Entry();
+        }
+    }
+}
+
+void InstrumentDirectory::adopt(const Snapshot* snapshot) noexcept {
+    // Advertise before use, then make sure the snapshot wasn't superseded
+    // (and possibly reclaimed) before the advertisement became visible
+    const Snapshot* seen;
+    do {
+        seen = snapshot;
+        hazard_.store(seen, std::memory_order_seq_cst);
+        snapshot = published_.load(std::memory_order_seq_cst);
+    } while (snapshot != seen);
+
+    current_ = seen;
+    current_slots_ = seen->slot_of.data();
+    current_limit_ = static_cast<uint32_t>(seen->slot_of.size());
+}
+
+uint32_t InstrumentDirectory::slot_in(const Snapshot& snapshot, uint32_t instrument_id) const noexcept {
+    return (instrument_id < snapshot.slot_of.size()) ? snapshot.slot_of[instrument_id] : NO_SLOT;
+}
+
+void InstrumentDirectory::publish(std::unique_ptr<Snapshot> next) {
+    const Snapshot* snapshot = next.get();
+    snapshots_.push_back(std::move(next));
+    published_.store(snapshot, std::memory_order_seq_cst);
+}
+
+bool InstrumentDirectory::add(const Instrument& instrument) {
+    collect();
+
+    const Snapshot& base = *latest();
+    if (slot_in(base, instrument.instrument_id) != NO_SLOT || free_slots_.empty()) {
+        return false;
+    }
+
+    const uint32_t slot = free_slots_.back();
+    auto next = std::make_unique<Snapshot>(base);
+    next->epoch = base.epoch + 1;
+    if (instrument.instrument_id >= next->slot_of.size()) {
+        next->slot_of.resize(instrument.instrument_id + 1, NO_SLOT);
+    }
+    next->slot_of[instrument.instrument_id] = slot;
+    snapshots_.reserve(snapshots_.size() + 1);
+    new (&entries_[slot]) Entry(instrument, pool_);
+
+    // Nothing below throws - commit
+    free_slots_.pop_back();
+    control_[slot].state.store(SlotState::LIVE, std::memory_order_relaxed);
+    publish(std::move(next));
+    ++live_count_;
+    return true;
+}
+
+bool InstrumentDirectory::remove(uint32_t instrument_id) {
+    collect();
+
+    const Snapshot& base = *latest();
+    const uint32_t slot = slot_in(base, instrument_id);
+    if (slot == NO_SLOT) return false;
+
+    auto next = std::make_unique<Snapshot>(base);
+    next->epoch = base.epoch + 1;
+    next->slot_of[instrument_id] = NO_SLOT;
+    const uint64_t retire_epoch = next->epoch;
+    publish(std::move(next));
+
+    SlotControl& control = control_[slot];
+    control.retire_epoch = retire_epoch;
+    retired_pending_.fetch_add(1, std::memory_order_relaxed);
+    control.state.store(SlotState::RETIRED, std::memory_order_release);
+    --live_count_;
+    ++retired_count_;
+    return true;
+}
+
+void InstrumentDirectory::collect() {
+    if (retired_count_ > 0) {
+        const size_t freed_before = free_slots_.size();
+        for (uint32_t slot = 0; slot < capacity_; ++slot) {
+            SlotControl& control = control_[slot];
+            if (control.state.load(std::memory_order_acquire) != SlotState::DRAINED) continue;
+
+            entries_[slot].~Entry();
+            control.state.store(SlotState::FREE, std::memory_order_relaxed);
+            free_slots_.push_back(slot);
+            --retired_count_;
+        }
+        // Keep handing out the lowest slots so live entries stay packed
+        if (free_slots_.size() != freed_before) {
+            std::sort(free_slots_.begin(), free_slots_.end(), std::greater<uint32_t>());
+        }
+    }
+
+    // Only the newest snapshot and the one the matching thread holds can be in use
+    const Snapshot* newest = latest();
+    const Snapshot* held = hazard_.load(std::memory_order_seq_cst);
+    snapshots_.erase(std::remove_if(snapshots_.begin(), snapshots_.end(),
+                                    [&](const std::unique_ptr<Snapshot>& snapshot) {
+                                        return snapshot.get() != newest && snapshot.get() != held;
+                                    }),
+                     snapshots_.end());
+}
+
+const InstrumentDirectory::Entry* InstrumentDirectory::lookup(uint32_t instrument_id) const noexcept {
+    const uint32_t slot = slot_in(*latest(), instrument_id);
+    return (slot != NO_SLOT) ? entries_ + slot : nullptr;
+}
+
+} // namespace OrderBook
@@ -0,0 +1,66 @@
+#include "latency_histogram.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace OrderBook {
+
+LatencyHistogram::LatencyHistogram() noexcept {
+    reset();
+}
+
+uint64_t LatencyHistogram::lowest_in_bucket(size_t bucket) noexcept {
+    constexpr size_t linear = size_t{1} << SUB_BUCKET_BITS;
+    if (bucket < linear) return bucket;
+
+    // Log buckets: bucket = (shift << (SUB_BUCKET_BITS - 1)) + sub, sub in [linear / 2, linear)
+    const uint32_t shift = static_cast<uint32_t>(bucket >> (SUB_BUCKET_BITS - 1)) - 1;
+    const uint64_t sub = bucket - (size_t{shift} << (SUB_BUCKET_BITS - 1));
+    return sub << shift;
+}
+
+uint64_t LatencyHistogram::highest_in_bucket(size_t bucket) noexcept {
+    if (bucket + 1 >= BUCKET_COUNT) return MAX_VALUE;
+    return lowest_in_bucket(bucket + 1) - 1;
+}
+
+void LatencyHistogram::merge(const LatencyHistogram& other) noexcept {
+    for (size_t bucket = 0; bucket < BUCKET_COUNT; ++bucket) {
+        counts_[bucket] += other.counts_[bucket];
+    }
+    count_ += other.count_;
+    clamped_ += other.clamped_;
+    sum_ += other.sum_;
+    min_ = std::min(min_, other.min_);
+    max_ = std::max(max_, other.max_);
+}
+
+void LatencyHistogram::reset() noexcept {
+    counts_.fill(0);
+    count_ = 0;
+    clamped_ = 0;
+    min_ = std::numeric_limits<uint64_t>::max();
+    max_ = 0;
+    sum_ = 0;
+}
+
+uint64_t LatencyHistogram::percentile(double percentile) const noexcept {
+    if (count_ == 0) return 0;
+    if (percentile <= 0.0) return min_;
+    if (percentile >= 100.0) return max_;
+
+    // Rank of the sample the percentile lands on, 1-based
+    const uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(percentile / 100.0 * count_)));
+    uint64_t seen = 0;
+    for (size_t bucket = 0; bucket < BUCKET_COUNT; ++bucket) {
+        seen += counts_[bucket];
+        if (seen >= rank) return std::min(highest_in_bucket(bucket), max_);
+    }
+    return max_;
+}
+
+double LatencyHistogram::mean() const noexcept {
+    return count_ ? static_cast<double>(sum_) / count_ : 0.0;
+}
+
+} // namespace OrderBook
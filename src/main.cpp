@@ -1,44 +1,396 @@
 #include "matching_engine.hpp"
 #include "feed_handler.hpp"
 #include "spsc_ring_buffer.hpp"
+#include "ingress_fan_in.hpp"
+#include "output_stage.hpp"
+#include "shared_ring.hpp"
+#include "command_journal.hpp"
+#include "market_data.hpp"
+#include "instrument.hpp"
+#include "tsc_clock.hpp"
+#include "numa_placement.hpp"
+#include "wait_strategy.hpp"
+#include "sharded_matching_engine.hpp"
 #include <iostream>
+#include <cstring>
+#include <cstdlib>
+#include <memory>
 #include <thread>
 #include <chrono>
 #include <algorithm>
+#include <bit>
+#include <string>
+#include <vector>
 
 using namespace OrderBook;
 
 /**
- * Calculate percentile from sorted vector
+ * One line of the per-stage latency breakdown
  */
-long long calculate_percentile(const std::vector<long long>& sorted_data, double percentile) noexcept {
-    if (sorted_data.empty()) return 0;
+void print_stage_latency(const char* name, const LatencyHistogram& histogram) {
+    std::cout << name << ": P50 " << histogram.percentile(50.0) << " / P99 " << histogram.percentile(99.0)
+              << " / P99.9 " << histogram.percentile(99.9) << " / max " << histogram.max() << " ns ("
+              << histogram.count() << " samples)\n";
+}
+
+/**
+ * One line of the placement report: sampled pages local / remote to the matching node
+ */
+void print_census(const char* name, const PageCensus& census) {
+    const uint64_t placed = census.local + census.remote;
+    std::cout << name << ": " << census.local << " local / " << census.remote << " remote pages";
+    if (placed > 0) std::cout << " (" << (census.local * 100 / placed) << "% local)";
+    if (census.unknown > 0) std::cout << ", " << census.unknown << " unknown";
+    std::cout << "\n";
+}
+
+/**
+ * Comma-separated core list, e.g. "2,3,4,5"
+ */
+std::vector<int> parse_cpu_list(const char* list) {
+    std::vector<int> cpus;
+    for (const char* p = list; *p;) {
+        char* end = nullptr;
+        cpus.push_back(static_cast<int>(std::strtol(p, &end, 10)));
+        if (end == p) break;
+        p = (*end == ',') ? end + 1 : end;
+    }
+    return cpus;
+}
+
+/**
+ * --shards mode: the feed thread routes a multi-symbol flow into N matching
+ * shards. Matching only - shards run without output stages.
+ */
+int run_sharded_benchmark(uint32_t shard_count, uint32_t symbol_count, const PlacementConfig& placement,
+                          const std::vector<int>& shard_cpus, uint64_t seed) {
+    // Each shard gets its share of the single-engine pool and ring
+    ShardingConfig config(shard_count, shard_cpus, std::max<uint64_t>(MAX_ORDERS / shard_count, 1024),
+                          std::bit_ceil(std::max<uint64_t>(RING_BUFFER_SIZE / shard_count, 1024)));
+    ShardedMatchingEngine engine(config);
+    for (uint32_t id = 1; id <= symbol_count; ++id) {
+        engine.add_instrument(Instrument(id, "SYM" + std::to_string(id)));
+    }
+    
+    std::cout << "Starting sharded benchmark with " << TOTAL_ORDERS_TO_GENERATE << " orders over "
+              << symbol_count << " instruments on " << shard_count << " shard(s)...\n\n";
+    
+    const auto start_time = std::chrono::high_resolution_clock::now();
+    
+    engine.start();
+    std::thread ingress_thread([&engine, symbol_count, seed, cpu = placement.feed_cpu] {
+        if (cpu >= 0) NumaPlacement::pin_current_thread(cpu);
+        FeedHandler::run(&engine, symbol_count, seed);
+    });
+    ingress_thread.join();
+    engine.stop();
+    
+    const auto end_time = std::chrono::high_resolution_clock::now();
+    const auto total_duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
+    
+    std::cout << "\n=== SHARDED BENCHMARK RESULTS ===\n";
+    std::cout << "Total run time: " << total_duration.count() << " ms\n";
+    std::cout << "Orders processed: " << engine.orders_processed() << "\n";
+    std::cout << "Orders rejected (pool exhausted): " << engine.orders_rejected() << "\n";
+    std::cout << "Orders per second: "
+              << static_cast<uint64_t>(engine.orders_processed() * 1000.0 / total_duration.count()) << "\n";
+    std::cout << "Trades executed: " << engine.total_trades_executed() << "\n";
+    std::cout << "Router stalls (shard ring full): " << engine.router_stalls() << "\n";
+    for (uint32_t i = 0; i < engine.shard_count(); ++i) {
+        const MultiInstrumentEngine& shard = engine.shard(i);
+        std::cout << "Shard " << i << ": " << shard.orders_processed() << " orders, "
+                  << shard.total_trades_executed() << " trades\n";
+    }
+    
+    std::cout << "\n=== LATENCY STATISTICS ===\n";
+    print_stage_latency("Queueing (route -> dequeue)", engine.queue_latency());
+    print_stage_latency("Matching (dequeue -> fill)", engine.trade_latency());
+    return 0;
+}
+
+/**
+ * --recover: rebuild an engine from the latest snapshot plus the journal
+ * tail and report how long the restart took
+ */
+int run_recovery(const char* snapshot_path, const char* journal_base) {
+    std::cout << "Recovering from snapshot " << (snapshot_path ? snapshot_path : "(none)")
+              << " and journal " << (journal_base ? journal_base : "(none)") << "...\n\n";
+    
+    const auto start_time = std::chrono::high_resolution_clock::now();
+    SPSCRingBuffer ring_buffer;
+    MatchingEngine engine(&ring_buffer);
+    const auto constructed_time = std::chrono::high_resolution_clock::now();
+    const RecoveryResult result = engine.recover(snapshot_path ? snapshot_path : "", journal_base ? journal_base : "");
+    const auto end_time = std::chrono::high_resolution_clock::now();
     
-    const size_t index = static_cast<size_t>((percentile / 100.0) * (sorted_data.size() - 1));
-    return sorted_data[index];
+    const auto to_ms = [](auto duration) {
+        return std::chrono::duration_cast<std::chrono::microseconds>(duration).count() / 1000.0;
+    };
+    
+    std::cout << "=== RECOVERY RESULTS ===\n";
+    std::cout << "Engine construction: " << to_ms(constructed_time - start_time) << " ms\n";
+    std::cout << "Snapshot: " << (result.snapshot_loaded ? "loaded" : "none") << ", sequence "
+              << result.snapshot_sequence << "\n";
+    std::cout << "Journal commands replayed: " << result.commands_replayed << "\n";
+    std::cout << "Recovered to sequence: " << result.last_sequence << "\n";
+    std::cout << "Resting orders: " << engine.order_index().size() << "\n";
+    std::cout << "Trades executed: " << engine.trades_executed() << "\n";
+    std::cout << "Recovery time (load + replay): " << to_ms(end_time - constructed_time) << " ms\n";
+    std::cout << "Recovery: " << (result.ok ? "PASS" : "FAIL") << "\n";
+    return result.ok ? 0 : 1;
 }
 
-int main() {
+int main(int argc, char** argv) {
+    // --silent: no execution reports at all, for pure matching benchmarks
+    // --record <base>: also journal all market data in binary (replay with md_replay)
+    // --feed-cpu / --matching-cpu / --publisher-cpu <n>: pin that thread to a core
+    // --shards <n> [--symbols <m>] [--shard-cpus a,b,...]: sharded multi-instrument matching
+    // --producers <n> [--producer-cpus a,b,...]: n gateway threads fanned in to the engine
+    // --wait spin|pause|yield|park|timed: how feed and engine wait on a full / empty ring
+    // --journal <base> [--journal-cpu <n>]: write-ahead journal of every command the engine consumes
+    // --snapshot <path> [--snapshot-every <n>]: engine snapshot every n commands (default 5M)
+    // --recover: rebuild from --snapshot and --journal instead of running the benchmark
+    // --seed <n>: fixed generator seed, for a reproducible synthetic flow
+    // --replay <capture> [--pacing max|recorded]: drive the engine from a feed capture (see feed_capture)
+    // --shm <name>: commands from /dev/shm/<name>.in, output to <name>.out - gateway and consumer run as shm_peer
+    bool silent = false;
+    const char* record_base = nullptr;
+    PlacementConfig placement;
+    uint32_t shard_count = 0;
+    uint32_t symbol_count = 5000;
+    std::vector<int> shard_cpus;
+    uint32_t producer_count = 1;
+    std::vector<int> producer_cpus;
+    WaitConfig engine_wait(WaitPolicy::BUSY_SPIN);  // Defaults: engine spins, feed yields
+    WaitConfig feed_wait(WaitPolicy::YIELD);
+    const char* journal_base = nullptr;
+    const char* snapshot_path = nullptr;
+    uint64_t snapshot_every = 5'000'000;
+    bool recover = false;
+    uint64_t seed = FeedHandler::RANDOM_SEED;
+    const char* replay_path = nullptr;
+    ReplayPacing pacing = ReplayPacing::MAX_RATE;
+    const char* shm_name = nullptr;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--silent") == 0) {
+            silent = true;
+        } else if (std::strcmp(argv[i], "--record") == 0 && i + 1 < argc) {
+            record_base = argv[++i];
+        } else if (std::strcmp(argv[i], "--feed-cpu") == 0 && i + 1 < argc) {
+            placement.feed_cpu = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--matching-cpu") == 0 && i + 1 < argc) {
+            placement.matching_cpu = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--publisher-cpu") == 0 && i + 1 < argc) {
+            placement.publisher_cpu = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--shards") == 0 && i + 1 < argc) {
+            shard_count = static_cast<uint32_t>(std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--symbols") == 0 && i + 1 < argc) {
+            symbol_count = static_cast<uint32_t>(std::max(1, std::atoi(argv[++i])));
+        } else if (std::strcmp(argv[i], "--shard-cpus") == 0 && i + 1 < argc) {
+            shard_cpus = parse_cpu_list(argv[++i]);
+        } else if (std::strcmp(argv[i], "--producers") == 0 && i + 1 < argc) {
+            producer_count = static_cast<uint32_t>(std::max(1, std::atoi(argv[++i])));
+        } else if (std::strcmp(argv[i], "--producer-cpus") == 0 && i + 1 < argc) {
+            producer_cpus = parse_cpu_list(argv[++i]);
+        } else if (std::strcmp(argv[i], "--wait") == 0 && i + 1 < argc) {
+            WaitPolicy policy;
+            if (!parse_wait_policy(argv[++i], policy)) {
+                std::cerr << "Unknown wait policy " << argv[i] << " (spin, pause, yield, park, timed)\n";
+                return 1;
+            }
+            engine_wait = WaitConfig(policy);
+            feed_wait = WaitConfig(policy);
+        } else if (std::strcmp(argv[i], "--journal") == 0 && i + 1 < argc) {
+            journal_base = argv[++i];
+        } else if (std::strcmp(argv[i], "--journal-cpu") == 0 && i + 1 < argc) {
+            placement.journal_cpu = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--snapshot") == 0 && i + 1 < argc) {
+            snapshot_path = argv[++i];
+        } else if (std::strcmp(argv[i], "--snapshot-every") == 0 && i + 1 < argc) {
+            snapshot_every = std::strtoull(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--recover") == 0) {
+            recover = true;
+        } else if (std::strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = std::strtoull(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+            replay_path = argv[++i];
+        } else if (std::strcmp(argv[i], "--pacing") == 0 && i + 1 < argc) {
+            ++i;
+            if (std::strcmp(argv[i], "recorded") == 0) {
+                pacing = ReplayPacing::RECORDED;
+            } else if (std::strcmp(argv[i], "max") == 0) {
+                pacing = ReplayPacing::MAX_RATE;
+            } else {
+                std::cerr << "Unknown pacing " << argv[i] << " (max, recorded)\n";
+                return 1;
+            }
+        } else if (std::strcmp(argv[i], "--shm") == 0 && i + 1 < argc) {
+            shm_name = argv[++i];
+        }
+    }
+    if (shard_count == 0 && !shard_cpus.empty()) shard_count = static_cast<uint32_t>(shard_cpus.size());
+    if (producer_cpus.empty()) producer_cpus.push_back(placement.feed_cpu);
+    if (shm_name && (replay_path || producer_count > 1)) {
+        std::cerr << "--shm takes its commands from the shared ring; --replay and --producers go to shm_peer\n";
+        return 1;
+    }
+    
     std::cout << "High-Performance C++20 Limit Order Book\n";
     std::cout << "========================================\n\n";
     
-    // Initialize components
-    SPSCRingBuffer ring_buffer;
-    MatchingEngine matching_engine(&ring_buffer);
+    // Calibrate the TSC before any thread stamps a command
+    TscClock::calibrate();
+    
+    if (recover) {
+        return run_recovery(snapshot_path, journal_base);
+    }
+    
+    if (shard_count > 0) {
+        return run_sharded_benchmark(shard_count, symbol_count, placement, shard_cpus, seed);
+    }
+    
+    // A capture replaces the generator: same commands, same order, every run
+    std::unique_ptr<FeedCapture> capture;
+    if (replay_path) {
+        capture = std::make_unique<FeedCapture>(replay_path);
+        if (!capture->is_open()) {
+            std::cerr << "Cannot read feed capture " << replay_path << "\n";
+            return 1;
+        }
+        if (producer_count > 1) {
+            std::cerr << "--replay drives a single feed; ignoring --producers\n";
+            producer_count = 1;
+        }
+    }
+    const uint64_t command_count = capture ? capture->size() : TOTAL_ORDERS_TO_GENERATE;
+    
+    // The command ring, order pool, order-id index, book and output ring are
+    // all written by the matching thread: fault them in on its node
+    const int matching_node = NumaPlacement::node_of_cpu(placement.matching_cpu);
+    if (placement.matching_cpu >= 0 && matching_node < 0) {
+        std::cerr << "WARNING: cpu " << placement.matching_cpu << " not found, engine memory left unplaced\n";
+    }
+    NumaPlacement::ScopedNodePreference prefer_matching_node(matching_node);
+    
+    // Initialize components: one feed ring, in process or shared, or one lane per gateway thread
+    std::unique_ptr<SPSCRingBuffer> ring_buffer;
+    std::unique_ptr<SharedRing<SPSCRingBuffer>> shm_ingress;
+    std::unique_ptr<IngressFanIn> ingress;
+    std::unique_ptr<MatchingEngine> engine;
+    if (shm_name) {
+        shm_ingress = std::make_unique<SharedRing<SPSCRingBuffer>>(std::string(shm_name) + ".in",
+                                                                   RingEnd::CONSUMER, RING_BUFFER_SIZE);
+        if (!shm_ingress->is_open()) {
+            std::cerr << "Cannot create command ring: " << shm_ingress->error() << "\n";
+            return 1;
+        }
+        engine = std::make_unique<MatchingEngine>(&shm_ingress->queue());
+    } else if (producer_count > 1) {
+        ingress = std::make_unique<IngressFanIn>(
+            producer_count, std::bit_ceil(std::max<uint64_t>(RING_BUFFER_SIZE / producer_count, 1024)));
+        engine = std::make_unique<MatchingEngine>(ingress.get());
+    } else {
+        ring_buffer = std::make_unique<SPSCRingBuffer>();
+        engine = std::make_unique<MatchingEngine>(ring_buffer.get());
+    }
+    MatchingEngine& matching_engine = *engine;
+    SPSCRingBuffer* command_ring = shm_ingress ? &shm_ingress->queue() : ring_buffer.get();
+    
+    // Doorbells are process-local; a shared ring's parked engine falls back to timed sleeps
+    WaitSignals wait_signals;  // Lets parked engine / producers wake each other
+    matching_engine.set_wait_strategy(engine_wait, shm_name ? nullptr : &wait_signals);
+    
+    // Trades are formatted and written by the output stage's publisher thread;
+    // events carry instrument ids and publishers resolve symbols from this table
+    SymbolTable symbols;
+    symbols.add(DEFAULT_INSTRUMENT_ID, "DEFAULT");
+    MarketDataManager market_data(&symbols);
+    market_data.set_conflation(true);  // At most one delta per level per output batch
+    market_data.add_publisher(std::make_unique<ConsoleMarketDataPublisher>());
+    if (record_base) {
+        market_data.add_publisher(std::make_unique<FileMarketDataPublisher>(record_base, true));
+    }
     
-    std::cout << "Starting benchmark with " << TOTAL_ORDERS_TO_GENERATE << " orders...\n\n";
+    // Shared output ring: this process only produces, shm_peer consume publishes
+    std::unique_ptr<SharedRing<SPSCQueue<OutputEvent>>> shm_output;
+    std::unique_ptr<OutputStage> output;
+    if (shm_name && !silent) {
+        shm_output = std::make_unique<SharedRing<SPSCQueue<OutputEvent>>>(std::string(shm_name) + ".out",
+                                                                          RingEnd::PRODUCER, OUTPUT_RING_SIZE);
+        if (!shm_output->is_open()) {
+            std::cerr << "Cannot create output ring: " << shm_output->error() << "\n";
+            return 1;
+        }
+        output = std::make_unique<OutputStage>(nullptr, &shm_output->queue());
+    } else {
+        output = std::make_unique<OutputStage>(&market_data);
+    }
+    OutputStage& output_stage = *output;
+    
+    // Input journal ring is filled by the matching thread too
+    std::unique_ptr<JournalStage> journal;
+    if (journal_base) {
+        journal = std::make_unique<JournalStage>(journal_base);
+        if (!journal->is_open()) {
+            std::cerr << "Cannot open command journal " << journal_base << "\n";
+            return 1;
+        }
+        matching_engine.set_journal(journal.get());
+    }
+    if (snapshot_path) matching_engine.set_snapshot_policy(snapshot_path, snapshot_every);
+    prefer_matching_node.release();
+    if (journal) journal->start(placement.journal_cpu);
+    
+    if (!silent) {
+        matching_engine.set_output_stage(&output_stage);
+        if (!shm_output) output_stage.start(placement.publisher_cpu);
+    }
+    
+    std::cout << "Starting benchmark with " << command_count << " orders from ";
+    if (shm_name) {
+        std::cout << "shared ring /dev/shm/" << shm_name << ".in";
+        if (shm_output) std::cout << " (output to /dev/shm/" << shm_name << ".out)";
+    } else if (capture) {
+        std::cout << "capture " << replay_path << " ("
+                  << (pacing == ReplayPacing::RECORDED ? "recorded pacing" : "max rate") << ")";
+    } else {
+        std::cout << producer_count << " producer(s)";
+    }
+    std::cout << ", wait " << to_string(engine_wait.policy) << "/" << to_string(feed_wait.policy) << "...\n\n";
     
     const auto start_time = std::chrono::high_resolution_clock::now();
     
-    // Launch producer and consumer threads
-    std::thread producer_thread(FeedHandler::run, &ring_buffer);
-    std::thread consumer_thread(&MatchingEngine::run, &matching_engine);
+    // Launch producer and consumer threads; gateways split the order flow between them
+    std::vector<std::thread> producer_threads;
+    for (uint32_t p = 0; p < (shm_name ? 0 : producer_count); ++p) {
+        SPSCQueue<Command>* ring = ingress ? &ingress->lane(p) : command_ring;
+        const uint64_t count = command_count / producer_count + (p < command_count % producer_count ? 1 : 0);
+        const int cpu = (p < producer_cpus.size()) ? producer_cpus[p] : -1;
+        producer_threads.emplace_back([ring, count, cpu, p, seed, pacing, &capture, &feed_wait, &wait_signals] {
+            if (cpu >= 0) NumaPlacement::pin_current_thread(cpu);
+            if (capture) {
+                FeedHandler::replay(ring, *capture, pacing, feed_wait, &wait_signals);
+            } else {
+                // Gateways must not share a flow - each offsets the fixed seed
+                FeedHandler::run(ring, count, feed_wait, &wait_signals,
+                                 (seed == FeedHandler::RANDOM_SEED) ? seed : seed + p);
+            }
+        });
+    }
+    std::thread consumer_thread([&matching_engine, command_count, cpu = placement.matching_cpu] {
+        if (cpu >= 0) NumaPlacement::pin_current_thread(cpu);
+        matching_engine.run(command_count);
+    });
     
     // Wait for completion
-    producer_thread.join();
+    for (std::thread& producer_thread : producer_threads) producer_thread.join();
     consumer_thread.join();
     
     const auto end_time = std::chrono::high_resolution_clock::now();
+    
+    // Publish whatever the engine left queued before printing results
+    output_stage.stop();
+    if (journal) journal->stop();
     const auto total_duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
     
     // Calculate statistics
@@ -46,23 +398,77 @@ int main() {
     const uint64_t trades_executed = matching_engine.trades_executed();
     const double orders_per_second = (orders_processed * 1000.0) / total_duration.count();
     
-    // Latency statistics
-    auto latencies = matching_engine.trade_latencies();
-    std::sort(latencies.begin(), latencies.end());
-    
     // Print results
     std::cout << "\n=== BENCHMARK RESULTS ===\n";
     std::cout << "Total run time: " << total_duration.count() << " ms\n";
     std::cout << "Orders processed: " << orders_processed << "\n";
     std::cout << "Orders rejected (pool exhausted): " << matching_engine.orders_rejected() << "\n";
+    const OrderPool& pool = matching_engine.order_pool();
+    std::cout << "Order pool high-water mark: " << pool.high_water_mark() << " / " << pool.max_capacity()
+              << " (" << pool.slab_count() << " slab(s), " << to_string(pool.page_backing()) << ")\n";
     std::cout << "Orders per second: " << static_cast<uint64_t>(orders_per_second) << "\n";
     std::cout << "Trades executed: " << trades_executed << "\n";
+    if (ingress) {
+        std::cout << "Ingress lanes: " << ingress->lane_count() << ", commands sequenced: "
+                  << ingress->last_sequence() << "\n";
+    }
+    if (journal) {
+        std::cout << "Commands journaled: " << journal->journaled_sequence() << " ("
+                  << journal->journal().segment_count() << " segment(s), "
+                  << journal->producer_stalls() << " ring stalls)\n";
+    }
+    if (snapshot_path) {
+        std::cout << "Snapshots written: " << matching_engine.snapshots_written() << "\n";
+    }
+    if (shm_output) {
+        std::cout << "Output ring stalls: " << output_stage.producer_stalls() << " (published by shm_peer)\n";
+    } else if (!silent) {
+        std::cout << "Output events published: " << output_stage.events_published() << "\n";
+        std::cout << "Output ring stalls: " << output_stage.producer_stalls() << "\n";
+        std::cout << "L2 updates received / published: " << market_data.level2_updates_received() 
+                  << " / " << market_data.level2_updates_published() << "\n";
+    }
     
+    const LatencyHistogram& latencies = matching_engine.trade_latency();
     if (!latencies.empty()) {
         std::cout << "\n=== LATENCY STATISTICS ===\n";
-        std::cout << "P50 latency: " << calculate_percentile(latencies, 50.0) << " ns\n";
-        std::cout << "P95 latency: " << calculate_percentile(latencies, 95.0) << " ns\n";
-        std::cout << "P99 latency: " << calculate_percentile(latencies, 99.0) << " ns\n";
+        std::cout << "P50 latency: " << latencies.percentile(50.0) << " ns\n";
+        std::cout << "P95 latency: " << latencies.percentile(95.0) << " ns\n";
+        std::cout << "P99 latency: " << latencies.percentile(99.0) << " ns\n";
+        
+        // Where a command's time goes, from the gateway's enqueue on
+        print_stage_latency("Queueing (enqueue -> dequeue)", matching_engine.queue_latency());
+        print_stage_latency("Matching (dequeue -> fill)", latencies);
+        if (!silent && !shm_output) {
+            print_stage_latency("Publish (emit -> publisher)", output_stage.publish_latency());
+        }
+    }
+    
+    // Where the matching thread's memory actually ended up
+    if (matching_node >= 0) {
+        std::cout << "\n=== NUMA PLACEMENT ===\n";
+        std::cout << "NUMA nodes: " << NumaPlacement::node_count() << ", matching thread on cpu "
+                  << placement.matching_cpu << " (node " << matching_node << ")\n";
+        
+        const OrderPool& orders = matching_engine.order_pool();
+        PageCensus pool_pages = NumaPlacement::census(orders.order_memory().data(),
+                                                      orders.order_memory().committed_bytes(), matching_node);
+        pool_pages += NumaPlacement::census(orders.info_memory().data(),
+                                            orders.info_memory().committed_bytes(), matching_node);
+        print_census("Order pool", pool_pages);
+        
+        const OrderIdIndex& index = matching_engine.order_index();
+        print_census("Order-id index", NumaPlacement::census(index.storage(), index.storage_bytes(), matching_node));
+        PageCensus ring_pages;
+        if (ingress) {
+            for (uint32_t lane = 0; lane < ingress->lane_count(); ++lane) {
+                ring_pages += NumaPlacement::census(ingress->lane(lane).storage(),
+                                                    ingress->lane(lane).storage_bytes(), matching_node);
+            }
+        } else {
+            ring_pages = NumaPlacement::census(command_ring->storage(), command_ring->storage_bytes(), matching_node);
+        }
+        print_census("Command ring", ring_pages);
     }
     
     // Correctness check
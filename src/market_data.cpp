@@ -1,25 +1,30 @@
 #include "market_data.hpp"
 #include <iostream>
-#include <fstream>
 #include <iomanip>
+#include <sstream>
 
 namespace OrderBook {
 
+std::ostream& operator<<(std::ostream& os, const SymbolRef& ref) {
+    if (ref.symbol.empty()) return os << '#' << ref.instrument_id;
+    return os << ref.symbol;
+}
+
 // Console Market Data Publisher Implementation
 void ConsoleMarketDataPublisher::publish_trade(const Trade& trade) {
-    std::cout << "TRADE: " << trade.symbol 
+    std::cout << "TRADE: " << symbol_for(trade.instrument_id) 
               << " price=" << trade.price 
               << " qty=" << trade.quantity
               << " aggressor=" << trade.aggressor_order_id
               << " resting=" << trade.resting_order_id
               << " side=" << (trade.aggressor_side == Side::BUY ? "BUY" : "SELL")
-              << std::endl;
+              << '\n';
 }
 
 void ConsoleMarketDataPublisher::publish_level2_snapshot(const Level2Snapshot& snapshot) {
     if (!verbose_) return;
     
-    std::cout << "L2_SNAPSHOT: " << snapshot.symbol << std::endl;
+    std::cout << "L2_SNAPSHOT: " << symbol_for(snapshot.instrument_id) << std::endl;
     
     // Print asks (highest to lowest)
     std::cout << "  ASKS:" << std::endl;
@@ -41,89 +46,185 @@ void ConsoleMarketDataPublisher::publish_level2_snapshot(const Level2Snapshot& s
     std::cout << std::endl;
 }
 
-void ConsoleMarketDataPublisher::publish_level2_update(uint32_t instrument_id, const std::string& symbol,
-                                                       Side side, int64_t price, uint64_t new_quantity,
-                                                       uint32_t new_order_count) {
+void ConsoleMarketDataPublisher::publish_level2_update(uint32_t instrument_id, Side side, int64_t price, 
+                                                       uint64_t new_quantity, uint32_t new_order_count) {
     if (!verbose_) return;
     
-    std::cout << "L2_UPDATE: " << symbol 
+    std::cout << "L2_UPDATE: " << symbol_for(instrument_id) 
               << " " << (side == Side::BUY ? "BID" : "ASK")
               << " price=" << price
               << " qty=" << new_quantity
-              << " orders=" << new_order_count << std::endl;
+              << " orders=" << new_order_count << '\n';
+}
+
+void ConsoleMarketDataPublisher::flush() {
+    std::cout.flush();
 }
 
 // File Market Data Publisher Implementation
+namespace {
+
+uint64_t to_epoch_ns(std::chrono::high_resolution_clock::time_point timestamp) {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        timestamp.time_since_epoch()).count());
+}
+
+} // namespace
+
+FileMarketDataPublisher::FileMarketDataPublisher(const std::string& filename, bool binary,
+                                                 uint64_t segment_bytes)
+    : base_filename_(filename), binary_format_(binary) {
+    if (binary_format_) {
+        journal_ = std::make_unique<MarketDataJournal>(base_filename_, segment_bytes);
+    }
+}
+
+std::ofstream& FileMarketDataPublisher::csv_stream(std::ofstream& stream, const std::string& suffix) {
+    // Opened once on first use, then kept open for the whole session
+    if (!stream.is_open()) {
+        stream.open(base_filename_ + suffix, std::ios::app);
+    }
+    return stream;
+}
+
 void FileMarketDataPublisher::publish_trade(const Trade& trade) {
-    std::string filename = base_filename_ + "_trades.csv";
-    std::ofstream file(filename, std::ios::app);
+    if (binary_format_) {
+        JournalRecord record;
+        record.type = JournalRecordType::TRADE;
+        record.timestamp_ns = to_epoch_ns(trade.timestamp);
+        record.instrument_id = trade.instrument_id;
+        record.aggressor_order_id = trade.aggressor_order_id;
+        record.resting_order_id = trade.resting_order_id;
+        record.side = trade.aggressor_side;
+        record.price = trade.price;
+        record.quantity = trade.quantity;
+        journal_->append(record);
+        return;
+    }
     
+    std::ofstream& file = csv_stream(trades_csv_, "_trades.csv");
     if (file.is_open()) {
         // CSV format: timestamp,symbol,price,quantity,aggressor_id,resting_id,aggressor_side
-        auto time_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
-            trade.timestamp.time_since_epoch()).count();
-        
-        file << time_ns << ","
-             << trade.symbol << ","
+        file << to_epoch_ns(trade.timestamp) << ","
+             << symbol_for(trade.instrument_id) << ","
              << trade.price << ","
              << trade.quantity << ","
              << trade.aggressor_order_id << ","
              << trade.resting_order_id << ","
-             << (trade.aggressor_side == Side::BUY ? "BUY" : "SELL") << std::endl;
+             << (trade.aggressor_side == Side::BUY ? "BUY" : "SELL") << '\n';
     }
 }
 
 void FileMarketDataPublisher::publish_level2_snapshot(const Level2Snapshot& snapshot) {
-    std::string filename = base_filename_ + "_l2_" + snapshot.symbol + ".csv";
-    std::ofstream file(filename, std::ios::app);
+    const uint64_t time_ns = to_epoch_ns(snapshot.timestamp);
     
-    if (file.is_open()) {
-        auto time_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
-            snapshot.timestamp.time_since_epoch()).count();
+    if (binary_format_) {
+        JournalRecord record;
+        record.type = JournalRecordType::SNAPSHOT_BEGIN;
+        record.timestamp_ns = time_ns;
+        record.instrument_id = snapshot.instrument_id;
+        record.quantity = snapshot.bids.size();
+        record.order_count = static_cast<uint32_t>(snapshot.asks.size());
+        journal_->append(record);
+        
+        record.type = JournalRecordType::SNAPSHOT_LEVEL;
+        for (const auto* levels : {&snapshot.bids, &snapshot.asks}) {
+            record.side = (levels == &snapshot.bids) ? Side::BUY : Side::SELL;
+            for (const auto& level : *levels) {
+                record.price = level.price;
+                record.quantity = level.quantity;
+                record.order_count = level.order_count;
+                journal_->append(record);
+            }
+        }
         
+        JournalRecord end;
+        end.type = JournalRecordType::SNAPSHOT_END;
+        end.timestamp_ns = time_ns;
+        end.instrument_id = snapshot.instrument_id;
+        journal_->append(end);
+        return;
+    }
+    
+    const SymbolRef symbol = symbol_for(snapshot.instrument_id);
+    std::ofstream& file = csv_stream(snapshot_csv_[snapshot.instrument_id], 
+                                     "_l2_" + (std::ostringstream() << symbol).str() + ".csv");
+    if (file.is_open()) {
         // Write snapshot header
-        file << "SNAPSHOT," << time_ns << "," << snapshot.symbol << std::endl;
+        file << "SNAPSHOT," << time_ns << "," << symbol << '\n';
         
         // Write bids
         for (const auto& level : snapshot.bids) {
             file << "BID," << level.price << "," << level.quantity 
-                 << "," << level.order_count << std::endl;
+                 << "," << level.order_count << '\n';
         }
         
         // Write asks
         for (const auto& level : snapshot.asks) {
             file << "ASK," << level.price << "," << level.quantity 
-                 << "," << level.order_count << std::endl;
+                 << "," << level.order_count << '\n';
         }
         
-        file << "END_SNAPSHOT" << std::endl;
+        file << "END_SNAPSHOT" << '\n';
     }
 }
 
-void FileMarketDataPublisher::publish_level2_update(uint32_t instrument_id, const std::string& symbol,
-                                                    Side side, int64_t price, uint64_t new_quantity,
-                                                    uint32_t new_order_count) {
-    std::string filename = base_filename_ + "_l2_updates.csv";
-    std::ofstream file(filename, std::ios::app);
+void FileMarketDataPublisher::publish_level2_update(uint32_t instrument_id, Side side, int64_t price, 
+                                                    uint64_t new_quantity, uint32_t new_order_count) {
+    const uint64_t time_ns = to_epoch_ns(std::chrono::high_resolution_clock::now());
     
+    if (binary_format_) {
+        JournalRecord record;
+        record.type = JournalRecordType::LEVEL2_UPDATE;
+        record.timestamp_ns = time_ns;
+        record.instrument_id = instrument_id;
+        record.side = side;
+        record.price = price;
+        record.quantity = new_quantity;
+        record.order_count = new_order_count;
+        journal_->append(record);
+        return;
+    }
+    
+    std::ofstream& file = csv_stream(updates_csv_, "_l2_updates.csv");
     if (file.is_open()) {
-        auto time_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
-            std::chrono::high_resolution_clock::now().time_since_epoch()).count();
-        
         file << time_ns << ","
-             << symbol << ","
+             << symbol_for(instrument_id) << ","
              << (side == Side::BUY ? "BID" : "ASK") << ","
              << price << ","
              << new_quantity << ","
-             << new_order_count << std::endl;
+             << new_order_count << '\n';
+    }
+}
+
+void FileMarketDataPublisher::flush() {
+    // Journal pages are already in the page cache; the kernel writes them back
+    if (journal_) return;
+    
+    if (trades_csv_.is_open()) trades_csv_.flush();
+    if (updates_csv_.is_open()) updates_csv_.flush();
+    for (auto& [instrument_id, file] : snapshot_csv_) {
+        if (file.is_open()) file.flush();
     }
 }
 
+const MarketDataJournal* FileMarketDataPublisher::journal() const noexcept {
+    return journal_.get();
+}
+
 // Market Data Manager Implementation
 void MarketDataManager::add_publisher(std::unique_ptr<MarketDataPublisher> publisher) {
+    publisher->set_symbol_table(symbols_);
     publishers_.push_back(std::move(publisher));
 }
 
+void MarketDataManager::set_symbol_table(const SymbolTable* symbols) {
+    symbols_ = symbols;
+    for (auto& publisher : publishers_) {
+        publisher->set_symbol_table(symbols_);
+    }
+}
+
 void MarketDataManager::remove_all_publishers() {
     publishers_.clear();
 }
@@ -139,19 +240,80 @@ void MarketDataManager::publish_trade(const Trade& trade) {
 void MarketDataManager::publish_level2_snapshot(const Level2Snapshot& snapshot) {
     if (!enabled_) return;
     
+    // Deltas queued before the snapshot go out first
+    publish_pending_updates();
+    
     for (auto& publisher : publishers_) {
         publisher->publish_level2_snapshot(snapshot);
     }
 }
 
-void MarketDataManager::publish_level2_update(uint32_t instrument_id, const std::string& symbol,
-                                              Side side, int64_t price, uint64_t new_quantity,
-                                              uint32_t new_order_count) {
+void MarketDataManager::set_conflation(bool enabled, std::chrono::nanoseconds interval) {
+    publish_pending_updates();
+    conflate_ = enabled;
+    conflation_interval_ = interval;
+    last_conflated_publish_ = std::chrono::steady_clock::now();
+}
+
+void MarketDataManager::publish_level2_update(uint32_t instrument_id, Side side, int64_t price, 
+                                              uint64_t new_quantity, uint32_t new_order_count) {
     if (!enabled_) return;
     
+    ++updates_received_;
+    if (!conflate_) {
+        dispatch_level2_update(instrument_id, side, price, new_quantity, new_order_count);
+        return;
+    }
+    
+    // Overwrite the pending state for this level, or queue it in arrival order
+    const LevelKey key{instrument_id, side, price};
+    auto [it, inserted] = pending_index_.try_emplace(key, pending_updates_.size());
+    if (inserted) {
+        pending_updates_.push_back({instrument_id, side, price, new_quantity, new_order_count});
+    } else {
+        PendingUpdate& pending = pending_updates_[it->second];
+        pending.quantity = new_quantity;
+        pending.order_count = new_order_count;
+    }
+}
+
+void MarketDataManager::dispatch_level2_update(uint32_t instrument_id, Side side, int64_t price, 
+                                               uint64_t new_quantity, uint32_t new_order_count) {
+    ++updates_published_;
+    for (auto& publisher : publishers_) {
+        publisher->publish_level2_update(instrument_id, side, price, new_quantity, new_order_count);
+    }
+}
+
+void MarketDataManager::publish_pending_updates() {
+    for (const PendingUpdate& pending : pending_updates_) {
+        dispatch_level2_update(pending.instrument_id, pending.side, pending.price,
+                               pending.quantity, pending.order_count);
+    }
+    pending_updates_.clear();
+    pending_index_.clear();
+}
+
+void MarketDataManager::flush() {
+    if (conflate_ && !pending_updates_.empty()) {
+        const auto now = std::chrono::steady_clock::now();
+        if (now - last_conflated_publish_ >= conflation_interval_) {
+            publish_pending_updates();
+            last_conflated_publish_ = now;
+        }
+    }
+    
+    for (auto& publisher : publishers_) {
+        publisher->flush();
+    }
+}
+
+void MarketDataManager::flush_all() {
+    publish_pending_updates();
+    
     for (auto& publisher : publishers_) {
-        publisher->publish_level2_update(instrument_id, symbol, side, price, new_quantity, new_order_count);
+        publisher->flush();
     }
 }
 
-} // namespace OrderBook
\ No newline at end of file
+} // namespace OrderBook
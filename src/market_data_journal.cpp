@@ -0,0 +1,264 @@
+#include "market_data_journal.hpp"
+#include "market_data.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <chrono>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace OrderBook {
+
+namespace {
+
+constexpr char JOURNAL_MAGIC[8] = {'O', 'B', 'M', 'D', 'J', 'N', 'L', '\0'};
+constexpr uint32_t JOURNAL_VERSION = 1;
+
+std::chrono::high_resolution_clock::time_point from_ns(uint64_t ns) {
+    using clock = std::chrono::high_resolution_clock;
+    return clock::time_point(std::chrono::duration_cast<clock::duration>(std::chrono::nanoseconds(ns)));
+}
+
+} // namespace
+
+JournalRecord::JournalRecord() noexcept {
+    std::memset(this, 0, sizeof(*this));
+}
+
+// Journal writer
+
+MarketDataJournal::MarketDataJournal(const std::string& base_path, uint64_t segment_bytes)
+    : base_path_(base_path),
+      segment_bytes_(std::max<uint64_t>(segment_bytes, sizeof(JournalSegmentHeader) + sizeof(JournalRecord))),
+      segment_index_(0), fd_(-1), map_(nullptr), write_offset_(0),
+      segment_records_(0), records_written_(0) {
+    open_segment(0);
+}
+
+MarketDataJournal::~MarketDataJournal() {
+    close();
+}
+
+std::string MarketDataJournal::segment_path(const std::string& base_path, uint64_t index) {
+    char suffix[32];
+    std::snprintf(suffix, sizeof(suffix), ".%06llu.mdj", static_cast<unsigned long long>(index));
+    return base_path + suffix;
+}
+
+bool MarketDataJournal::open_segment(uint64_t index) noexcept {
+    const std::string path = segment_path(base_path_, index);
+    fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd_ < 0) return false;
+
+    // Reserve the blocks up front so appends never hit ENOSPC or extend the file
+    if (posix_fallocate(fd_, 0, static_cast<off_t>(segment_bytes_)) != 0 &&
+        ftruncate(fd_, static_cast<off_t>(segment_bytes_)) != 0) {
+        ::close(fd_);
+        fd_ = -1;
+        return false;
+    }
+
+    // Pre-fault the mapping so appends don't take page faults
+    void* map = mmap(nullptr, segment_bytes_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, 0);
+    if (map == MAP_FAILED) {
+        ::close(fd_);
+        fd_ = -1;
+        return false;
+    }
+    map_ = static_cast<char*>(map);
+    madvise(map_, segment_bytes_, MADV_SEQUENTIAL);
+
+    JournalSegmentHeader header{};
+    std::memcpy(header.magic, JOURNAL_MAGIC, sizeof(header.magic));
+    header.version = JOURNAL_VERSION;
+    header.record_size = sizeof(JournalRecord);
+    header.segment_index = index;
+    std::memcpy(map_, &header, sizeof(header));
+
+    segment_index_ = index;
+    write_offset_ = sizeof(JournalSegmentHeader);
+    segment_records_ = 0;
+    return true;
+}
+
+void MarketDataJournal::close_segment() noexcept {
+    if (!map_) return;
+
+    // Record count in the header, then trim the unused pre-allocated tail
+    auto* header = reinterpret_cast<JournalSegmentHeader*>(map_);
+    header->record_count = segment_records_;
+
+    munmap(map_, segment_bytes_);
+    map_ = nullptr;
+    if (ftruncate(fd_, static_cast<off_t>(write_offset_)) != 0) {
+        // Tail stays zero-filled - readers stop at the first NONE record
+    }
+    ::close(fd_);
+    fd_ = -1;
+}
+
+bool MarketDataJournal::is_open() const noexcept {
+    return map_ != nullptr;
+}
+
+void MarketDataJournal::append(const JournalRecord& record) noexcept {
+    if (!map_) return;
+
+    if (write_offset_ + sizeof(JournalRecord) > segment_bytes_) {
+        close_segment();
+        if (!open_segment(segment_index_ + 1)) return;
+    }
+
+    std::memcpy(map_ + write_offset_, &record, sizeof(JournalRecord));
+    write_offset_ += sizeof(JournalRecord);
+    ++segment_records_;
+    ++records_written_;
+}
+
+void MarketDataJournal::sync() noexcept {
+    if (map_) msync(map_, write_offset_, MS_ASYNC);
+}
+
+void MarketDataJournal::close() noexcept {
+    close_segment();
+}
+
+uint64_t MarketDataJournal::records_written() const noexcept {
+    return records_written_;
+}
+
+uint64_t MarketDataJournal::segment_count() const noexcept {
+    return segment_index_ + 1;
+}
+
+// Journal reader
+
+MarketDataJournalReader::MarketDataJournalReader(const std::string& base_path)
+    : base_path_(base_path), segment_index_(0), fd_(-1), map_(nullptr),
+      map_size_(0), read_offset_(0) {
+    open_segment(0);
+}
+
+MarketDataJournalReader::~MarketDataJournalReader() {
+    close_segment();
+}
+
+bool MarketDataJournalReader::open_segment(uint64_t index) noexcept {
+    const std::string path = MarketDataJournal::segment_path(base_path_, index);
+    fd_ = ::open(path.c_str(), O_RDONLY);
+    if (fd_ < 0) return false;
+
+    struct stat st;
+    if (fstat(fd_, &st) != 0 || static_cast<uint64_t>(st.st_size) < sizeof(JournalSegmentHeader)) {
+        close_segment();
+        return false;
+    }
+
+    map_size_ = static_cast<uint64_t>(st.st_size);
+    void* map = mmap(nullptr, map_size_, PROT_READ, MAP_PRIVATE, fd_, 0);
+    if (map == MAP_FAILED) {
+        map_ = nullptr;
+        close_segment();
+        return false;
+    }
+    map_ = static_cast<const char*>(map);
+    madvise(const_cast<char*>(map_), map_size_, MADV_SEQUENTIAL);
+
+    const auto* header = reinterpret_cast<const JournalSegmentHeader*>(map_);
+    if (std::memcmp(header->magic, JOURNAL_MAGIC, sizeof(header->magic)) != 0 ||
+        header->version != JOURNAL_VERSION || header->record_size != sizeof(JournalRecord)) {
+        close_segment();
+        return false;
+    }
+
+    segment_index_ = index;
+    read_offset_ = sizeof(JournalSegmentHeader);
+    return true;
+}
+
+void MarketDataJournalReader::close_segment() noexcept {
+    if (map_) munmap(const_cast<char*>(map_), map_size_);
+    if (fd_ >= 0) ::close(fd_);
+    map_ = nullptr;
+    fd_ = -1;
+    map_size_ = 0;
+}
+
+bool MarketDataJournalReader::next(JournalRecord& record) noexcept {
+    while (map_) {
+        if (read_offset_ + sizeof(JournalRecord) <= map_size_) {
+            std::memcpy(&record, map_ + read_offset_, sizeof(JournalRecord));
+            if (record.type != JournalRecordType::NONE) {
+                read_offset_ += sizeof(JournalRecord);
+                return true;
+            }
+        }
+
+        // End of this segment (or its unwritten tail) - move on to the next one
+        const uint64_t next_index = segment_index_ + 1;
+        close_segment();
+        if (!open_segment(next_index)) return false;
+    }
+    return false;
+}
+
+uint64_t MarketDataJournalReader::replay(MarketDataManager& manager) {
+    uint64_t replayed = 0;
+    JournalRecord record;
+
+    while (next(record)) {
+        switch (record.type) {
+            case JournalRecordType::TRADE: {
+                Trade trade(record.instrument_id, record.aggressor_order_id,
+                            record.resting_order_id, record.side, record.price, record.quantity);
+                trade.timestamp = from_ns(record.timestamp_ns);
+                manager.publish_trade(trade);
+                break;
+            }
+
+            case JournalRecordType::LEVEL2_UPDATE:
+                manager.publish_level2_update(record.instrument_id, record.side, record.price,
+                                              record.quantity, record.order_count);
+                break;
+
+            case JournalRecordType::SNAPSHOT_BEGIN: {
+                Level2Snapshot snapshot(record.instrument_id);
+                snapshot.timestamp = from_ns(record.timestamp_ns);
+
+                JournalRecord level;
+                uint64_t level_records = 0;
+                bool complete = false;
+                while (next(level)) {
+                    if (level.type != JournalRecordType::SNAPSHOT_LEVEL) {
+                        complete = level.type == JournalRecordType::SNAPSHOT_END;
+                        break;
+                    }
+                    ++level_records;
+                    auto& levels = (level.side == Side::BUY) ? snapshot.bids : snapshot.asks;
+                    levels.emplace_back(level.price, level.quantity, level.order_count);
+                }
+
+                // A snapshot cut short is where the journal stops being trustworthy:
+                // end replay there rather than publish part of it or skip past it
+                if (!complete) {
+                    manager.flush();
+                    return replayed;
+                }
+                replayed += level_records + 1;  // Levels and end
+                manager.publish_level2_snapshot(snapshot);
+                break;
+            }
+
+            default:
+                break;  // Stray level/end records outside a snapshot
+        }
+        ++replayed;
+    }
+
+    manager.flush();
+    return replayed;
+}
+
+} // namespace OrderBook
@@ -1,36 +1,185 @@
 #include "matching_engine.hpp"
-#include <iostream>
+#include "instrument.hpp"
+#include "engine_snapshot.hpp"
 #include <algorithm>
+#include <unistd.h>
 
 namespace OrderBook {
 
-MatchingEngine::MatchingEngine(SPSCRingBuffer* ring_buffer) 
-    : order_pool_(MAX_ORDERS), ring_buffer_(ring_buffer), 
-      order_map_(MAX_ORDERS, nullptr), orders_processed_(0),
+MatchingEngine::MatchingEngine(SPSCRingBuffer* ring_buffer)
+    : MatchingEngine(ring_buffer, nullptr) {}
+
+MatchingEngine::MatchingEngine(IngressFanIn* ingress)
+    : MatchingEngine(nullptr, ingress) {}
+
+MatchingEngine::MatchingEngine(SPSCRingBuffer* ring_buffer, IngressFanIn* ingress)
+    : order_pool_(MAX_ORDERS, ORDER_POOL_MAX_SLABS), book_(order_pool_), depth_(book_), ring_buffer_(ring_buffer),
+      ingress_(ingress), output_(nullptr), wait_signals_(nullptr), journal_(nullptr),
+      snapshot_interval_(0), next_snapshot_at_(0), snapshots_written_(0), replaying_(false),
+      order_index_(order_pool_, order_pool_.max_capacity()), orders_processed_(0),
       trades_executed_(0), orders_rejected_(0),
       total_buy_quantity_matched_(0),
-      total_sell_quantity_matched_(0) {
+      total_sell_quantity_matched_(0) {}
+
+void MatchingEngine::set_output_stage(OutputStage* output) noexcept {
+    output_ = output;
+    depth_.rebuild();
+}
+
+void MatchingEngine::set_wait_strategy(const WaitConfig& config, WaitSignals* signals) noexcept {
+    wait_config_ = config;
+    wait_signals_ = signals;
+}
+
+void MatchingEngine::set_journal(JournalStage* journal) noexcept {
+    journal_ = journal;
+}
+
+void MatchingEngine::set_snapshot_policy(const std::string& path, uint64_t interval_commands) noexcept {
+    snapshot_path_ = path;
+    snapshot_interval_ = interval_commands;
+    next_snapshot_at_ = orders_processed_ + interval_commands;
+}
+
+bool MatchingEngine::save_snapshot(const std::string& path) const noexcept {
+    EngineSnapshotHeader header;
+    init_snapshot_header(header);
+    header.sequence = orders_processed_;
+    header.trades_executed = trades_executed_;
+    header.orders_rejected = orders_rejected_;
+    header.total_buy_quantity_matched = total_buy_quantity_matched_;
+    header.total_sell_quantity_matched = total_sell_quantity_matched_;
     
-    trade_latencies_ns_.reserve(TOTAL_ORDERS_TO_GENERATE / 10);  // Estimate 10% will trade
+    SnapshotWriter out(path);
+    out.put(header);
+    order_pool_.save(out);
+    order_index_.save(out);
+    book_.save(out);
+    return out.commit();
 }
 
-void MatchingEngine::run() noexcept {
-    Command cmd;
+RecoveryResult MatchingEngine::recover(const std::string& snapshot_path, const std::string& journal_base) noexcept {
+    RecoveryResult result;
+    if (orders_processed_ != 0) return result;  // Only a fresh engine can be rebuilt
+    
+    if (!snapshot_path.empty() && access(snapshot_path.c_str(), F_OK) == 0) {
+        SnapshotReader in(snapshot_path);
+        EngineSnapshotHeader header;
+        if (!in.get(header) || !valid_snapshot_header(header) || !order_pool_.load(in) ||
+            !order_index_.load(in) || !book_.load(in) || !in.at_end()) {
+            return result;
+        }
+        
+        orders_processed_ = header.sequence;
+        trades_executed_ = header.trades_executed;
+        orders_rejected_ = header.orders_rejected;
+        total_buy_quantity_matched_ = header.total_buy_quantity_matched;
+        total_sell_quantity_matched_ = header.total_sell_quantity_matched;
+        result.snapshot_loaded = true;
+        result.snapshot_sequence = header.sequence;
+    }
     
-    while (orders_processed_ < TOTAL_ORDERS_TO_GENERATE) {
-        if (ring_buffer_->dequeue(cmd)) {
-            const auto processing_start = std::chrono::high_resolution_clock::now();
+    // Replay with every side effect detached: the snapshot already includes
+    // what was published, and the journal already holds these commands
+    OutputStage* const output = output_;
+    output_ = nullptr;
+    replaying_ = true;
+    
+    bool gap = false;
+    CommandJournalReader reader(journal_base);
+    reader.skip_to(orders_processed_ + 1);
+    CommandJournalRecord record;
+    while (reader.next(record)) {
+        if (record.sequence <= orders_processed_) continue;  // Covered by the snapshot
+        if (record.sequence != orders_processed_ + 1) {
+            gap = true;
+            break;
+        }
+        apply(record.command, 0);
+        ++result.commands_replayed;
+    }
+    
+    replaying_ = false;
+    output_ = output;
+    if (output_) depth_.rebuild();
+    
+    result.ok = !gap;
+    result.last_sequence = orders_processed_;
+    next_snapshot_at_ = orders_processed_ + snapshot_interval_;
+    return result;
+}
+
+void MatchingEngine::run(uint64_t command_count) noexcept {
+    WaitStrategy wait = WaitStrategy::consumer(wait_config_, wait_signals_);
+    
+    while (orders_processed_ < command_count) {
+        if (process_burst() > 0) {
+            wait.reset();
+            wait.notify();  // Slots freed - wake a producer parked on a full ring
             
-            if (cmd.type == CommandType::NEW) {
-                handle_new_order(cmd, processing_start);
-            } else {
-                handle_cancel_order(cmd.order_id);
+            // Burst boundary: the book is consistent with orders_processed_
+            if (snapshot_interval_ != 0 && orders_processed_ >= next_snapshot_at_) {
+                if (save_snapshot(snapshot_path_)) ++snapshots_written_;
+                next_snapshot_at_ = orders_processed_ + snapshot_interval_;
             }
-            
-            ++orders_processed_;
+        } else {
+            wait.idle([this] { return has_input(); });
+        }
+    }
+}
+
+bool MatchingEngine::has_input() noexcept {
+    return ingress_ ? ingress_->has_input() : ring_buffer_->front() != nullptr;
+}
+
+size_t MatchingEngine::process_burst() noexcept {
+    // Commands are processed in place in their ring slots - no copy out
+    const auto handle = [this](const Command& cmd) {
+        const uint64_t processing_start = rdtsc();
+        
+        // Time spent queued in the ring; commands built without a stamp carry none
+        if (cmd.producer_timestamp != 0 && cmd.producer_timestamp < processing_start) {
+            queue_latency_.record(TscClock::to_ns(processing_start - cmd.producer_timestamp));
         }
-        // Tight loop for minimum latency - no yield or sleep
+        
+        // Write-ahead: the command is queued for the journal before it takes effect
+        if (journal_) journal_->record(orders_processed_ + 1, cmd);
+        apply(cmd, processing_start);
+    };
+    
+    const size_t processed = ingress_ ? ingress_->consume_bulk(ENGINE_BURST_SIZE, handle)
+                                      : ring_buffer_->consume_bulk(ENGINE_BURST_SIZE, handle);
+    
+    // One load unless a scraper is waiting
+    metrics_.serve([this](EngineMetrics& metrics) noexcept { fill_metrics(metrics); });
+    return processed;
+}
+
+void MatchingEngine::fill_metrics(EngineMetrics& metrics) const noexcept {
+    metrics.orders_processed = orders_processed_;
+    metrics.trades_executed = trades_executed_;
+    metrics.orders_rejected = orders_rejected_;
+    metrics.pool_allocated = order_pool_.allocated_count();
+    metrics.pool_capacity = order_pool_.capacity();
+    metrics.pool_max_capacity = order_pool_.max_capacity();
+    metrics.pool_exhaustions = order_pool_.exhaustion_count();
+    metrics.queue_latency = queue_latency_;
+    metrics.trade_latency = trade_latency_;
+    metrics.new_order_span = new_order_span_.histogram();
+    metrics.match_span = match_span_.histogram();
+}
+
+void MatchingEngine::apply(const Command& cmd, uint64_t processing_start) noexcept {
+    // Market-maker commands are MultiInstrumentEngine only; they still count as processed
+    if (cmd.type == CommandType::NEW) {
+        const uint64_t span = new_order_span_.begin();
+        handle_new_order(cmd, processing_start);
+        new_order_span_.end(span);
+    } else if (cmd.type == CommandType::CANCEL) {
+        handle_cancel_order(cmd.order_id);
     }
+    
+    ++orders_processed_;
 }
 
 uint64_t MatchingEngine::orders_processed() const noexcept { 
@@ -45,8 +194,24 @@ uint64_t MatchingEngine::orders_rejected() const noexcept {
     return orders_rejected_;
 }
 
-const std::vector<long long>& MatchingEngine::trade_latencies() const noexcept { 
-    return trade_latencies_ns_; 
+uint64_t MatchingEngine::snapshots_written() const noexcept {
+    return snapshots_written_;
+}
+
+const OrderPool& MatchingEngine::order_pool() const noexcept {
+    return order_pool_;
+}
+
+const OrderIdIndex& MatchingEngine::order_index() const noexcept {
+    return order_index_;
+}
+
+const LatencyHistogram& MatchingEngine::queue_latency() const noexcept {
+    return queue_latency_;
+}
+
+const LatencyHistogram& MatchingEngine::trade_latency() const noexcept {
+    return trade_latency_;
 }
 
 uint64_t MatchingEngine::total_buy_quantity_matched() const noexcept { 
@@ -57,11 +222,15 @@ uint64_t MatchingEngine::total_sell_quantity_matched() const noexcept {
     return total_sell_quantity_matched_; 
 }
 
-void MatchingEngine::handle_new_order(const Command& cmd, const std::chrono::high_resolution_clock::time_point& processing_start) noexcept {
+MetricsMailbox<EngineMetrics>& MatchingEngine::metrics() noexcept {
+    return metrics_;
+}
+
+void MatchingEngine::handle_new_order(const Command& cmd, uint64_t processing_start) noexcept {
     Order* order = order_pool_.allocate();
     if (!order) {
+        // Pool at max capacity - the pool counts it in exhaustion_count()
         ++orders_rejected_;
-        std::cerr << "WARNING: Order pool exhausted, rejecting order_id=" << cmd.order_id << "\n";
         return;
     }
     
@@ -70,40 +239,37 @@ void MatchingEngine::handle_new_order(const Command& cmd, const std::chrono::hig
     order->side = cmd.side;
     order->price = cmd.price;
     order->quantity = cmd.quantity;
-    order->timestamp = cmd.producer_timestamp;
-    
-    // Store in order map for cancellation lookup
-    if (order->order_id < order_map_.size()) {
-        order_map_[order->order_id] = order;
-    }
+    order_pool_.info(order).timestamp = cmd.producer_timestamp;
     
     // Try to match against opposite side
+    const uint64_t span = match_span_.begin();
     match_order(order, processing_start);
+    match_span_.end(span);
     
     // Add remainder to book if any quantity left
-    if (order->quantity > 0) {
-        book_.add_order(order);
+    if (order->quantity > 0 && book_.add_order(order)) {
+        publish_level(order->side, order->price);
+        
+        // Only resting orders can be cancelled, so only they are indexed
+        order_index_.insert(order->order_id, order_pool_.index_of(order));
     } else {
-        // Order fully matched, return to pool
-        if (order->order_id < order_map_.size()) {
-            order_map_[order->order_id] = nullptr;
-        }
+        // Fully matched, or a remainder priced outside the book's ladder - return to pool
+        if (order->quantity > 0) ++orders_rejected_;
         order_pool_.free(order);
     }
 }
 
 void MatchingEngine::handle_cancel_order(uint64_t order_id) noexcept {
-    if (order_id >= order_map_.size()) return;
-    
-    Order* order = order_map_[order_id];
-    if (!order) return;  // Order not found or already matched/cancelled
+    const OrderIndex index = order_index_.erase(order_id);
+    if (index == NULL_ORDER) return;  // Order not found or already matched/cancelled
     
+    Order* order = order_pool_.at(index);
     book_.remove_order(order);
-    order_map_[order_id] = nullptr;
+    publish_level(order->side, order->price);
     order_pool_.free(order);
 }
 
-void MatchingEngine::match_order(Order* aggressor, const std::chrono::high_resolution_clock::time_point& processing_start) noexcept {
+void MatchingEngine::match_order(Order* aggressor, uint64_t processing_start) noexcept {
     if (aggressor->side == Side::BUY) {
         // Buy order: match against asks at or below aggressor's price
         match_against_asks(aggressor, processing_start);
@@ -113,89 +279,105 @@ void MatchingEngine::match_order(Order* aggressor, const std::chrono::high_resol
     }
 }
 
-void MatchingEngine::match_against_asks(Order* buy_order, const std::chrono::high_resolution_clock::time_point& processing_start) noexcept {
-    // Start from best ask and work up in price
-    for (int64_t price = book_.best_ask(); price <= buy_order->price && price != -1; ++price) {
+void MatchingEngine::match_against_asks(Order* buy_order, uint64_t processing_start) noexcept {
+    // Start from best ask and jump up through occupied levels only
+    for (int64_t price = book_.best_ask(); price != -1 && price <= buy_order->price; 
+         price = book_.next_ask_price(price)) {
         PriceLevel* level = book_.get_price_level(price, Side::SELL);
-        if (!level || level->empty()) continue;
         
         // Match against all orders at this price level in time priority
-        Order* ask_order = level->head;
-        while (ask_order && buy_order->quantity > 0) {
-            Order* next_ask = ask_order->next;  // Save next before potential removal
+        OrderIndex next_ask = level->head;
+        while (next_ask != NULL_ORDER && buy_order->quantity > 0) {
+            Order* ask_order = order_pool_.at(next_ask);
+            next_ask = ask_order->next;  // Save next before potential removal
             
             const uint64_t trade_quantity = std::min(buy_order->quantity, ask_order->quantity);
-            execute_trade(buy_order->order_id, ask_order->order_id, price, trade_quantity, processing_start);
+            execute_trade(buy_order->order_id, ask_order->order_id, Side::BUY, price, trade_quantity, 
+                          processing_start);
             
             buy_order->quantity -= trade_quantity;
-            ask_order->quantity -= trade_quantity;
+            book_.fill_order(level, ask_order, trade_quantity);
             
             if (ask_order->quantity == 0) {
-                // Ask order fully matched, remove from book
-                level->remove_order(ask_order);
-                if (ask_order->order_id < order_map_.size()) {
-                    order_map_[ask_order->order_id] = nullptr;
-                }
+                // Ask order fully matched, remove from book (keeps occupancy and best ask current)
+                book_.remove_order(ask_order);
+                order_index_.erase(ask_order->order_id, order_pool_.index_of(ask_order));
                 order_pool_.free(ask_order);
             }
-            
-            ask_order = next_ask;
         }
         
+        publish_level(Side::SELL, price);
+        
         if (buy_order->quantity == 0) break;  // Buy order fully matched
     }
 }
 
-void MatchingEngine::match_against_bids(Order* sell_order, const std::chrono::high_resolution_clock::time_point& processing_start) noexcept {
-    // Start from best bid and work down in price
-    for (int64_t price = book_.best_bid(); price >= sell_order->price && price != -1; --price) {
+void MatchingEngine::match_against_bids(Order* sell_order, uint64_t processing_start) noexcept {
+    // Start from best bid and jump down through occupied levels only
+    for (int64_t price = book_.best_bid(); price != -1 && price >= sell_order->price; 
+         price = book_.next_bid_price(price)) {
         PriceLevel* level = book_.get_price_level(price, Side::BUY);
-        if (!level || level->empty()) continue;
         
         // Match against all orders at this price level in time priority
-        Order* bid_order = level->head;
-        while (bid_order && sell_order->quantity > 0) {
-            Order* next_bid = bid_order->next;  // Save next before potential removal
+        OrderIndex next_bid = level->head;
+        while (next_bid != NULL_ORDER && sell_order->quantity > 0) {
+            Order* bid_order = order_pool_.at(next_bid);
+            next_bid = bid_order->next;  // Save next before potential removal
             
             const uint64_t trade_quantity = std::min(sell_order->quantity, bid_order->quantity);
-            execute_trade(sell_order->order_id, bid_order->order_id, price, trade_quantity, processing_start);
+            execute_trade(sell_order->order_id, bid_order->order_id, Side::SELL, price, trade_quantity, 
+                          processing_start);
             
             sell_order->quantity -= trade_quantity;
-            bid_order->quantity -= trade_quantity;
+            book_.fill_order(level, bid_order, trade_quantity);
             
             if (bid_order->quantity == 0) {
-                // Bid order fully matched, remove from book
-                level->remove_order(bid_order);
-                if (bid_order->order_id < order_map_.size()) {
-                    order_map_[bid_order->order_id] = nullptr;
-                }
+                // Bid order fully matched, remove from book (keeps occupancy and best bid current)
+                book_.remove_order(bid_order);
+                order_index_.erase(bid_order->order_id, order_pool_.index_of(bid_order));
                 order_pool_.free(bid_order);
             }
-            
-            bid_order = next_bid;
         }
         
+        publish_level(Side::BUY, price);
+        
         if (sell_order->quantity == 0) break;  // Sell order fully matched
     }
 }
 
-void MatchingEngine::execute_trade(uint64_t aggressor_id, uint64_t resting_id, int64_t price, 
-                  uint64_t quantity, const std::chrono::high_resolution_clock::time_point& processing_start) noexcept {
+void MatchingEngine::execute_trade(uint64_t aggressor_id, uint64_t resting_id, Side aggressor_side, int64_t price, 
+                  uint64_t quantity, uint64_t processing_start) noexcept {
     
     // Calculate latency from processing start to trade execution
-    const auto latency_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
-        std::chrono::high_resolution_clock::now() - processing_start).count();
-
-    trade_latencies_ns_.push_back(latency_ns);
+    // Replayed trades already happened - they are not latency samples
+    if (!replaying_) {
+        trade_latency_.record(TscClock::to_ns(rdtsc() - processing_start));
+    }
     
     // Update statistics
     ++trades_executed_;
     total_buy_quantity_matched_ += quantity;
     total_sell_quantity_matched_ += quantity;
     
-    // Print trade details
-    std::cout << "TRADE: aggressor=" << aggressor_id << " resting=" << resting_id 
-              << " price=" << price << " qty=" << quantity << "\n";
+    // Hand the execution report to the output stage - formatting happens off this thread
+    if (output_) {
+        output_->publish_trade(DEFAULT_INSTRUMENT_ID, aggressor_id, resting_id, aggressor_side, 
+                               price, quantity);
+    }
+}
+
+void MatchingEngine::publish_level(Side side, int64_t price) noexcept {
+    // Only changes inside the published depth produce a delta
+    if (!output_ || !depth_.on_level_change(side, price)) return;
+    
+    // Swept or cancelled-out levels may no longer exist - report them as empty
+    const PriceLevel* level = book_.get_price_level(price, side);
+    if (level) {
+        output_->publish_level2_update(DEFAULT_INSTRUMENT_ID, side, price, 
+                                       level->total_volume, level->order_count);
+    } else {
+        output_->publish_level2_update(DEFAULT_INSTRUMENT_ID, side, price, 0, 0);
+    }
 }
 
 } // namespace OrderBook
\ No newline at end of file
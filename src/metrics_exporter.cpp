@@ -0,0 +1,169 @@
+#include "metrics_exporter.hpp"
+#include "numa_placement.hpp"
+#include <cstdio>
+#include <sstream>
+
+namespace OrderBook {
+
+namespace {
+
+constexpr double SUMMARY_QUANTILES[] = {0.5, 0.9, 0.99, 0.999, 1.0};
+
+void write_header(std::ostringstream& out, const std::string& name, const char* type, const std::string& help) {
+    out << "# HELP " << name << ' ' << help << "\n# TYPE " << name << ' ' << type << '\n';
+}
+
+void write_summary(std::ostringstream& out, const std::string& name, const std::string& labels,
+                   const LatencyHistogram& histogram) {
+    for (const double quantile : SUMMARY_QUANTILES) {
+        out << name << '{' << labels << ",quantile=\"" << quantile << "\"} "
+            << histogram.percentile(quantile * 100.0) << '\n';
+    }
+    out << name << "_sum{" << labels << "} " << histogram.sum() << '\n';
+    out << name << "_count{" << labels << "} " << histogram.count() << '\n';
+}
+
+} // namespace
+
+MetricsExporter::MetricsExporter(std::string path, std::chrono::milliseconds interval,
+                                 std::chrono::microseconds answer_timeout)
+    : path_(std::move(path)), interval_(interval), answer_timeout_(answer_timeout),
+      running_(false), scrapes_(0), stale_answers_(0) {}
+
+MetricsExporter::~MetricsExporter() {
+    stop();
+}
+
+void MetricsExporter::add_engine(const std::string& label, MetricsMailbox<EngineMetrics>& mailbox) {
+    EngineEntry entry;
+    entry.label = label;
+    entry.mailbox = &mailbox;
+    engines_.push_back(std::move(entry));
+}
+
+void MetricsExporter::add_gauge(const std::string& name, const std::string& labels, const std::string& help,
+                                std::function<double()> read) {
+    gauges_.push_back(Gauge{name, labels, help, std::move(read)});
+}
+
+void MetricsExporter::start(int cpu) {
+    if (running_.exchange(true)) return;
+    scraper_thread_ = std::thread([this, cpu] {
+        if (cpu >= 0) NumaPlacement::pin_current_thread(cpu);
+        run();
+    });
+}
+
+void MetricsExporter::stop() {
+    if (!running_.exchange(false)) return;
+    scraper_thread_.join();
+
+    // Final page with everything the engines counted
+    write_file(scrape());
+}
+
+void MetricsExporter::run() {
+    auto next = std::chrono::steady_clock::now();
+    while (running_.load(std::memory_order_acquire)) {
+        write_file(scrape());
+
+        // Sleep in short steps so stop() doesn't wait out a long interval
+        next += interval_;
+        while (running_.load(std::memory_order_acquire) && std::chrono::steady_clock::now() < next) {
+            std::this_thread::sleep_for(std::min<std::chrono::steady_clock::duration>(
+                next - std::chrono::steady_clock::now(), std::chrono::milliseconds(10)));
+        }
+    }
+}
+
+std::string MetricsExporter::scrape() {
+    // Ask every engine at once, then give them answer_timeout between them
+    for (EngineEntry& engine : engines_) {
+        engine.ticket = engine.mailbox->request();
+    }
+    const auto deadline = std::chrono::steady_clock::now() + answer_timeout_;
+    for (EngineEntry& engine : engines_) {
+        while (!engine.mailbox->answered(engine.ticket) && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::yield();
+        }
+        engine.answered = engine.mailbox->answered(engine.ticket);
+        if (engine.answered) {
+            engine.last = engine.mailbox->value();
+        } else {
+            stale_answers_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    std::ostringstream out;
+    const auto engine_family = [&](const std::string& name, const char* type, const std::string& help,
+                                   auto value) {
+        write_header(out, name, type, help);
+        for (const EngineEntry& engine : engines_) {
+            out << name << "{engine=\"" << engine.label << "\"} " << value(engine.last) << '\n';
+        }
+    };
+    const auto engine_summary = [&](const std::string& name, const std::string& help, auto histogram) {
+        write_header(out, name, "summary", help);
+        for (const EngineEntry& engine : engines_) {
+            write_summary(out, name, "engine=\"" + engine.label + "\"", histogram(engine.last));
+        }
+    };
+
+    if (!engines_.empty()) {
+        write_header(out, "ome_engine_metrics_fresh", "gauge",
+                     "1 if the engine answered this scrape, 0 if reported from an earlier answer");
+        for (const EngineEntry& engine : engines_) {
+            out << "ome_engine_metrics_fresh{engine=\"" << engine.label << "\"} " << (engine.answered ? 1 : 0) << '\n';
+        }
+        engine_family("ome_orders_processed_total", "counter", "Commands processed",
+                      [](const EngineMetrics& m) { return m.orders_processed; });
+        engine_family("ome_trades_executed_total", "counter", "Trades executed",
+                      [](const EngineMetrics& m) { return m.trades_executed; });
+        engine_family("ome_orders_rejected_total", "counter", "Orders rejected",
+                      [](const EngineMetrics& m) { return m.orders_rejected; });
+        engine_family("ome_order_pool_allocated", "gauge", "Orders resting in the pool",
+                      [](const EngineMetrics& m) { return m.pool_allocated; });
+        engine_family("ome_order_pool_capacity", "gauge", "Orders the pool's mapped slabs hold",
+                      [](const EngineMetrics& m) { return m.pool_capacity; });
+        engine_family("ome_order_pool_utilisation", "gauge", "Allocated share of the pool's maximum capacity",
+                      [](const EngineMetrics& m) {
+                          return m.pool_max_capacity ? static_cast<double>(m.pool_allocated) / m.pool_max_capacity : 0.0;
+                      });
+        engine_family("ome_order_pool_exhaustions_total", "counter", "Allocations refused at maximum capacity",
+                      [](const EngineMetrics& m) { return m.pool_exhaustions; });
+        engine_summary("ome_queue_latency_ns", "Producer enqueue to engine dequeue",
+                       [](const EngineMetrics& m) -> const LatencyHistogram& { return m.queue_latency; });
+        engine_summary("ome_trade_latency_ns", "Engine dequeue to fill",
+                       [](const EngineMetrics& m) -> const LatencyHistogram& { return m.trade_latency; });
+        engine_summary("ome_new_order_span_ns", "New order handling, sampled",
+                       [](const EngineMetrics& m) -> const LatencyHistogram& { return m.new_order_span; });
+        engine_summary("ome_match_span_ns", "Matching an aggressor, sampled",
+                       [](const EngineMetrics& m) -> const LatencyHistogram& { return m.match_span; });
+    }
+
+    // Gauges of one name share a header
+    for (size_t i = 0; i < gauges_.size(); ++i) {
+        const Gauge& gauge = gauges_[i];
+        if (i == 0 || gauges_[i - 1].name != gauge.name) write_header(out, gauge.name, "gauge", gauge.help);
+        out << gauge.name;
+        if (!gauge.labels.empty()) out << '{' << gauge.labels << '}';
+        out << ' ' << gauge.read() << '\n';
+    }
+
+    scrapes_.fetch_add(1, std::memory_order_relaxed);
+    return out.str();
+}
+
+bool MetricsExporter::write_file(const std::string& page) const {
+    if (path_.empty()) return true;
+
+    // Readers see the old page or the new one, never a partial write
+    const std::string tmp_path = path_ + ".tmp";
+    std::FILE* file = std::fopen(tmp_path.c_str(), "w");
+    if (!file) return false;
+    const bool written = std::fwrite(page.data(), 1, page.size(), file) == page.size();
+    const bool closed = std::fclose(file) == 0;
+    return written && closed && std::rename(tmp_path.c_str(), path_.c_str()) == 0;
+}
+
+} // namespace OrderBook
@@ -1,79 +1,177 @@
 #include "multi_instrument_engine.hpp"
-#include <iostream>
 #include <algorithm>
 
 namespace OrderBook {
 
-MultiInstrumentEngine::MultiInstrumentEngine(SPSCRingBuffer* ring_buffer) 
-    : order_pool_(std::make_unique<OrderPool>(MAX_ORDERS)), 
+MultiInstrumentEngine::MultiInstrumentEngine(SPSCQueue<MultiInstrumentCommand>* ring_buffer,
+                                             uint64_t max_orders)
+    : order_pool_(std::make_unique<OrderPool>(max_orders, ORDER_POOL_MAX_SLABS)), 
+      directory_(*order_pool_),
       ring_buffer_(ring_buffer),
-      order_map_(MAX_ORDERS, {nullptr, 0}),
+      output_(nullptr),
+      risk_(nullptr),
+      risk_stage_(nullptr),
+      quote_batch_(nullptr),
+      quote_legs_remaining_(0),
+      order_index_(*order_pool_, order_pool_->max_capacity(), true),
       orders_processed_(0),
       total_trades_executed_(0),
-      orders_rejected_(0) {
-    
-    trade_latencies_ns_.reserve(TOTAL_ORDERS_TO_GENERATE / 10);
-}
+      orders_rejected_(0) {}
 
 bool MultiInstrumentEngine::add_instrument(const Instrument& instrument) {
-    if (instruments_.find(instrument.instrument_id) != instruments_.end()) {
-        return false; // Instrument already exists
+    if (!directory_.add(instrument)) {
+        return false; // Instrument already exists, or directory full
     }
-    
-    instruments_[instrument.instrument_id] = instrument;
-    books_[instrument.instrument_id] = std::make_unique<Book>();
-    trades_per_instrument_[instrument.instrument_id] = 0;
-    volume_per_instrument_[instrument.instrument_id] = 0;
+    symbols_.add(instrument);
     
     return true;
 }
 
 bool MultiInstrumentEngine::remove_instrument(uint32_t instrument_id) {
-    auto it = instruments_.find(instrument_id);
-    if (it == instruments_.end()) {
-        return false;
+    return directory_.remove(instrument_id);
+}
+
+void MultiInstrumentEngine::release_resting_orders(InstrumentState& state) noexcept {
+    Book& book = state.book;
+    
+    // Readers still holding the block see the instrument emptied
+    if (snapshots_) {
+        snapshots_[directory_.slot_of(state)].publish(Level2Snapshot(state.instrument.instrument_id));
     }
     
-    // TODO: Ensure all orders for this instrument are processed/cancelled
-    instruments_.erase(it);
-    books_.erase(instrument_id);
-    trades_per_instrument_.erase(instrument_id);
-    volume_per_instrument_.erase(instrument_id);
+    // The entry is about to be destroyed, so orders are only unindexed and freed
+    const auto release_level = [this](PriceLevel* level) noexcept {
+        OrderIndex next = level->head;
+        while (next != NULL_ORDER) {
+            Order* order = order_pool_->at(next);
+            next = order->next;
+            order_index_.erase(order->order_id, order_pool_->index_of(order));
+            order_pool_->free(order);
+        }
+    };
     
-    return true;
+    for (int64_t price = book.best_bid(); price != -1; price = book.next_bid_price(price)) {
+        release_level(book.get_price_level(price, Side::BUY));
+    }
+    for (int64_t price = book.best_ask(); price != -1; price = book.next_ask_price(price)) {
+        release_level(book.get_price_level(price, Side::SELL));
+    }
+}
+
+void MultiInstrumentEngine::run(uint64_t command_count) noexcept {
+    while (orders_processed_ < command_count) {
+        process_burst();
+    }
 }
 
-void MultiInstrumentEngine::run() noexcept {
-    Command cmd;  // Using original command type for compatibility
+size_t MultiInstrumentEngine::process_burst() noexcept {
+    // Pick up instruments added or removed since the last burst
+    directory_.refresh([this](InstrumentState& state) noexcept { release_resting_orders(state); });
     
-    while (orders_processed_ < TOTAL_ORDERS_TO_GENERATE) {
-        if (ring_buffer_->dequeue(cmd)) {
-            const auto processing_start = std::chrono::high_resolution_clock::now();
-            
-            // Convert to multi-instrument command (assume instrument_id = 1 for compatibility)
-            MultiInstrumentCommand multi_cmd;
-            multi_cmd.type = cmd.type;
-            multi_cmd.instrument_id = 1; // Default instrument for backward compatibility
-            multi_cmd.order_id = cmd.order_id;
-            multi_cmd.side = cmd.side;
-            multi_cmd.price = cmd.price;
-            multi_cmd.quantity = cmd.quantity;
-            multi_cmd.producer_timestamp = cmd.producer_timestamp;
-            
-            if (multi_cmd.type == CommandType::NEW) {
-                handle_new_order(multi_cmd, processing_start);
-            } else {
-                handle_cancel_order(multi_cmd.instrument_id, multi_cmd.order_id);
+    // Commands are read in place from the ring
+    const size_t processed = ring_buffer_->consume_bulk(ENGINE_BURST_SIZE, [this](const MultiInstrumentCommand& cmd) {
+        const uint64_t processing_start = rdtsc();
+        
+        if (cmd.producer_timestamp != 0 && cmd.producer_timestamp < processing_start) {
+            queue_latency_.record(TscClock::to_ns(processing_start - cmd.producer_timestamp));
+        }
+        
+        // Single-instrument feeds leave instrument_id unset - route to the default instrument
+        const uint32_t instrument_id = cmd.instrument_id ? cmd.instrument_id : DEFAULT_INSTRUMENT_ID;
+        
+        if (quote_batch_ && cmd.type != CommandType::QUOTE_LEG) end_mass_quote();
+        
+        switch (cmd.type) {
+            case CommandType::NEW: {
+                const uint64_t span = new_order_span_.begin();
+                handle_new_order(cmd, instrument_id, processing_start);
+                new_order_span_.end(span);
+                break;
             }
-            
-            ++orders_processed_;
+            case CommandType::CANCEL:
+                handle_cancel_order(cmd, instrument_id);
+                break;
+            case CommandType::REPLACE:
+                handle_replace_order(cmd, instrument_id, processing_start);
+                break;
+            case CommandType::MASS_CANCEL:
+                handle_mass_cancel(cmd, instrument_id);
+                break;
+            case CommandType::MASS_QUOTE:
+                begin_mass_quote(cmd, instrument_id);
+                break;
+            case CommandType::QUOTE_LEG:
+                handle_quote_leg(cmd, instrument_id);
+                break;
         }
-    }
+        
+        ++orders_processed_;
+    });
+    
+    // Readers between bursts always see a settled touch
+    if (quote_batch_) end_mass_quote();
+    if (!dirty_books_.empty()) publish_snapshots();
+    
+    if (risk_ && processed > 0) risk_->publish_statistics();
+    metrics_.serve([this](EngineMetrics& metrics) noexcept { fill_metrics(metrics); });
+    return processed;
+}
+
+void MultiInstrumentEngine::fill_metrics(EngineMetrics& metrics) const noexcept {
+    metrics.orders_processed = orders_processed_;
+    metrics.trades_executed = total_trades_executed_;
+    metrics.orders_rejected = orders_rejected_;
+    metrics.pool_allocated = order_pool_->allocated_count();
+    metrics.pool_capacity = order_pool_->capacity();
+    metrics.pool_max_capacity = order_pool_->max_capacity();
+    metrics.pool_exhaustions = order_pool_->exhaustion_count();
+    metrics.queue_latency = queue_latency_;
+    metrics.trade_latency = trade_latency_;
+    metrics.new_order_span = new_order_span_.histogram();
+    metrics.match_span = match_span_.histogram();
 }
 
 const Book* MultiInstrumentEngine::get_book(uint32_t instrument_id) const noexcept {
-    auto it = books_.find(instrument_id);
-    return (it != books_.end()) ? it->second.get() : nullptr;
+    const InstrumentState* state = directory_.lookup(instrument_id);
+    return state ? &state->book : nullptr;
+}
+
+void MultiInstrumentEngine::enable_book_snapshots() {
+    if (snapshots_) return;
+    snapshots_ = std::make_unique<BookSnapshot[]>(directory_.capacity());
+    snapshot_dirty_.assign(directory_.capacity(), 0);
+    dirty_books_.reserve(directory_.capacity());
+}
+
+const BookSnapshot* MultiInstrumentEngine::book_snapshot(uint32_t instrument_id) const noexcept {
+    if (!snapshots_) return nullptr;
+    const uint32_t slot = directory_.slot_of(instrument_id);
+    return (slot != InstrumentDirectory::NO_SLOT) ? &snapshots_[slot] : nullptr;
+}
+
+void MultiInstrumentEngine::publish_snapshots() noexcept {
+    for (InstrumentState* state : dirty_books_) {
+        const uint32_t slot = directory_.slot_of(*state);
+        snapshot_dirty_[slot] = 0;
+        snapshots_[slot].publish(state->book, state->instrument.instrument_id);
+    }
+    dirty_books_.clear();
+}
+
+const SymbolTable& MultiInstrumentEngine::symbols() const noexcept {
+    return symbols_;
+}
+
+void MultiInstrumentEngine::set_output_stage(OutputStage* output) noexcept {
+    output_ = output;
+}
+
+void MultiInstrumentEngine::set_risk_manager(RiskManager* risk) noexcept {
+    risk_ = risk;
+}
+
+void MultiInstrumentEngine::set_risk_stage(RiskStage* stage) noexcept {
+    risk_stage_ = stage;
 }
 
 uint64_t MultiInstrumentEngine::orders_processed() const noexcept {
@@ -88,174 +186,351 @@ uint64_t MultiInstrumentEngine::orders_rejected() const noexcept {
     return orders_rejected_;
 }
 
+const OrderPool& MultiInstrumentEngine::order_pool() const noexcept {
+    return *order_pool_;
+}
+
+const OrderIdIndex& MultiInstrumentEngine::order_index() const noexcept {
+    return order_index_;
+}
+
 uint64_t MultiInstrumentEngine::trades_for_instrument(uint32_t instrument_id) const noexcept {
-    auto it = trades_per_instrument_.find(instrument_id);
-    return (it != trades_per_instrument_.end()) ? it->second : 0;
+    const InstrumentState* state = directory_.lookup(instrument_id);
+    return state ? state->trades : 0;
 }
 
 uint64_t MultiInstrumentEngine::volume_for_instrument(uint32_t instrument_id) const noexcept {
-    auto it = volume_per_instrument_.find(instrument_id);
-    return (it != volume_per_instrument_.end()) ? it->second : 0;
+    const InstrumentState* state = directory_.lookup(instrument_id);
+    return state ? state->volume : 0;
 }
 
-const std::vector<long long>& MultiInstrumentEngine::trade_latencies() const noexcept {
-    return trade_latencies_ns_;
+const LatencyHistogram& MultiInstrumentEngine::queue_latency() const noexcept {
+    return queue_latency_;
 }
 
-void MultiInstrumentEngine::handle_new_order(const MultiInstrumentCommand& cmd, 
-                                            const std::chrono::high_resolution_clock::time_point& processing_start) noexcept {
-    // Validate order
-    if (!validate_order(cmd)) {
-        return;
+const LatencyHistogram& MultiInstrumentEngine::trade_latency() const noexcept {
+    return trade_latency_;
+}
+
+MetricsMailbox<EngineMetrics>& MultiInstrumentEngine::metrics() noexcept {
+    return metrics_;
+}
+
+void MultiInstrumentEngine::handle_new_order(const MultiInstrumentCommand& cmd, uint32_t instrument_id,
+                                            uint64_t processing_start) noexcept {
+    InstrumentState* state = directory_.find(instrument_id);
+    if (!state) {
+        return; // Unknown instrument
     }
     
-    auto book_it = books_.find(cmd.instrument_id);
-    if (book_it == books_.end()) {
-        return; // Unknown instrument
+    // Validate order and convert wire ticks to instrument price
+    int64_t price;
+    if (!validate_order(cmd, state->instrument, price)) {
+        return;
     }
     
     Order* order = order_pool_->allocate();
     if (!order) {
+        // Pool at max capacity - the pool counts it in exhaustion_count()
         ++orders_rejected_;
-        std::cerr << "WARNING: Order pool exhausted, rejecting order_id=" << cmd.order_id << "\n";
         return;
     }
     
     // Initialize order
     order->order_id = cmd.order_id;
     order->side = cmd.side;
-    order->price = cmd.price;
+    order->price = price;
     order->quantity = cmd.quantity;
-    order->timestamp = cmd.producer_timestamp;
     
-    // Store in order map with instrument mapping
-    if (order->order_id < order_map_.size()) {
-        order_map_[order->order_id] = {order, cmd.instrument_id};
-    }
+    OrderInfo& info = order_pool_->info(order);
+    info.timestamp = cmd.producer_timestamp;
+    info.instrument_id = instrument_id;
+    info.account_id = cmd.account_id;
+    
+    enter_order(*state, order, cmd.account_id, processing_start);
+}
+
+void MultiInstrumentEngine::enter_order(InstrumentState& state, Order* order, AccountId account_id,
+                                        uint64_t processing_start) noexcept {
+    mark_changed(state);
     
     // Try to match against opposite side
-    match_order(cmd.instrument_id, order, processing_start);
+    const uint64_t quantity = order->quantity;
+    const uint64_t span = match_span_.begin();
+    match_order(state, order, processing_start);
+    match_span_.end(span);
+    if (order->quantity < quantity) {
+        record_fill(account_id, order->side, quantity - order->quantity);
+    }
     
     // Add remainder to book if any quantity left
-    if (order->quantity > 0) {
-        book_it->second->add_order(order);
+    if (order->quantity > 0 && state.book.add_order(order)) {
+        // Only resting orders can be cancelled, so only they are indexed
+        order_index_.insert(order->order_id, order_pool_->index_of(order));
     } else {
-        // Order fully matched, return to pool
-        if (order->order_id < order_map_.size()) {
-            order_map_[order->order_id] = {nullptr, 0};
-        }
+        // Fully matched, or a remainder priced outside the book's ladder - return to pool
+        if (order->quantity > 0) ++orders_rejected_;
         order_pool_->free(order);
     }
 }
 
-void MultiInstrumentEngine::handle_cancel_order(uint32_t instrument_id, uint64_t order_id) noexcept {
-    if (order_id >= order_map_.size()) return;
+void MultiInstrumentEngine::handle_cancel_order(const MultiInstrumentCommand& cmd, uint32_t instrument_id) noexcept {
+    if (risk_ && risk_->check_cancel_order(cmd) != RiskCheckResult::ACCEPTED) return;
+    
+    Order* order = find_owned_order(cmd, instrument_id);
+    if (!order) return;
+    
+    InstrumentState* state = directory_.find(instrument_id);
+    if (!state) return;
+    
+    cancel_resting_order(state->book, order);
+    mark_changed(*state);
+}
+
+void MultiInstrumentEngine::handle_replace_order(const MultiInstrumentCommand& cmd, uint32_t instrument_id,
+                                                 uint64_t processing_start) noexcept {
+    if (cmd.quantity == 0) {
+        handle_cancel_order(cmd, instrument_id);
+        return;
+    }
+    
+    // Risk is checked on the command's side, so it has to be the order's
+    Order* order = find_owned_order(cmd, instrument_id);
+    InstrumentState* state = directory_.find(instrument_id);
+    if (!order || !state || order->side != cmd.side) return;
     
-    auto& [order, stored_instrument_id] = order_map_[order_id];
-    if (!order || stored_instrument_id != instrument_id) return;
+    int64_t price;
+    if (!validate_order(cmd, state->instrument, price)) return;
     
-    auto book_it = books_.find(instrument_id);
-    if (book_it == books_.end()) return;
+    Book& book = state->book;
+    if (price == order->price && cmd.quantity <= order->quantity) {
+        book.reduce_order(order, order->quantity - cmd.quantity);
+        mark_changed(*state);
+        return;
+    }
     
-    book_it->second->remove_order(order);
-    order_map_[order_id] = {nullptr, 0};
+    // Re-priced or grown: back of the queue, as an aggressor at the new price
+    book.remove_order(order);
+    order_index_.erase(order->order_id, order_pool_->index_of(order));
+    order->price = price;
+    order->quantity = cmd.quantity;
+    order_pool_->info(order).timestamp = cmd.producer_timestamp;
+    enter_order(*state, order, cmd.account_id, processing_start);
+}
+
+void MultiInstrumentEngine::handle_mass_cancel(const MultiInstrumentCommand& cmd, uint32_t instrument_id) noexcept {
+    if (risk_ && risk_->check_cancel_order(cmd) != RiskCheckResult::ACCEPTED) return;
+    
+    InstrumentState* state = directory_.find(instrument_id);
+    if (!state) return;
+    Book& book = state->book;
+    mark_changed(*state);
+    
+    const auto cancel_level = [&](PriceLevel* level) noexcept {
+        OrderIndex next = level->head;
+        while (next != NULL_ORDER) {
+            Order* order = order_pool_->at(next);
+            next = order->next;
+            if (order_pool_->info(order).account_id == cmd.account_id) cancel_resting_order(book, order);
+        }
+    };
+    
+    // Levels are stepped by price, so emptying one does not lose the walk
+    book.begin_batch();
+    for (int64_t price = book.best_bid(); price != -1; price = book.next_bid_price(price)) {
+        cancel_level(book.get_price_level(price, Side::BUY));
+    }
+    for (int64_t price = book.best_ask(); price != -1; price = book.next_ask_price(price)) {
+        cancel_level(book.get_price_level(price, Side::SELL));
+    }
+    book.end_batch();
+}
+
+void MultiInstrumentEngine::begin_mass_quote(const MultiInstrumentCommand& cmd, uint32_t instrument_id) noexcept {
+    InstrumentState* state = directory_.find(instrument_id);
+    if (!state || cmd.quantity == 0) return;
+    
+    quote_batch_ = state;
+    quote_legs_remaining_ = cmd.quantity;
+    state->book.begin_batch();
+}
+
+void MultiInstrumentEngine::end_mass_quote() noexcept {
+    quote_batch_->book.end_batch();
+    quote_batch_ = nullptr;
+    quote_legs_remaining_ = 0;
+}
+
+void MultiInstrumentEngine::handle_quote_leg(const MultiInstrumentCommand& cmd, uint32_t instrument_id) noexcept {
+    // A leg outside a mass quote is applied on its own
+    InstrumentState* state = quote_batch_ ? quote_batch_ : directory_.find(instrument_id);
+    if (state && state->instrument.instrument_id == instrument_id) {
+        if (cmd.quantity == 0) {
+            handle_cancel_order(cmd, instrument_id);
+        } else {
+            apply_quote_leg(*state, cmd, instrument_id);
+        }
+    }
+    
+    if (quote_batch_ && --quote_legs_remaining_ == 0) end_mass_quote();
+}
+
+void MultiInstrumentEngine::apply_quote_leg(InstrumentState& state, const MultiInstrumentCommand& cmd,
+                                            uint32_t instrument_id) noexcept {
+    int64_t price;
+    if (!validate_order(cmd, state.instrument, price)) return;
+    
+    Book& book = state.book;
+    mark_changed(state);
+    Order* order = find_owned_order(cmd, instrument_id);
+    if (order && order->side != cmd.side) return;
+    if (order && price == order->price && cmd.quantity <= order->quantity) {
+        book.reduce_order(order, order->quantity - cmd.quantity);
+        return;
+    }
+    
+    // Depth through the price is exact even while the batch leaves the touch stale
+    const uint64_t crossing = (cmd.side == Side::BUY) ? book.ask_volume_through(price, 1)
+                                                      : book.bid_volume_through(price, 1);
+    if (crossing > 0) {
+        if (order) cancel_resting_order(book, order);
+        ++orders_rejected_;
+        return;
+    }
+    
+    const bool indexed = order != nullptr;
+    if (order) {
+        // Moved or grown: same order, back of the queue at its new level
+        book.remove_order(order);
+    } else {
+        order = order_pool_->allocate();
+        if (!order) {
+            ++orders_rejected_;
+            return;
+        }
+        order->order_id = cmd.order_id;
+        order->side = cmd.side;
+        
+        OrderInfo& info = order_pool_->info(order);
+        info.instrument_id = instrument_id;
+        info.account_id = cmd.account_id;
+    }
+    
+    order->price = price;
+    order->quantity = cmd.quantity;
+    order_pool_->info(order).timestamp = cmd.producer_timestamp;
+    
+    // A new leg is indexed only once it rests; a moved one keeps its entry
+    if (!book.add_order(order)) {
+        if (indexed) order_index_.erase(order->order_id, order_pool_->index_of(order));
+        order_pool_->free(order);
+        ++orders_rejected_;
+        return;
+    }
+    if (!indexed) order_index_.insert(order->order_id, order_pool_->index_of(order));
+}
+
+Order* MultiInstrumentEngine::find_owned_order(const MultiInstrumentCommand& cmd, uint32_t instrument_id) noexcept {
+    // Ids are keyed per account, so this only ever finds the account's own order
+    const OrderIndex index = order_index_.find(cmd.order_id, cmd.account_id);
+    if (index == NULL_ORDER) return nullptr;
+    
+    // And only under the instrument it was entered for
+    Order* order = order_pool_->at(index);
+    return order_pool_->info(order).instrument_id == instrument_id ? order : nullptr;
+}
+
+void MultiInstrumentEngine::cancel_resting_order(Book& book, Order* order) noexcept {
+    book.remove_order(order);
+    order_index_.erase(order->order_id, order_pool_->index_of(order));
     order_pool_->free(order);
 }
 
-bool MultiInstrumentEngine::validate_order(const MultiInstrumentCommand& cmd) const noexcept {
-    auto it = instruments_.find(cmd.instrument_id);
-    if (it == instruments_.end()) return false;
+bool MultiInstrumentEngine::validate_order(const MultiInstrumentCommand& cmd, const Instrument& instrument,
+                                           int64_t& price) noexcept {
+    price = static_cast<int64_t>(cmd.price) * instrument.tick_size;
+    if (!instrument.is_valid_price(price) || !instrument.is_valid_quantity(cmd.quantity)) {
+        ++orders_rejected_;  // Risk rejections are counted by the RiskManager
+        return false;
+    }
     
-    const Instrument& instrument = it->second;
-    return instrument.is_valid_price(cmd.price) && instrument.is_valid_quantity(cmd.quantity);
+    // Pre-trade risk on the wire price, in ticks - one flat-array entry, no lookup
+    return !risk_ || risk_->check_new_order(cmd) == RiskCheckResult::ACCEPTED;
 }
 
-void MultiInstrumentEngine::execute_trade(uint32_t instrument_id, uint64_t aggressor_id, uint64_t resting_id, 
-                                        int64_t price, uint64_t quantity,
-                                        const std::chrono::high_resolution_clock::time_point& processing_start) noexcept {
+void MultiInstrumentEngine::execute_trade(InstrumentState& state, uint64_t aggressor_id, uint64_t resting_id, 
+                                        Side aggressor_side, int64_t price, uint64_t quantity,
+                                        uint64_t processing_start) noexcept {
     // Calculate latency from processing start to trade execution
-    const auto latency_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
-        std::chrono::high_resolution_clock::now() - processing_start).count();
-
-    trade_latencies_ns_.push_back(latency_ns);
+    trade_latency_.record(TscClock::to_ns(rdtsc() - processing_start));
     
     // Update statistics
     ++total_trades_executed_;
-    trades_per_instrument_[instrument_id]++;
-    volume_per_instrument_[instrument_id] += quantity;
+    ++state.trades;
+    state.volume += quantity;
     
-    // Get instrument symbol for output
-    const std::string& symbol = instruments_.at(instrument_id).symbol;
-    
-    // Print trade details with instrument information
-    std::cout << "TRADE: " << symbol << " aggressor=" << aggressor_id 
-              << " resting=" << resting_id << " price=" << price 
-              << " qty=" << quantity << "\n";
+    // Symbol is resolved from the instrument id on the publisher thread
+    if (output_) {
+        output_->publish_trade(state.instrument.instrument_id, aggressor_id, resting_id, aggressor_side, price, quantity);
+    }
 }
 
-void MultiInstrumentEngine::match_order(uint32_t instrument_id, Order* order, 
-                                       const std::chrono::high_resolution_clock::time_point& processing_start) noexcept {
-    auto book_it = books_.find(instrument_id);
-    if (book_it == books_.end()) return;
-    
-    Book* book = book_it->second.get();
+void MultiInstrumentEngine::match_order(InstrumentState& state, Order* order, 
+                                       uint64_t processing_start) noexcept {
+    Book* book = &state.book;
     
     if (order->side == Side::BUY) {
         // Match against asks
-        for (int64_t price = book->best_ask(); price <= order->price && price != -1; ++price) {
+        for (int64_t price = book->best_ask(); price != -1 && price <= order->price; 
+             price = book->next_ask_price(price)) {
             PriceLevel* level = book->get_price_level(price, Side::SELL);
-            if (!level || level->empty()) continue;
             
-            Order* ask_order = level->head;
-            while (ask_order && order->quantity > 0) {
-                Order* next_ask = ask_order->next;
+            OrderIndex next_ask = level->head;
+            while (next_ask != NULL_ORDER && order->quantity > 0) {
+                Order* ask_order = order_pool_->at(next_ask);
+                next_ask = ask_order->next;
                 
                 const uint64_t trade_quantity = std::min(order->quantity, ask_order->quantity);
-                execute_trade(instrument_id, order->order_id, ask_order->order_id, 
-                            price, trade_quantity, processing_start);
+                execute_trade(state, order->order_id, ask_order->order_id, 
+                            order->side, price, trade_quantity, processing_start);
                 
                 order->quantity -= trade_quantity;
-                ask_order->quantity -= trade_quantity;
+                book->fill_order(level, ask_order, trade_quantity);
+                record_fill(order_pool_->info(ask_order).account_id, Side::SELL, trade_quantity);
                 
                 if (ask_order->quantity == 0) {
-                    level->remove_order(ask_order);
-                    if (ask_order->order_id < order_map_.size()) {
-                        order_map_[ask_order->order_id] = {nullptr, 0};
-                    }
+                    book->remove_order(ask_order);
+                    order_index_.erase(ask_order->order_id, order_pool_->index_of(ask_order));
                     order_pool_->free(ask_order);
                 }
-                
-                ask_order = next_ask;
             }
             
             if (order->quantity == 0) break;
         }
     } else {
         // Match against bids
-        for (int64_t price = book->best_bid(); price >= order->price && price != -1; --price) {
+        for (int64_t price = book->best_bid(); price != -1 && price >= order->price; 
+             price = book->next_bid_price(price)) {
             PriceLevel* level = book->get_price_level(price, Side::BUY);
-            if (!level || level->empty()) continue;
             
-            Order* bid_order = level->head;
-            while (bid_order && order->quantity > 0) {
-                Order* next_bid = bid_order->next;
+            OrderIndex next_bid = level->head;
+            while (next_bid != NULL_ORDER && order->quantity > 0) {
+                Order* bid_order = order_pool_->at(next_bid);
+                next_bid = bid_order->next;
                 
                 const uint64_t trade_quantity = std::min(order->quantity, bid_order->quantity);
-                execute_trade(instrument_id, order->order_id, bid_order->order_id, 
-                            price, trade_quantity, processing_start);
+                execute_trade(state, order->order_id, bid_order->order_id, 
+                            order->side, price, trade_quantity, processing_start);
                 
                 order->quantity -= trade_quantity;
-                bid_order->quantity -= trade_quantity;
+                book->fill_order(level, bid_order, trade_quantity);
+                record_fill(order_pool_->info(bid_order).account_id, Side::BUY, trade_quantity);
                 
                 if (bid_order->quantity == 0) {
-                    level->remove_order(bid_order);
-                    if (bid_order->order_id < order_map_.size()) {
-                        order_map_[bid_order->order_id] = {nullptr, 0};
-                    }
+                    book->remove_order(bid_order);
+                    order_index_.erase(bid_order->order_id, order_pool_->index_of(bid_order));
                     order_pool_->free(bid_order);
                 }
-                
-                bid_order = next_bid;
             }
             
             if (order->quantity == 0) break;
@@ -264,32 +539,11 @@ void MultiInstrumentEngine::match_order(uint32_t instrument_id, Order* order,
 }
 
 // Multi-instrument ring buffer implementation
-MultiInstrumentRingBuffer::MultiInstrumentRingBuffer() 
-    : head_(0), tail_(0), buffer_(RING_BUFFER_SIZE) {}
-
-bool MultiInstrumentRingBuffer::enqueue(const MultiInstrumentCommand& cmd) noexcept {
-    const uint64_t current_head = head_.load(std::memory_order_relaxed);
-    const uint64_t next_head = (current_head + 1) & RING_BUFFER_MASK;
-    
-    if (next_head == tail_.load(std::memory_order_acquire)) {
-        return false;
-    }
-    
-    buffer_[current_head] = cmd;
-    head_.store(next_head, std::memory_order_release);
-    return true;
-}
+MultiInstrumentRingBuffer::MultiInstrumentRingBuffer(uint64_t capacity) 
+    : SPSCQueue<MultiInstrumentCommand>(capacity) {}
 
-bool MultiInstrumentRingBuffer::dequeue(MultiInstrumentCommand& cmd) noexcept {
-    const uint64_t current_tail = tail_.load(std::memory_order_relaxed);
-    
-    if (current_tail == head_.load(std::memory_order_acquire)) {
-        return false;
-    }
-    
-    cmd = buffer_[current_tail];
-    tail_.store((current_tail + 1) & RING_BUFFER_MASK, std::memory_order_release);
-    return true;
-}
+MultiInstrumentRingBuffer::MultiInstrumentRingBuffer(SPSCQueueIndices* indices, void* slots,
+                                                     uint64_t capacity) noexcept
+    : SPSCQueue<MultiInstrumentCommand>(indices, slots, capacity) {}
 
 } // namespace OrderBook
\ No newline at end of file
@@ -0,0 +1,146 @@
+#include "multicast_publisher.hpp"
+#include <cerrno>
+#include <cstring>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace OrderBook {
+
+MulticastMarketDataPublisher::MulticastMarketDataPublisher(const std::string& group, uint16_t port,
+                                                           const std::string& interface_address, int ttl,
+                                                           bool loopback)
+    : fd_(-1), packet_length_(sizeof(MarketDataPacketHeader)), message_count_(0), sequence_(0),
+      packets_sent_(0), send_failures_(0) {
+    sockaddr_in destination{};
+    destination.sin_family = AF_INET;
+    destination.sin_port = htons(port);
+    if (inet_pton(AF_INET, group.c_str(), &destination.sin_addr) != 1) {
+        error_ = "invalid address " + group;
+        return;
+    }
+
+    const int fd = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        error_ = std::string("socket: ") + std::strerror(errno);
+        return;
+    }
+
+    bool ok = true;
+    if (IN_MULTICAST(ntohl(destination.sin_addr.s_addr))) {
+        const unsigned char multicast_ttl = static_cast<unsigned char>(ttl);
+        const unsigned char multicast_loop = loopback ? 1 : 0;
+        ok = setsockopt(fd, IPPROTO_IP, IP_MULTICAST_TTL, &multicast_ttl, sizeof(multicast_ttl)) == 0 &&
+             setsockopt(fd, IPPROTO_IP, IP_MULTICAST_LOOP, &multicast_loop, sizeof(multicast_loop)) == 0;
+        if (ok && !interface_address.empty()) {
+            in_addr interface{};
+            ok = inet_pton(AF_INET, interface_address.c_str(), &interface) == 1 &&
+                 setsockopt(fd, IPPROTO_IP, IP_MULTICAST_IF, &interface, sizeof(interface)) == 0;
+        }
+    }
+    if (!ok || connect(fd, reinterpret_cast<sockaddr*>(&destination), sizeof(destination)) != 0) {
+        error_ = "connect to " + group + ":" + std::to_string(port) + ": " + std::strerror(errno);
+        ::close(fd);
+        return;
+    }
+    fd_ = fd;
+}
+
+MulticastMarketDataPublisher::~MulticastMarketDataPublisher() {
+    if (fd_ < 0) return;
+    flush();
+    ::close(fd_);
+}
+
+char* MulticastMarketDataPublisher::reserve(size_t size) {
+    if (packet_length_ + size > packet_.size()) send_packet();
+    char* message = packet_.data() + packet_length_;
+    packet_length_ += size;
+    return message;
+}
+
+void MulticastMarketDataPublisher::send_packet() noexcept {
+    if (message_count_ == 0) return;
+
+    MarketDataPacketHeader header{};
+    header.sequence = ++sequence_;
+    header.message_count = message_count_;
+    header.length = static_cast<uint16_t>(packet_length_);
+    std::memcpy(packet_.data(), &header, sizeof(header));
+
+    // A datagram is sent whole or not at all; a dropped one shows up as a sequence gap
+    if (fd_ >= 0 && ::send(fd_, packet_.data(), packet_length_, MSG_DONTWAIT) == static_cast<ssize_t>(packet_length_)) {
+        ++packets_sent_;
+    } else {
+        ++send_failures_;
+    }
+    packet_length_ = sizeof(MarketDataPacketHeader);
+    message_count_ = 0;
+}
+
+void MulticastMarketDataPublisher::publish_trade(const Trade& trade) {
+    TradeMessage message{};
+    message.type = MarketDataMessageType::TRADE;
+    message.aggressor_side = trade.aggressor_side;
+    message.instrument_id = trade.instrument_id;
+    message.timestamp_ns = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(trade.timestamp.time_since_epoch()).count());
+    message.aggressor_order_id = trade.aggressor_order_id;
+    message.resting_order_id = trade.resting_order_id;
+    message.price = trade.price;
+    message.quantity = trade.quantity;
+    std::memcpy(reserve(sizeof(message)), &message, sizeof(message));
+    ++message_count_;
+}
+
+void MulticastMarketDataPublisher::publish_level2_update(uint32_t instrument_id, Side side, int64_t price,
+                                                         uint64_t new_quantity, uint32_t new_order_count) {
+    LevelMessage message{};
+    message.type = MarketDataMessageType::LEVEL2_UPDATE;
+    message.side = side;
+    message.instrument_id = instrument_id;
+    message.price = price;
+    message.quantity = new_quantity;
+    message.order_count = new_order_count;
+    std::memcpy(reserve(sizeof(message)), &message, sizeof(message));
+    ++message_count_;
+}
+
+void MulticastMarketDataPublisher::publish_level2_snapshot(const Level2Snapshot& snapshot) {
+    const size_t levels = snapshot.bids.size() + snapshot.asks.size();
+
+    // Reserve the whole snapshot at once so it never spans two packets
+    char* out = reserve(sizeof(SnapshotHeaderMessage) + levels * sizeof(LevelMessage));
+
+    SnapshotHeaderMessage header{};
+    header.type = MarketDataMessageType::SNAPSHOT;
+    header.instrument_id = snapshot.instrument_id;
+    header.bid_levels = static_cast<uint16_t>(snapshot.bids.size());
+    header.ask_levels = static_cast<uint16_t>(snapshot.asks.size());
+    std::memcpy(out, &header, sizeof(header));
+    out += sizeof(header);
+
+    auto write_levels = [&](const DepthLevels& depth, Side side) {
+        for (const PriceLevelData& level : depth) {
+            LevelMessage message{};
+            message.type = MarketDataMessageType::SNAPSHOT_LEVEL;
+            message.side = side;
+            message.instrument_id = snapshot.instrument_id;
+            message.price = level.price;
+            message.quantity = level.quantity;
+            message.order_count = level.order_count;
+            std::memcpy(out, &message, sizeof(message));
+            out += sizeof(message);
+        }
+    };
+    write_levels(snapshot.bids, Side::BUY);
+    write_levels(snapshot.asks, Side::SELL);
+    message_count_ += static_cast<uint16_t>(1 + levels);
+}
+
+void MulticastMarketDataPublisher::flush() {
+    send_packet();
+}
+
+} // namespace OrderBook
@@ -0,0 +1,140 @@
+#include "numa_placement.hpp"
+#include <linux/mempolicy.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace OrderBook {
+
+namespace {
+
+constexpr uint64_t PAGE_SIZE_BYTES = 4096;
+constexpr int MAX_NODES = 1024;
+constexpr size_t MASK_WORDS = MAX_NODES / (8 * sizeof(unsigned long));
+
+/**
+ * Number after `prefix` in a sysfs entry name like "node1", or -1
+ */
+int parse_index(const char* name, const char* prefix) noexcept {
+    const size_t length = std::strlen(prefix);
+    if (std::strncmp(name, prefix, length) != 0 || name[length] == '\0') return -1;
+
+    char* end = nullptr;
+    const long value = std::strtol(name + length, &end, 10);
+    return (*end == '\0' && value >= 0 && value < MAX_NODES) ? static_cast<int>(value) : -1;
+}
+
+long set_mempolicy(int mode, const unsigned long* mask, unsigned long max_node) noexcept {
+    return syscall(SYS_set_mempolicy, mode, mask, max_node);
+}
+
+} // namespace
+
+PageCensus& PageCensus::operator+=(const PageCensus& other) noexcept {
+    local += other.local;
+    remote += other.remote;
+    unknown += other.unknown;
+    return *this;
+}
+
+int NumaPlacement::node_count() noexcept {
+    DIR* dir = opendir("/sys/devices/system/node");
+    if (!dir) return 1;
+
+    int count = 0;
+    while (const dirent* entry = readdir(dir)) {
+        if (parse_index(entry->d_name, "node") >= 0) ++count;
+    }
+    closedir(dir);
+    return std::max(count, 1);
+}
+
+int NumaPlacement::node_of_cpu(int cpu) noexcept {
+    if (cpu < 0) return -1;
+
+    // cpuN/ holds a nodeK link to the node it belongs to
+    const std::string path = "/sys/devices/system/cpu/cpu" + std::to_string(cpu);
+    DIR* dir = opendir(path.c_str());
+    if (!dir) return -1;
+
+    int node = -1;
+    while (const dirent* entry = readdir(dir)) {
+        node = parse_index(entry->d_name, "node");
+        if (node >= 0) break;
+    }
+    closedir(dir);
+
+    // Kernels without NUMA have no link - everything is on node 0
+    return (node >= 0) ? node : 0;
+}
+
+bool NumaPlacement::pin_current_thread(int cpu) noexcept {
+    if (cpu < 0 || cpu >= CPU_SETSIZE) return false;
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return sched_setaffinity(0, sizeof(set), &set) == 0;
+}
+
+PageCensus NumaPlacement::census(const void* address, uint64_t bytes, int node,
+                                 uint64_t max_samples) noexcept {
+    PageCensus result;
+    if (!address || bytes == 0 || max_samples == 0) return result;
+
+    const uintptr_t first = reinterpret_cast<uintptr_t>(address) & ~(PAGE_SIZE_BYTES - 1);
+    const uint64_t pages = (reinterpret_cast<uintptr_t>(address) + bytes - first + PAGE_SIZE_BYTES - 1) /
+                           PAGE_SIZE_BYTES;
+    const uint64_t stride = std::max<uint64_t>(1, pages / max_samples);
+
+    std::vector<void*> sample;
+    sample.reserve(std::min(pages, max_samples));
+    for (uint64_t page = 0; page < pages && sample.size() < max_samples; page += stride) {
+        sample.push_back(reinterpret_cast<void*>(first + page * PAGE_SIZE_BYTES));
+    }
+
+    // move_pages with no target nodes only reports where each page is
+    std::vector<int> status(sample.size(), -1);
+    if (syscall(SYS_move_pages, 0, sample.size(), sample.data(), nullptr, status.data(), 0) != 0) {
+        result.unknown = sample.size();
+        return result;
+    }
+
+    for (const int page_node : status) {
+        if (page_node < 0) {
+            ++result.unknown;
+        } else if (page_node == node) {
+            ++result.local;
+        } else {
+            ++result.remote;
+        }
+    }
+    return result;
+}
+
+NumaPlacement::ScopedNodePreference::ScopedNodePreference(int node) noexcept
+    : active_(false) {
+    if (node < 0 || node >= MAX_NODES || node_count() < 2) return;
+
+    unsigned long mask[MASK_WORDS] = {};
+    mask[node / (8 * sizeof(unsigned long))] = 1ul << (node % (8 * sizeof(unsigned long)));
+    active_ = set_mempolicy(MPOL_PREFERRED, mask, MAX_NODES + 1) == 0;
+}
+
+NumaPlacement::ScopedNodePreference::~ScopedNodePreference() {
+    release();
+}
+
+void NumaPlacement::ScopedNodePreference::release() noexcept {
+    if (!active_) return;
+    set_mempolicy(MPOL_DEFAULT, nullptr, 0);
+    active_ = false;
+}
+
+} // namespace OrderBook
@@ -0,0 +1,143 @@
+#include "order_gateway.hpp"
+#include "risk_manager.hpp"
+#include "numa_placement.hpp"
+#include "tsc_clock.hpp"
+#include <string>
+
+namespace OrderBook {
+
+using namespace OrderEntry;
+
+OrderGateway::OrderGateway(GatewayTransport* transport, SPSCQueue<Command>* ring, const RiskManager& accounts)
+    : transport_(transport), ring_(ring), accounts_(accounts), last_session_id_(0), running_(false) {}
+
+OrderGateway::~OrderGateway() {
+    stop();
+}
+
+void OrderGateway::start(int cpu) {
+    if (running_.exchange(true)) return;
+    thread_ = std::thread([this, cpu] {
+        if (cpu >= 0) NumaPlacement::pin_current_thread(cpu);
+        while (running_.load(std::memory_order_acquire)) {
+            if (poll_once(0) == 0) std::this_thread::yield();  // Idle - let a shared core's other stages run
+        }
+    });
+}
+
+void OrderGateway::stop() {
+    if (!running_.exchange(false)) return;
+    thread_.join();
+}
+
+size_t OrderGateway::poll_once(int timeout_ms) {
+    return transport_->poll(*this, timeout_ms);
+}
+
+OrderGateway::Session& OrderGateway::session(ConnectionId connection) {
+    if (connection >= sessions_.size()) sessions_.resize(connection + 1);
+    return sessions_[connection];
+}
+
+void OrderGateway::on_connect(ConnectionId connection) {
+    session(connection) = Session{};
+    ++statistics_.sessions_accepted;
+}
+
+void OrderGateway::on_disconnect(ConnectionId connection) {
+    session(connection) = Session{};
+}
+
+size_t OrderGateway::on_data(ConnectionId connection, const char* data, size_t size) {
+    Session& current = session(connection);
+
+    size_t offset = 0;
+    while (size - offset >= sizeof(MessageHeader)) {
+        const MessageHeader header = read_message<MessageHeader>(data + offset);
+        if (header.version != PROTOCOL_VERSION || header.length == 0 ||
+            header.length != message_length(header.type)) {
+            protocol_error(connection, current);
+            return size;
+        }
+        if (size - offset < header.length) break;  // Rest of the message still in flight
+
+        const char* message = data + offset;
+        offset += header.length;
+
+        if (header.type == MessageType::LOGON) {
+            if (!handle_logon(connection, current, message)) return size;
+            continue;
+        }
+        if (!current.logged_on) {
+            protocol_error(connection, current);
+            return size;
+        }
+
+        // Decode in place into the engine's next slot; a bad message is never committed
+        Command& slot = claim();
+        if (!decode_command(message, header.type, current.session_id, slot)) {
+            protocol_error(connection, current);
+            return size;
+        }
+        slot.account_id = current.account_id;
+        slot.producer_timestamp = rdtsc();
+        ring_->commit();
+        ++statistics_.commands;
+    }
+    return offset;
+}
+
+bool OrderGateway::handle_logon(ConnectionId connection, Session& session, const char* bytes) {
+    if (session.logged_on) {
+        protocol_error(connection, session);
+        return false;
+    }
+
+    const LogonMessage logon = read_message<LogonMessage>(bytes);
+    const AccountId account = accounts_.find_account(std::string(account_name(logon)));
+    const bool accepted = account != NO_ACCOUNT && last_session_id_ < MAX_SESSION_ID;
+
+    LogonResponseMessage response{};
+    response.header.length = sizeof(response);
+    response.header.type = accepted ? MessageType::LOGON_ACK : MessageType::LOGON_REJECT;
+    response.header.version = PROTOCOL_VERSION;
+    response.account_id = accepted ? account : NO_ACCOUNT;
+    response.session_id = accepted ? last_session_id_ + 1 : 0;
+    const bool sent = transport_->send(connection, &response, sizeof(response));
+
+    if (!accepted || !sent) {
+        ++statistics_.logons_rejected;
+        session = Session{};
+        transport_->close(connection);
+        return false;
+    }
+    session.logged_on = true;
+    session.account_id = account;
+    session.session_id = ++last_session_id_;
+    ++statistics_.logons;
+    return true;
+}
+
+void OrderGateway::protocol_error(ConnectionId connection, Session& session) {
+    ++statistics_.protocol_errors;
+    session = Session{};
+    transport_->close(connection);
+}
+
+Command& OrderGateway::claim() noexcept {
+    Command* slot = ring_->try_claim();
+    if (!slot) {
+        ++statistics_.ring_stalls;
+        while (!(slot = ring_->try_claim())) {
+            // Engine ring full - wait rather than drop an accepted order
+            std::this_thread::yield();
+        }
+    }
+    return *slot;
+}
+
+const GatewayStatistics& OrderGateway::statistics() const noexcept {
+    return statistics_;
+}
+
+} // namespace OrderBook
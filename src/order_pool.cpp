@@ -1,47 +1,114 @@
 #include "order_pool.hpp"
+#include "engine_snapshot.hpp"
+#include <algorithm>
+#include <memory>
+#include <new>
 
 namespace OrderBook {
 
-OrderPool::OrderPool(uint64_t max_orders) noexcept 
-    : pool_(max_orders), free_head_(nullptr), allocated_count_(0) {
-    
-    // Initialize free list - all orders are initially free
-    // Link them together using the next pointer
-    for (uint64_t i = 0; i < max_orders - 1; ++i) {
-        pool_[i].next = &pool_[i + 1];
+OrderPool::OrderPool(uint64_t slab_orders, uint32_t max_slabs)
+    : order_region_(slab_orders * std::max<uint32_t>(max_slabs, 1) * sizeof(Order)),
+      info_region_(slab_orders * std::max<uint32_t>(max_slabs, 1) * sizeof(OrderInfo)),
+      pool_(reinterpret_cast<Order*>(order_region_.data())),
+      info_(reinterpret_cast<OrderInfo*>(info_region_.data())),
+      free_head_(NULL_ORDER), slab_orders_(slab_orders), max_slabs_(std::max<uint32_t>(max_slabs, 1)),
+      slab_count_(0), allocated_count_(0), high_water_mark_(0), exhaustion_count_(0) {
+
+    // The first slab is mapped and pre-faulted here, at startup
+    if (slab_orders_ == 0 || !grow()) throw std::bad_alloc();
+}
+
+bool OrderPool::grow() noexcept {
+    if (slab_count_ == max_slabs_) return false;
+
+    const uint64_t first = capacity();
+    const uint64_t last = first + slab_orders_;
+    if (!order_region_.commit(last * sizeof(Order)) || !info_region_.commit(last * sizeof(OrderInfo))) {
+        return false;
     }
-    pool_[max_orders - 1].next = nullptr;
-    free_head_ = &pool_[0];
+
+    std::uninitialized_default_construct_n(pool_ + first, slab_orders_);
+    std::uninitialized_default_construct_n(info_ + first, slab_orders_);
+
+    // Link the new slab in index order ahead of whatever is still free
+    for (uint64_t i = first; i < last - 1; ++i) {
+        pool_[i].next = static_cast<OrderIndex>(i + 1);
+    }
+    pool_[last - 1].next = free_head_;
+    free_head_ = static_cast<OrderIndex>(first);
+
+    ++slab_count_;
+    return true;
 }
 
 Order* OrderPool::allocate() noexcept {
-    if (!free_head_) return nullptr;
-    
-    Order* order = free_head_;
-    free_head_ = free_head_->next;
-    
+    if (free_head_ == NULL_ORDER && !grow()) {
+        ++exhaustion_count_;
+        return nullptr;
+    }
+
+    Order* order = &pool_[free_head_];
+    free_head_ = order->next;
+
     // Clear the order for reuse
-    order->next = nullptr;
-    order->prev = nullptr;
+    order->next = NULL_ORDER;
+    order->prev = NULL_ORDER;
     ++allocated_count_;
-    
+    high_water_mark_ = std::max(high_water_mark_, allocated_count_);
+
     return order;
 }
 
 void OrderPool::free(Order* order) noexcept {
     if (!order) return;
-    
+
     order->next = free_head_;
-    free_head_ = order;
+    free_head_ = index_of(order);
     --allocated_count_;
 }
 
-uint64_t OrderPool::allocated_count() const noexcept { 
-    return allocated_count_; 
+uint64_t OrderPool::allocated_count() const noexcept {
+    return allocated_count_;
+}
+
+uint64_t OrderPool::available_count() const noexcept {
+    return capacity() - allocated_count_;
+}
+
+void OrderPool::save(SnapshotWriter& out) const noexcept {
+    out.put(slab_orders_);
+    out.put(slab_count_);
+    out.put(free_head_);
+    out.put(allocated_count_);
+    out.put(high_water_mark_);
+    out.put(exhaustion_count_);
+    out.write(pool_, capacity() * sizeof(Order));
+    out.write(info_, capacity() * sizeof(OrderInfo));
 }
 
-uint64_t OrderPool::available_count() const noexcept { 
-    return pool_.size() - allocated_count_; 
+bool OrderPool::load(SnapshotReader& in) noexcept {
+    uint64_t slab_orders = 0, allocated = 0, high_water_mark = 0, exhaustions = 0;
+    uint32_t slab_count = 0;
+    OrderIndex free_head = NULL_ORDER;
+    if (!in.get(slab_orders) || !in.get(slab_count) || !in.get(free_head) || !in.get(allocated) ||
+        !in.get(high_water_mark) || !in.get(exhaustions) ||
+        slab_orders != slab_orders_ || slab_count > max_slabs_ || slab_count < slab_count_) {
+        return false;
+    }
+
+    // Back every slab the snapshot used; their free lists are overwritten below
+    while (slab_count_ < slab_count) {
+        if (!grow()) return false;
+    }
+    if (!in.read(pool_, capacity() * sizeof(Order)) || !in.read(info_, capacity() * sizeof(OrderInfo))) {
+        return false;
+    }
+
+    free_head_ = free_head;
+    allocated_count_ = allocated;
+    high_water_mark_ = high_water_mark;
+    exhaustion_count_ = exhaustions;
+    return true;
 }
 
-} // namespace OrderBook
\ No newline at end of file
+} // namespace OrderBook
@@ -0,0 +1,125 @@
+#include "output_stage.hpp"
+#include "tsc_clock.hpp"
+#include "numa_placement.hpp"
+
+namespace OrderBook {
+
+OutputStage::OutputStage(MarketDataManager* manager, uint64_t capacity)
+    : owned_ring_(std::make_unique<SPSCQueue<OutputEvent>>(capacity)), ring_(owned_ring_.get()),
+      manager_(manager), running_(false), producer_stalls_(0), events_published_(0) {}
+
+OutputStage::OutputStage(MarketDataManager* manager, SPSCQueue<OutputEvent>* ring)
+    : ring_(ring), manager_(manager), running_(false), producer_stalls_(0), events_published_(0) {}
+
+OutputStage::~OutputStage() {
+    stop();
+}
+
+void OutputStage::start(int cpu) {
+    if (running_.exchange(true)) return;
+    publisher_thread_ = std::thread([this, cpu] {
+        if (cpu >= 0) NumaPlacement::pin_current_thread(cpu);
+        run();
+    });
+}
+
+void OutputStage::stop() {
+    if (!running_.exchange(false)) return;
+    publisher_thread_.join();
+}
+
+void OutputStage::run() {
+    // Keep draining after stop() is requested until the ring is empty
+    while (true) {
+        const bool stopping = !running_.load(std::memory_order_acquire);
+        if (drain() == 0) {
+            if (stopping) break;
+            std::this_thread::yield();  // Idle - publisher is off the critical path
+        }
+    }
+    
+    // Conflated updates still waiting on their interval go out before exit
+    if (manager_) manager_->flush_all();
+}
+
+OutputEvent& OutputStage::claim() noexcept {
+    OutputEvent* slot = ring_->try_claim();
+    if (!slot) {
+        ++producer_stalls_;
+        while (!(slot = ring_->try_claim())) {
+            // Output ring full - wait for the publisher rather than drop reports
+            std::this_thread::yield();
+        }
+    }
+    return *slot;
+}
+
+void OutputStage::publish_trade(uint32_t instrument_id, uint64_t aggressor_id, uint64_t resting_id,
+                                Side aggressor_side, int64_t price, uint64_t quantity) noexcept {
+    OutputEvent& event = claim();
+    event.type = OutputEventType::TRADE;
+    event.instrument_id = instrument_id;
+    event.aggressor_order_id = aggressor_id;
+    event.resting_order_id = resting_id;
+    event.side = aggressor_side;
+    event.price = price;
+    event.quantity = quantity;
+    event.order_count = 0;
+    event.timestamp = rdtsc();
+    ring_->commit();
+}
+
+void OutputStage::publish_level2_update(uint32_t instrument_id, Side side, int64_t price,
+                                        uint64_t quantity, uint32_t order_count) noexcept {
+    OutputEvent& event = claim();
+    event.type = OutputEventType::LEVEL2_UPDATE;
+    event.instrument_id = instrument_id;
+    event.aggressor_order_id = 0;
+    event.resting_order_id = 0;
+    event.side = side;
+    event.price = price;
+    event.quantity = quantity;
+    event.order_count = order_count;
+    event.timestamp = rdtsc();
+    ring_->commit();
+}
+
+size_t OutputStage::drain() {
+    const size_t count = ring_->consume_bulk(OUTPUT_BATCH_SIZE, [this](const OutputEvent& event) {
+        publish_latency_.record(TscClock::to_ns(rdtsc() - event.timestamp));
+        dispatch(event);
+    });
+
+    if (count > 0) {
+        events_published_ += count;
+        if (manager_) manager_->flush();  // One write per batch, not per record
+    }
+    return count;
+}
+
+void OutputStage::dispatch(const OutputEvent& event) {
+    if (!manager_) return;
+
+    if (event.type == OutputEventType::TRADE) {
+        Trade trade(event.instrument_id, event.aggressor_order_id, event.resting_order_id,
+                    event.side, event.price, event.quantity);
+        manager_->publish_trade(trade);
+    } else {
+        manager_->publish_level2_update(event.instrument_id, event.side, event.price,
+                                        event.quantity, event.order_count);
+    }
+}
+
+uint64_t OutputStage::producer_stalls() const noexcept {
+    return producer_stalls_;
+}
+
+uint64_t OutputStage::events_published() const noexcept {
+    return events_published_;
+}
+
+const LatencyHistogram& OutputStage::publish_latency() const noexcept {
+    return publish_latency_;
+}
+
+} // namespace OrderBook
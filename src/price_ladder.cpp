@@ -0,0 +1,276 @@
+#include "price_ladder.hpp"
+#include "engine_snapshot.hpp"
+#include <algorithm>
+
+namespace OrderBook {
+
+namespace {
+
+uint64_t ladder_tick_count(const LadderConfig& config) noexcept {
+    if (config.price_max < config.price_min || config.tick_size <= 0) return 1;
+    return static_cast<uint64_t>((config.price_max - config.price_min) / config.tick_size) + 1;
+}
+
+} // namespace
+
+PriceLadder::PriceLadder(const LadderConfig& config)
+    : price_min_(config.price_min),
+      tick_size_(config.tick_size > 0 ? config.tick_size : 1),
+      tick_count_(ladder_tick_count(config)),
+      window_base_(0),
+      window_(std::max<uint64_t>(1, std::min(config.window_levels, tick_count_))),
+      occupancy_(window_.size()),
+      depth_(window_.size()) {}
+
+bool PriceLadder::to_tick(int64_t price, uint64_t& tick) const noexcept {
+    if (price < price_min_) return false;
+
+    const uint64_t offset = static_cast<uint64_t>(price - price_min_);
+    if (tick_size_ == 1) {
+        tick = offset;
+    } else {
+        if (offset % static_cast<uint64_t>(tick_size_) != 0) return false;
+        tick = offset / static_cast<uint64_t>(tick_size_);
+    }
+    return tick < tick_count_;
+}
+
+int64_t PriceLadder::to_price(uint64_t tick) const noexcept {
+    return price_min_ + static_cast<int64_t>(tick) * tick_size_;
+}
+
+PriceLevel* PriceLadder::find(uint64_t tick) noexcept {
+    if (in_window(tick)) return &window_[tick - window_base_];
+
+    auto it = overflow_.find(tick);
+    return (it != overflow_.end()) ? &it->second : nullptr;
+}
+
+const PriceLevel* PriceLadder::find(uint64_t tick) const noexcept {
+    if (in_window(tick)) return &window_[tick - window_base_];
+
+    auto it = overflow_.find(tick);
+    return (it != overflow_.end()) ? &it->second : nullptr;
+}
+
+void PriceLadder::add_order(uint64_t tick, Order* order, OrderPool& pool) noexcept {
+    if (in_window(tick)) {
+        const uint64_t slot = tick - window_base_;
+        window_[slot].add_order(order, pool);
+        occupancy_.set(slot);
+        depth_.add(slot, order->quantity);
+    } else {
+        // Far from the touch - sparse store, allocation is acceptable here
+        overflow_[tick].add_order(order, pool);
+    }
+}
+
+bool PriceLadder::remove_order(uint64_t tick, Order* order, OrderPool& pool) noexcept {
+    if (in_window(tick)) {
+        const uint64_t slot = tick - window_base_;
+        window_[slot].remove_order(order, pool);
+        depth_.subtract(slot, order->quantity);
+        if (window_[slot].empty()) {
+            occupancy_.clear(slot);
+            return true;
+        }
+        return false;
+    }
+
+    auto it = overflow_.find(tick);
+    if (it == overflow_.end()) return true;
+
+    it->second.remove_order(order, pool);
+    if (it->second.empty()) {
+        overflow_.erase(it);
+        return true;
+    }
+    return false;
+}
+
+uint64_t PriceLadder::next_up(uint64_t tick) const noexcept {
+    if (tick >= tick_count_) return NO_TICK;
+
+    // Overflow levels below the window
+    if (tick < window_base_) {
+        auto it = overflow_.lower_bound(tick);
+        if (it != overflow_.end() && it->first < window_base_) return it->first;
+        tick = window_base_;
+    }
+
+    // Dense window via occupancy bitmap
+    const uint64_t window_end = window_base_ + window_.size();
+    if (tick < window_end) {
+        const uint64_t slot = occupancy_.find_next(tick - window_base_);
+        if (slot != OccupancyBitmap::NOT_FOUND) return window_base_ + slot;
+        tick = window_end;
+    }
+
+    // Overflow levels above the window
+    auto it = overflow_.lower_bound(tick);
+    return (it != overflow_.end()) ? it->first : NO_TICK;
+}
+
+uint64_t PriceLadder::next_down(uint64_t tick) const noexcept {
+    if (tick == NO_TICK) return NO_TICK;
+    if (tick >= tick_count_) tick = tick_count_ - 1;
+
+    // Overflow levels above the window
+    const uint64_t window_end = window_base_ + window_.size();
+    if (tick >= window_end) {
+        auto it = overflow_.upper_bound(tick);
+        if (it != overflow_.begin()) {
+            --it;
+            if (it->first >= window_end) return it->first;
+        }
+        tick = window_end - 1;
+    }
+
+    // Dense window via occupancy bitmap
+    if (tick >= window_base_) {
+        const uint64_t slot = occupancy_.find_prev(tick - window_base_);
+        if (slot != OccupancyBitmap::NOT_FOUND) return window_base_ + slot;
+        if (window_base_ == 0) return NO_TICK;
+        tick = window_base_ - 1;
+    }
+
+    // Overflow levels below the window
+    auto it = overflow_.upper_bound(tick);
+    if (it == overflow_.begin()) return NO_TICK;
+    --it;
+    return it->first;
+}
+
+void PriceLadder::recenter(uint64_t tick) noexcept {
+    const uint64_t size = window_.size();
+    const uint64_t max_base = tick_count_ - size;
+    const uint64_t new_base = std::min(max_base, (tick > size / 2) ? tick - size / 2 : 0);
+
+    if (new_base == window_base_) return;
+
+    // Park every occupied window level in the overflow store...
+    for (uint64_t slot = occupancy_.find_next(0); slot != OccupancyBitmap::NOT_FOUND;
+         slot = occupancy_.find_next(slot + 1)) {
+        overflow_.emplace(window_base_ + slot, window_[slot]);
+        window_[slot] = PriceLevel();
+    }
+    occupancy_.reset();
+    window_base_ = new_base;
+
+    // ...then pull back everything that falls inside the new window
+    auto it = overflow_.lower_bound(new_base);
+    while (it != overflow_.end() && it->first < new_base + size) {
+        const uint64_t slot = it->first - new_base;
+        window_[slot] = it->second;
+        occupancy_.set(slot);
+        it = overflow_.erase(it);
+    }
+    rebuild_depth();
+}
+
+void PriceLadder::rebuild_depth() noexcept {
+    depth_.rebuild([this](uint64_t slot) noexcept { return window_[slot].total_volume; });
+}
+
+uint64_t PriceLadder::volume_between(uint64_t first, uint64_t last, uint64_t enough) const noexcept {
+    // Window part from the depth tree...
+    const uint64_t window_end = window_base_ + window_.size();
+    uint64_t volume = 0;
+    if (first < window_end && last >= window_base_) {
+        const uint64_t from = std::max(first, window_base_) - window_base_;
+        const uint64_t to = std::min(last + 1, window_end) - window_base_;
+        volume = depth_.range(from, to);
+    }
+
+    // ...overflow levels in range only if that was not enough
+    for (auto it = overflow_.lower_bound(first); it != overflow_.end() && it->first <= last && volume < enough; ++it) {
+        volume += it->second.total_volume;
+    }
+    return volume;
+}
+
+uint64_t PriceLadder::volume_at_or_below(int64_t price, uint64_t enough) const noexcept {
+    if (price < price_min_) return 0;
+    const uint64_t tick = static_cast<uint64_t>(price - price_min_) / static_cast<uint64_t>(tick_size_);
+    return volume_between(0, std::min(tick, tick_count_ - 1), enough);
+}
+
+uint64_t PriceLadder::volume_at_or_above(int64_t price, uint64_t enough) const noexcept {
+    uint64_t tick = 0;
+    if (price > price_min_) {
+        tick = (static_cast<uint64_t>(price - price_min_) + tick_size_ - 1) / static_cast<uint64_t>(tick_size_);
+        if (tick >= tick_count_) return 0;
+    }
+    return volume_between(tick, tick_count_ - 1, enough);
+}
+
+bool PriceLadder::in_window(uint64_t tick) const noexcept {
+    return tick - window_base_ < window_.size();
+}
+
+uint64_t PriceLadder::tick_count() const noexcept {
+    return tick_count_;
+}
+
+uint64_t PriceLadder::window_size() const noexcept {
+    return window_.size();
+}
+
+uint64_t PriceLadder::overflow_levels() const noexcept {
+    return overflow_.size();
+}
+
+void PriceLadder::save(SnapshotWriter& out) const noexcept {
+    out.put(tick_count_);
+    out.put(static_cast<uint64_t>(window_.size()));
+    out.put(window_base_);
+
+    uint64_t levels = overflow_.size();
+    for (uint64_t slot = occupancy_.find_next(0); slot != OccupancyBitmap::NOT_FOUND;
+         slot = occupancy_.find_next(slot + 1)) {
+        ++levels;
+    }
+    out.put(levels);
+
+    for (uint64_t slot = occupancy_.find_next(0); slot != OccupancyBitmap::NOT_FOUND;
+         slot = occupancy_.find_next(slot + 1)) {
+        out.put(window_base_ + slot);
+        out.put(window_[slot]);
+    }
+    for (const auto& [tick, level] : overflow_) {
+        out.put(tick);
+        out.put(level);
+    }
+}
+
+bool PriceLadder::load(SnapshotReader& in) noexcept {
+    std::fill(window_.begin(), window_.end(), PriceLevel());
+    occupancy_.reset();
+    depth_.reset();
+    overflow_.clear();
+    window_base_ = 0;
+
+    uint64_t tick_count = 0, window_size = 0, window_base = 0, levels = 0;
+    if (!in.get(tick_count) || !in.get(window_size) || !in.get(window_base) || !in.get(levels) ||
+        tick_count != tick_count_ || window_size != window_.size() || window_base > tick_count_ - window_size) {
+        return false;
+    }
+    window_base_ = window_base;
+
+    for (uint64_t i = 0; i < levels; ++i) {
+        uint64_t tick = 0;
+        PriceLevel level;
+        if (!in.get(tick) || !in.get(level) || tick >= tick_count_) return false;
+
+        if (in_window(tick)) {
+            window_[tick - window_base_] = level;
+            occupancy_.set(tick - window_base_);
+        } else {
+            overflow_.emplace(tick, level);
+        }
+    }
+    rebuild_depth();
+    return true;
+}
+
+} // namespace OrderBook
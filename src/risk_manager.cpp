@@ -1,214 +1,181 @@
 #include "risk_manager.hpp"
-#include <iostream>
-#include <iomanip>
+#include "tsc_clock.hpp"
+#include "wait_strategy.hpp"
+#include <algorithm>
 #include <cmath>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
 
 namespace OrderBook {
 
-bool RiskManager::add_account(const std::string& account_id, const RiskLimits& limits) {
-    auto [it, inserted] = accounts_.try_emplace(account_id, account_id);
-    if (inserted) {
-        it->second.limits = limits;
-        return true;
+void TokenBucket::configure(uint32_t tokens_per_second) noexcept {
+    arrival_ticks = 0;
+    if (tokens_per_second == 0) {
+        ticks_per_token = 0;
+        burst_ticks = 0;
+        return;
     }
-    return false; // Account already exists
+    const double ticks_per_second = TscClock::ticks_per_ns() * 1e9;
+    ticks_per_token = std::max<uint64_t>(1, static_cast<uint64_t>(ticks_per_second / tokens_per_second));
+    burst_ticks = ticks_per_token * (tokens_per_second - 1);
 }
 
-bool RiskManager::remove_account(const std::string& account_id) {
-    return accounts_.erase(account_id) > 0;
+const char* to_string(RiskCheckResult result) noexcept {
+    switch (result) {
+        case RiskCheckResult::ACCEPTED: return "ACCEPTED";
+        case RiskCheckResult::REJECTED_POSITION_LIMIT: return "POSITION_LIMIT";
+        case RiskCheckResult::REJECTED_ORDER_SIZE: return "ORDER_SIZE";
+        case RiskCheckResult::REJECTED_ORDER_VALUE: return "ORDER_VALUE";
+        case RiskCheckResult::REJECTED_RATE_LIMIT: return "RATE_LIMIT";
+        case RiskCheckResult::REJECTED_EXPOSURE_LIMIT: return "EXPOSURE_LIMIT";
+        case RiskCheckResult::REJECTED_DAILY_VOLUME: return "DAILY_VOLUME";
+        case RiskCheckResult::REJECTED_PRICE_DEVIATION: return "PRICE_DEVIATION";
+        case RiskCheckResult::REJECTED_ACCOUNT_DISABLED: return "ACCOUNT_DISABLED";
+        case RiskCheckResult::REJECTED_UNKNOWN_ACCOUNT: return "UNKNOWN_ACCOUNT";
+        default: return "UNKNOWN";
+    }
 }
 
-bool RiskManager::update_limits(const std::string& account_id, const RiskLimits& limits) {
-    auto it = accounts_.find(account_id);
-    if (it != accounts_.end()) {
-        it->second.limits = limits;
-        return true;
-    }
-    return false;
+RiskManager::RiskManager() {
+    // Slot 0 is NO_ACCOUNT: present so any id indexes safely, never enabled
+    accounts_.emplace_back();
+    names_.emplace_back();
+    limits_.emplace_back();
 }
 
-bool RiskManager::enable_account(const std::string& account_id, bool enabled) {
-    auto it = accounts_.find(account_id);
-    if (it != accounts_.end()) {
-        it->second.enabled = enabled;
-        return true;
+void RiskManager::apply_limits(TradingAccount& account, const RiskLimits& limits) noexcept {
+    account.max_order_size = limits.max_order_size;
+    account.max_order_value = limits.max_order_value;
+    account.max_position = limits.max_position;
+    account.max_gross_exposure = limits.max_gross_exposure;
+    account.max_daily_volume = limits.max_daily_volume;
+    account.orders.configure(limits.max_orders_per_second);
+    account.cancels.configure(limits.max_cancels_per_second);
+
+    // Deviation band as whole ticks, so the check is two integer compares
+    if (reference_price_ > 0) {
+        const double band = std::floor(static_cast<double>(reference_price_) * limits.max_price_deviation);
+        account.price_floor = reference_price_ - static_cast<int64_t>(band);
+        account.price_ceiling = reference_price_ + static_cast<int64_t>(band);
+    } else {
+        account.price_floor = std::numeric_limits<int64_t>::min();
+        account.price_ceiling = std::numeric_limits<int64_t>::max();
     }
-    return false;
 }
 
-RiskCheckResult RiskManager::check_new_order(const std::string& account_id, const Command& cmd) noexcept {
-    total_orders_checked_++;
-    
-    if (!enabled_) {
-        return RiskCheckResult::ACCEPTED;
-    }
-    
-    auto it = accounts_.find(account_id);
-    if (it == accounts_.end()) {
-        total_orders_rejected_++;
-        rejection_counts_[static_cast<size_t>(RiskCheckResult::REJECTED_UNKNOWN_ACCOUNT)]++;
-        return RiskCheckResult::REJECTED_UNKNOWN_ACCOUNT;
-    }
-    
-    TradingAccount& account = it->second;
-    
-    if (!account.enabled) {
-        total_orders_rejected_++;
-        rejection_counts_[static_cast<size_t>(RiskCheckResult::REJECTED_ACCOUNT_DISABLED)]++;
-        return RiskCheckResult::REJECTED_ACCOUNT_DISABLED;
-    }
-    
-    update_rate_limits(account);
-    
-    // Check order size limit
-    if (cmd.quantity > account.limits.max_order_size) {
-        total_orders_rejected_++;
-        rejection_counts_[static_cast<size_t>(RiskCheckResult::REJECTED_ORDER_SIZE)]++;
-        return RiskCheckResult::REJECTED_ORDER_SIZE;
-    }
-    
-    // Check order value limit
-    uint64_t order_value = static_cast<uint64_t>(cmd.price) * cmd.quantity;
-    if (order_value > account.limits.max_order_value) {
-        total_orders_rejected_++;
-        rejection_counts_[static_cast<size_t>(RiskCheckResult::REJECTED_ORDER_VALUE)]++;
-        return RiskCheckResult::REJECTED_ORDER_VALUE;
-    }
-    
-    // Check rate limits
-    if (account.orders_this_second >= account.limits.max_orders_per_second) {
-        total_orders_rejected_++;
-        rejection_counts_[static_cast<size_t>(RiskCheckResult::REJECTED_RATE_LIMIT)]++;
-        return RiskCheckResult::REJECTED_RATE_LIMIT;
-    }
-    
-    // Check position limits
-    int64_t position_change = (cmd.side == Side::BUY) ? 
-        static_cast<int64_t>(cmd.quantity) : -static_cast<int64_t>(cmd.quantity);
-    int64_t new_position = account.net_position + position_change;
-    
-    if (std::abs(new_position) > account.limits.max_position) {
-        total_orders_rejected_++;
-        rejection_counts_[static_cast<size_t>(RiskCheckResult::REJECTED_POSITION_LIMIT)]++;
-        return RiskCheckResult::REJECTED_POSITION_LIMIT;
-    }
-    
-    // Check gross exposure limits
-    uint64_t new_gross_exposure = account.gross_exposure + cmd.quantity;
-    if (new_gross_exposure > account.limits.max_gross_exposure) {
-        total_orders_rejected_++;
-        rejection_counts_[static_cast<size_t>(RiskCheckResult::REJECTED_EXPOSURE_LIMIT)]++;
-        return RiskCheckResult::REJECTED_EXPOSURE_LIMIT;
-    }
-    
-    // Check daily volume limit
-    if (account.daily_volume + cmd.quantity > account.limits.max_daily_volume) {
-        total_orders_rejected_++;
-        rejection_counts_[static_cast<size_t>(RiskCheckResult::REJECTED_DAILY_VOLUME)]++;
-        return RiskCheckResult::REJECTED_DAILY_VOLUME;
-    }
-    
-    // Check price deviation
-    if (!check_price_deviation(cmd.price, account.limits.max_price_deviation)) {
-        total_orders_rejected_++;
-        rejection_counts_[static_cast<size_t>(RiskCheckResult::REJECTED_PRICE_DEVIATION)]++;
-        return RiskCheckResult::REJECTED_PRICE_DEVIATION;
-    }
-    
-    // Update rate limiting counter
-    account.orders_this_second++;
-    
-    return RiskCheckResult::ACCEPTED;
+AccountId RiskManager::logon(const std::string& account_name, const RiskLimits& limits) {
+    if (accounts_.size() >= MAX_ACCOUNTS || ids_.count(account_name)) return NO_ACCOUNT;
+
+    const AccountId id = static_cast<AccountId>(accounts_.size());
+    TradingAccount& account = accounts_.emplace_back();
+    apply_limits(account, limits);
+    account.enabled = true;
+    names_.push_back(account_name);
+    limits_.push_back(limits);
+    ids_.emplace(account_name, id);
+    return id;
 }
 
-RiskCheckResult RiskManager::check_cancel_order(const std::string& account_id, uint64_t order_id) noexcept {
-    if (!enabled_) {
-        return RiskCheckResult::ACCEPTED;
-    }
-    
-    auto it = accounts_.find(account_id);
-    if (it == accounts_.end()) {
-        return RiskCheckResult::REJECTED_UNKNOWN_ACCOUNT;
-    }
-    
-    TradingAccount& account = it->second;
-    
-    if (!account.enabled) {
-        return RiskCheckResult::REJECTED_ACCOUNT_DISABLED;
-    }
-    
-    update_rate_limits(account);
-    
-    // Check cancel rate limits
-    if (account.cancels_this_second >= account.limits.max_cancels_per_second) {
-        return RiskCheckResult::REJECTED_RATE_LIMIT;
+AccountId RiskManager::find_account(const std::string& account_name) const noexcept {
+    const auto it = ids_.find(account_name);
+    return it != ids_.end() ? it->second : NO_ACCOUNT;
+}
+
+bool RiskManager::update_limits(AccountId account_id, const RiskLimits& limits) noexcept {
+    if (account_id == NO_ACCOUNT || account_id >= accounts_.size()) return false;
+    apply_limits(accounts_[account_id], limits);
+    limits_[account_id] = limits;
+    return true;
+}
+
+bool RiskManager::enable_account(AccountId account_id, bool enabled) noexcept {
+    if (account_id == NO_ACCOUNT || account_id >= accounts_.size()) return false;
+    accounts_[account_id].enabled = enabled;
+    return true;
+}
+
+void RiskManager::set_reference_price(int64_t price) noexcept {
+    reference_price_ = price;
+
+    // Bands are derived from the reference - re-derive them, keeping rate state
+    for (size_t id = 1; id < accounts_.size(); ++id) {
+        const TokenBucket orders = accounts_[id].orders;
+        const TokenBucket cancels = accounts_[id].cancels;
+        apply_limits(accounts_[id], limits_[id]);
+        accounts_[id].orders = orders;
+        accounts_[id].cancels = cancels;
     }
-    
-    account.cancels_this_second++;
-    return RiskCheckResult::ACCEPTED;
 }
 
-void RiskManager::update_position(const std::string& account_id, Side side, uint64_t quantity, int64_t price) noexcept {
-    auto it = accounts_.find(account_id);
-    if (it == accounts_.end()) return;
-    
-    TradingAccount& account = it->second;
-    
-    int64_t position_change = (side == Side::BUY) ? 
-        static_cast<int64_t>(quantity) : -static_cast<int64_t>(quantity);
-    
-    account.net_position += position_change;
-    account.gross_exposure += quantity;
-    account.daily_volume += quantity;
-    account.daily_trade_count++;
+void RiskManager::publish_statistics() noexcept {
+    uint64_t words[STATISTICS_WORDS];
+    std::memcpy(words, &counters_, sizeof(words));
+
+    // Odd while the copy is in progress
+    const uint64_t sequence = statistics_sequence_.load(std::memory_order_relaxed);
+    statistics_sequence_.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for (size_t i = 0; i < STATISTICS_WORDS; ++i) {
+        published_[i].store(words[i], std::memory_order_relaxed);
+    }
+    statistics_sequence_.store(sequence + 2, std::memory_order_release);
 }
 
-void RiskManager::update_daily_volume(const std::string& account_id, uint64_t volume) noexcept {
-    auto it = accounts_.find(account_id);
-    if (it != accounts_.end()) {
-        it->second.daily_volume += volume;
+RiskStatistics RiskManager::statistics() const noexcept {
+    uint64_t words[STATISTICS_WORDS];
+    while (true) {
+        const uint64_t before = statistics_sequence_.load(std::memory_order_acquire);
+        if (before & 1) {
+            cpu_relax();  // Writer mid-copy
+            continue;
+        }
+        for (size_t i = 0; i < STATISTICS_WORDS; ++i) {
+            words[i] = published_[i].load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (statistics_sequence_.load(std::memory_order_relaxed) == before) break;
     }
+
+    RiskStatistics statistics;
+    std::memcpy(&statistics, words, sizeof(words));
+    return statistics;
 }
 
 uint64_t RiskManager::rejection_count(RiskCheckResult reason) const noexcept {
-    size_t index = static_cast<size_t>(reason);
-    if (index < rejection_counts_.size()) {
-        return rejection_counts_[index];
-    }
-    return 0;
+    const size_t index = static_cast<size_t>(reason);
+    return index < RISK_CHECK_RESULT_COUNT ? statistics().rejections[index] : 0;
 }
 
 double RiskManager::rejection_rate() const noexcept {
-    uint64_t total = total_orders_checked_;
-    if (total == 0) return 0.0;
-    return static_cast<double>(total_orders_rejected_) / total * 100.0;
+    const RiskStatistics stats = statistics();
+    if (stats.orders_checked == 0) return 0.0;
+    return static_cast<double>(stats.orders_rejected) / stats.orders_checked * 100.0;
 }
 
 void RiskManager::print_risk_statistics() const noexcept {
+    const RiskStatistics stats = statistics();
+
     std::cout << "\n=== RISK MANAGEMENT STATISTICS ===\n";
     std::cout << "Enabled: " << (enabled_ ? "YES" : "NO") << "\n";
-    std::cout << "Total Orders Checked: " << total_orders_checked_ << "\n";
-    std::cout << "Total Orders Rejected: " << total_orders_rejected_ << "\n";
-    std::cout << "Rejection Rate: " << std::fixed << std::setprecision(2) 
+    std::cout << "Total Orders Checked: " << stats.orders_checked << "\n";
+    std::cout << "Total Orders Rejected: " << stats.orders_rejected << "\n";
+    std::cout << "Total Cancels Checked / Rejected: " << stats.cancels_checked << " / "
+              << stats.cancels_rejected << "\n";
+    std::cout << "Rejection Rate: " << std::fixed << std::setprecision(2)
               << rejection_rate() << "%\n";
-    
+
     std::cout << "\nRejection Reasons:\n";
-    const char* reasons[] = {
-        "ACCEPTED", "POSITION_LIMIT", "ORDER_SIZE", "ORDER_VALUE", 
-        "RATE_LIMIT", "EXPOSURE_LIMIT", "DAILY_VOLUME", "PRICE_DEVIATION",
-        "ACCOUNT_DISABLED", "UNKNOWN_ACCOUNT"
-    };
-    
-    for (size_t i = 1; i < rejection_counts_.size(); ++i) { // Skip ACCEPTED
-        uint64_t count = rejection_counts_[i];
-        if (count > 0) {
-            std::cout << "  " << reasons[i] << ": " << count << "\n";
+    for (size_t i = 1; i < RISK_CHECK_RESULT_COUNT; ++i) { // Skip ACCEPTED
+        if (stats.rejections[i] > 0) {
+            std::cout << "  " << to_string(static_cast<RiskCheckResult>(i)) << ": " << stats.rejections[i] << "\n";
         }
     }
-    
+
     std::cout << "\nAccount Summary:\n";
-    for (const auto& [account_id, account] : accounts_) {
-        std::cout << "  Account: " << account_id << "\n";
+    for (size_t id = 1; id < accounts_.size(); ++id) {
+        const TradingAccount& account = accounts_[id];
+        std::cout << "  Account: " << names_[id] << " (id " << id << ")\n";
         std::cout << "    Enabled: " << (account.enabled ? "YES" : "NO") << "\n";
         std::cout << "    Net Position: " << account.net_position << "\n";
         std::cout << "    Gross Exposure: " << account.gross_exposure << "\n";
@@ -219,60 +186,20 @@ void RiskManager::print_risk_statistics() const noexcept {
 }
 
 void RiskManager::reset_daily_limits() noexcept {
-    for (auto& [account_id, account] : accounts_) {
+    for (TradingAccount& account : accounts_) {
         account.daily_volume = 0;
         account.daily_trade_count = 0;
     }
 }
 
-const TradingAccount* RiskManager::get_account(const std::string& account_id) const noexcept {
-    auto it = accounts_.find(account_id);
-    return (it != accounts_.end()) ? &it->second : nullptr;
+const TradingAccount* RiskManager::get_account(AccountId account_id) const noexcept {
+    if (account_id == NO_ACCOUNT || account_id >= accounts_.size()) return nullptr;
+    return &accounts_[account_id];
 }
 
-std::vector<std::string> RiskManager::get_all_account_ids() const noexcept {
-    std::vector<std::string> account_ids;
-    account_ids.reserve(accounts_.size());
-    
-    for (const auto& [account_id, account] : accounts_) {
-        account_ids.push_back(account_id);
-    }
-    
-    return account_ids;
-}
-
-void RiskManager::update_rate_limits(TradingAccount& account) noexcept {
-    auto now = std::chrono::high_resolution_clock::now();
-    auto duration = std::chrono::duration_cast<std::chrono::seconds>(now - account.last_second_reset);
-    
-    if (duration.count() >= 1) {
-        account.orders_this_second = 0;
-        account.cancels_this_second = 0;
-        account.last_second_reset = now;
-    }
-}
-
-bool RiskManager::check_price_deviation(int64_t order_price, double max_deviation) const noexcept {
-    if (reference_price_ <= 0) return true; // No reference price set
-    
-    double deviation = std::abs(static_cast<double>(order_price - reference_price_)) / reference_price_;
-    return deviation <= max_deviation;
-}
-
-const char* RiskManager::risk_result_to_string(RiskCheckResult result) const noexcept {
-    switch (result) {
-        case RiskCheckResult::ACCEPTED: return "ACCEPTED";
-        case RiskCheckResult::REJECTED_POSITION_LIMIT: return "POSITION_LIMIT";
-        case RiskCheckResult::REJECTED_ORDER_SIZE: return "ORDER_SIZE";
-        case RiskCheckResult::REJECTED_ORDER_VALUE: return "ORDER_VALUE";
-        case RiskCheckResult::REJECTED_RATE_LIMIT: return "RATE_LIMIT";
-        case RiskCheckResult::REJECTED_EXPOSURE_LIMIT: return "EXPOSURE_LIMIT";
-        case RiskCheckResult::REJECTED_DAILY_VOLUME: return "DAILY_VOLUME";
-        case RiskCheckResult::REJECTED_PRICE_DEVIATION: return "PRICE_DEVIATION";
-        case RiskCheckResult::REJECTED_ACCOUNT_DISABLED: return "ACCOUNT_DISABLED";
-        case RiskCheckResult::REJECTED_UNKNOWN_ACCOUNT: return "UNKNOWN_ACCOUNT";
-        default: return "UNKNOWN";
-    }
+const std::string* RiskManager::account_name(AccountId account_id) const noexcept {
+    if (account_id == NO_ACCOUNT || account_id >= accounts_.size()) return nullptr;
+    return &names_[account_id];
 }
 
-} // namespace OrderBook
\ No newline at end of file
+} // namespace OrderBook
@@ -0,0 +1,142 @@
+#include "risk_stage.hpp"
+#include "tsc_clock.hpp"
+#include "numa_placement.hpp"
+#include <cstring>
+
+namespace OrderBook {
+
+const char* to_string(RiskTopology topology) noexcept {
+    switch (topology) {
+        case RiskTopology::INLINE: return "inline";
+        case RiskTopology::STAGED: return "staged";
+        default: return "unknown";
+    }
+}
+
+bool parse_risk_topology(const char* name, RiskTopology& topology) noexcept {
+    if (std::strcmp(name, "inline") == 0) {
+        topology = RiskTopology::INLINE;
+    } else if (std::strcmp(name, "staged") == 0) {
+        topology = RiskTopology::STAGED;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+RiskStage::RiskStage(RiskManager& risk, SPSCQueue<Command>& input, SPSCQueue<Command>& output,
+                     const WaitConfig& wait, uint64_t fill_capacity)
+    : risk_(risk), input_(input), output_(output), fills_(fill_capacity), wait_(wait),
+      running_(false), commands_consumed_(0), commands_forwarded_(0),
+      commands_rejected_(0), output_stalls_(0), fill_stalls_(0) {}
+
+RiskStage::~RiskStage() {
+    stop();
+}
+
+void RiskStage::start(int cpu) {
+    if (running_.exchange(true)) return;
+    stage_thread_ = std::thread([this, cpu] {
+        if (cpu >= 0) NumaPlacement::pin_current_thread(cpu);
+        run();
+    });
+}
+
+void RiskStage::stop() {
+    if (!running_.exchange(false)) return;
+    stage_thread_.join();
+}
+
+void RiskStage::run() noexcept {
+    WaitStrategy wait(wait_);
+    while (running_.load(std::memory_order_acquire)) {
+        if (process_burst() > 0) {
+            wait.reset();
+        } else {
+            wait.idle([this] { return input_.front() != nullptr; });
+        }
+    }
+
+    // Fills the engine emitted before it stopped still count towards positions
+    while (drain_fills() > 0) {}
+    risk_.publish_statistics();
+}
+
+size_t RiskStage::process_burst() noexcept {
+    drain_fills();
+
+    // Accepted commands are gathered and forwarded with one engine ring publication
+    Command accepted[ENGINE_BURST_SIZE];
+    size_t accepted_count = 0;
+    const size_t count = input_.consume_bulk(ENGINE_BURST_SIZE, [&](const Command& cmd) {
+        const uint64_t now = rdtsc();
+        if (cmd.producer_timestamp != 0 && cmd.producer_timestamp < now) {
+            queue_latency_.record(TscClock::to_ns(now - cmd.producer_timestamp));
+        }
+
+        if (risk_.check_command(cmd) == RiskCheckResult::ACCEPTED) {
+            accepted[accepted_count++] = cmd;
+        }
+    });
+    if (count == 0) return 0;
+
+    forward(accepted, accepted_count);
+    commands_rejected_ += count - accepted_count;
+    commands_forwarded_.store(commands_forwarded_.load(std::memory_order_relaxed) + accepted_count,
+                              std::memory_order_relaxed);
+    commands_consumed_.store(commands_consumed_.load(std::memory_order_relaxed) + count,
+                             std::memory_order_release);
+    risk_.publish_statistics();
+    return count;
+}
+
+void RiskStage::forward(const Command* commands, size_t count) noexcept {
+    size_t sent = output_.enqueue_bulk(std::span<const Command>(commands, count));
+    if (sent == count) return;
+
+    ++output_stalls_;
+    while (sent < count) {
+        // Engine ring full - keep taking fills so the engine can make progress
+        if (drain_fills() == 0) cpu_relax();
+        sent += output_.enqueue_bulk(std::span<const Command>(commands + sent, count - sent));
+    }
+}
+
+size_t RiskStage::drain_fills() noexcept {
+    return fills_.consume_bulk(RISK_FILL_RING_SIZE, [this](const FillUpdate& fill) {
+        risk_.on_fill(fill.account_id, fill.side, fill.quantity);
+    });
+}
+
+void RiskStage::publish_fill(AccountId account_id, Side side, uint64_t quantity) noexcept {
+    FillUpdate* slot = fills_.try_claim();
+    if (!slot) {
+        ++fill_stalls_;
+        while (!(slot = fills_.try_claim())) {
+            // Fill ring full - positions must not lose a fill, wait for the stage
+            std::this_thread::yield();
+        }
+    }
+    slot->account_id = account_id;
+    slot->side = side;
+    slot->quantity = quantity;
+    fills_.commit();
+}
+
+uint64_t RiskStage::commands_rejected() const noexcept {
+    return commands_rejected_;
+}
+
+uint64_t RiskStage::output_stalls() const noexcept {
+    return output_stalls_;
+}
+
+uint64_t RiskStage::fill_stalls() const noexcept {
+    return fill_stalls_;
+}
+
+const LatencyHistogram& RiskStage::queue_latency() const noexcept {
+    return queue_latency_;
+}
+
+} // namespace OrderBook
@@ -0,0 +1,184 @@
+#include "sharded_matching_engine.hpp"
+#include "numa_placement.hpp"
+#include <functional>
+
+namespace OrderBook {
+
+ShardedMatchingEngine::Shard::Shard(uint64_t ring_capacity, uint64_t max_orders, int shard_cpu, int shard_node)
+    : ring(ring_capacity), engine(&ring, max_orders), cpu(shard_cpu), node(shard_node) {}
+
+ShardedMatchingEngine::ShardedMatchingEngine(const ShardingConfig& config)
+    : next_shard_(0), running_(false),
+      commands_routed_(0), commands_unroutable_(0), router_stalls_(0) {
+
+    shards_.reserve(config.shard_count);
+    for (uint32_t i = 0; i < config.shard_count; ++i) {
+        const int cpu = (i < config.shard_cpus.size()) ? config.shard_cpus[i] : -1;
+        const int node = NumaPlacement::node_of_cpu(cpu);
+
+        // Ring, pool and order index are faulted in on the shard core's node
+        NumaPlacement::ScopedNodePreference prefer_node(node);
+        shards_.push_back(std::make_unique<Shard>(config.ring_capacity, config.orders_per_shard, cpu, node));
+    }
+}
+
+ShardedMatchingEngine::~ShardedMatchingEngine() {
+    stop();
+}
+
+uint32_t ShardedMatchingEngine::add_instrument(const Instrument& instrument) {
+    const uint32_t shard = add_instrument(instrument, next_shard_);
+    if (shard != NO_SHARD) next_shard_ = (next_shard_ + 1) % shard_count();
+    return shard;
+}
+
+uint32_t ShardedMatchingEngine::add_instrument(const Instrument& instrument, uint32_t shard) {
+    if (shard >= shard_count() || shard_of(instrument.instrument_id) != NO_SHARD) return NO_SHARD;
+
+    // The book lives with the shard that writes it
+    Shard& owner = *shards_[shard];
+    NumaPlacement::ScopedNodePreference prefer_node(owner.node);
+    if (!owner.engine.add_instrument(instrument)) return NO_SHARD;
+
+    if (instrument.instrument_id >= shard_of_.size()) {
+        shard_of_.resize(instrument.instrument_id + 1, NO_SHARD);
+    }
+    shard_of_[instrument.instrument_id] = shard;
+    symbols_.add(instrument);
+    return shard;
+}
+
+bool ShardedMatchingEngine::remove_instrument(uint32_t instrument_id) {
+    const uint32_t shard = shard_of(instrument_id);
+    if (shard == NO_SHARD) return false;
+
+    shard_of_[instrument_id] = NO_SHARD;
+    return shards_[shard]->engine.remove_instrument(instrument_id);
+}
+
+void ShardedMatchingEngine::set_output_stage(uint32_t shard, OutputStage* output) noexcept {
+    if (shard < shard_count()) shards_[shard]->engine.set_output_stage(output);
+}
+
+void ShardedMatchingEngine::enable_book_snapshots() {
+    for (auto& shard : shards_) {
+        shard->engine.enable_book_snapshots();
+    }
+}
+
+void ShardedMatchingEngine::start() {
+    if (running_.exchange(true)) return;
+    for (auto& shard : shards_) {
+        shard->thread = std::thread(&ShardedMatchingEngine::run_shard, this, std::ref(*shard));
+    }
+}
+
+void ShardedMatchingEngine::stop() {
+    if (!running_.exchange(false)) return;
+    for (auto& shard : shards_) {
+        shard->thread.join();
+    }
+}
+
+void ShardedMatchingEngine::run_shard(Shard& shard) noexcept {
+    if (shard.cpu >= 0) NumaPlacement::pin_current_thread(shard.cpu);
+
+    // Keep draining after stop() is requested until the ring is empty
+    while (true) {
+        const bool stopping = !running_.load(std::memory_order_acquire);
+        if (shard.engine.process_burst() == 0) {
+            if (stopping) break;
+            std::this_thread::yield();  // Idle shard - give the core back
+        }
+    }
+}
+
+bool ShardedMatchingEngine::route(const MultiInstrumentCommand& cmd) noexcept {
+    // Single-instrument feeds leave instrument_id unset - same default as the engine
+    const uint32_t instrument_id = cmd.instrument_id ? cmd.instrument_id : DEFAULT_INSTRUMENT_ID;
+    const uint32_t shard = shard_of(instrument_id);
+    if (shard == NO_SHARD) {
+        ++commands_unroutable_;
+        return false;
+    }
+
+    MultiInstrumentRingBuffer& ring = shards_[shard]->ring;
+    MultiInstrumentCommand* slot = ring.try_claim();
+    if (!slot) {
+        ++router_stalls_;
+        while (!(slot = ring.try_claim())) {
+            // Shard ring full - wait for that shard rather than drop the command
+            std::this_thread::yield();
+        }
+    }
+    *slot = cmd;
+    ring.commit();
+
+    ++commands_routed_;
+    return true;
+}
+
+uint32_t ShardedMatchingEngine::shard_of(uint32_t instrument_id) const noexcept {
+    return (instrument_id < shard_of_.size()) ? shard_of_[instrument_id] : NO_SHARD;
+}
+
+const BookSnapshot* ShardedMatchingEngine::book_snapshot(uint32_t instrument_id) const noexcept {
+    const uint32_t shard = shard_of(instrument_id);
+    return (shard != NO_SHARD) ? shards_[shard]->engine.book_snapshot(instrument_id) : nullptr;
+}
+
+uint32_t ShardedMatchingEngine::shard_count() const noexcept {
+    return static_cast<uint32_t>(shards_.size());
+}
+
+const MultiInstrumentEngine& ShardedMatchingEngine::shard(uint32_t index) const noexcept {
+    return shards_[index]->engine;
+}
+
+const SymbolTable& ShardedMatchingEngine::symbols() const noexcept {
+    return symbols_;
+}
+
+uint64_t ShardedMatchingEngine::orders_processed() const noexcept {
+    uint64_t total = 0;
+    for (const auto& shard : shards_) total += shard->engine.orders_processed();
+    return total;
+}
+
+uint64_t ShardedMatchingEngine::total_trades_executed() const noexcept {
+    uint64_t total = 0;
+    for (const auto& shard : shards_) total += shard->engine.total_trades_executed();
+    return total;
+}
+
+uint64_t ShardedMatchingEngine::orders_rejected() const noexcept {
+    uint64_t total = 0;
+    for (const auto& shard : shards_) total += shard->engine.orders_rejected();
+    return total;
+}
+
+LatencyHistogram ShardedMatchingEngine::queue_latency() const noexcept {
+    LatencyHistogram total;
+    for (const auto& shard : shards_) total.merge(shard->engine.queue_latency());
+    return total;
+}
+
+LatencyHistogram ShardedMatchingEngine::trade_latency() const noexcept {
+    LatencyHistogram total;
+    for (const auto& shard : shards_) total.merge(shard->engine.trade_latency());
+    return total;
+}
+
+uint64_t ShardedMatchingEngine::commands_routed() const noexcept {
+    return commands_routed_;
+}
+
+uint64_t ShardedMatchingEngine::commands_unroutable() const noexcept {
+    return commands_unroutable_;
+}
+
+uint64_t ShardedMatchingEngine::router_stalls() const noexcept {
+    return router_stalls_;
+}
+
+} // namespace OrderBook
@@ -0,0 +1,221 @@
+#include "shared_ring.hpp"
+#include <cerrno>
+#include <cstring>
+#include <new>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace OrderBook {
+
+namespace {
+
+constexpr char RING_MAGIC[8] = {'O', 'B', 'S', 'H', 'R', 'I', 'N', 'G'};
+constexpr uint32_t RING_VERSION = 1;
+
+std::string shm_path(const std::string& name) {
+    return (!name.empty() && name[0] == '/') ? name : "/" + name;
+}
+
+/**
+ * pid still names a process. A zombie counts as alive until reaped.
+ */
+bool process_alive(int32_t pid) noexcept {
+    return kill(pid, 0) == 0 || errno == EPERM;
+}
+
+size_t end_index(RingEnd end) noexcept {
+    return static_cast<size_t>(end);
+}
+
+} // namespace
+
+SharedRingSegment::SharedRingSegment(const std::string& name, RingEnd end, uint32_t record_size,
+                                     uint32_t slot_size, uint64_t capacity)
+    : name_(shm_path(name)), map_(nullptr), map_size_(0), inode_(0), end_(end), creator_(capacity > 0) {
+    const bool ok = creator_ ? create(record_size, slot_size, capacity) : attach(record_size, slot_size);
+    if (!ok && map_) {
+        munmap(map_, map_size_);
+        map_ = nullptr;
+    }
+}
+
+SharedRingSegment::~SharedRingSegment() {
+    if (!map_) return;
+
+    // Give the end back unless a restarted process already took it over
+    int32_t self = getpid();
+    header()->end_pids[end_index(end_)].compare_exchange_strong(self, 0, std::memory_order_acq_rel);
+
+    if (creator_) {
+        header()->state.store(SharedRingState::CLOSED, std::memory_order_release);
+
+        // Only unlink the name if it still refers to this segment, not a replacement
+        struct stat current;
+        const int fd = shm_open(name_.c_str(), O_RDONLY, 0);
+        if (fd >= 0) {
+            const bool same = fstat(fd, &current) == 0 && inode_ == current.st_ino;
+            ::close(fd);
+            if (same) shm_unlink(name_.c_str());
+        }
+    }
+    munmap(map_, map_size_);
+}
+
+bool SharedRingSegment::create(uint32_t record_size, uint32_t slot_size, uint64_t capacity) {
+    if ((capacity & (capacity - 1)) != 0) {
+        error_ = "capacity must be a power of 2";
+        return false;
+    }
+
+    // A segment left by an earlier run is closed first, so peers still mapping it notice
+    int fd = shm_open(name_.c_str(), O_RDWR, 0);
+    if (fd >= 0) {
+        struct stat st;
+        if (fstat(fd, &st) == 0 && static_cast<uint64_t>(st.st_size) >= sizeof(SharedRingHeader)) {
+            void* old = mmap(nullptr, sizeof(SharedRingHeader), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            if (old != MAP_FAILED) {
+                auto* old_header = static_cast<SharedRingHeader*>(old);
+                if (std::memcmp(old_header->magic, RING_MAGIC, sizeof(RING_MAGIC)) == 0) {
+                    old_header->state.store(SharedRingState::CLOSED, std::memory_order_release);
+                }
+                munmap(old, sizeof(SharedRingHeader));
+            }
+        }
+        ::close(fd);
+        shm_unlink(name_.c_str());
+    }
+
+    fd = shm_open(name_.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0) {
+        error_ = "shm_open " + name_ + ": " + std::strerror(errno);
+        return false;
+    }
+
+    // ftruncate zero-fills, so the header starts out INITIALIZING with no ends attached
+    const uint64_t bytes = SLOTS_OFFSET + capacity * slot_size;
+    struct stat st;
+    void* map = MAP_FAILED;
+    if (ftruncate(fd, static_cast<off_t>(bytes)) == 0 && fstat(fd, &st) == 0) {
+        map = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, 0);
+    }
+    ::close(fd);
+    if (map == MAP_FAILED) {
+        error_ = "map " + name_ + ": " + std::strerror(errno);
+        shm_unlink(name_.c_str());
+        return false;
+    }
+    map_ = static_cast<char*>(map);
+    map_size_ = bytes;
+    inode_ = st.st_ino;
+
+    SharedRingHeader* ring = new (map_) SharedRingHeader;
+    new (map_ + INDICES_OFFSET) SPSCQueueIndices;
+    std::memcpy(ring->magic, RING_MAGIC, sizeof(RING_MAGIC));
+    ring->version = RING_VERSION;
+    ring->record_size = record_size;
+    ring->slot_size = slot_size;
+    ring->capacity = capacity;
+    ring->segment_bytes = bytes;
+    ring->creator_pid = getpid();
+    if (!claim_end()) return false;
+
+    ring->state.store(SharedRingState::READY, std::memory_order_release);
+    return true;
+}
+
+bool SharedRingSegment::attach(uint32_t record_size, uint32_t slot_size) {
+    const int fd = shm_open(name_.c_str(), O_RDWR, 0);
+    if (fd < 0) {
+        error_ = "shm_open " + name_ + ": " + std::strerror(errno);
+        return false;
+    }
+
+    struct stat st;
+    void* map = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && static_cast<uint64_t>(st.st_size) >= SLOTS_OFFSET) {
+        map = mmap(nullptr, st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, 0);
+    }
+    ::close(fd);
+    if (map == MAP_FAILED) {
+        error_ = name_ + " is not a shared ring";
+        return false;
+    }
+    map_ = static_cast<char*>(map);
+    map_size_ = st.st_size;
+    inode_ = st.st_ino;
+
+    const SharedRingHeader* ring = header();
+    if (std::memcmp(ring->magic, RING_MAGIC, sizeof(RING_MAGIC)) != 0 || ring->version != RING_VERSION) {
+        error_ = name_ + " is not a version " + std::to_string(RING_VERSION) + " shared ring";
+        return false;
+    }
+    if (ring->state.load(std::memory_order_acquire) != SharedRingState::READY) {
+        error_ = name_ + " is not ready";
+        return false;
+    }
+    if (ring->record_size != record_size || ring->slot_size != slot_size) {
+        error_ = name_ + " holds " + std::to_string(ring->record_size) + "-byte records, expected " +
+                 std::to_string(record_size);
+        return false;
+    }
+    const uint64_t capacity = ring->capacity;
+    if (capacity == 0 || (capacity & (capacity - 1)) != 0 || ring->segment_bytes != map_size_ ||
+        SLOTS_OFFSET + capacity * slot_size != map_size_) {
+        error_ = name_ + " has an inconsistent layout";
+        return false;
+    }
+    return claim_end();
+}
+
+bool SharedRingSegment::claim_end() {
+    const int32_t self = getpid();
+    std::atomic<int32_t>& holder = header()->end_pids[end_index(end_)];
+
+    // Free, or held by a process that died without detaching
+    int32_t current = holder.load(std::memory_order_acquire);
+    while (true) {
+        if (current != 0 && (current == self || process_alive(current))) {
+            error_ = std::string(end_ == RingEnd::PRODUCER ? "producer" : "consumer") + " end of " + name_ +
+                     " is held by pid " + std::to_string(current);
+            return false;
+        }
+        if (holder.compare_exchange_weak(current, self, std::memory_order_acq_rel)) break;
+    }
+    header()->attach_counts[end_index(end_)].fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+SPSCQueueIndices* SharedRingSegment::indices() const noexcept {
+    return reinterpret_cast<SPSCQueueIndices*>(map_ + INDICES_OFFSET);
+}
+
+void* SharedRingSegment::slots() const noexcept {
+    return map_ + SLOTS_OFFSET;
+}
+
+uint64_t SharedRingSegment::capacity() const noexcept {
+    return header()->capacity;
+}
+
+bool SharedRingSegment::closed() const noexcept {
+    return header()->state.load(std::memory_order_acquire) != SharedRingState::READY;
+}
+
+bool SharedRingSegment::peer_attached() const noexcept {
+    const RingEnd peer = (end_ == RingEnd::PRODUCER) ? RingEnd::CONSUMER : RingEnd::PRODUCER;
+    const int32_t pid = header()->end_pids[end_index(peer)].load(std::memory_order_acquire);
+    return pid != 0 && process_alive(pid);
+}
+
+uint32_t SharedRingSegment::attach_count(RingEnd end) const noexcept {
+    return header()->attach_counts[end_index(end)].load(std::memory_order_relaxed);
+}
+
+bool SharedRingSegment::remove(const std::string& name) noexcept {
+    return shm_unlink(shm_path(name).c_str()) == 0;
+}
+
+} // namespace OrderBook
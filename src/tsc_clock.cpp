@@ -0,0 +1,51 @@
+#include "tsc_clock.hpp"
+
+namespace OrderBook {
+
+namespace {
+
+double measure_ns_per_tick() noexcept {
+    using namespace std::chrono;
+    
+    // Spin for the calibration window rather than sleeping so the
+    // measurement isn't skewed by scheduler wake-up latency
+    constexpr auto window = milliseconds(20);
+    
+    const auto wall_start = steady_clock::now();
+    const uint64_t tsc_start = rdtsc();
+    
+    auto wall_end = wall_start;
+    while (wall_end - wall_start < window) {
+        wall_end = steady_clock::now();
+    }
+    const uint64_t tsc_end = rdtsc();
+    
+    const double elapsed_ns = static_cast<double>(duration_cast<nanoseconds>(wall_end - wall_start).count());
+    const double elapsed_ticks = static_cast<double>(tsc_end - tsc_start);
+    return (elapsed_ticks > 0.0) ? elapsed_ns / elapsed_ticks : 1.0;
+}
+
+double calibrated_ns_per_tick() noexcept {
+    static const double value = measure_ns_per_tick();
+    return value;
+}
+
+} // namespace
+
+void TscClock::calibrate() noexcept {
+    calibrated_ns_per_tick();
+}
+
+int64_t TscClock::to_ns(uint64_t ticks) noexcept {
+    return static_cast<int64_t>(static_cast<double>(ticks) * calibrated_ns_per_tick());
+}
+
+double TscClock::ns_per_tick() noexcept {
+    return calibrated_ns_per_tick();
+}
+
+double TscClock::ticks_per_ns() noexcept {
+    return 1.0 / calibrated_ns_per_tick();
+}
+
+} // namespace OrderBook
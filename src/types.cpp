@@ -1,46 +1,58 @@
 #include "types.hpp"
+#include "order_pool.hpp"
 
 namespace OrderBook {
 
 Order::Order() noexcept 
-    : order_id(0), side(Side::BUY), order_type(OrderType::LIMIT), price(0), 
-      quantity(0), original_quantity(0), status(OrderStatus::PENDING),
-      next(nullptr), prev(nullptr) {}
+    : order_id(0), price(0), quantity(0), next(NULL_ORDER), prev(NULL_ORDER),
+      side(Side::BUY), order_type(OrderType::LIMIT), status(OrderStatus::PENDING) {}
+
+OrderInfo::OrderInfo() noexcept 
+    : original_quantity(0), timestamp(0), instrument_id(0), account_id(NO_ACCOUNT) {}
 
 PriceLevel::PriceLevel() noexcept 
-    : total_volume(0), head(nullptr), tail(nullptr) {}
+    : total_volume(0), head(NULL_ORDER), tail(NULL_ORDER), order_count(0) {}
 
-void PriceLevel::add_order(Order* order) noexcept {
-    if (!head) {
-        head = tail = order;
-        order->next = order->prev = nullptr;
+void PriceLevel::add_order(Order* order, OrderPool& pool) noexcept {
+    const OrderIndex index = pool.index_of(order);
+    
+    if (head == NULL_ORDER) {
+        head = tail = index;
+        order->next = order->prev = NULL_ORDER;
     } else {
-        tail->next = order;
+        pool.at(tail)->next = index;
         order->prev = tail;
-        order->next = nullptr;
-        tail = order;
+        order->next = NULL_ORDER;
+        tail = index;
     }
     total_volume += order->quantity;
+    ++order_count;
 }
 
-void PriceLevel::remove_order(Order* order) noexcept {
-    if (order->prev) {
-        order->prev->next = order->next;
+void PriceLevel::remove_order(Order* order, OrderPool& pool) noexcept {
+    if (order->prev != NULL_ORDER) {
+        pool.at(order->prev)->next = order->next;
     } else {
         head = order->next;
     }
     
-    if (order->next) {
-        order->next->prev = order->prev;
+    if (order->next != NULL_ORDER) {
+        pool.at(order->next)->prev = order->prev;
     } else {
         tail = order->prev;
     }
     
     total_volume -= order->quantity;
+    --order_count;
+}
+
+void PriceLevel::fill_order(Order* order, uint64_t quantity) noexcept {
+    order->quantity -= static_cast<uint32_t>(quantity);
+    total_volume -= quantity;
 }
 
 bool PriceLevel::empty() const noexcept { 
-    return head == nullptr; 
+    return head == NULL_ORDER; 
 }
 
-} // namespace OrderBook
\ No newline at end of file
+} // namespace OrderBook
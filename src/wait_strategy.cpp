@@ -0,0 +1,60 @@
+#include "wait_strategy.hpp"
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <climits>
+#include <cstring>
+#include <ctime>
+
+namespace OrderBook {
+
+namespace {
+
+timespec to_timespec(uint64_t ns) noexcept {
+    timespec ts;
+    ts.tv_sec = static_cast<time_t>(ns / 1'000'000'000);
+    ts.tv_nsec = static_cast<long>(ns % 1'000'000'000);
+    return ts;
+}
+
+} // namespace
+
+const char* to_string(WaitPolicy policy) noexcept {
+    switch (policy) {
+    case WaitPolicy::BUSY_SPIN:  return "spin";
+    case WaitPolicy::SPIN_PAUSE: return "pause";
+    case WaitPolicy::YIELD:      return "yield";
+    case WaitPolicy::SPIN_PARK:  return "park";
+    case WaitPolicy::TIMED_PARK: return "timed";
+    }
+    return "unknown";
+}
+
+bool parse_wait_policy(const char* name, WaitPolicy& policy) noexcept {
+    for (const WaitPolicy candidate : {WaitPolicy::BUSY_SPIN, WaitPolicy::SPIN_PAUSE, WaitPolicy::YIELD,
+                                       WaitPolicy::SPIN_PARK, WaitPolicy::TIMED_PARK}) {
+        if (std::strcmp(name, to_string(candidate)) == 0) {
+            policy = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+void Doorbell::sleep(uint32_t ticket, uint64_t timeout_ns) noexcept {
+    // Returns at once if a ring() already moved the epoch past our ticket
+    const timespec timeout = to_timespec(timeout_ns);
+    syscall(SYS_futex, &epoch_, FUTEX_WAIT_PRIVATE, ticket, &timeout, nullptr, 0);
+}
+
+void Doorbell::wake() noexcept {
+    epoch_.fetch_add(1, std::memory_order_seq_cst);
+    syscall(SYS_futex, &epoch_, FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+}
+
+void WaitStrategy::sleep_for_ns(uint64_t ns) noexcept {
+    const timespec duration = to_timespec(ns);
+    nanosleep(&duration, nullptr);
+}
+
+} // namespace OrderBook
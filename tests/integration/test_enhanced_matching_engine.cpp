@@ -0,0 +1,155 @@
+#include <gtest/gtest.h>
+#include "enhanced_matching_engine.hpp"
+#include "output_stage.hpp"
+#include "spsc_ring_buffer.hpp"
+#include <memory>
+#include <random>
+#include <vector>
+
+using namespace OrderBook;
+
+namespace {
+
+Command new_order(uint64_t id, Side side, int32_t price, uint32_t quantity, OrderType type = OrderType::LIMIT) {
+    Command cmd{};
+    cmd.type = CommandType::NEW;
+    cmd.order_type = type;
+    cmd.order_id = id;
+    cmd.side = side;
+    cmd.price = price;
+    cmd.quantity = quantity;
+    return cmd;
+}
+
+Command cancel(uint64_t id) {
+    Command cmd{};
+    cmd.type = CommandType::CANCEL;
+    cmd.order_id = id;
+    return cmd;
+}
+
+} // namespace
+
+class EnhancedMatchingEngineTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        ring_buffer = std::make_unique<SPSCRingBuffer>();
+        engine = std::make_unique<EnhancedMatchingEngine>(ring_buffer.get());
+    }
+
+    void run(const std::vector<Command>& commands) {
+        for (const Command& cmd : commands) ASSERT_TRUE(ring_buffer->enqueue(cmd));
+        engine->run(commands.size());
+    }
+
+    std::unique_ptr<SPSCRingBuffer> ring_buffer;
+    std::unique_ptr<EnhancedMatchingEngine> engine;
+};
+
+TEST_F(EnhancedMatchingEngineTest, LimitIocAndFokOutcomes) {
+    run({
+        new_order(1, Side::SELL, 5000, 100),
+        new_order(2, Side::SELL, 5001, 100),
+        new_order(3, Side::BUY, 5001, 150, OrderType::IOC),   // 150 traded over two levels
+        new_order(4, Side::BUY, 5001, 100, OrderType::FOK),   // Only 50 left - killed
+        new_order(5, Side::BUY, 5002, 50, OrderType::FOK),    // Exactly fillable
+        new_order(6, Side::BUY, 4990, 10, OrderType::IOC),    // Nothing to trade - cancelled
+        new_order(7, Side::BUY, 4995, 30),                    // Rests
+        cancel(7),
+    });
+
+    EXPECT_EQ(engine->trades_executed(), 3u);
+    EXPECT_EQ(engine->total_buy_quantity_matched(), 200u);
+    EXPECT_EQ(engine->create_level2_snapshot().asks.size(), 0u);
+    EXPECT_EQ(engine->create_level2_snapshot().bids.size(), 0u);
+
+    const auto& ioc = engine->get_order_type_stats(OrderType::IOC);
+    EXPECT_EQ(ioc.submitted, 2u);
+    EXPECT_EQ(ioc.filled, 1u);
+    EXPECT_EQ(ioc.cancelled, 1u);
+
+    const auto& fok = engine->get_order_type_stats(OrderType::FOK);
+    EXPECT_EQ(fok.submitted, 2u);
+    EXPECT_EQ(fok.filled, 1u);
+    EXPECT_EQ(fok.rejected, 1u);
+
+    const auto& limit = engine->get_order_type_stats(OrderType::LIMIT);
+    EXPECT_EQ(limit.submitted, 3u);
+    EXPECT_EQ(limit.cancelled, 1u);
+    EXPECT_EQ(engine->order_pool().allocated_count(), 0u);
+}
+
+TEST_F(EnhancedMatchingEngineTest, RejectsLimitRemainderOutsideTheLadder) {
+    run({
+        new_order(1, Side::BUY, static_cast<int32_t>(PRICE_MAX) + 1, 100),
+        new_order(2, Side::SELL, 5000, 40),
+        new_order(3, Side::BUY, static_cast<int32_t>(PRICE_MAX) + 1, 100),  // Takes the 40, can't rest 60
+    });
+
+    EXPECT_EQ(engine->trades_executed(), 1u);
+    EXPECT_EQ(engine->orders_rejected(), 2u);
+    EXPECT_EQ(engine->get_order_type_stats(OrderType::LIMIT).rejected, 2u);
+    EXPECT_EQ(engine->create_level2_snapshot().bids.size(), 0u);
+    EXPECT_EQ(engine->order_pool().allocated_count(), 0u);
+}
+
+TEST_F(EnhancedMatchingEngineTest, EveryPolicyMatchesIdentically) {
+    std::mt19937_64 rng(11);
+    std::vector<Command> commands;
+    for (uint64_t id = 1; id <= 20000; ++id) {
+        const Side side = (rng() & 1) ? Side::BUY : Side::SELL;
+        const OrderType type = static_cast<OrderType>(rng() % 3);
+        if (id > 10 && rng() % 4 == 0) {
+            commands.push_back(cancel(id - 1 - rng() % 10));
+        } else {
+            commands.push_back(new_order(id, side, 4990 + static_cast<int32_t>(rng() % 21),
+                                         1 + static_cast<uint32_t>(rng() % 200), type));
+        }
+    }
+
+    run(commands);
+    const uint64_t reference_trades = engine->trades_executed();
+    const Level2Snapshot reference_book = engine->create_level2_snapshot();
+    ASSERT_GT(reference_trades, 0u);
+
+    // Statistics and latency off, market data on through a silent output stage
+    OutputStage output(nullptr, 1 << 20);  // Not started - holds every event of the run
+    for (int variant = 0; variant < 2; ++variant) {
+        SetUp();
+        EnhancedMatchingEngine::MatchFeatures features;
+        features.order_statistics = false;
+        features.latency_capture = false;
+        engine->set_match_features(features);
+        if (variant == 1) engine->set_output_stage(&output);
+        run(commands);
+
+        EXPECT_EQ(engine->trades_executed(), reference_trades);
+        EXPECT_EQ(engine->total_buy_quantity_matched(), 0u);
+        EXPECT_EQ(engine->queue_latency().count(), 0u);
+        EXPECT_EQ(engine->trade_latency().count(), 0u);
+
+        const Level2Snapshot book = engine->create_level2_snapshot();
+        ASSERT_EQ(book.bids.size(), reference_book.bids.size());
+        ASSERT_EQ(book.asks.size(), reference_book.asks.size());
+        for (size_t i = 0; i < book.bids.size(); ++i) {
+            EXPECT_EQ(book.bids[i].price, reference_book.bids[i].price);
+            EXPECT_EQ(book.bids[i].quantity, reference_book.bids[i].quantity);
+        }
+    }
+    while (output.drain() > 0) {}
+    EXPECT_GT(output.events_published(), reference_trades);
+}
+
+TEST_F(EnhancedMatchingEngineTest, PublishesBookSnapshotAfterEachBurst) {
+    engine->enable_book_snapshot();
+    BookTop top;
+    ASSERT_TRUE(engine->book_snapshot().read_top(top));
+    EXPECT_EQ(top.bid_price, -1);
+
+    run({new_order(1, Side::BUY, 4999, 10), new_order(2, Side::SELL, 5003, 5),
+         new_order(3, Side::SELL, 5003, 5, OrderType::IOC)});
+    ASSERT_TRUE(engine->book_snapshot().read_top(top));
+    EXPECT_EQ(top.bid_price, 4999);
+    EXPECT_EQ(top.ask_price, 5003);
+    EXPECT_EQ(top.ask_quantity, 5u);
+}
@@ -1,5 +1,6 @@
 #include <gtest/gtest.h>
 #include "matching_engine.hpp"
+#include "tsc_clock.hpp"
 #include "spsc_ring_buffer.hpp"
 #include <thread>
 #include <chrono>
@@ -20,7 +21,7 @@ protected:
         cmd.side = side;
         cmd.price = price;
         cmd.quantity = quantity;
-        cmd.producer_timestamp = std::chrono::high_resolution_clock::now();
+        cmd.producer_timestamp = rdtsc();
         return cmd;
     }
 
@@ -28,7 +29,7 @@ protected:
         Command cmd;
         cmd.type = CommandType::CANCEL;
         cmd.order_id = id;
-        cmd.producer_timestamp = std::chrono::high_resolution_clock::now();
+        cmd.producer_timestamp = rdtsc();
         return cmd;
     }
 
@@ -129,4 +130,64 @@ TEST_F(MatchingEngineTest, NoMatchDifferentPrices) {
     // No match should occur
     // Would need full engine processing to verify
     EXPECT_EQ(engine->trades_executed(), 0);
-}
\ No newline at end of file
+}
+
+TEST_F(MatchingEngineTest, BurstProcessingMatchesAcrossLevels) {
+    // Resting asks on three levels, then one buy sweeping the first two
+    ring_buffer->enqueue(createOrder(1, Side::SELL, 5001, 100));
+    ring_buffer->enqueue(createOrder(2, Side::SELL, 5003, 100));
+    ring_buffer->enqueue(createOrder(3, Side::SELL, 5100, 100));
+    ring_buffer->enqueue(createOrder(4, Side::BUY, 5003, 250));
+    
+    EXPECT_EQ(engine->process_burst(), 4u);
+    EXPECT_EQ(engine->orders_processed(), 4u);
+    EXPECT_EQ(engine->trades_executed(), 2u);
+    EXPECT_EQ(engine->total_buy_quantity_matched(), 200u);
+    
+    // Remaining 50 rests at 5003 as the best bid; a sell at 5003 hits it
+    ring_buffer->enqueue(createOrder(5, Side::SELL, 5003, 50));
+    EXPECT_EQ(engine->process_burst(), 1u);
+    EXPECT_EQ(engine->trades_executed(), 3u);
+    EXPECT_EQ(engine->total_buy_quantity_matched(), engine->total_sell_quantity_matched());
+    
+    EXPECT_EQ(engine->process_burst(), 0u);
+}
+
+TEST_F(MatchingEngineTest, ExecutionReportsGoThroughOutputStage) {
+    OutputStage output(nullptr, 64);
+    engine->set_output_stage(&output);
+    
+    ring_buffer->enqueue(createOrder(1, Side::SELL, 5001, 100));  // Rest: 1 L2 update
+    ring_buffer->enqueue(createOrder(2, Side::BUY, 5001, 40));    // 1 trade + 1 L2 update
+    engine->process_burst();
+    
+    EXPECT_EQ(engine->trades_executed(), 1u);
+    EXPECT_EQ(output.drain(), 3u);
+}
+
+TEST_F(MatchingEngineTest, CancelsSparseSixtyFourBitIds) {
+    // Ids far beyond MAX_ORDERS used to be silently uncancellable
+    const uint64_t big_id = 0x0123'4567'89AB'CDEFull;
+    ring_buffer->enqueue(createOrder(big_id, Side::SELL, 5001, 100));
+    ring_buffer->enqueue(createOrder(MAX_ORDERS + 1, Side::SELL, 5002, 100));
+    ring_buffer->enqueue(createCancel(big_id));
+    ring_buffer->enqueue(createCancel(big_id));  // Second cancel is a no-op
+    
+    // Only the uncancelled ask at 5002 is left to trade against
+    ring_buffer->enqueue(createOrder(3, Side::BUY, 5002, 200));
+    engine->process_burst();
+    
+    EXPECT_EQ(engine->trades_executed(), 1u);
+    EXPECT_EQ(engine->total_buy_quantity_matched(), 100u);
+}
+
+TEST_F(MatchingEngineTest, RejectsPricesOutsideTheLadder) {
+    // Above PRICE_MAX: nothing to match, and no level to rest on
+    ring_buffer->enqueue(createOrder(1, Side::BUY, static_cast<int64_t>(PRICE_MAX) + 1, 100));
+    ring_buffer->enqueue(createOrder(2, Side::SELL, static_cast<int64_t>(PRICE_MAX) + 500, 100));
+    engine->process_burst();
+
+    EXPECT_EQ(engine->orders_rejected(), 2u);
+    EXPECT_EQ(engine->order_index().size(), 0u);
+    EXPECT_EQ(engine->order_pool().allocated_count(), 0u);
+}
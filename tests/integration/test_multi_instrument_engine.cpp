@@ -0,0 +1,223 @@
+#include <gtest/gtest.h>
+#include "multi_instrument_engine.hpp"
+#include <memory>
+
+using namespace OrderBook;
+
+class MultiInstrumentEngineTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        ring = std::make_unique<MultiInstrumentRingBuffer>(1024);
+        engine = std::make_unique<MultiInstrumentEngine>(ring.get(), 1024);
+        ASSERT_TRUE(engine->add_instrument(Instrument(DEFAULT_INSTRUMENT_ID, "DEF")));
+    }
+
+    static Command createCommand(CommandType type, uint64_t id, AccountId account, Side side,
+                                 int32_t price, uint32_t quantity) {
+        Command cmd{};
+        cmd.type = type;
+        cmd.order_type = OrderType::LIMIT;
+        cmd.instrument_id = DEFAULT_INSTRUMENT_ID;
+        cmd.order_id = id;
+        cmd.account_id = account;
+        cmd.side = side;
+        cmd.price = price;
+        cmd.quantity = quantity;
+        return cmd;
+    }
+
+    void submit(const Command& cmd) {
+        ASSERT_TRUE(ring->enqueue(cmd));
+    }
+
+    void process() {
+        while (engine->process_burst() > 0) {}
+    }
+
+    const Book& book() const {
+        return *engine->get_book(DEFAULT_INSTRUMENT_ID);
+    }
+
+    uint64_t head_order_id(int64_t price, Side side) const {
+        const PriceLevel* level = book().get_price_level(price, side);
+        if (!level || level->head == NULL_ORDER) return 0;
+        return engine->order_pool().at(level->head)->order_id;
+    }
+
+    std::unique_ptr<MultiInstrumentRingBuffer> ring;
+    std::unique_ptr<MultiInstrumentEngine> engine;
+};
+
+TEST_F(MultiInstrumentEngineTest, ReplaceKeepsPriorityOnlyWhenShrinking) {
+    submit(createCommand(CommandType::NEW, 1, 1, Side::SELL, 5000, 10));
+    submit(createCommand(CommandType::NEW, 2, 1, Side::SELL, 5000, 10));
+    submit(createCommand(CommandType::REPLACE, 1, 1, Side::SELL, 5000, 4));
+    process();
+    EXPECT_EQ(head_order_id(5000, Side::SELL), 1u);
+    EXPECT_EQ(book().get_price_level(5000, Side::SELL)->total_volume, 14u);
+
+    // Growing loses priority; another account cannot touch the order
+    submit(createCommand(CommandType::REPLACE, 1, 1, Side::SELL, 5000, 12));
+    submit(createCommand(CommandType::REPLACE, 2, 7, Side::SELL, 5000, 1));
+    process();
+    EXPECT_EQ(head_order_id(5000, Side::SELL), 2u);
+    EXPECT_EQ(book().get_price_level(5000, Side::SELL)->total_volume, 22u);
+
+    // Re-priced through the touch it trades like a new order
+    submit(createCommand(CommandType::NEW, 3, 2, Side::BUY, 4990, 5));
+    submit(createCommand(CommandType::REPLACE, 3, 2, Side::BUY, 5000, 5));
+    process();
+    EXPECT_EQ(engine->total_trades_executed(), 1u);
+    EXPECT_EQ(book().get_price_level(5000, Side::SELL)->total_volume, 17u);
+    EXPECT_EQ(book().best_bid(), -1);
+
+    // A replace must name the order's side - risk is checked on it
+    submit(createCommand(CommandType::REPLACE, 2, 1, Side::BUY, 5000, 1));
+    process();
+    EXPECT_EQ(book().get_price_level(5000, Side::SELL)->total_volume, 17u);
+
+    submit(createCommand(CommandType::REPLACE, 2, 1, Side::SELL, 5000, 0));
+    process();
+    EXPECT_EQ(head_order_id(5000, Side::SELL), 1u);
+    EXPECT_EQ(engine->orders_processed(), 9u);
+}
+
+TEST_F(MultiInstrumentEngineTest, MassCancelPullsOnlyTheAccount) {
+    submit(createCommand(CommandType::NEW, 1, 1, Side::BUY, 4999, 10));
+    submit(createCommand(CommandType::NEW, 2, 2, Side::BUY, 4998, 10));
+    submit(createCommand(CommandType::NEW, 3, 1, Side::BUY, 4998, 10));
+    submit(createCommand(CommandType::NEW, 4, 1, Side::SELL, 5001, 10));
+    submit(createCommand(CommandType::NEW, 5, 2, Side::SELL, 5003, 10));
+    submit(createCommand(CommandType::MASS_CANCEL, 0, 1, Side::BUY, 0, 0));
+    process();
+
+    EXPECT_EQ(book().best_bid(), 4998);
+    EXPECT_EQ(book().best_ask(), 5003);
+    EXPECT_EQ(book().get_price_level(4998, Side::BUY)->order_count, 1u);
+    EXPECT_EQ(head_order_id(4998, Side::BUY), 2u);
+    EXPECT_EQ(engine->order_pool().allocated_count(), 2u);
+
+    // Cancelled ids are gone from the index
+    submit(createCommand(CommandType::CANCEL, 1, 1, Side::BUY, 0, 0));
+    submit(createCommand(CommandType::CANCEL, 2, 2, Side::BUY, 0, 0));
+    process();
+    EXPECT_EQ(book().best_bid(), -1);
+    EXPECT_EQ(engine->order_pool().allocated_count(), 1u);
+}
+
+TEST_F(MultiInstrumentEngineTest, AccountsSharingAnOrderIdManageTheirOwn) {
+    submit(createCommand(CommandType::NEW, 7, 1, Side::BUY, 4999, 10));
+    submit(createCommand(CommandType::NEW, 7, 2, Side::BUY, 4998, 20));
+    process();
+
+    // Account 2 reaches its own order 7, not account 1's, which was indexed first
+    submit(createCommand(CommandType::REPLACE, 7, 2, Side::BUY, 4998, 5));
+    process();
+    EXPECT_EQ(book().get_price_level(4998, Side::BUY)->total_volume, 5u);
+    EXPECT_EQ(book().get_price_level(4999, Side::BUY)->total_volume, 10u);
+
+    submit(createCommand(CommandType::CANCEL, 7, 2, Side::BUY, 0, 0));
+    process();
+    EXPECT_EQ(book().get_price_level(4998, Side::BUY)->total_volume, 0u);
+    EXPECT_EQ(book().best_bid(), 4999);
+
+    submit(createCommand(CommandType::QUOTE_LEG, 7, 1, Side::BUY, 4999, 0));
+    process();
+    EXPECT_EQ(book().best_bid(), -1);
+    EXPECT_EQ(engine->order_pool().allocated_count(), 0u);
+}
+
+TEST_F(MultiInstrumentEngineTest, RejectsOrdersOffTheLaddersGrid) {
+    // Ticks of 10 counted from 1005: validation and the ladder agree 1400-1600 are off the grid
+    constexpr uint32_t OFF_GRID = 2;
+    ASSERT_TRUE(engine->add_instrument(Instrument(OFF_GRID, "X", 10, 1, 1005, 2005)));
+    Command sell = createCommand(CommandType::NEW, 1, 1, Side::SELL, 150, 10);
+    Command buy = createCommand(CommandType::NEW, 2, 1, Side::BUY, 160, 10);
+    Command leg = createCommand(CommandType::QUOTE_LEG, 3, 1, Side::BUY, 140, 10);
+    for (Command* cmd : {&sell, &buy, &leg}) {
+        cmd->instrument_id = OFF_GRID;
+        submit(*cmd);
+    }
+    process();
+
+    EXPECT_EQ(engine->orders_rejected(), 3u);
+    EXPECT_EQ(engine->total_trades_executed(), 0u);
+    EXPECT_EQ(engine->order_pool().allocated_count(), 0u);
+    EXPECT_EQ(engine->order_index().size(), 0u);
+}
+
+TEST_F(MultiInstrumentEngineTest, MassQuoteRequotesLevelsAsOneBatch) {
+    submit(createCommand(CommandType::NEW, 100, 2, Side::BUY, 4995, 10));
+    submit(createCommand(CommandType::MASS_QUOTE, 0, 1, Side::BUY, 0, 4));
+    submit(createCommand(CommandType::QUOTE_LEG, 1, 1, Side::BUY, 4999, 10));
+    submit(createCommand(CommandType::QUOTE_LEG, 2, 1, Side::BUY, 4998, 20));
+    submit(createCommand(CommandType::QUOTE_LEG, 3, 1, Side::SELL, 5001, 10));
+    submit(createCommand(CommandType::QUOTE_LEG, 4, 1, Side::SELL, 5002, 20));
+    process();
+    EXPECT_EQ(book().best_bid(), 4999);
+    EXPECT_EQ(book().best_ask(), 5001);
+    EXPECT_EQ(engine->total_trades_executed(), 0u);
+
+    // Shrink in place, pull the touch, move a level, and one leg that would cross
+    submit(createCommand(CommandType::MASS_QUOTE, 0, 1, Side::BUY, 0, 4));
+    submit(createCommand(CommandType::QUOTE_LEG, 2, 1, Side::BUY, 4998, 5));
+    submit(createCommand(CommandType::QUOTE_LEG, 1, 1, Side::BUY, 4999, 0));
+    submit(createCommand(CommandType::QUOTE_LEG, 3, 1, Side::SELL, 5003, 10));
+    submit(createCommand(CommandType::QUOTE_LEG, 4, 1, Side::SELL, 4995, 20));
+    submit(createCommand(CommandType::NEW, 101, 2, Side::BUY, 4998, 1));
+    process();
+
+    EXPECT_EQ(book().best_bid(), 4998);
+    EXPECT_EQ(book().best_ask(), 5003);
+    EXPECT_EQ(head_order_id(4998, Side::BUY), 2u);
+    EXPECT_EQ(book().get_price_level(4998, Side::BUY)->total_volume, 6u);
+    EXPECT_EQ(engine->total_trades_executed(), 0u);
+    EXPECT_EQ(engine->orders_rejected(), 1u);
+    EXPECT_EQ(engine->order_pool().allocated_count(), 4u);  // 100, 101, 2 and 3
+}
+
+TEST_F(MultiInstrumentEngineTest, LegsOutsideAMassQuoteApplyOnTheirOwn) {
+    submit(createCommand(CommandType::MASS_QUOTE, 0, 1, Side::BUY, 0, 2));
+    submit(createCommand(CommandType::QUOTE_LEG, 1, 1, Side::BUY, 4999, 10));
+    submit(createCommand(CommandType::NEW, 10, 2, Side::SELL, 5005, 10));  // Closes the batch early
+    submit(createCommand(CommandType::QUOTE_LEG, 2, 1, Side::SELL, 5001, 10));
+    process();
+
+    EXPECT_EQ(book().best_bid(), 4999);
+    EXPECT_EQ(book().best_ask(), 5001);
+
+    submit(createCommand(CommandType::QUOTE_LEG, 2, 1, Side::SELL, 5001, 0));
+    process();
+    EXPECT_EQ(book().best_ask(), 5005);
+}
+
+TEST_F(MultiInstrumentEngineTest, PublishesBookSnapshotsOncePerBurst) {
+    EXPECT_EQ(engine->book_snapshot(DEFAULT_INSTRUMENT_ID), nullptr);
+    engine->enable_book_snapshots();
+    const BookSnapshot* snapshot = engine->book_snapshot(DEFAULT_INSTRUMENT_ID);
+    ASSERT_NE(snapshot, nullptr);
+    EXPECT_EQ(engine->book_snapshot(99), nullptr);
+
+    submit(createCommand(CommandType::NEW, 1, 1, Side::BUY, 4999, 10));
+    submit(createCommand(CommandType::NEW, 2, 1, Side::SELL, 5001, 20));
+    submit(createCommand(CommandType::NEW, 3, 2, Side::BUY, 4998, 30));
+    EXPECT_EQ(engine->process_burst(), 3u);
+
+    BookTop top;
+    ASSERT_TRUE(snapshot->read_top(top));
+    EXPECT_EQ(top.bid_price, 4999);
+    EXPECT_EQ(top.ask_quantity, 20u);
+    EXPECT_EQ(snapshot->version(), 1u);
+
+    Level2Snapshot depth(0);
+    ASSERT_TRUE(snapshot->read(depth));
+    EXPECT_EQ(depth.instrument_id, DEFAULT_INSTRUMENT_ID);
+    EXPECT_EQ(depth.bids.size(), 2u);
+
+    // Removing the instrument publishes it empty
+    ASSERT_TRUE(engine->remove_instrument(DEFAULT_INSTRUMENT_ID));
+    engine->process_burst();
+    ASSERT_TRUE(snapshot->read_top(top));
+    EXPECT_EQ(top.bid_price, -1);
+    EXPECT_EQ(top.ask_price, -1);
+}
@@ -0,0 +1,132 @@
+#include <gtest/gtest.h>
+#include "sharded_matching_engine.hpp"
+#include "tsc_clock.hpp"
+
+using namespace OrderBook;
+
+class ShardedMatchingEngineTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        // Small pools and rings - four instruments over two shards
+        engine = std::make_unique<ShardedMatchingEngine>(ShardingConfig(2, {}, 1024, 1024));
+        for (uint32_t id = 1; id <= 4; ++id) {
+            shards.push_back(engine->add_instrument(Instrument(id, "SYM" + std::to_string(id))));
+        }
+    }
+
+    static Command createOrder(uint32_t instrument_id, uint64_t id, Side side, int32_t price, uint32_t quantity) {
+        Command cmd;
+        cmd.type = CommandType::NEW;
+        cmd.instrument_id = instrument_id;
+        cmd.order_id = id;
+        cmd.side = side;
+        cmd.order_type = OrderType::LIMIT;
+        cmd.price = price;
+        cmd.quantity = quantity;
+        cmd.producer_timestamp = rdtsc();
+        return cmd;
+    }
+
+    static Command createCancel(uint32_t instrument_id, uint64_t id) {
+        Command cmd = createOrder(instrument_id, id, Side::BUY, 0, 0);
+        cmd.type = CommandType::CANCEL;
+        return cmd;
+    }
+
+    std::unique_ptr<ShardedMatchingEngine> engine;
+    std::vector<uint32_t> shards;
+};
+
+TEST_F(ShardedMatchingEngineTest, AssignsInstrumentsRoundRobin) {
+    EXPECT_EQ(engine->shard_count(), 2u);
+    EXPECT_EQ(shards, (std::vector<uint32_t>{0, 1, 0, 1}));
+    EXPECT_EQ(engine->shard_of(3), 0u);
+    EXPECT_EQ(engine->shard_of(99), ShardedMatchingEngine::NO_SHARD);
+    EXPECT_EQ(engine->symbols().symbol(4), "SYM4");
+    
+    // Ids are unique across the whole engine; explicit placement is honoured
+    EXPECT_EQ(engine->add_instrument(Instrument(2, "DUP")), ShardedMatchingEngine::NO_SHARD);
+    EXPECT_EQ(engine->add_instrument(Instrument(5, "SYM5"), 1), 1u);
+    EXPECT_EQ(engine->add_instrument(Instrument(6, "SYM6"), 7), ShardedMatchingEngine::NO_SHARD);
+}
+
+TEST_F(ShardedMatchingEngineTest, EachShardMatchesOnlyItsInstruments) {
+    engine->start();
+    
+    // One crossing pair per instrument; the same order ids on every book
+    for (uint32_t id = 1; id <= 4; ++id) {
+        EXPECT_TRUE(engine->route(createOrder(id, 1, Side::SELL, 5000, 10 * id)));
+        EXPECT_TRUE(engine->route(createOrder(id, 2, Side::BUY, 5000, 10 * id)));
+    }
+    EXPECT_FALSE(engine->route(createOrder(99, 3, Side::BUY, 5000, 10)));  // No shard trades it
+    
+    engine->stop();
+    
+    EXPECT_EQ(engine->commands_routed(), 8u);
+    EXPECT_EQ(engine->commands_unroutable(), 1u);
+    EXPECT_EQ(engine->orders_processed(), 8u);
+    EXPECT_EQ(engine->total_trades_executed(), 4u);
+    
+    for (uint32_t id = 1; id <= 4; ++id) {
+        const MultiInstrumentEngine& owner = engine->shard(engine->shard_of(id));
+        const MultiInstrumentEngine& other = engine->shard(1 - engine->shard_of(id));
+        EXPECT_EQ(owner.trades_for_instrument(id), 1u);
+        EXPECT_EQ(owner.volume_for_instrument(id), 10u * id);
+        EXPECT_EQ(other.get_book(id), nullptr);
+    }
+    EXPECT_EQ(engine->shard(0).orders_processed(), 4u);
+    EXPECT_EQ(engine->shard(1).orders_processed(), 4u);
+}
+
+TEST_F(ShardedMatchingEngineTest, CancelFollowsItsOrderToTheShard) {
+    engine->start();
+    
+    engine->route(createOrder(2, 7, Side::SELL, 5000, 100));
+    engine->route(createCancel(2, 7));
+    engine->route(createOrder(2, 8, Side::BUY, 5000, 100));  // Nothing left to hit
+    
+    engine->stop();
+    
+    EXPECT_EQ(engine->total_trades_executed(), 0u);
+    const Book* book = engine->shard(engine->shard_of(2)).get_book(2);
+    ASSERT_NE(book, nullptr);
+    EXPECT_EQ(book->best_ask(), -1);
+    EXPECT_EQ(book->best_bid(), 5000);
+}
+
+TEST_F(ShardedMatchingEngineTest, StopDrainsFullRings) {
+    engine->start();
+    
+    // Far more than a 1024-slot ring holds, all on one instrument
+    const uint64_t count = 20000;
+    for (uint64_t i = 0; i < count; ++i) {
+        engine->route(createOrder(1, i + 1, (i % 2) ? Side::BUY : Side::SELL, 5000, 1));
+    }
+    engine->stop();
+    
+    EXPECT_EQ(engine->orders_processed(), count);
+    EXPECT_EQ(engine->total_trades_executed(), count / 2);
+}
+
+TEST_F(ShardedMatchingEngineTest, InstrumentsChangeWhileRunning) {
+    engine->start();
+    
+    engine->route(createOrder(3, 1, Side::SELL, 5000, 10));
+    engine->route(createOrder(3, 2, Side::BUY, 4000, 10));
+    
+    // Retiring a book hands its resting orders back to the shard's pool
+    EXPECT_TRUE(engine->remove_instrument(3));
+    EXPECT_FALSE(engine->remove_instrument(3));
+    EXPECT_FALSE(engine->route(createOrder(3, 3, Side::BUY, 5000, 10)));
+    
+    EXPECT_EQ(engine->add_instrument(Instrument(7, "SYM7"), 0), 0u);
+    engine->route(createOrder(7, 1, Side::SELL, 5000, 10));
+    engine->route(createOrder(7, 2, Side::BUY, 5000, 10));
+    
+    engine->stop();
+    
+    const MultiInstrumentEngine& shard = engine->shard(0);
+    EXPECT_EQ(shard.get_book(3), nullptr);
+    EXPECT_EQ(shard.trades_for_instrument(7), 1u);
+    EXPECT_EQ(shard.order_pool().allocated_count(), 0u);
+}
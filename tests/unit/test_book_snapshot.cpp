@@ -0,0 +1,109 @@
+#include <gtest/gtest.h>
+#include "book_snapshot.hpp"
+#include "book.hpp"
+#include <atomic>
+#include <memory>
+#include <thread>
+
+using namespace OrderBook;
+
+namespace {
+
+void add_order(OrderPool& pool, Book& book, uint64_t id, Side side, int64_t price, uint32_t quantity) {
+    Order* order = pool.allocate();
+    order->order_id = id;
+    order->side = side;
+    order->price = price;
+    order->quantity = quantity;
+    book.add_order(order);
+}
+
+} // namespace
+
+TEST(BookSnapshotTest, PublishesTopAndDepthFromTheBook) {
+    auto snapshot = std::make_unique<BookSnapshot>();
+    Level2Snapshot depth(0);
+    BookTop top;
+    EXPECT_FALSE(snapshot->read(depth));
+    EXPECT_FALSE(snapshot->read_top(top));
+
+    OrderPool pool(64);
+    Book book(pool);
+    add_order(pool, book, 1, Side::BUY, 4999, 10);
+    add_order(pool, book, 2, Side::BUY, 4999, 15);
+    add_order(pool, book, 3, Side::BUY, 4990, 5);
+    add_order(pool, book, 4, Side::SELL, 5002, 7);
+    snapshot->publish(book, 42);
+
+    ASSERT_TRUE(snapshot->read(depth));
+    EXPECT_EQ(depth.instrument_id, 42u);
+    ASSERT_EQ(depth.bids.size(), 2u);
+    EXPECT_EQ(depth.bids[0].price, 4999);
+    EXPECT_EQ(depth.bids[0].quantity, 25u);
+    EXPECT_EQ(depth.bids[0].order_count, 2u);
+    EXPECT_EQ(depth.bids[1].price, 4990);
+    ASSERT_EQ(depth.asks.size(), 1u);
+
+    ASSERT_TRUE(snapshot->read_top(top));
+    EXPECT_EQ(top.bid_price, 4999);
+    EXPECT_EQ(top.bid_quantity, 25u);
+    EXPECT_EQ(top.ask_price, 5002);
+    EXPECT_EQ(top.ask_quantity, 7u);
+    EXPECT_EQ(snapshot->version(), 1u);
+
+    // Depth is capped at MARKET_DEPTH_LEVELS, an empty side reads as -1
+    for (uint64_t i = 0; i < MARKET_DEPTH_LEVELS + 5; ++i) {
+        add_order(pool, book, 10 + i, Side::SELL, 5010 + static_cast<int64_t>(i), 1);
+    }
+    Book empty(pool);
+    snapshot->publish(book, 42);
+    ASSERT_TRUE(snapshot->read(depth));
+    EXPECT_EQ(depth.asks.size(), MARKET_DEPTH_LEVELS);
+    snapshot->publish(empty, 42);
+    ASSERT_TRUE(snapshot->read_top(top));
+    EXPECT_EQ(top.bid_price, -1);
+    EXPECT_EQ(top.ask_price, -1);
+}
+
+TEST(BookSnapshotTest, ReadersNeverSeeATornPublication) {
+    auto snapshot = std::make_unique<BookSnapshot>();
+    std::atomic<bool> done{false};
+    constexpr uint64_t PUBLICATIONS = 100'000;
+
+    // Every level of publication n carries quantity n, so a mix of two is detectable
+    std::thread writer([&] {
+        for (uint64_t n = 1; n <= PUBLICATIONS; ++n) {
+            Level2Snapshot depth(7);
+            for (uint32_t level = 0; level < MARKET_DEPTH_LEVELS; ++level) {
+                depth.bids.emplace_back(5000 - level, n, 1);
+                depth.asks.emplace_back(5001 + level, n, 1);
+            }
+            snapshot->publish(depth);
+        }
+        done.store(true, std::memory_order_release);
+    });
+
+    uint64_t reads = 0;
+    uint64_t last = 0;
+    while (!done.load(std::memory_order_acquire)) {
+        Level2Snapshot depth(0);
+        if (!snapshot->read(depth)) continue;
+        ++reads;
+        ASSERT_EQ(depth.bids.size(), MARKET_DEPTH_LEVELS);
+        const uint64_t n = depth.bids[0].quantity;
+        for (uint32_t level = 0; level < MARKET_DEPTH_LEVELS; ++level) {
+            ASSERT_EQ(depth.bids[level].quantity, n);
+            ASSERT_EQ(depth.asks[level].quantity, n);
+        }
+        EXPECT_GE(n, last);  // Publications are never seen going backwards
+        last = n;
+
+        BookTop top;
+        ASSERT_TRUE(snapshot->read_top(top));
+        EXPECT_EQ(top.bid_quantity, top.ask_quantity);
+    }
+    writer.join();
+
+    EXPECT_GT(reads, 0u);
+    EXPECT_EQ(snapshot->version(), PUBLICATIONS);
+}
@@ -0,0 +1,119 @@
+#include <gtest/gtest.h>
+#include "command_journal.hpp"
+#include "market_data_journal.hpp"
+#include <cstdio>
+#include <vector>
+
+using namespace OrderBook;
+
+class CommandJournalTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        base = ::testing::TempDir() + "cmd_journal_" +
+               ::testing::UnitTest::GetInstance()->current_test_info()->name();
+    }
+
+    void TearDown() override {
+        for (uint64_t i = 0; i < 16; ++i) {
+            std::remove(CommandJournal::segment_path(base, i).c_str());
+        }
+    }
+
+    static Command makeOrder(uint64_t id) {
+        Command cmd{};
+        cmd.type = CommandType::NEW;
+        cmd.order_id = id;
+        cmd.side = (id & 1) ? Side::SELL : Side::BUY;
+        cmd.price = static_cast<int32_t>(5000 + id % 10);
+        cmd.quantity = static_cast<uint32_t>(id * 3);
+        return cmd;
+    }
+
+    std::vector<CommandJournalRecord> readAll() {
+        std::vector<CommandJournalRecord> records;
+        CommandJournalReader reader(base);
+        CommandJournalRecord record;
+        while (reader.next(record)) records.push_back(record);
+        return records;
+    }
+
+    std::string base;
+};
+
+TEST_F(CommandJournalTest, WriteAndReadBack) {
+    {
+        CommandJournal journal(base);
+        ASSERT_TRUE(journal.is_open());
+        for (uint64_t i = 1; i <= 100; ++i) journal.append({i, makeOrder(i)});
+        EXPECT_EQ(journal.records_written(), 100u);
+        EXPECT_EQ(journal.last_sequence(), 100u);
+    }
+
+    const auto records = readAll();
+    ASSERT_EQ(records.size(), 100u);
+    for (uint64_t i = 0; i < records.size(); ++i) {
+        EXPECT_EQ(records[i].sequence, i + 1);
+        EXPECT_EQ(records[i].command.order_id, i + 1);
+        EXPECT_EQ(records[i].command.price, makeOrder(i + 1).price);
+        EXPECT_EQ(records[i].command.side, makeOrder(i + 1).side);
+    }
+}
+
+TEST_F(CommandJournalTest, RollsOverBySizeAndStopsAtUnwrittenTail) {
+    // Room for 10 records per segment after the header
+    const uint64_t segment_bytes = sizeof(JournalSegmentHeader) + 10 * sizeof(CommandJournalRecord);
+    CommandJournal journal(base, segment_bytes);
+    for (uint64_t i = 1; i <= 25; ++i) journal.append({i, makeOrder(i)});
+    EXPECT_EQ(journal.segment_count(), 3u);
+
+    // Still open, as after a crash: the zero-filled tail of the last segment ends the journal
+    const auto records = readAll();
+    ASSERT_EQ(records.size(), 25u);
+    EXPECT_EQ(records.back().sequence, 25u);
+}
+
+TEST_F(CommandJournalTest, StageWritesEverythingBeforeStopReturns) {
+    constexpr uint64_t count = 20000;
+    {
+        // Small ring so the engine side has to wait for the writer
+        JournalStage stage(base, 64);
+        ASSERT_TRUE(stage.is_open());
+        stage.start();
+        for (uint64_t i = 1; i <= count; ++i) stage.record(i, makeOrder(i));
+        EXPECT_EQ(stage.recorded_sequence(), count);
+        stage.stop();
+        EXPECT_EQ(stage.journaled_sequence(), count);
+    }
+
+    const auto records = readAll();
+    ASSERT_EQ(records.size(), count);
+    for (uint64_t i = 0; i < count; ++i) {
+        ASSERT_EQ(records[i].sequence, i + 1);
+        ASSERT_EQ(records[i].command.order_id, i + 1);
+    }
+}
+
+TEST_F(CommandJournalTest, MissingJournalReadsEmpty) {
+    EXPECT_TRUE(readAll().empty());
+}
+
+TEST_F(CommandJournalTest, SkipToJumpsAcrossSegments) {
+    const uint64_t segment_bytes = sizeof(JournalSegmentHeader) + 10 * sizeof(CommandJournalRecord);
+    {
+        CommandJournal journal(base, segment_bytes);
+        for (uint64_t i = 1; i <= 35; ++i) journal.append({i, makeOrder(i)});
+    }
+
+    for (uint64_t target : {1, 7, 10, 11, 23, 35}) {
+        CommandJournalReader reader(base);
+        reader.skip_to(target);
+        CommandJournalRecord record;
+        ASSERT_TRUE(reader.next(record));
+        EXPECT_EQ(record.sequence, target);
+    }
+
+    CommandJournalReader past_end(base);
+    past_end.skip_to(36);
+    CommandJournalRecord record;
+    EXPECT_FALSE(past_end.next(record));
+}
@@ -0,0 +1,56 @@
+#include <gtest/gtest.h>
+#include "cumulative_depth.hpp"
+#include <random>
+#include <vector>
+
+using namespace OrderBook;
+
+TEST(CumulativeDepthTest, PrefixAndRangeSums) {
+    CumulativeDepth depth(100);
+    depth.add(0, 5);
+    depth.add(10, 7);
+    depth.add(99, 11);
+
+    EXPECT_EQ(depth.prefix(0), 0u);
+    EXPECT_EQ(depth.prefix(1), 5u);
+    EXPECT_EQ(depth.prefix(11), 12u);
+    EXPECT_EQ(depth.prefix(100), 23u);
+    EXPECT_EQ(depth.prefix(1000), 23u);   // Clamped to the size
+    EXPECT_EQ(depth.range(1, 99), 7u);
+    EXPECT_EQ(depth.range(50, 10), 0u);
+
+    depth.subtract(10, 3);
+    EXPECT_EQ(depth.range(10, 11), 4u);
+}
+
+TEST(CumulativeDepthTest, MatchesNaiveSumsAndRebuild) {
+    constexpr uint64_t SIZE = 1000;
+    CumulativeDepth depth(SIZE);
+    std::vector<uint64_t> volume(SIZE, 0);
+    std::mt19937_64 rng(7);
+
+    for (int i = 0; i < 20000; ++i) {
+        const uint64_t slot = rng() % SIZE;
+        const uint64_t quantity = rng() % 100;
+        if ((rng() & 1) && volume[slot] >= quantity) {
+            depth.subtract(slot, quantity);
+            volume[slot] -= quantity;
+        } else {
+            depth.add(slot, quantity);
+            volume[slot] += quantity;
+        }
+    }
+
+    CumulativeDepth rebuilt(SIZE);
+    rebuilt.rebuild([&volume](uint64_t slot) { return volume[slot]; });
+
+    uint64_t sum = 0;
+    for (uint64_t count = 0; count <= SIZE; ++count) {
+        EXPECT_EQ(depth.prefix(count), sum);
+        EXPECT_EQ(rebuilt.prefix(count), sum);
+        if (count < SIZE) sum += volume[count];
+    }
+
+    depth.reset();
+    EXPECT_EQ(depth.prefix(SIZE), 0u);
+}
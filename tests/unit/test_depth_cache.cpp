@@ -0,0 +1,92 @@
+#include <gtest/gtest.h>
+#include "depth_cache.hpp"
+#include "book.hpp"
+#include <vector>
+
+using namespace OrderBook;
+
+class DepthCacheTest : public ::testing::Test {
+protected:
+    Order* addOrder(uint64_t id, Side side, int64_t price, uint64_t quantity) {
+        Order* order = pool.allocate();
+        order->order_id = id;
+        order->side = side;
+        order->price = price;
+        order->quantity = quantity;
+        book.add_order(order);
+        depth.on_level_change(side, price);
+        return order;
+    }
+
+    void removeOrder(Order* order) {
+        book.remove_order(order);
+        depth.on_level_change(order->side, order->price);
+    }
+
+    OrderPool pool{64};
+    Book book{pool};
+    DepthCache depth{book};
+};
+
+TEST_F(DepthCacheTest, KeepsLevelsSortedFromTheTouch) {
+    addOrder(1, Side::BUY, 5000, 100);
+    addOrder(2, Side::BUY, 5002, 100);
+    addOrder(3, Side::BUY, 5001, 100);
+    addOrder(4, Side::SELL, 5010, 100);
+    addOrder(5, Side::SELL, 5005, 100);
+
+    ASSERT_EQ(depth.bids().size(), 3u);
+    EXPECT_EQ(depth.bids()[0].price, 5002);
+    EXPECT_EQ(depth.bids()[2].price, 5000);
+    ASSERT_EQ(depth.asks().size(), 2u);
+    EXPECT_EQ(depth.asks()[0].price, 5005);
+}
+
+TEST_F(DepthCacheTest, UpdatesLevelInPlace) {
+    addOrder(1, Side::SELL, 5005, 100);
+    addOrder(2, Side::SELL, 5005, 50);
+
+    ASSERT_EQ(depth.asks().size(), 1u);
+    EXPECT_EQ(depth.asks()[0].quantity, 150u);
+    EXPECT_EQ(depth.asks()[0].order_count, 2u);
+}
+
+TEST_F(DepthCacheTest, DeeperLevelsAreInvisibleUntilPulledIn) {
+    Order* head = addOrder(1, Side::BUY, 5000, 10);
+    for (uint32_t i = 1; i < MARKET_DEPTH_LEVELS; ++i) {
+        addOrder(i + 1, Side::BUY, 5000 - i, 10);
+    }
+
+    // A level below the cached depth does not change it
+    addOrder(100, Side::BUY, 4000, 10);
+    EXPECT_FALSE(depth.on_level_change(Side::BUY, 4000));
+    EXPECT_EQ(depth.bids().size(), MARKET_DEPTH_LEVELS);
+    EXPECT_EQ(depth.bids().back().price, 5000 - static_cast<int64_t>(MARKET_DEPTH_LEVELS) + 1);
+
+    // Emptying the best level shifts everything up and refills from the book
+    removeOrder(head);
+    EXPECT_EQ(depth.bids().front().price, 4999);
+    EXPECT_EQ(depth.bids().back().price, 4000);
+}
+
+TEST_F(DepthCacheTest, BetterLevelPushesOutTheWorst) {
+    for (uint32_t i = 0; i < MARKET_DEPTH_LEVELS; ++i) {
+        addOrder(i + 1, Side::SELL, 5000 + i, 10);
+    }
+    addOrder(100, Side::SELL, 4990, 10);
+
+    EXPECT_EQ(depth.asks().size(), MARKET_DEPTH_LEVELS);
+    EXPECT_EQ(depth.asks().front().price, 4990);
+    EXPECT_EQ(depth.asks().back().price, 5000 + static_cast<int64_t>(MARKET_DEPTH_LEVELS) - 2);
+}
+
+TEST_F(DepthCacheTest, SnapshotCopiesCachedDepth) {
+    addOrder(1, Side::BUY, 5000, 100);
+    addOrder(2, Side::SELL, 5001, 70);
+
+    Level2Snapshot snapshot(1);
+    depth.copy_into(snapshot);
+    ASSERT_EQ(snapshot.bids.size(), 1u);
+    ASSERT_EQ(snapshot.asks.size(), 1u);
+    EXPECT_EQ(snapshot.asks[0].quantity, 70u);
+}
@@ -0,0 +1,126 @@
+#include <gtest/gtest.h>
+#include "depth_profile.hpp"
+#include "book_snapshot.hpp"
+#include <vector>
+
+using namespace OrderBook;
+
+class DepthProfileTest : public ::testing::Test {
+protected:
+    /**
+     * Bids 5000, 4999, ... and asks 5001, 5002, ..., level i holding (i + 1) * 10 in i + 1 orders
+     */
+    static Level2Snapshot ladder(size_t bid_levels, size_t ask_levels) {
+        Level2Snapshot snapshot(7);
+        for (size_t i = 0; i < bid_levels; ++i) {
+            snapshot.bids.emplace_back(5000 - static_cast<int64_t>(i), (i + 1) * 10, static_cast<uint32_t>(i + 1));
+        }
+        for (size_t i = 0; i < ask_levels; ++i) {
+            snapshot.asks.emplace_back(5001 + static_cast<int64_t>(i), (i + 1) * 10, static_cast<uint32_t>(i + 1));
+        }
+        return snapshot;
+    }
+
+    static std::vector<DepthKernel> kernels() {
+        std::vector<DepthKernel> available{DepthKernel::SCALAR};
+        if (DepthProfile::best_kernel() == DepthKernel::AVX2) available.push_back(DepthKernel::AVX2);
+        return available;
+    }
+};
+
+TEST_F(DepthProfileTest, TransposesDepthIntoColumns) {
+    for (DepthKernel kernel : kernels()) {
+        DepthProfile profile(kernel);
+        profile.load(ladder(3, MARKET_DEPTH_LEVELS));
+        EXPECT_EQ(profile.instrument_id(), 7u);
+
+        const DepthColumns& bids = profile.side(Side::BUY);
+        ASSERT_EQ(bids.count, 3u);
+        EXPECT_EQ(bids.prices[0], 5000);
+        EXPECT_EQ(bids.prices[2], 4998);
+        EXPECT_EQ(bids.quantities[1], 20u);
+        EXPECT_EQ(bids.order_counts[2], 3u);
+        EXPECT_EQ(bids.cumulative_quantity[2], 60u);
+        EXPECT_DOUBLE_EQ(bids.cumulative_notional[1], 5000.0 * 10 + 4999.0 * 20);
+
+        // Past the last level: zero columns, totals carried through
+        EXPECT_EQ(bids.quantities[3], 0u);
+        EXPECT_EQ(bids.order_counts[DEPTH_PROFILE_CAPACITY - 1], 0u);
+        EXPECT_EQ(bids.cumulative_quantity[DEPTH_PROFILE_CAPACITY - 1], 60u);
+        EXPECT_EQ(profile.side(Side::SELL).count, MARKET_DEPTH_LEVELS);
+    }
+}
+
+TEST_F(DepthProfileTest, KernelsAgree) {
+    if (kernels().size() < 2) GTEST_SKIP() << "No AVX2 on this CPU";
+
+    DepthProfile scalar(DepthKernel::SCALAR);
+    DepthProfile avx2(DepthKernel::AVX2);
+    for (size_t levels = 0; levels <= MARKET_DEPTH_LEVELS; ++levels) {
+        const Level2Snapshot snapshot = ladder(levels, MARKET_DEPTH_LEVELS - levels);
+        scalar.load(snapshot);
+        avx2.load(snapshot);
+        for (Side side : {Side::BUY, Side::SELL}) {
+            EXPECT_EQ(scalar.side(side).cumulative_quantity, avx2.side(side).cumulative_quantity);
+            EXPECT_EQ(scalar.side(side).cumulative_notional, avx2.side(side).cumulative_notional);
+            for (uint64_t quantity = 0; quantity <= 2200; quantity += 7) {
+                EXPECT_EQ(scalar.levels_to_fill(side, quantity), avx2.levels_to_fill(side, quantity));
+            }
+        }
+        EXPECT_EQ(scalar.imbalance(5), avx2.imbalance(5));
+    }
+}
+
+TEST_F(DepthProfileTest, SweepAnalytics) {
+    for (DepthKernel kernel : kernels()) {
+        DepthProfile profile(kernel);
+        profile.load(ladder(4, 2));  // Bids 10 20 30 40, asks 10 20
+
+        EXPECT_EQ(profile.volume(Side::BUY), 100u);
+        EXPECT_EQ(profile.volume(Side::BUY, 2), 30u);
+        EXPECT_EQ(profile.volume(Side::SELL, 0), 0u);
+
+        EXPECT_EQ(profile.levels_to_fill(Side::BUY, 10), 1u);
+        EXPECT_EQ(profile.levels_to_fill(Side::BUY, 11), 2u);
+        EXPECT_EQ(profile.levels_to_fill(Side::BUY, 100), 4u);
+        EXPECT_EQ(profile.levels_to_fill(Side::BUY, 101), 0u);
+        EXPECT_EQ(profile.levels_to_fill(Side::SELL, 0), 0u);
+
+        // A buyer of 25 takes 10 @ 5001 and 15 @ 5002
+        double price = 0.0;
+        ASSERT_TRUE(profile.vwap(Side::SELL, 25, price));
+        EXPECT_DOUBLE_EQ(price, (10 * 5001.0 + 15 * 5002.0) / 25);
+        ASSERT_TRUE(profile.vwap(Side::BUY, 5, price));
+        EXPECT_DOUBLE_EQ(price, 5000.0);
+        EXPECT_FALSE(profile.vwap(Side::SELL, 31, price));
+
+        EXPECT_DOUBLE_EQ(profile.imbalance(2), 0.0);
+        EXPECT_DOUBLE_EQ(profile.imbalance(), (100.0 - 30.0) / 130.0);
+    }
+}
+
+TEST_F(DepthProfileTest, EmptyBook) {
+    DepthProfile profile;
+    profile.load(Level2Snapshot(1));
+    double price = 0.0;
+    EXPECT_EQ(profile.volume(Side::BUY), 0u);
+    EXPECT_EQ(profile.levels_to_fill(Side::SELL, 1), 0u);
+    EXPECT_FALSE(profile.vwap(Side::BUY, 1, price));
+    EXPECT_DOUBLE_EQ(profile.imbalance(), 0.0);
+}
+
+TEST_F(DepthProfileTest, RefreshesOnlyOnNewPublications) {
+    BookSnapshot published;
+    DepthProfile profile;
+    EXPECT_FALSE(profile.refresh(published));  // Nothing published yet
+
+    published.publish(ladder(2, 2));
+    EXPECT_TRUE(profile.refresh(published));
+    EXPECT_EQ(profile.volume(Side::SELL), 30u);
+    EXPECT_FALSE(profile.refresh(published));
+
+    published.publish(ladder(3, 1));
+    EXPECT_TRUE(profile.refresh(published));
+    EXPECT_EQ(profile.volume(Side::BUY), 60u);
+    EXPECT_EQ(profile.volume(Side::SELL), 10u);
+}
@@ -0,0 +1,142 @@
+#include <gtest/gtest.h>
+#include "engine_snapshot.hpp"
+#include "order_pool.hpp"
+#include "order_id_index.hpp"
+#include "book.hpp"
+#include <cstdio>
+#include <vector>
+
+using namespace OrderBook;
+
+class EngineSnapshotTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        path = ::testing::TempDir() + "engine_snapshot_" +
+               ::testing::UnitTest::GetInstance()->current_test_info()->name();
+    }
+
+    void TearDown() override {
+        std::remove(path.c_str());
+        std::remove((path + ".tmp").c_str());
+    }
+
+    static Order* rest(OrderPool& pool, Book& book, OrderIdIndex& index, uint64_t id, Side side,
+                       int64_t price, uint64_t quantity) {
+        Order* order = pool.allocate();
+        order->order_id = id;
+        order->side = side;
+        order->price = price;
+        order->quantity = quantity;
+        book.add_order(order);
+        index.insert(id, pool.index_of(order));
+        return order;
+    }
+
+    std::string path;
+};
+
+TEST_F(EngineSnapshotTest, UncommittedSnapshotLeavesNothingBehind) {
+    {
+        SnapshotWriter out(path);
+        out.put(uint64_t{42});
+    }
+    SnapshotReader in(path);
+    EXPECT_FALSE(in.ok());
+}
+
+TEST_F(EngineSnapshotTest, TruncatedSnapshotFailsToRead) {
+    {
+        SnapshotWriter out(path);
+        out.put(uint32_t{7});
+        ASSERT_TRUE(out.commit());
+    }
+    SnapshotReader in(path);
+    uint32_t small = 0;
+    uint64_t large = 0;
+    EXPECT_TRUE(in.get(small));
+    EXPECT_EQ(small, 7u);
+    EXPECT_TRUE(in.at_end());
+    EXPECT_FALSE(in.get(large));
+    EXPECT_FALSE(in.ok());
+}
+
+TEST_F(EngineSnapshotTest, BookIndexAndPoolRoundTrip) {
+    // Window of 64 ticks, so the far bid lands in the overflow store
+    const LadderConfig config(0, 10000, 1, 64);
+    OrderPool pool(1000);
+    Book book(pool, config);
+    OrderIdIndex index(pool, pool.max_capacity());
+
+    rest(pool, book, index, 1, Side::BUY, 5000, 100);
+    rest(pool, book, index, 2, Side::BUY, 5000, 50);
+    rest(pool, book, index, 3, Side::BUY, 100, 10);
+    Order* gone = rest(pool, book, index, 4, Side::SELL, 5010, 70);
+    rest(pool, book, index, 5, Side::SELL, 5011, 30);
+    book.remove_order(gone);
+    index.erase(4);
+    pool.free(gone);
+    ASSERT_EQ(book.bid_ladder().overflow_levels(), 1u);
+
+    {
+        SnapshotWriter out(path);
+        pool.save(out);
+        index.save(out);
+        book.save(out);
+        ASSERT_TRUE(out.commit());
+    }
+
+    OrderPool restored_pool(1000);
+    Book restored_book(restored_pool, config);
+    OrderIdIndex restored_index(restored_pool, restored_pool.max_capacity());
+    {
+        SnapshotReader in(path);
+        ASSERT_TRUE(restored_pool.load(in));
+        ASSERT_TRUE(restored_index.load(in));
+        ASSERT_TRUE(restored_book.load(in));
+        EXPECT_TRUE(in.at_end());
+    }
+
+    EXPECT_EQ(restored_pool.allocated_count(), 4u);
+    EXPECT_EQ(restored_index.size(), 4u);
+    EXPECT_EQ(restored_book.best_bid(), 5000);
+    EXPECT_EQ(restored_book.best_ask(), 5011);
+    EXPECT_EQ(restored_book.next_bid_price(5000), 100);
+    EXPECT_EQ(restored_book.bid_ladder().overflow_levels(), 1u);
+
+    const PriceLevel* level = restored_book.get_price_level(5000, Side::BUY);
+    ASSERT_NE(level, nullptr);
+    EXPECT_EQ(level->total_volume, 150u);
+    EXPECT_EQ(level->order_count, 2u);
+    EXPECT_EQ(restored_pool.at(level->head)->order_id, 1u);
+    EXPECT_EQ(restored_pool.at(level->tail)->order_id, 2u);
+
+    const OrderIndex found = restored_index.find(2);
+    ASSERT_NE(found, NULL_ORDER);
+    EXPECT_EQ(restored_pool.at(found)->quantity, 50u);
+    EXPECT_EQ(restored_index.find(4), NULL_ORDER);
+
+    // The free list came across too: both pools hand out the same slots next
+    EXPECT_EQ(restored_pool.index_of(restored_pool.allocate()), pool.index_of(pool.allocate()));
+}
+
+TEST_F(EngineSnapshotTest, LoadRejectsDifferentGeometry) {
+    OrderPool pool(1000);
+    Book book(pool, LadderConfig(0, 10000, 1, 64));
+    {
+        SnapshotWriter out(path);
+        pool.save(out);
+        book.save(out);
+        ASSERT_TRUE(out.commit());
+    }
+
+    SnapshotReader in(path);
+    OrderPool smaller_pool(500);
+    EXPECT_FALSE(smaller_pool.load(in));
+
+    SnapshotReader again(path);
+    OrderPool same_pool(1000);
+    Book wider_book(same_pool, LadderConfig(0, 20000, 1, 64));
+    ASSERT_TRUE(same_pool.load(again));
+    EXPECT_FALSE(wider_book.load(again));
+    EXPECT_EQ(wider_book.best_bid(), -1);
+}
@@ -0,0 +1,108 @@
+#include <gtest/gtest.h>
+#include "feed_capture.hpp"
+#include "feed_handler.hpp"
+#include "spsc_queue.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+using namespace OrderBook;
+
+class FeedCaptureTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        path = ::testing::TempDir() + "feed_capture_" +
+               ::testing::UnitTest::GetInstance()->current_test_info()->name();
+    }
+
+    void TearDown() override {
+        std::remove(path.c_str());
+        std::remove((path + ".other").c_str());
+    }
+
+    std::string path;
+};
+
+TEST_F(FeedCaptureTest, WriteAndReadBack) {
+    {
+        FeedCaptureWriter writer(path, 9);
+        for (uint64_t i = 1; i <= 50; ++i) {
+            Command cmd{};
+            cmd.type = (i % 5 == 0) ? CommandType::CANCEL : CommandType::NEW;
+            cmd.order_id = i;
+            cmd.price = static_cast<int32_t>(5000 + i);
+            cmd.quantity = static_cast<uint32_t>(i);
+            writer.append(cmd, (i == 30) ? 0 : i * 1000);  // Out-of-order offset is clamped
+        }
+        ASSERT_TRUE(writer.finish());
+    }
+
+    FeedCapture capture(path);
+    ASSERT_TRUE(capture.is_open());
+    ASSERT_EQ(capture.size(), 50u);
+    EXPECT_EQ(capture.seed(), 9u);
+    EXPECT_EQ(capture.duration_ns(), 50000u);
+    EXPECT_EQ(capture[0].order_id, 1u);
+    EXPECT_EQ(capture[4].type, CommandType::CANCEL);
+    EXPECT_EQ(capture[49].price, 5050);
+    EXPECT_EQ(capture[29].producer_timestamp, 29000u);
+}
+
+TEST_F(FeedCaptureTest, FixedSeedReproducesTheFlow) {
+    ASSERT_TRUE(FeedHandler::record(path, 10000, 42));
+    ASSERT_TRUE(FeedHandler::record(path + ".other", 10000, 42));
+    {
+        FeedCapture first(path);
+        FeedCapture second(path + ".other");
+        ASSERT_EQ(first.size(), 10000u);
+        ASSERT_EQ(second.size(), 10000u);
+        EXPECT_EQ(std::memcmp(first.commands(), second.commands(), 10000 * sizeof(Command)), 0);
+    }
+
+    ASSERT_TRUE(FeedHandler::record(path + ".other", 10000, 43));
+    FeedCapture first(path);
+    FeedCapture different(path + ".other");
+    EXPECT_NE(std::memcmp(first.commands(), different.commands(), 10000 * sizeof(Command)), 0);
+}
+
+TEST_F(FeedCaptureTest, ReplayPushesEveryCommandInOrder) {
+    ASSERT_TRUE(FeedHandler::record(path, 500, 7));
+    FeedCapture capture(path);
+    SPSCQueue<Command> ring(1024);
+
+    EXPECT_EQ(FeedHandler::replay(&ring, capture), 500u);
+
+    uint64_t index = 0;
+    Command cmd;
+    while (ring.dequeue(cmd)) {
+        ASSERT_LT(index, capture.size());
+        EXPECT_EQ(cmd.order_id, capture[index].order_id);
+        EXPECT_EQ(cmd.type, capture[index].type);
+        EXPECT_EQ(cmd.price, capture[index].price);
+        ++index;
+    }
+    EXPECT_EQ(index, 500u);
+}
+
+TEST_F(FeedCaptureTest, RecordedPacingHoldsCommandsToTheirOffsets) {
+    // 21 commands at 1000/s span 20 ms
+    ASSERT_TRUE(FeedHandler::record(path, 21, 7, 1000));
+    FeedCapture capture(path);
+    ASSERT_EQ(capture.duration_ns(), 20'000'000u);
+    SPSCQueue<Command> ring(64);
+
+    const auto start = std::chrono::steady_clock::now();
+    FeedHandler::replay(&ring, capture, ReplayPacing::RECORDED);
+    EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(19));
+}
+
+TEST_F(FeedCaptureTest, MissingOrForeignFileDoesNotOpen) {
+    EXPECT_FALSE(FeedCapture(path).is_open());
+
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    ASSERT_NE(file, nullptr);
+    const char junk[128] = "not a capture";
+    std::fwrite(junk, sizeof(junk), 1, file);
+    std::fclose(file);
+    EXPECT_FALSE(FeedCapture(path).is_open());
+}
@@ -0,0 +1,39 @@
+#include <gtest/gtest.h>
+#include "huge_page_region.hpp"
+
+using namespace OrderBook;
+
+TEST(HugePageRegionTest, ReservesWholePagesWithoutCommitting) {
+    HugePageRegion region(100);
+    
+    ASSERT_NE(region.data(), nullptr);
+    EXPECT_EQ(region.reserved_bytes(), region.page_size());
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(region.data()) % region.page_size(), 0u);  // hugetlbfs alignment
+    EXPECT_EQ(region.committed_bytes(), 0u);
+    EXPECT_EQ(region.backing(), PageBacking::NONE);
+}
+
+TEST(HugePageRegionTest, CommitsInPlaceAndZeroFills) {
+    HugePageRegion region(3 * (2ull << 20));
+    ASSERT_NE(region.data(), nullptr);
+    char* base = region.data();
+    
+    ASSERT_TRUE(region.commit(1000));
+    EXPECT_EQ(region.committed_bytes(), region.page_size());
+    EXPECT_NE(region.backing(), PageBacking::NONE);
+    base[999] = 42;
+    
+    // Growing keeps the base address and what was already written
+    ASSERT_TRUE(region.commit(region.page_size() + 1));
+    EXPECT_EQ(region.data(), base);
+    EXPECT_EQ(region.committed_bytes(), 2 * region.page_size());
+    EXPECT_EQ(base[999], 42);
+    EXPECT_EQ(base[region.page_size()], 0);
+}
+
+TEST(HugePageRegionTest, RefusesCommitPastReservation) {
+    HugePageRegion region(1);
+    
+    EXPECT_FALSE(region.commit(region.reserved_bytes() + 1));
+    EXPECT_TRUE(region.commit(region.reserved_bytes()));
+}
@@ -0,0 +1,117 @@
+#include <gtest/gtest.h>
+#include "ingress_fan_in.hpp"
+#include "matching_engine.hpp"
+#include <thread>
+#include <utility>
+#include <vector>
+
+using namespace OrderBook;
+
+class IngressFanInTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        ingress = std::make_unique<IngressFanIn>(3, 64, 2);
+    }
+
+    void fill(uint32_t lane, uint64_t first_id, uint64_t count) {
+        for (uint64_t id = first_id; id < first_id + count; ++id) {
+            Command cmd{};
+            cmd.type = CommandType::NEW;
+            cmd.order_id = id;
+            ASSERT_TRUE(ingress->lane(lane).enqueue(cmd));
+        }
+    }
+
+    // (lane, order id) in consumption order
+    std::vector<std::pair<uint32_t, uint64_t>> drain(size_t max) {
+        std::vector<std::pair<uint32_t, uint64_t>> seen;
+        ingress->consume_bulk(max, [&](const Command& cmd, const IngressStamp& stamp) {
+            EXPECT_EQ(stamp.sequence, ingress->last_sequence());
+            seen.emplace_back(stamp.lane, cmd.order_id);
+        });
+        return seen;
+    }
+
+    std::unique_ptr<IngressFanIn> ingress;
+};
+
+TEST_F(IngressFanInTest, DrainsLanesRoundRobinByQuantum) {
+    fill(0, 100, 5);
+    fill(1, 200, 1);
+    fill(2, 300, 3);
+
+    const std::vector<std::pair<uint32_t, uint64_t>> expected = {
+        {0, 100}, {0, 101}, {1, 200}, {2, 300}, {2, 301},  // First pass, two per lane
+        {0, 102}, {0, 103}, {2, 302},                      // Lane 1 is dry
+        {0, 104}
+    };
+    EXPECT_EQ(drain(100), expected);
+    EXPECT_EQ(ingress->last_sequence(), 9u);
+    EXPECT_TRUE(drain(100).empty());
+}
+
+TEST_F(IngressFanInTest, StartingLaneRotatesAndBurstIsBounded) {
+    fill(0, 100, 4);
+    fill(1, 200, 4);
+    fill(2, 300, 4);
+
+    // Second call starts with lane 1, third with lane 2
+    EXPECT_EQ(drain(3), (std::vector<std::pair<uint32_t, uint64_t>>{{0, 100}, {0, 101}, {1, 200}}));
+    EXPECT_EQ(drain(3), (std::vector<std::pair<uint32_t, uint64_t>>{{1, 201}, {1, 202}, {2, 300}}));
+    EXPECT_EQ(drain(3), (std::vector<std::pair<uint32_t, uint64_t>>{{2, 301}, {2, 302}, {0, 102}}));
+    EXPECT_EQ(ingress->last_sequence(), 9u);
+}
+
+TEST_F(IngressFanInTest, ConcurrentGatewaysKeepPerLaneOrder) {
+    constexpr uint64_t per_lane = 50000;
+    std::vector<std::thread> gateways;
+    for (uint32_t lane = 0; lane < ingress->lane_count(); ++lane) {
+        gateways.emplace_back([this, lane] {
+            for (uint64_t i = 0; i < per_lane; ++i) {
+                Command* slot;
+                while (!(slot = ingress->lane(lane).try_claim())) std::this_thread::yield();
+                slot->order_id = i;
+                slot->instrument_id = lane;
+                ingress->lane(lane).commit();
+            }
+        });
+    }
+
+    std::vector<uint64_t> next_id(ingress->lane_count(), 0);
+    uint64_t sequenced = 0;
+    while (sequenced < per_lane * ingress->lane_count()) {
+        const size_t taken = ingress->consume_bulk(ENGINE_BURST_SIZE, [&](const Command& cmd, const IngressStamp& stamp) {
+            EXPECT_EQ(stamp.sequence, ++sequenced);
+            EXPECT_EQ(stamp.lane, cmd.instrument_id);
+            EXPECT_EQ(cmd.order_id, next_id[stamp.lane]++);
+        });
+        if (taken == 0) std::this_thread::yield();
+    }
+    for (std::thread& gateway : gateways) gateway.join();
+    EXPECT_EQ(ingress->last_sequence(), per_lane * ingress->lane_count());
+}
+
+TEST_F(IngressFanInTest, EngineMatchesAcrossGateways) {
+    MatchingEngine engine(ingress.get());
+
+    Command sell{};
+    sell.type = CommandType::NEW;
+    sell.order_id = 1;
+    sell.side = Side::SELL;
+    sell.order_type = OrderType::LIMIT;
+    sell.price = 5000;
+    sell.quantity = 100;
+    Command buy = sell;
+    buy.order_id = 2;
+    buy.side = Side::BUY;
+
+    // Resting order from one gateway, aggressor from another
+    ASSERT_TRUE(ingress->lane(2).enqueue(sell));
+    ASSERT_EQ(engine.process_burst(), 1u);
+    ASSERT_TRUE(ingress->lane(0).enqueue(buy));
+    EXPECT_EQ(engine.process_burst(), 1u);
+
+    EXPECT_EQ(engine.trades_executed(), 1u);
+    EXPECT_EQ(engine.total_buy_quantity_matched(), 100u);
+    EXPECT_EQ(ingress->last_sequence(), 2u);
+}
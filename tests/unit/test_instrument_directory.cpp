@@ -0,0 +1,121 @@
+#include <gtest/gtest.h>
+#include "instrument_directory.hpp"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace OrderBook;
+
+class InstrumentDirectoryTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        pool = std::make_unique<OrderPool>(1024);
+        directory = std::make_unique<InstrumentDirectory>(*pool, 8);
+    }
+
+    void refresh() {
+        directory->refresh([this](InstrumentDirectory::Entry& entry) { drained.push_back(entry.instrument.instrument_id); });
+    }
+
+    std::unique_ptr<OrderPool> pool;
+    std::unique_ptr<InstrumentDirectory> directory;
+    std::vector<uint32_t> drained;
+};
+
+TEST_F(InstrumentDirectoryTest, EntriesAreCacheLineAligned) {
+    EXPECT_EQ(alignof(InstrumentDirectory::Entry), CACHE_LINE_SIZE);
+    EXPECT_EQ(sizeof(InstrumentDirectory::Entry) % CACHE_LINE_SIZE, 0u);
+
+    ASSERT_TRUE(directory->add(Instrument(3, "AAA")));
+    ASSERT_TRUE(directory->add(Instrument(700, "BBB")));
+    refresh();
+
+    // Compact slots regardless of how sparse the ids are
+    const auto* first = directory->find(3);
+    const auto* second = directory->find(700);
+    ASSERT_NE(first, nullptr);
+    ASSERT_NE(second, nullptr);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(first) % CACHE_LINE_SIZE, 0u);
+    EXPECT_EQ(second - first, 1);
+}
+
+TEST_F(InstrumentDirectoryTest, MatchingSideSeesChangesOnRefresh) {
+    ASSERT_TRUE(directory->add(Instrument(1, "AAA")));
+    EXPECT_FALSE(directory->add(Instrument(1, "DUP")));
+    EXPECT_EQ(directory->size(), 1u);
+    EXPECT_EQ(directory->epoch(), 1u);
+
+    // Published, but the matching side still holds the empty snapshot
+    EXPECT_NE(directory->lookup(1), nullptr);
+    EXPECT_EQ(directory->find(1), nullptr);
+
+    refresh();
+    EXPECT_EQ(directory->current_epoch(), 1u);
+    ASSERT_NE(directory->find(1), nullptr);
+    EXPECT_EQ(directory->find(1)->instrument.symbol, "AAA");
+    EXPECT_EQ(directory->find(2), nullptr);
+}
+
+TEST_F(InstrumentDirectoryTest, RemovedEntryIsDrainedThenReused) {
+    ASSERT_TRUE(directory->add(Instrument(1, "AAA")));
+    ASSERT_TRUE(directory->add(Instrument(2, "BBB")));
+    refresh();
+    InstrumentDirectory::Entry* removed = directory->find(1);
+
+    ASSERT_TRUE(directory->remove(1));
+    EXPECT_FALSE(directory->remove(1));
+    EXPECT_EQ(directory->lookup(1), nullptr);
+    EXPECT_TRUE(drained.empty());  // Matching side may still be using it
+
+    refresh();
+    EXPECT_EQ(drained, std::vector<uint32_t>{1});
+    EXPECT_EQ(directory->find(1), nullptr);
+
+    // Drained slot is handed out again
+    ASSERT_TRUE(directory->add(Instrument(9, "CCC")));
+    refresh();
+    EXPECT_EQ(directory->find(9), removed);
+    EXPECT_EQ(drained.size(), 1u);
+}
+
+TEST_F(InstrumentDirectoryTest, RejectsAddWhenFull) {
+    for (uint32_t id = 1; id <= directory->capacity(); ++id) {
+        ASSERT_TRUE(directory->add(Instrument(id, "SYM")));
+    }
+    EXPECT_FALSE(directory->add(Instrument(100, "FULL")));
+
+    ASSERT_TRUE(directory->remove(1));
+    EXPECT_FALSE(directory->add(Instrument(100, "FULL")));  // Slot not drained yet
+    refresh();
+    EXPECT_TRUE(directory->add(Instrument(100, "FULL")));
+}
+
+TEST_F(InstrumentDirectoryTest, ChangesWhileMatchingThreadRuns) {
+    std::atomic<bool> running{true};
+    std::atomic<uint64_t> drains{0};
+
+    std::thread matching([&] {
+        while (running.load(std::memory_order_acquire)) {
+            directory->refresh([&](InstrumentDirectory::Entry&) { drains.fetch_add(1); });
+            for (uint32_t id = 1; id <= 4; ++id) {
+                if (InstrumentDirectory::Entry* entry = directory->find(id)) {
+                    ++entry->trades;  // Touch it as the match loop would
+                }
+            }
+        }
+        directory->refresh([&](InstrumentDirectory::Entry&) { drains.fetch_add(1); });
+    });
+
+    for (int round = 0; round < 2000; ++round) {
+        const uint32_t id = 1 + round % 4;
+        while (!directory->add(Instrument(id, "SYM"))) {
+            std::this_thread::yield();  // Every slot waiting to be drained
+        }
+        EXPECT_TRUE(directory->remove(id));
+    }
+    running.store(false, std::memory_order_release);
+    matching.join();
+
+    EXPECT_EQ(drains.load(), 2000u);
+    EXPECT_EQ(directory->size(), 0u);
+}
@@ -0,0 +1,82 @@
+#include <gtest/gtest.h>
+#include "latency_histogram.hpp"
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using namespace OrderBook;
+
+TEST(LatencyHistogramTest, EmptyReportsZero) {
+    LatencyHistogram histogram;
+    EXPECT_TRUE(histogram.empty());
+    EXPECT_EQ(histogram.percentile(50.0), 0u);
+    EXPECT_EQ(histogram.min(), 0u);
+    EXPECT_EQ(histogram.max(), 0u);
+    EXPECT_EQ(histogram.mean(), 0.0);
+}
+
+TEST(LatencyHistogramTest, SmallValuesAreExact) {
+    LatencyHistogram histogram;
+    for (uint64_t value = 1; value <= 100; ++value) histogram.record(value);
+
+    EXPECT_EQ(histogram.count(), 100u);
+    EXPECT_EQ(histogram.min(), 1u);
+    EXPECT_EQ(histogram.max(), 100u);
+    EXPECT_EQ(histogram.percentile(50.0), 50u);
+    EXPECT_EQ(histogram.percentile(99.0), 99u);
+    EXPECT_EQ(histogram.percentile(100.0), 100u);
+    EXPECT_DOUBLE_EQ(histogram.mean(), 50.5);
+}
+
+TEST(LatencyHistogramTest, BucketsTileTheRange) {
+    // Every bucket starts right after the previous one ends
+    for (size_t bucket = 1; bucket < LatencyHistogram::BUCKET_COUNT; ++bucket) {
+        ASSERT_EQ(LatencyHistogram::lowest_in_bucket(bucket),
+                  LatencyHistogram::highest_in_bucket(bucket - 1) + 1) << "bucket " << bucket;
+    }
+    EXPECT_EQ(LatencyHistogram::highest_in_bucket(LatencyHistogram::BUCKET_COUNT - 1), LatencyHistogram::MAX_VALUE);
+
+    for (uint64_t value : {uint64_t{0}, uint64_t{127}, uint64_t{128}, uint64_t{1000}, uint64_t{123456789},
+                           LatencyHistogram::MAX_VALUE}) {
+        const size_t bucket = LatencyHistogram::bucket_of(value);
+        EXPECT_LE(LatencyHistogram::lowest_in_bucket(bucket), value);
+        EXPECT_GE(LatencyHistogram::highest_in_bucket(bucket), value);
+    }
+}
+
+TEST(LatencyHistogramTest, PercentilesWithinBucketPrecision) {
+    LatencyHistogram histogram;
+    std::mt19937_64 rng(7);
+    std::vector<uint64_t> samples;
+    for (int i = 0; i < 100000; ++i) {
+        const uint64_t value = 100 + rng() % 1'000'000;
+        samples.push_back(value);
+        histogram.record(value);
+    }
+    std::sort(samples.begin(), samples.end());
+
+    for (double p : {50.0, 90.0, 99.0, 99.9}) {
+        const uint64_t exact = samples[static_cast<size_t>(p / 100.0 * samples.size()) - 1];
+        const uint64_t reported = histogram.percentile(p);
+        EXPECT_GE(reported, exact);
+        EXPECT_LE(reported, exact + exact / 64 + 1) << "P" << p;
+    }
+}
+
+TEST(LatencyHistogramTest, ClampsAndMerges) {
+    LatencyHistogram a;
+    LatencyHistogram b;
+    a.record(10);
+    b.record(LatencyHistogram::MAX_VALUE + 1000);
+    b.record(5);
+
+    a.merge(b);
+    EXPECT_EQ(a.count(), 3u);
+    EXPECT_EQ(a.clamped_count(), 1u);
+    EXPECT_EQ(a.min(), 5u);
+    EXPECT_EQ(a.max(), LatencyHistogram::MAX_VALUE);
+
+    a.reset();
+    EXPECT_TRUE(a.empty());
+    EXPECT_EQ(a.clamped_count(), 0u);
+}
@@ -0,0 +1,177 @@
+#include <gtest/gtest.h>
+#include "market_data_journal.hpp"
+#include "market_data.hpp"
+#include <cstdio>
+#include <vector>
+
+using namespace OrderBook;
+
+namespace {
+
+/**
+ * Publisher that records replayed events
+ */
+class CollectingPublisher : public MarketDataPublisher {
+public:
+    std::vector<Trade>* trades;
+    std::vector<Level2Snapshot>* snapshots;
+    uint64_t* updates;
+
+    CollectingPublisher(std::vector<Trade>* t, std::vector<Level2Snapshot>* s, uint64_t* u)
+        : trades(t), snapshots(s), updates(u) {}
+
+    void publish_trade(const Trade& trade) override { trades->push_back(trade); }
+    void publish_level2_snapshot(const Level2Snapshot& snapshot) override { snapshots->push_back(snapshot); }
+    void publish_level2_update(uint32_t, Side, int64_t, uint64_t, uint32_t) override {
+        ++*updates;
+    }
+};
+
+} // namespace
+
+class MarketDataJournalTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        base = ::testing::TempDir() + "md_journal_" +
+               ::testing::UnitTest::GetInstance()->current_test_info()->name();
+    }
+
+    void TearDown() override {
+        for (uint64_t i = 0; i < 16; ++i) {
+            std::remove(MarketDataJournal::segment_path(base, i).c_str());
+        }
+    }
+
+    JournalRecord makeTrade(uint64_t id, int64_t price) {
+        JournalRecord record;
+        record.type = JournalRecordType::TRADE;
+        record.instrument_id = 1;
+        record.aggressor_order_id = id;
+        record.resting_order_id = id + 1000;
+        record.side = Side::BUY;
+        record.price = price;
+        record.quantity = 10;
+        return record;
+    }
+
+    std::string base;
+};
+
+TEST_F(MarketDataJournalTest, WriteAndReadBack) {
+    {
+        MarketDataJournal journal(base);
+        ASSERT_TRUE(journal.is_open());
+        for (uint64_t i = 0; i < 100; ++i) {
+            journal.append(makeTrade(i, 5000 + i));
+        }
+        EXPECT_EQ(journal.records_written(), 100u);
+    }
+
+    MarketDataJournalReader reader(base);
+    JournalRecord record;
+    uint64_t count = 0;
+    while (reader.next(record)) {
+        EXPECT_EQ(record.type, JournalRecordType::TRADE);
+        EXPECT_EQ(record.aggressor_order_id, count);
+        EXPECT_EQ(record.price, static_cast<int64_t>(5000 + count));
+        ++count;
+    }
+    EXPECT_EQ(count, 100u);
+}
+
+TEST_F(MarketDataJournalTest, RollsOverBySize) {
+    // Room for 10 records per segment after the header
+    const uint64_t segment_bytes = sizeof(JournalSegmentHeader) + 10 * sizeof(JournalRecord);
+    {
+        MarketDataJournal journal(base, segment_bytes);
+        for (uint64_t i = 0; i < 25; ++i) {
+            journal.append(makeTrade(i, 5000));
+        }
+        EXPECT_EQ(journal.segment_count(), 3u);
+    }
+
+    MarketDataJournalReader reader(base);
+    JournalRecord record;
+    uint64_t expected = 0;
+    while (reader.next(record)) {
+        EXPECT_EQ(record.aggressor_order_id, expected++);
+    }
+    EXPECT_EQ(expected, 25u);
+}
+
+TEST_F(MarketDataJournalTest, BinaryPublisherReplaysThroughManager) {
+    {
+        FileMarketDataPublisher publisher(base, true);
+        ASSERT_NE(publisher.journal(), nullptr);
+
+        publisher.publish_trade(Trade(1, 7, 8, Side::SELL, 15000, 25));
+        publisher.publish_level2_update(1, Side::BUY, 14999, 300, 3);
+
+        Level2Snapshot snapshot(1);
+        snapshot.bids.emplace_back(14999, 300, 3);
+        snapshot.bids.emplace_back(14998, 100, 1);
+        snapshot.asks.emplace_back(15001, 50, 1);
+        publisher.publish_level2_snapshot(snapshot);
+
+        EXPECT_EQ(publisher.journal()->records_written(), 7u);  // Trade, update, begin + 3 levels + end
+    }
+
+    std::vector<Trade> trades;
+    std::vector<Level2Snapshot> snapshots;
+    uint64_t updates = 0;
+    MarketDataManager manager;
+    manager.add_publisher(std::make_unique<CollectingPublisher>(&trades, &snapshots, &updates));
+
+    MarketDataJournalReader reader(base);
+    EXPECT_EQ(reader.replay(manager), 7u);
+
+    ASSERT_EQ(trades.size(), 1u);
+    EXPECT_EQ(trades[0].aggressor_order_id, 7u);
+    EXPECT_EQ(trades[0].aggressor_side, Side::SELL);
+    EXPECT_EQ(trades[0].quantity, 25u);
+    EXPECT_EQ(updates, 1u);
+
+    ASSERT_EQ(snapshots.size(), 1u);
+    ASSERT_EQ(snapshots[0].bids.size(), 2u);
+    ASSERT_EQ(snapshots[0].asks.size(), 1u);
+    EXPECT_EQ(snapshots[0].bids[1].price, 14998);
+    EXPECT_EQ(snapshots[0].asks[0].quantity, 50u);
+}
+
+TEST_F(MarketDataJournalTest, MissingJournalReadsEmpty) {
+    MarketDataJournalReader reader(base);
+    JournalRecord record;
+    EXPECT_FALSE(reader.next(record));
+}
+
+TEST_F(MarketDataJournalTest, ReplayStopsAtTruncatedSnapshot) {
+    {
+        MarketDataJournal journal(base);
+        journal.append(makeTrade(1, 5000));
+
+        // Snapshot whose end record never made it, then a record after the cut
+        JournalRecord begin{};
+        begin.type = JournalRecordType::SNAPSHOT_BEGIN;
+        begin.instrument_id = 1;
+        JournalRecord level{};
+        level.type = JournalRecordType::SNAPSHOT_LEVEL;
+        level.side = Side::BUY;
+        level.price = 4999;
+        level.quantity = 10;
+        journal.append(begin);
+        journal.append(level);
+        journal.append(makeTrade(2, 5001));
+    }
+
+    std::vector<Trade> trades;
+    std::vector<Level2Snapshot> snapshots;
+    uint64_t updates = 0;
+    MarketDataManager manager;
+    manager.add_publisher(std::make_unique<CollectingPublisher>(&trades, &snapshots, &updates));
+
+    MarketDataJournalReader reader(base);
+    EXPECT_EQ(reader.replay(manager), 1u);
+    ASSERT_EQ(trades.size(), 1u);
+    EXPECT_EQ(trades[0].aggressor_order_id, 1u);
+    EXPECT_TRUE(snapshots.empty());
+}
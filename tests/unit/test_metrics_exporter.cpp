@@ -0,0 +1,132 @@
+#include <gtest/gtest.h>
+#include "metrics_exporter.hpp"
+#include "multi_instrument_engine.hpp"
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <thread>
+
+using namespace OrderBook;
+
+namespace {
+
+MultiInstrumentCommand createCommand(uint64_t id, Side side, int32_t price, uint32_t quantity) {
+    MultiInstrumentCommand cmd{};
+    cmd.type = CommandType::NEW;
+    cmd.order_type = OrderType::LIMIT;
+    cmd.instrument_id = DEFAULT_INSTRUMENT_ID;
+    cmd.order_id = id;
+    cmd.side = side;
+    cmd.price = price;
+    cmd.quantity = quantity;
+    return cmd;
+}
+
+} // namespace
+
+TEST(SpanSamplerTest, TimesOneCallInPeriod) {
+    SpanSampler sampler(4);
+    uint64_t sampled = 0;
+    for (int i = 0; i < 12; ++i) {
+        const uint64_t span = sampler.begin();
+        if (span != 0) ++sampled;
+        sampler.end(span);
+    }
+    EXPECT_EQ(sampled, 3u);
+    EXPECT_EQ(sampler.histogram().count(), 3u);
+}
+
+TEST(MetricsMailboxTest, OwnerWritesOnlyWhenAsked) {
+    MetricsMailbox<uint64_t> mailbox;
+    uint64_t fills = 0;
+    mailbox.serve([&](uint64_t& value) { value = ++fills; });
+    EXPECT_EQ(fills, 0u);
+
+    const uint64_t ticket = mailbox.request();
+    EXPECT_FALSE(mailbox.answered(ticket));
+    mailbox.serve([&](uint64_t& value) { value = ++fills; });
+    ASSERT_TRUE(mailbox.answered(ticket));
+    EXPECT_EQ(mailbox.value(), 1u);
+
+    // Answered tickets aren't served twice
+    mailbox.serve([&](uint64_t& value) { value = ++fills; });
+    EXPECT_EQ(fills, 1u);
+}
+
+TEST(MetricsMailboxTest, AnswersAcrossThreads) {
+    MetricsMailbox<uint64_t> mailbox;
+    std::atomic<bool> done{false};
+    uint64_t state = 0;
+
+    std::thread owner([&] {
+        while (!done.load(std::memory_order_acquire)) {
+            ++state;
+            mailbox.serve([&](uint64_t& value) { value = state; });
+        }
+    });
+
+    uint64_t last = 0;
+    for (int i = 0; i < 100; ++i) {
+        const uint64_t ticket = mailbox.request();
+        while (!mailbox.answered(ticket)) std::this_thread::yield();
+        EXPECT_GT(mailbox.value(), last);
+        last = mailbox.value();
+    }
+    done.store(true, std::memory_order_release);
+    owner.join();
+}
+
+TEST(MetricsExporterTest, RendersEngineMetricsAndGauges) {
+    auto ring = std::make_unique<MultiInstrumentRingBuffer>(1024);
+    auto engine = std::make_unique<MultiInstrumentEngine>(ring.get(), 1024);
+    ASSERT_TRUE(engine->add_instrument(Instrument(DEFAULT_INSTRUMENT_ID, "DEF")));
+
+    ASSERT_TRUE(ring->enqueue(createCommand(1, Side::SELL, 5000, 10)));
+    ASSERT_TRUE(ring->enqueue(createCommand(2, Side::BUY, 5000, 4)));
+    ASSERT_TRUE(ring->enqueue(createCommand(3, Side::BUY, 4990, 4)));
+
+    const std::string path = "test_metrics_exporter.prom";
+    MetricsExporter exporter(path, std::chrono::milliseconds(1), std::chrono::milliseconds(20));
+    exporter.add_engine("mi0", engine->metrics());
+    exporter.add_gauge("ome_ring_occupancy", "ring=\"ingress\"", "Commands queued in the ring",
+                       [&ring] { return static_cast<double>(ring->size()); });
+
+    // No burst boundary within the timeout: reported from the engine's (empty) last answer
+    std::string page = exporter.scrape();
+    EXPECT_EQ(exporter.stale_answers(), 1u);
+    EXPECT_NE(page.find("ome_engine_metrics_fresh{engine=\"mi0\"} 0"), std::string::npos);
+    EXPECT_NE(page.find("ome_orders_processed_total{engine=\"mi0\"} 0"), std::string::npos);
+    EXPECT_NE(page.find("ome_ring_occupancy{ring=\"ingress\"} 3"), std::string::npos);
+
+    std::atomic<bool> done{false};
+    std::thread matching([&] {
+        while (!done.load(std::memory_order_acquire)) engine->process_burst();
+    });
+    while (ring->size() != 0) std::this_thread::yield();
+    page = exporter.scrape();
+
+    EXPECT_EQ(exporter.stale_answers(), 1u);
+    EXPECT_NE(page.find("ome_engine_metrics_fresh{engine=\"mi0\"} 1"), std::string::npos);
+    EXPECT_NE(page.find("# TYPE ome_orders_processed_total counter"), std::string::npos);
+    EXPECT_NE(page.find("ome_orders_processed_total{engine=\"mi0\"} 3"), std::string::npos);
+    EXPECT_NE(page.find("ome_trades_executed_total{engine=\"mi0\"} 1"), std::string::npos);
+    EXPECT_NE(page.find("ome_order_pool_allocated{engine=\"mi0\"} 2"), std::string::npos);
+    EXPECT_NE(page.find("ome_queue_latency_ns{engine=\"mi0\",quantile=\"0.99\"}"), std::string::npos);
+    EXPECT_NE(page.find("ome_match_span_ns_count{engine=\"mi0\"}"), std::string::npos);
+    EXPECT_NE(page.find("ome_ring_occupancy{ring=\"ingress\"} 0"), std::string::npos);
+
+    // The scraper thread writes the same page to the file
+    exporter.start();
+    while (exporter.scrapes() < 5) std::this_thread::yield();
+    exporter.stop();
+    done.store(true, std::memory_order_release);
+    matching.join();
+
+    std::ifstream file(path);
+    std::stringstream contents;
+    contents << file.rdbuf();
+    EXPECT_NE(contents.str().find("ome_orders_processed_total{engine=\"mi0\"} 3"), std::string::npos);
+    std::remove(path.c_str());
+}
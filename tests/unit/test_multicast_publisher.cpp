@@ -0,0 +1,135 @@
+#include <gtest/gtest.h>
+#include "multicast_publisher.hpp"
+#include <cstring>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <vector>
+
+using namespace OrderBook;
+
+class MulticastPublisherTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        // Unicast loopback receiver; the publisher only sets multicast options for a group address
+        receiver = socket(AF_INET, SOCK_DGRAM, 0);
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        socklen_t length = sizeof(address);
+        ASSERT_EQ(bind(receiver, reinterpret_cast<sockaddr*>(&address), sizeof(address)), 0);
+        ASSERT_EQ(getsockname(receiver, reinterpret_cast<sockaddr*>(&address), &length), 0);
+        port = ntohs(address.sin_port);
+        timeval timeout{2, 0};
+        setsockopt(receiver, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    }
+
+    void TearDown() override {
+        ::close(receiver);
+    }
+
+    std::vector<char> receive_packet() {
+        std::vector<char> packet(2048);
+        const ssize_t size = ::recv(receiver, packet.data(), packet.size(), 0);
+        packet.resize(size > 0 ? static_cast<size_t>(size) : 0);
+        return packet;
+    }
+
+    template <typename Message>
+    static Message read_at(const std::vector<char>& packet, size_t offset) {
+        Message message;
+        std::memcpy(&message, packet.data() + offset, sizeof(message));
+        return message;
+    }
+
+    int receiver = -1;
+    uint16_t port = 0;
+};
+
+TEST_F(MulticastPublisherTest, BatchesRecordsIntoSequencedPackets) {
+    MulticastMarketDataPublisher publisher("127.0.0.1", port);
+    ASSERT_TRUE(publisher.is_open()) << publisher.error();
+
+    publisher.publish_trade(Trade(3, 11, 12, Side::BUY, 5000, 25));
+    publisher.publish_level2_update(3, Side::SELL, 5000, 75, 2);
+    publisher.flush();
+    publisher.flush();  // Nothing new - no empty packet
+
+    const std::vector<char> packet = receive_packet();
+    ASSERT_EQ(packet.size(), sizeof(MarketDataPacketHeader) + sizeof(TradeMessage) + sizeof(LevelMessage));
+    const auto header = read_at<MarketDataPacketHeader>(packet, 0);
+    EXPECT_EQ(header.sequence, 1u);
+    EXPECT_EQ(header.message_count, 2u);
+    EXPECT_EQ(header.length, packet.size());
+
+    const auto trade = read_at<TradeMessage>(packet, sizeof(header));
+    EXPECT_EQ(trade.type, MarketDataMessageType::TRADE);
+    EXPECT_EQ(trade.instrument_id, 3u);
+    EXPECT_EQ(trade.aggressor_order_id, 11u);
+    EXPECT_EQ(trade.resting_order_id, 12u);
+    EXPECT_EQ(trade.aggressor_side, Side::BUY);
+    EXPECT_EQ(trade.price, 5000);
+    EXPECT_EQ(trade.quantity, 25u);
+    EXPECT_NE(trade.timestamp_ns, 0u);
+
+    const auto update = read_at<LevelMessage>(packet, sizeof(header) + sizeof(trade));
+    EXPECT_EQ(update.type, MarketDataMessageType::LEVEL2_UPDATE);
+    EXPECT_EQ(update.side, Side::SELL);
+    EXPECT_EQ(update.quantity, 75u);
+    EXPECT_EQ(update.order_count, 2u);
+    EXPECT_EQ(publisher.packets_sent(), 1u);
+    EXPECT_EQ(publisher.send_failures(), 0u);
+}
+
+TEST_F(MulticastPublisherTest, SendsFullPacketsBeforeOverflowing) {
+    MulticastMarketDataPublisher publisher("127.0.0.1", port);
+    ASSERT_TRUE(publisher.is_open());
+
+    constexpr size_t PER_PACKET = (MARKET_DATA_PACKET_SIZE - sizeof(MarketDataPacketHeader)) / sizeof(LevelMessage);
+    for (size_t i = 0; i < PER_PACKET + 1; ++i) {
+        publisher.publish_level2_update(1, Side::BUY, 5000 - static_cast<int64_t>(i), 10, 1);
+    }
+    EXPECT_EQ(publisher.packets_sent(), 1u);  // Before any flush
+    publisher.flush();
+
+    const auto first = read_at<MarketDataPacketHeader>(receive_packet(), 0);
+    const auto second = read_at<MarketDataPacketHeader>(receive_packet(), 0);
+    EXPECT_EQ(first.message_count, PER_PACKET);
+    EXPECT_EQ(second.sequence, first.sequence + 1);
+    EXPECT_EQ(second.message_count, 1u);
+}
+
+TEST_F(MulticastPublisherTest, KeepsASnapshotInOnePacket) {
+    MulticastMarketDataPublisher publisher("127.0.0.1", port);
+    ASSERT_TRUE(publisher.is_open());
+
+    Level2Snapshot snapshot(2);
+    snapshot.bids.emplace_back(4999, 10, 1);
+    snapshot.bids.emplace_back(4998, 20, 2);
+    snapshot.asks.emplace_back(5001, 30, 3);
+    publisher.publish_level2_snapshot(snapshot);
+    publisher.flush();
+
+    const std::vector<char> packet = receive_packet();
+    ASSERT_EQ(read_at<MarketDataPacketHeader>(packet, 0).message_count, 4u);
+    const auto header = read_at<SnapshotHeaderMessage>(packet, sizeof(MarketDataPacketHeader));
+    EXPECT_EQ(header.type, MarketDataMessageType::SNAPSHOT);
+    EXPECT_EQ(header.instrument_id, 2u);
+    EXPECT_EQ(header.bid_levels, 2u);
+    EXPECT_EQ(header.ask_levels, 1u);
+
+    const size_t levels = sizeof(MarketDataPacketHeader) + sizeof(SnapshotHeaderMessage);
+    const auto best_bid = read_at<LevelMessage>(packet, levels);
+    const auto best_ask = read_at<LevelMessage>(packet, levels + 2 * sizeof(LevelMessage));
+    EXPECT_EQ(best_bid.type, MarketDataMessageType::SNAPSHOT_LEVEL);
+    EXPECT_EQ(best_bid.price, 4999);
+    EXPECT_EQ(best_ask.side, Side::SELL);
+    EXPECT_EQ(best_ask.quantity, 30u);
+}
+
+TEST_F(MulticastPublisherTest, RefusesABadAddress) {
+    MulticastMarketDataPublisher publisher("not-an-address", port);
+    EXPECT_FALSE(publisher.is_open());
+    EXPECT_FALSE(publisher.error().empty());
+}
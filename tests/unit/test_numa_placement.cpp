@@ -0,0 +1,60 @@
+#include <gtest/gtest.h>
+#include "numa_placement.hpp"
+#include <sched.h>
+#include <thread>
+#include <vector>
+
+using namespace OrderBook;
+
+TEST(NumaPlacementTest, TopologyIsAlwaysUsable) {
+    EXPECT_GE(NumaPlacement::node_count(), 1);
+    EXPECT_EQ(NumaPlacement::node_of_cpu(-1), -1);
+    EXPECT_EQ(NumaPlacement::node_of_cpu(1 << 20), -1);  // No such cpu
+    
+    const int cpu = sched_getcpu();
+    ASSERT_GE(cpu, 0);
+    EXPECT_GE(NumaPlacement::node_of_cpu(cpu), 0);
+}
+
+TEST(NumaPlacementTest, PinsOnlyValidCpus) {
+    EXPECT_FALSE(NumaPlacement::pin_current_thread(-1));
+    
+    // Pin a scratch thread so the test runner's affinity is left alone
+    const int cpu = sched_getcpu();
+    bool pinned = false;
+    int ran_on = -1;
+    std::thread worker([&] {
+        pinned = NumaPlacement::pin_current_thread(cpu);
+        ran_on = sched_getcpu();
+    });
+    worker.join();
+    
+    EXPECT_TRUE(pinned);
+    EXPECT_EQ(ran_on, cpu);
+}
+
+TEST(NumaPlacementTest, CensusClassifiesEverySampledPage) {
+    std::vector<char> buffer(64 * 4096, 1);  // Touched, so every page is resident
+    const int node = NumaPlacement::node_of_cpu(sched_getcpu());
+    
+    const PageCensus census = NumaPlacement::census(buffer.data(), buffer.size(), node, 16);
+    EXPECT_EQ(census.local + census.remote + census.unknown, 16u);
+    if (NumaPlacement::node_count() == 1 && census.unknown == 0) {
+        EXPECT_EQ(census.local, 16u);
+    }
+    
+    const PageCensus empty = NumaPlacement::census(nullptr, 4096, node);
+    EXPECT_EQ(empty.local + empty.remote + empty.unknown, 0u);
+}
+
+TEST(NumaPlacementTest, NodePreferenceIsNoOpWithoutNuma) {
+    NumaPlacement::ScopedNodePreference none(-1);
+    EXPECT_FALSE(none.active());
+    
+    NumaPlacement::ScopedNodePreference node0(0);
+    if (NumaPlacement::node_count() < 2) {
+        EXPECT_FALSE(node0.active());
+    }
+    node0.release();
+    EXPECT_FALSE(node0.active());
+}
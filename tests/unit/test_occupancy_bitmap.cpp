@@ -0,0 +1,135 @@
+#include <gtest/gtest.h>
+#include "occupancy_bitmap.hpp"
+#include "book.hpp"
+#include <memory>
+#include <vector>
+
+using namespace OrderBook;
+
+class OccupancyBitmapTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        bitmap = std::make_unique<OccupancyBitmap>(PRICE_LEVELS);
+    }
+
+    std::unique_ptr<OccupancyBitmap> bitmap;
+};
+
+TEST_F(OccupancyBitmapTest, InitialState) {
+    EXPECT_TRUE(bitmap->empty());
+    EXPECT_EQ(bitmap->size(), PRICE_LEVELS);
+    EXPECT_EQ(bitmap->find_next(0), OccupancyBitmap::NOT_FOUND);
+    EXPECT_EQ(bitmap->find_prev(PRICE_LEVELS - 1), OccupancyBitmap::NOT_FOUND);
+}
+
+TEST_F(OccupancyBitmapTest, SetAndClear) {
+    bitmap->set(4242);
+
+    EXPECT_FALSE(bitmap->empty());
+    EXPECT_TRUE(bitmap->test(4242));
+    EXPECT_FALSE(bitmap->test(4241));
+
+    bitmap->clear(4242);
+    EXPECT_TRUE(bitmap->empty());
+    EXPECT_FALSE(bitmap->test(4242));
+}
+
+TEST_F(OccupancyBitmapTest, FindNextAcrossSummaryWords) {
+    // Slots chosen to cross leaf-word and summary-word boundaries
+    bitmap->set(0);
+    bitmap->set(63);
+    bitmap->set(64);
+    bitmap->set(4095);
+    bitmap->set(4096);
+    bitmap->set(PRICE_LEVELS - 1);
+
+    EXPECT_EQ(bitmap->find_next(0), 0u);
+    EXPECT_EQ(bitmap->find_next(1), 63u);
+    EXPECT_EQ(bitmap->find_next(64), 64u);
+    EXPECT_EQ(bitmap->find_next(65), 4095u);
+    EXPECT_EQ(bitmap->find_next(4096), 4096u);
+    EXPECT_EQ(bitmap->find_next(4097), PRICE_LEVELS - 1);
+    EXPECT_EQ(bitmap->find_next(PRICE_LEVELS), OccupancyBitmap::NOT_FOUND);
+}
+
+TEST_F(OccupancyBitmapTest, FindPrevAcrossSummaryWords) {
+    bitmap->set(0);
+    bitmap->set(63);
+    bitmap->set(64);
+    bitmap->set(4095);
+    bitmap->set(4096);
+    bitmap->set(PRICE_LEVELS - 1);
+
+    EXPECT_EQ(bitmap->find_prev(PRICE_LEVELS - 1), PRICE_LEVELS - 1);
+    EXPECT_EQ(bitmap->find_prev(PRICE_LEVELS - 2), 4096u);
+    EXPECT_EQ(bitmap->find_prev(4095), 4095u);
+    EXPECT_EQ(bitmap->find_prev(4094), 64u);
+    EXPECT_EQ(bitmap->find_prev(63), 63u);
+    EXPECT_EQ(bitmap->find_prev(62), 0u);
+
+    bitmap->clear(0);
+    EXPECT_EQ(bitmap->find_prev(62), OccupancyBitmap::NOT_FOUND);
+}
+
+TEST_F(OccupancyBitmapTest, ClearKeepsSiblingsInSameWord) {
+    bitmap->set(100);
+    bitmap->set(101);
+    bitmap->clear(100);
+
+    EXPECT_FALSE(bitmap->empty());
+    EXPECT_EQ(bitmap->find_next(0), 101u);
+    EXPECT_EQ(bitmap->find_prev(PRICE_LEVELS - 1), 101u);
+}
+
+class BookOccupancyTest : public ::testing::Test {
+protected:
+    Order* makeOrder(uint64_t id, Side side, int64_t price, uint64_t quantity) {
+        Order* order = pool.allocate();
+        order->order_id = id;
+        order->side = side;
+        order->price = price;
+        order->quantity = quantity;
+        return order;
+    }
+
+    OrderPool pool{64};
+    Book book{pool};
+};
+
+TEST_F(BookOccupancyTest, BestAskRecoversAfterTouchRemoved) {
+    Order* touch = makeOrder(1, Side::SELL, 5001, 100);
+    Order* far = makeOrder(2, Side::SELL, 9000, 100);
+    book.add_order(touch);
+    book.add_order(far);
+
+    EXPECT_EQ(book.best_ask(), 5001);
+    book.remove_order(touch);
+    EXPECT_EQ(book.best_ask(), 9000);
+    book.remove_order(far);
+    EXPECT_EQ(book.best_ask(), -1);
+}
+
+TEST_F(BookOccupancyTest, BestBidRecoversAfterTouchRemoved) {
+    Order* far = makeOrder(1, Side::BUY, 10, 100);
+    Order* touch = makeOrder(2, Side::BUY, 4999, 100);
+    book.add_order(far);
+    book.add_order(touch);
+
+    EXPECT_EQ(book.best_bid(), 4999);
+    book.remove_order(touch);
+    EXPECT_EQ(book.best_bid(), 10);
+    book.remove_order(far);
+    EXPECT_EQ(book.best_bid(), -1);
+}
+
+TEST_F(BookOccupancyTest, NextPriceSkipsEmptyLevels) {
+    book.add_order(makeOrder(1, Side::SELL, 5001, 100));
+    book.add_order(makeOrder(2, Side::SELL, 5500, 100));
+    book.add_order(makeOrder(3, Side::BUY, 4999, 100));
+    book.add_order(makeOrder(4, Side::BUY, 4000, 100));
+
+    EXPECT_EQ(book.next_ask_price(5001), 5500);
+    EXPECT_EQ(book.next_ask_price(5500), -1);
+    EXPECT_EQ(book.next_bid_price(4999), 4000);
+    EXPECT_EQ(book.next_bid_price(4000), -1);
+}
@@ -0,0 +1,249 @@
+#include <gtest/gtest.h>
+#include "order_gateway.hpp"
+#include "risk_manager.hpp"
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <vector>
+
+using namespace OrderBook;
+using namespace OrderEntry;
+
+class OrderGatewayTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        ASSERT_TRUE(transport.is_open()) << transport.error();
+        account = risk.logon("ACCT1", RiskLimits());
+        ASSERT_NE(account, NO_ACCOUNT);
+    }
+
+    void TearDown() override {
+        for (int fd : clients) ::close(fd);
+    }
+
+    int connect_client() {
+        const int fd = socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(transport.port());
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        EXPECT_EQ(connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)), 0);
+        timeval timeout{2, 0};
+        setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        clients.push_back(fd);
+        return fd;
+    }
+
+    template <typename Message>
+    static void send_message(int fd, const Message& message) {
+        ASSERT_EQ(::send(fd, &message, sizeof(message), 0), static_cast<ssize_t>(sizeof(message)));
+    }
+
+    /**
+     * Poll the gateway until done() holds or a second has passed
+     */
+    template <typename Done>
+    bool poll_until(Done&& done) {
+        for (int i = 0; i < 1000 && !done(); ++i) gateway.poll_once(1);
+        return done();
+    }
+
+    /**
+     * Log fd on as name and return the gateway's answer
+     */
+    LogonResponseMessage logon(int fd, const char* name) {
+        send_message(fd, make_logon(name));
+        LogonResponseMessage response{};
+        poll_until([&] { return gateway.statistics().logons + gateway.statistics().logons_rejected > logons_seen; });
+        ++logons_seen;
+        EXPECT_EQ(::recv(fd, &response, sizeof(response), MSG_WAITALL), static_cast<ssize_t>(sizeof(response)));
+        return response;
+    }
+
+    static NewOrderMessage new_order(uint64_t order_id, Side side, int32_t price, uint32_t quantity) {
+        NewOrderMessage message = make_message<NewOrderMessage>();
+        message.instrument_id = 1;
+        message.order_id = order_id;
+        message.side = side;
+        message.order_type = OrderType::LIMIT;
+        message.price = price;
+        message.quantity = quantity;
+        return message;
+    }
+
+    /**
+     * A closed session reads end-of-stream
+     */
+    static bool closed_by_gateway(int fd) {
+        char byte;
+        return ::recv(fd, &byte, 1, 0) == 0;
+    }
+
+    EpollTcpTransport transport{0, "127.0.0.1"};
+    SPSCQueue<Command> ring{1024};
+    RiskManager risk;
+    OrderGateway gateway{&transport, &ring, risk};
+    AccountId account = NO_ACCOUNT;
+    std::vector<int> clients;
+    uint64_t logons_seen = 0;
+};
+
+TEST_F(OrderGatewayTest, StampsTheSessionsAccountIntoEveryCommand) {
+    const int fd = connect_client();
+    const LogonResponseMessage response = logon(fd, "ACCT1");
+    EXPECT_EQ(response.header.type, MessageType::LOGON_ACK);
+    EXPECT_EQ(response.account_id, account);
+    EXPECT_NE(response.session_id, 0u);
+
+    send_message(fd, new_order(7, Side::BUY, 5000, 10));
+    CancelMessage cancel = make_message<CancelMessage>();
+    cancel.instrument_id = 1;
+    cancel.order_id = 7;
+    send_message(fd, cancel);
+    ASSERT_TRUE(poll_until([&] { return gateway.statistics().commands == 2; }));
+
+    std::vector<Command> commands;
+    ring.consume_bulk(16, [&](const Command& cmd) { commands.push_back(cmd); });
+    ASSERT_EQ(commands.size(), 2u);
+    EXPECT_EQ(commands[0].type, CommandType::NEW);
+    EXPECT_EQ(commands[0].order_id, engine_order_id(response.session_id, 7));
+    EXPECT_EQ(commands[0].instrument_id, 1u);
+    EXPECT_EQ(commands[0].side, Side::BUY);
+    EXPECT_EQ(commands[0].price, 5000);
+    EXPECT_EQ(commands[0].quantity, 10u);
+    EXPECT_NE(commands[0].producer_timestamp, 0u);
+    EXPECT_EQ(commands[1].type, CommandType::CANCEL);
+    EXPECT_EQ(commands[1].order_id, commands[0].order_id);
+    for (const Command& cmd : commands) EXPECT_EQ(cmd.account_id, account);
+}
+
+TEST_F(OrderGatewayTest, ReassemblesMessagesSplitAcrossReads) {
+    const int fd = connect_client();
+    const LogonResponseMessage response = logon(fd, "ACCT1");
+    ASSERT_EQ(response.header.type, MessageType::LOGON_ACK);
+
+    // Three orders in one stream, cut mid-header and mid-body
+    std::vector<char> stream;
+    for (uint64_t id = 1; id <= 3; ++id) {
+        const NewOrderMessage message = new_order(id, Side::SELL, 5001, 5);
+        const char* bytes = reinterpret_cast<const char*>(&message);
+        stream.insert(stream.end(), bytes, bytes + sizeof(message));
+    }
+    size_t sent = 0;
+    for (size_t cut : {2ul, 40ul, stream.size()}) {
+        ASSERT_EQ(::send(fd, stream.data() + sent, cut - sent, 0), static_cast<ssize_t>(cut - sent));
+        sent = cut;
+        for (int i = 0; i < 10; ++i) gateway.poll_once(1);
+    }
+    ASSERT_TRUE(poll_until([&] { return gateway.statistics().commands == 3; }));
+
+    uint64_t expected = 1;
+    EXPECT_EQ(ring.consume_bulk(16, [&](const Command& cmd) {
+        EXPECT_EQ(cmd.order_id, engine_order_id(response.session_id, expected++));
+    }), 3u);
+}
+
+TEST_F(OrderGatewayTest, RejectsUnknownAccounts) {
+    const int fd = connect_client();
+    const LogonResponseMessage response = logon(fd, "NOBODY");
+    EXPECT_EQ(response.header.type, MessageType::LOGON_REJECT);
+    EXPECT_EQ(response.account_id, NO_ACCOUNT);
+    EXPECT_EQ(response.session_id, 0u);
+    EXPECT_TRUE(closed_by_gateway(fd));
+    EXPECT_EQ(gateway.statistics().logons_rejected, 1u);
+}
+
+TEST_F(OrderGatewayTest, ClosesSessionsThatBreakTheProtocol) {
+    // Orders before logon are not accepted
+    const int early = connect_client();
+    send_message(early, new_order(1, Side::BUY, 5000, 10));
+    ASSERT_TRUE(poll_until([&] { return gateway.statistics().protocol_errors == 1; }));
+    EXPECT_TRUE(closed_by_gateway(early));
+
+    // Nor an order id too wide for the session namespace
+    const int wide = connect_client();
+    ASSERT_EQ(logon(wide, "ACCT1").header.type, MessageType::LOGON_ACK);
+    send_message(wide, new_order(MAX_CLIENT_ORDER_ID + 1, Side::BUY, 5000, 10));
+    ASSERT_TRUE(poll_until([&] { return gateway.statistics().protocol_errors == 2; }));
+    EXPECT_TRUE(closed_by_gateway(wide));
+
+    // Nor a length that doesn't match the type
+    const int garbled = connect_client();
+    ASSERT_EQ(logon(garbled, "ACCT1").header.type, MessageType::LOGON_ACK);
+    NewOrderMessage bad = new_order(2, Side::BUY, 5000, 10);
+    bad.header.length = 16;
+    send_message(garbled, bad);
+    ASSERT_TRUE(poll_until([&] { return gateway.statistics().protocol_errors == 3; }));
+    EXPECT_TRUE(closed_by_gateway(garbled));
+
+    // Other sessions carry on
+    const int good = connect_client();
+    ASSERT_EQ(logon(good, "ACCT1").header.type, MessageType::LOGON_ACK);
+    send_message(good, new_order(3, Side::BUY, 5000, 10));
+    ASSERT_TRUE(poll_until([&] { return gateway.statistics().commands == 1; }));
+    EXPECT_EQ(ring.size(), 1u);
+    EXPECT_EQ(gateway.statistics().sessions_accepted, 4u);
+}
+
+TEST_F(OrderGatewayTest, SessionsCannotNameEachOthersOrders) {
+    // Same account and the same client id on two logons: distinct engine orders
+    const int first = connect_client();
+    const int second = connect_client();
+    const LogonResponseMessage first_logon = logon(first, "ACCT1");
+    const LogonResponseMessage second_logon = logon(second, "ACCT1");
+    ASSERT_EQ(second_logon.header.type, MessageType::LOGON_ACK);
+    EXPECT_NE(first_logon.session_id, second_logon.session_id);
+
+    send_message(first, new_order(1, Side::BUY, 5000, 10));
+    CancelMessage cancel = make_message<CancelMessage>();
+    cancel.instrument_id = 1;
+    cancel.order_id = 1;
+    send_message(second, cancel);
+    ASSERT_TRUE(poll_until([&] { return gateway.statistics().commands == 2; }));
+
+    // Sessions are served in readiness order, so pick the commands out by type
+    uint64_t new_id = 0, cancel_id = 0;
+    ring.consume_bulk(16, [&](const Command& cmd) {
+        (cmd.type == CommandType::NEW ? new_id : cancel_id) = cmd.order_id;
+    });
+    EXPECT_NE(new_id, cancel_id);
+    EXPECT_EQ(session_of(new_id), first_logon.session_id);
+    EXPECT_EQ(session_of(cancel_id), second_logon.session_id);
+    EXPECT_EQ(client_order_id(cancel_id), 1u);
+
+    // A reconnect is a new session, not the old one back
+    ::close(second);
+    const int again = connect_client();
+    EXPECT_GT(logon(again, "ACCT1").session_id, second_logon.session_id);
+}
+
+TEST(OrderEntryProtocolTest, ReplaceOverwritesEveryFieldOfAReusedSlot) {
+    // The slot still holds the ring's previous command: an IOC buy
+    Command slot{};
+    NewOrderMessage buy = make_message<NewOrderMessage>();
+    buy.order_id = 1;
+    buy.side = Side::BUY;
+    buy.order_type = OrderType::IOC;
+    buy.price = 5000;
+    buy.quantity = 10;
+    ASSERT_TRUE(decode_command(reinterpret_cast<const char*>(&buy), MessageType::NEW_ORDER, 3, slot));
+
+    ReplaceMessage replace = make_message<ReplaceMessage>();
+    replace.instrument_id = 1;
+    replace.order_id = 2;
+    replace.side = Side::SELL;
+    replace.price = 5002;
+    replace.quantity = 4;
+    ASSERT_TRUE(decode_command(reinterpret_cast<const char*>(&replace), MessageType::REPLACE, 3, slot));
+    EXPECT_EQ(slot.type, CommandType::REPLACE);
+    EXPECT_EQ(slot.side, Side::SELL);
+    EXPECT_EQ(slot.order_type, OrderType::LIMIT);
+    EXPECT_EQ(slot.order_id, engine_order_id(3, 2));
+    EXPECT_EQ(slot.price, 5002);
+    EXPECT_EQ(slot.quantity, 4u);
+
+    // A side byte outside the enum is malformed
+    reinterpret_cast<uint8_t&>(replace.side) = 2;
+    EXPECT_FALSE(decode_command(reinterpret_cast<const char*>(&replace), MessageType::REPLACE, 3, slot));
+}
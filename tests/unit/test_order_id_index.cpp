@@ -0,0 +1,137 @@
+#include <gtest/gtest.h>
+#include "order_id_index.hpp"
+#include "order_pool.hpp"
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+using namespace OrderBook;
+
+class OrderIdIndexTest : public ::testing::Test {
+protected:
+    OrderIndex addOrder(uint64_t id) {
+        Order* order = pool.allocate();
+        order->order_id = id;
+        const OrderIndex index = pool.index_of(order);
+        EXPECT_TRUE(ids.insert(id, index));
+        return index;
+    }
+
+    OrderPool pool{1024};
+    OrderIdIndex ids{pool, 1024};
+};
+
+TEST_F(OrderIdIndexTest, SizedForHalfLoad) {
+    EXPECT_EQ(ids.capacity(), 2048u);
+    EXPECT_TRUE(ids.empty());
+
+    OrderIdIndex small(pool, 1000);
+    EXPECT_EQ(small.capacity(), 2048u);
+}
+
+TEST_F(OrderIdIndexTest, SparseSixtyFourBitIds) {
+    // Well past MAX_ORDERS, and nowhere near each other
+    const OrderIndex a = addOrder(5'000'000'000ull);
+    const OrderIndex b = addOrder(0xFFFF'FFFF'FFFF'0001ull);
+    const OrderIndex c = addOrder(MAX_ORDERS + 7);
+
+    EXPECT_EQ(ids.size(), 3u);
+    EXPECT_EQ(ids.find(5'000'000'000ull), a);
+    EXPECT_EQ(ids.find(0xFFFF'FFFF'FFFF'0001ull), b);
+    EXPECT_EQ(ids.find(MAX_ORDERS + 7), c);
+    EXPECT_EQ(ids.find(42), NULL_ORDER);
+}
+
+TEST_F(OrderIdIndexTest, EraseReturnsTheOrder) {
+    const OrderIndex a = addOrder(100);
+    addOrder(200);
+
+    EXPECT_EQ(ids.erase(100), a);
+    EXPECT_EQ(ids.erase(100), NULL_ORDER);  // Already cancelled
+    EXPECT_EQ(ids.find(100), NULL_ORDER);
+    EXPECT_NE(ids.find(200), NULL_ORDER);
+    EXPECT_EQ(ids.size(), 1u);
+}
+
+TEST_F(OrderIdIndexTest, EraseSpecificOrderWithDuplicateIds) {
+    const OrderIndex first = addOrder(77);
+    const OrderIndex second = addOrder(77);
+
+    EXPECT_TRUE(ids.erase(77, second));
+    EXPECT_FALSE(ids.erase(77, second));
+    EXPECT_EQ(ids.find(77), first);
+}
+
+TEST_F(OrderIdIndexTest, KeyedByAccountSeparatesSharedIds) {
+    OrderIdIndex owned(pool, 1024, true);
+    OrderIndex orders[3];
+    for (AccountId account = 1; account <= 3; ++account) {
+        Order* order = pool.allocate();
+        order->order_id = 42;
+        pool.info(order).account_id = account;
+        orders[account - 1] = pool.index_of(order);
+        ASSERT_TRUE(owned.insert(42, orders[account - 1]));
+    }
+
+    EXPECT_EQ(owned.find(42, 2), orders[1]);
+    EXPECT_EQ(owned.find(42, 3), orders[2]);
+    EXPECT_EQ(owned.find(42, 4), NULL_ORDER);
+    EXPECT_EQ(owned.find(42), NULL_ORDER);  // NO_ACCOUNT is an account of its own
+
+    EXPECT_TRUE(owned.erase(42, orders[0]));
+    EXPECT_EQ(owned.find(42, 1), NULL_ORDER);
+    EXPECT_EQ(owned.find(42, 2), orders[1]);
+    EXPECT_EQ(owned.size(), 2u);
+}
+
+TEST_F(OrderIdIndexTest, FullTableRejectsInsertAndMissesTerminate) {
+    OrderIdIndex tiny(pool, 8);
+    ASSERT_EQ(tiny.capacity(), 16u);
+
+    for (uint64_t id = 1; id <= 16; ++id) {
+        Order* order = pool.allocate();
+        order->order_id = id * 1'000'003;
+        EXPECT_TRUE(tiny.insert(order->order_id, pool.index_of(order)));
+    }
+    EXPECT_EQ(tiny.size(), tiny.capacity());
+
+    EXPECT_FALSE(tiny.insert(1, 0));
+    EXPECT_EQ(tiny.find(1), NULL_ORDER);
+    EXPECT_NE(tiny.find(8 * 1'000'003), NULL_ORDER);
+}
+
+TEST_F(OrderIdIndexTest, ChurnMatchesReferenceMap) {
+    // Random insert / cancel / fill mix at high load, checked against std::unordered_map
+    std::mt19937_64 rng(7);
+    std::unordered_map<uint64_t, OrderIndex> reference;
+    std::vector<uint64_t> live;
+    uint64_t next_id = 1'000'000'000ull;
+
+    for (int step = 0; step < 200000; ++step) {
+        const bool add = live.size() < 1000 && (live.empty() || rng() % 2 == 0);
+        if (add) {
+            next_id += 1 + rng() % 1000;
+            reference[next_id] = addOrder(next_id);
+            live.push_back(next_id);
+        } else {
+            const size_t pick = rng() % live.size();
+            const uint64_t id = live[pick];
+            const OrderIndex index = reference[id];
+
+            if (rng() % 2 == 0) {
+                EXPECT_EQ(ids.erase(id), index);
+            } else {
+                EXPECT_TRUE(ids.erase(id, index));
+            }
+            pool.free(pool.at(index));
+            reference.erase(id);
+            live[pick] = live.back();
+            live.pop_back();
+        }
+    }
+
+    EXPECT_EQ(ids.size(), reference.size());
+    for (const auto& [id, index] : reference) {
+        EXPECT_EQ(ids.find(id), index);
+    }
+}
@@ -61,16 +61,83 @@ TEST_F(OrderPoolTest, OrderInitialization) {
     ASSERT_NE(order, nullptr);
     
     // Check that order is properly initialized
-    EXPECT_EQ(order->next, nullptr);
-    EXPECT_EQ(order->prev, nullptr);
+    EXPECT_EQ(order->next, NULL_ORDER);
+    EXPECT_EQ(order->prev, NULL_ORDER);
     
     pool->free(order);
 }
 
+TEST_F(OrderPoolTest, IndexAndColdDataRoundTrip) {
+    Order* first = pool->allocate();
+    Order* second = pool->allocate();
+    ASSERT_NE(first, nullptr);
+    ASSERT_NE(second, nullptr);
+    
+    const OrderIndex index = pool->index_of(second);
+    EXPECT_LT(index, 100u);
+    EXPECT_EQ(pool->at(index), second);
+    EXPECT_NE(pool->index_of(first), index);
+    
+    // Cold data lives in a parallel array, not in the Order itself
+    pool->info(second).original_quantity = 500;
+    pool->info(second).timestamp = 42;
+    EXPECT_EQ(pool->info(second).original_quantity, 500u);
+    EXPECT_EQ(pool->info(first).original_quantity, 0u);
+    
+    pool->free(second);
+    pool->free(first);
+}
+
 TEST_F(OrderPoolTest, FreeNullPointer) {
     // Should not crash or affect counts
     pool->free(nullptr);
     
     EXPECT_EQ(pool->allocated_count(), 0);
     EXPECT_EQ(pool->available_count(), 100);
-}
\ No newline at end of file
+}
+TEST(OrderPoolGrowthTest, GrowsBySlabInsteadOfRejecting) {
+    OrderPool pool(4, 3);
+    EXPECT_EQ(pool.capacity(), 4u);
+    EXPECT_EQ(pool.max_capacity(), 12u);
+    
+    std::vector<Order*> orders;
+    for (int i = 0; i < 4; ++i) orders.push_back(pool.allocate());
+    Order* first = orders.front();
+    
+    // Free list is empty - the next allocation commits a second slab
+    Order* grown = pool.allocate();
+    ASSERT_NE(grown, nullptr);
+    orders.push_back(grown);
+    EXPECT_EQ(pool.slab_count(), 2u);
+    EXPECT_EQ(pool.capacity(), 8u);
+    EXPECT_EQ(pool.available_count(), 3u);
+    EXPECT_EQ(pool.index_of(grown), 4u);  // Slabs are contiguous in index space
+    
+    // Earlier orders don't move when the pool grows
+    EXPECT_EQ(pool.at(0), first);
+    EXPECT_EQ(pool.exhaustion_count(), 0u);
+    
+    for (Order* order : orders) pool.free(order);
+}
+
+TEST(OrderPoolGrowthTest, CountsExhaustionAtMaxCapacity) {
+    OrderPool pool(2, 2);
+    
+    std::vector<Order*> orders;
+    for (int i = 0; i < 4; ++i) {
+        Order* order = pool.allocate();
+        ASSERT_NE(order, nullptr);
+        orders.push_back(order);
+    }
+    
+    EXPECT_EQ(pool.allocate(), nullptr);
+    EXPECT_EQ(pool.allocate(), nullptr);
+    EXPECT_EQ(pool.exhaustion_count(), 2u);
+    EXPECT_EQ(pool.slab_count(), 2u);
+    
+    // High-water mark survives orders being returned
+    for (Order* order : orders) pool.free(order);
+    EXPECT_EQ(pool.allocated_count(), 0u);
+    EXPECT_EQ(pool.high_water_mark(), 4u);
+    EXPECT_NE(pool.page_backing(), PageBacking::NONE);
+}
@@ -0,0 +1,134 @@
+#include <gtest/gtest.h>
+#include "output_stage.hpp"
+#include "market_data.hpp"
+#include <vector>
+
+using namespace OrderBook;
+
+namespace {
+
+/**
+ * Publisher that records what the output stage hands it
+ */
+class RecordingPublisher : public MarketDataPublisher {
+public:
+    struct Update {
+        uint32_t instrument_id;
+        Side side;
+        int64_t price;
+        uint64_t quantity;
+        uint32_t order_count;
+    };
+
+    std::vector<Trade>* trades;
+    std::vector<Update>* updates;
+    int* flushes;
+
+    RecordingPublisher(std::vector<Trade>* t, std::vector<Update>* u, int* f)
+        : trades(t), updates(u), flushes(f) {}
+
+    void publish_trade(const Trade& trade) override {
+        trades->push_back(trade);
+    }
+
+    void publish_level2_snapshot(const Level2Snapshot&) override {}
+
+    void publish_level2_update(uint32_t instrument_id, Side side, int64_t price,
+                               uint64_t new_quantity, uint32_t new_order_count) override {
+        updates->push_back({instrument_id, side, price, new_quantity, new_order_count});
+    }
+
+    void flush() override {
+        ++*flushes;
+    }
+};
+
+} // namespace
+
+class OutputStageTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        manager.add_publisher(std::make_unique<RecordingPublisher>(&trades, &updates, &flushes));
+    }
+
+    MarketDataManager manager;
+    std::vector<Trade> trades;
+    std::vector<RecordingPublisher::Update> updates;
+    int flushes = 0;
+};
+
+TEST_F(OutputStageTest, DrainPublishesQueuedRecords) {
+    OutputStage stage(&manager, 64);
+
+    stage.publish_trade(7, 11, 22, Side::SELL, 5000, 30);
+    stage.publish_level2_update(7, Side::BUY, 5000, 70, 2);
+    EXPECT_TRUE(trades.empty());  // Nothing is formatted on the producer side
+
+    EXPECT_EQ(stage.drain(), 2u);
+    ASSERT_EQ(trades.size(), 1u);
+    EXPECT_EQ(trades[0].instrument_id, 7u);
+    EXPECT_EQ(trades[0].aggressor_order_id, 11u);
+    EXPECT_EQ(trades[0].resting_order_id, 22u);
+    EXPECT_EQ(trades[0].aggressor_side, Side::SELL);
+    EXPECT_EQ(trades[0].price, 5000);
+    EXPECT_EQ(trades[0].quantity, 30u);
+
+    ASSERT_EQ(updates.size(), 1u);
+    EXPECT_EQ(updates[0].instrument_id, 7u);
+    EXPECT_EQ(updates[0].side, Side::BUY);
+    EXPECT_EQ(updates[0].quantity, 70u);
+    EXPECT_EQ(updates[0].order_count, 2u);
+
+    EXPECT_EQ(flushes, 1);  // One flush per batch
+    EXPECT_EQ(stage.drain(), 0u);
+    EXPECT_EQ(flushes, 1);
+}
+
+TEST_F(OutputStageTest, PublisherThreadDrainsEverythingOnStop) {
+    // Small ring so the producer has to wait on the publisher thread
+    OutputStage stage(&manager, 16);
+    stage.start();
+
+    const int count = 1000;
+    for (int i = 0; i < count; ++i) {
+        stage.publish_trade(1, i, i + 1, Side::BUY, 5000, 1);
+    }
+    stage.stop();
+
+    ASSERT_EQ(trades.size(), static_cast<size_t>(count));
+    EXPECT_EQ(stage.events_published(), static_cast<uint64_t>(count));
+    for (int i = 0; i < count; ++i) {
+        EXPECT_EQ(trades[i].aggressor_order_id, static_cast<uint64_t>(i));
+    }
+}
+
+TEST_F(OutputStageTest, ConflatesLevelUpdatesPerBatch) {
+    manager.set_conflation(true);
+    OutputStage stage(&manager, 64);
+
+    // Three changes to one level and one to another inside a single batch
+    stage.publish_level2_update(1, Side::BUY, 5000, 100, 1);
+    stage.publish_level2_update(1, Side::SELL, 5001, 40, 1);
+    stage.publish_level2_update(1, Side::BUY, 5000, 200, 2);
+    stage.publish_level2_update(1, Side::BUY, 5000, 150, 2);
+    stage.drain();
+
+    ASSERT_EQ(updates.size(), 2u);
+    EXPECT_EQ(updates[0].price, 5000);     // First-change order is kept
+    EXPECT_EQ(updates[0].quantity, 150u);  // Latest state wins
+    EXPECT_EQ(updates[1].price, 5001);
+    EXPECT_EQ(manager.level2_updates_received(), 4u);
+    EXPECT_EQ(manager.level2_updates_published(), 2u);
+}
+
+TEST_F(OutputStageTest, ConflationIntervalHoldsUpdatesUntilDue) {
+    manager.set_conflation(true, std::chrono::hours(1));
+    OutputStage stage(&manager, 64);
+
+    stage.publish_level2_update(1, Side::BUY, 5000, 100, 1);
+    stage.drain();
+    EXPECT_TRUE(updates.empty());
+
+    manager.flush_all();
+    ASSERT_EQ(updates.size(), 1u);
+}
@@ -0,0 +1,156 @@
+#include <gtest/gtest.h>
+#include "price_ladder.hpp"
+#include "book.hpp"
+#include "instrument.hpp"
+#include "order_pool.hpp"
+#include <vector>
+
+using namespace OrderBook;
+
+class PriceLadderTest : public ::testing::Test {
+protected:
+    Order* makeOrder(uint64_t id, Side side, int64_t price, uint64_t quantity) {
+        Order* order = pool.allocate();
+        order->order_id = id;
+        order->side = side;
+        order->price = price;
+        order->quantity = quantity;
+        return order;
+    }
+
+    OrderPool pool{64};
+};
+
+TEST_F(PriceLadderTest, TickConversion) {
+    // Price units of 1/100, tick of 5 units
+    PriceLadder ladder(LadderConfig(100000, 200000, 5, 64));
+
+    uint64_t tick = 0;
+    EXPECT_TRUE(ladder.to_tick(100000, tick));
+    EXPECT_EQ(tick, 0u);
+    EXPECT_TRUE(ladder.to_tick(100025, tick));
+    EXPECT_EQ(tick, 5u);
+    EXPECT_EQ(ladder.to_price(5), 100025);
+
+    EXPECT_FALSE(ladder.to_tick(100003, tick));   // Off the tick grid
+    EXPECT_FALSE(ladder.to_tick(99995, tick));    // Below range
+    EXPECT_FALSE(ladder.to_tick(200005, tick));   // Above range
+    EXPECT_EQ(ladder.tick_count(), 20001u);
+}
+
+TEST_F(PriceLadderTest, WindowSizedToInstrumentRange) {
+    PriceLadder narrow(LadderConfig(0, 99, 1, 1024));
+    EXPECT_EQ(narrow.window_size(), 100u);
+
+    PriceLadder wide(LadderConfig(0, 1000000, 1, 1024));
+    EXPECT_EQ(wide.window_size(), 1024u);
+}
+
+TEST_F(PriceLadderTest, FarLevelsGoToOverflow) {
+    PriceLadder ladder(LadderConfig(0, 100000, 1, 64));
+
+    ladder.add_order(10, makeOrder(1, Side::SELL, 10, 100), pool);
+    ladder.add_order(50000, makeOrder(2, Side::SELL, 50000, 100), pool);
+
+    EXPECT_TRUE(ladder.in_window(10));
+    EXPECT_FALSE(ladder.in_window(50000));
+    EXPECT_EQ(ladder.overflow_levels(), 1u);
+
+    EXPECT_EQ(ladder.next_up(0), 10u);
+    EXPECT_EQ(ladder.next_up(11), 50000u);
+    EXPECT_EQ(ladder.next_down(100000), 50000u);
+    EXPECT_EQ(ladder.next_down(49999), 10u);
+    EXPECT_EQ(ladder.find(70000), nullptr);
+}
+
+TEST_F(PriceLadderTest, RecenterMovesLevelsBetweenWindowAndOverflow) {
+    PriceLadder ladder(LadderConfig(0, 100000, 1, 64));
+    Order* near = makeOrder(1, Side::BUY, 10, 100);
+    Order* far = makeOrder(2, Side::BUY, 50000, 200);
+    ladder.add_order(10, near, pool);
+    ladder.add_order(50000, far, pool);
+
+    ladder.recenter(50000);
+
+    EXPECT_TRUE(ladder.in_window(50000));
+    EXPECT_FALSE(ladder.in_window(10));
+    EXPECT_EQ(ladder.find(50000)->head, pool.index_of(far));
+    EXPECT_EQ(ladder.find(10)->head, pool.index_of(near));
+    EXPECT_EQ(ladder.next_down(100000), 50000u);
+    EXPECT_EQ(ladder.next_down(49999), 10u);
+
+    EXPECT_TRUE(ladder.remove_order(10, near, pool));
+    EXPECT_EQ(ladder.overflow_levels(), 0u);
+}
+
+TEST_F(PriceLadderTest, BookSupportsWideRangeInstrument) {
+    // Prices well above the global PRICE_MAX with a 25-unit tick
+    Instrument instrument(7, "WIDE", 25, 1, 0, 5000000);
+    Book book(pool, instrument, 256);
+
+    Order* ask = makeOrder(1, Side::SELL, 2500025, 100);
+    Order* far_ask = makeOrder(2, Side::SELL, 4000000, 100);
+    Order* bid = makeOrder(3, Side::BUY, 2499975, 100);
+    book.add_order(ask);
+    book.add_order(far_ask);
+    book.add_order(bid);
+
+    EXPECT_EQ(book.best_ask(), 2500025);
+    EXPECT_EQ(book.best_bid(), 2499975);
+    EXPECT_EQ(book.next_ask_price(2500025), 4000000);
+    EXPECT_EQ(book.get_price_level(2500030, Side::SELL), nullptr);  // Off tick grid
+
+    // Sweeping the touch recentres the ask window onto the far level
+    book.remove_order(ask);
+    EXPECT_EQ(book.best_ask(), 4000000);
+    EXPECT_EQ(book.get_price_level(4000000, Side::SELL)->head, pool.index_of(far_ask));
+    EXPECT_TRUE(book.ask_ladder().in_window(160000));
+}
+
+TEST_F(PriceLadderTest, CumulativeVolumeFollowsAddsFillsAndRecentres) {
+    PriceLadder ladder(LadderConfig(0, 100000, 1, 64));
+
+    Order* a = makeOrder(1, Side::SELL, 10, 100);
+    Order* b = makeOrder(2, Side::SELL, 20, 50);
+    Order* far = makeOrder(3, Side::SELL, 50000, 200);
+    ladder.add_order(10, a, pool);
+    ladder.add_order(20, b, pool);
+    ladder.add_order(50000, far, pool);
+
+    EXPECT_EQ(ladder.volume_at_or_below(9), 0u);
+    EXPECT_EQ(ladder.volume_at_or_below(10), 100u);
+    EXPECT_EQ(ladder.volume_at_or_below(49999), 150u);
+    EXPECT_EQ(ladder.volume_at_or_below(200000), 350u);   // Overflow level included
+    EXPECT_EQ(ladder.volume_at_or_below(200000, 100), 150u);  // Window alone was enough
+    EXPECT_EQ(ladder.volume_at_or_above(11), 250u);
+    EXPECT_EQ(ladder.volume_at_or_above(-5), 350u);
+
+    // Partial fills reduce both the level and the running total
+    PriceLevel* level = ladder.find(10);
+    ladder.fill_order(level, a, 40);
+    EXPECT_EQ(level->total_volume, 60u);
+    EXPECT_EQ(ladder.volume_at_or_below(20), 110u);
+
+    // Recentring moves the window onto the far level without losing volume
+    ladder.recenter(50000);
+    EXPECT_EQ(ladder.volume_at_or_below(200000), 310u);
+    ladder.fill_order(ladder.find(50000), far, 200);
+    EXPECT_EQ(ladder.volume_at_or_above(100), 0u);
+    EXPECT_EQ(ladder.volume_at_or_below(100), 110u);
+}
+
+TEST_F(PriceLadderTest, BookVolumeThroughLimitOnTickGrid) {
+    Instrument instrument(7, "TICK5", 5, 1, 1000, 2000);
+    Book book(pool, instrument, 64);
+
+    book.add_order(makeOrder(1, Side::SELL, 1500, 10));
+    book.add_order(makeOrder(2, Side::SELL, 1505, 20));
+    book.add_order(makeOrder(3, Side::BUY, 1490, 30));
+    book.add_order(makeOrder(4, Side::BUY, 1495, 40));
+
+    EXPECT_EQ(book.ask_volume_through(1504), 10u);   // Off-grid limit rounds towards the touch
+    EXPECT_EQ(book.ask_volume_through(1505), 30u);
+    EXPECT_EQ(book.bid_volume_through(1491), 40u);
+    EXPECT_EQ(book.bid_volume_through(1490), 70u);
+    EXPECT_EQ(book.bid_volume_through(5000), 0u);
+}
@@ -1,123 +1,150 @@
 #include <gtest/gtest.h>
 #include "types.hpp"
+#include "order_pool.hpp"
 #include <memory>
+#include <vector>
 
 using namespace OrderBook;
 
 class PriceLevelTest : public ::testing::Test {
 protected:
     void SetUp() override {
+        pool = std::make_unique<OrderPool>(16);
         level = std::make_unique<PriceLevel>();
         
-        // Create test orders
+        // Create test orders - levels link orders by their pool index
         for (int i = 0; i < 3; ++i) {
-            auto order = std::make_unique<Order>();
+            Order* order = pool->allocate();
             order->order_id = i + 1;
             order->quantity = (i + 1) * 100;
             order->side = Side::BUY;
             order->price = 5000;
-            orders.push_back(std::move(order));
+            orders.push_back(order);
         }
     }
 
+    OrderIndex index(int i) const {
+        return pool->index_of(orders[i]);
+    }
+
+    std::unique_ptr<OrderPool> pool;
     std::unique_ptr<PriceLevel> level;
-    std::vector<std::unique_ptr<Order>> orders;
+    std::vector<Order*> orders;
 };
 
 TEST_F(PriceLevelTest, InitialState) {
     EXPECT_TRUE(level->empty());
     EXPECT_EQ(level->total_volume, 0);
-    EXPECT_EQ(level->head, nullptr);
-    EXPECT_EQ(level->tail, nullptr);
+    EXPECT_EQ(level->head, NULL_ORDER);
+    EXPECT_EQ(level->tail, NULL_ORDER);
+}
+
+TEST_F(PriceLevelTest, OrderHotFieldsFitHalfCacheLine) {
+    // Two resting orders per cache line when walking a level
+    EXPECT_EQ(sizeof(Order), CACHE_LINE_SIZE / 2);
+    EXPECT_EQ(alignof(Order), CACHE_LINE_SIZE / 2);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(pool->at(0)) % (CACHE_LINE_SIZE / 2), 0u);
+}
+
+TEST_F(PriceLevelTest, FillOrderKeepsVolumeInStep) {
+    for (int i = 0; i < 3; ++i) {
+        level->add_order(orders[i], *pool);
+    }
+    
+    level->fill_order(orders[1], 50);
+    
+    EXPECT_EQ(orders[1]->quantity, 150u);
+    EXPECT_EQ(level->total_volume, 550);
+    EXPECT_EQ(level->order_count, 3u);
 }
 
 TEST_F(PriceLevelTest, AddSingleOrder) {
-    Order* order = orders[0].get();
-    level->add_order(order);
+    Order* order = orders[0];
+    level->add_order(order, *pool);
     
     EXPECT_FALSE(level->empty());
     EXPECT_EQ(level->total_volume, 100);
-    EXPECT_EQ(level->head, order);
-    EXPECT_EQ(level->tail, order);
-    EXPECT_EQ(order->next, nullptr);
-    EXPECT_EQ(order->prev, nullptr);
+    EXPECT_EQ(level->head, index(0));
+    EXPECT_EQ(level->tail, index(0));
+    EXPECT_EQ(order->next, NULL_ORDER);
+    EXPECT_EQ(order->prev, NULL_ORDER);
 }
 
 TEST_F(PriceLevelTest, AddMultipleOrders) {
     // Add orders in sequence
     for (int i = 0; i < 3; ++i) {
-        level->add_order(orders[i].get());
+        level->add_order(orders[i], *pool);
     }
     
     EXPECT_FALSE(level->empty());
     EXPECT_EQ(level->total_volume, 600); // 100 + 200 + 300
     
     // Check FIFO ordering
-    EXPECT_EQ(level->head, orders[0].get());
-    EXPECT_EQ(level->tail, orders[2].get());
+    EXPECT_EQ(level->head, index(0));
+    EXPECT_EQ(level->tail, index(2));
     
     // Check linked list structure
-    EXPECT_EQ(orders[0]->next, orders[1].get());
-    EXPECT_EQ(orders[1]->prev, orders[0].get());
-    EXPECT_EQ(orders[1]->next, orders[2].get());
-    EXPECT_EQ(orders[2]->prev, orders[1].get());
+    EXPECT_EQ(orders[0]->next, index(1));
+    EXPECT_EQ(orders[1]->prev, index(0));
+    EXPECT_EQ(orders[1]->next, index(2));
+    EXPECT_EQ(orders[2]->prev, index(1));
 }
 
 TEST_F(PriceLevelTest, RemoveMiddleOrder) {
     // Add all orders
     for (int i = 0; i < 3; ++i) {
-        level->add_order(orders[i].get());
+        level->add_order(orders[i], *pool);
     }
     
     // Remove middle order
-    level->remove_order(orders[1].get());
+    level->remove_order(orders[1], *pool);
     
     EXPECT_EQ(level->total_volume, 400); // 100 + 300
-    EXPECT_EQ(orders[0]->next, orders[2].get());
-    EXPECT_EQ(orders[2]->prev, orders[0].get());
+    EXPECT_EQ(orders[0]->next, index(2));
+    EXPECT_EQ(orders[2]->prev, index(0));
 }
 
 TEST_F(PriceLevelTest, RemoveHeadOrder) {
     // Add all orders
     for (int i = 0; i < 3; ++i) {
-        level->add_order(orders[i].get());
+        level->add_order(orders[i], *pool);
     }
     
     // Remove head
-    level->remove_order(orders[0].get());
+    level->remove_order(orders[0], *pool);
     
     EXPECT_EQ(level->total_volume, 500); // 200 + 300
-    EXPECT_EQ(level->head, orders[1].get());
-    EXPECT_EQ(orders[1]->prev, nullptr);
+    EXPECT_EQ(level->head, index(1));
+    EXPECT_EQ(orders[1]->prev, NULL_ORDER);
 }
 
 TEST_F(PriceLevelTest, RemoveTailOrder) {
     // Add all orders
     for (int i = 0; i < 3; ++i) {
-        level->add_order(orders[i].get());
+        level->add_order(orders[i], *pool);
     }
     
     // Remove tail
-    level->remove_order(orders[2].get());
+    level->remove_order(orders[2], *pool);
     
     EXPECT_EQ(level->total_volume, 300); // 100 + 200
-    EXPECT_EQ(level->tail, orders[1].get());
-    EXPECT_EQ(orders[1]->next, nullptr);
+    EXPECT_EQ(level->tail, index(1));
+    EXPECT_EQ(orders[1]->next, NULL_ORDER);
 }
 
 TEST_F(PriceLevelTest, RemoveAllOrders) {
     // Add all orders
     for (int i = 0; i < 3; ++i) {
-        level->add_order(orders[i].get());
+        level->add_order(orders[i], *pool);
     }
     
     // Remove all orders
-    level->remove_order(orders[1].get());
-    level->remove_order(orders[0].get());
-    level->remove_order(orders[2].get());
+    level->remove_order(orders[1], *pool);
+    level->remove_order(orders[0], *pool);
+    level->remove_order(orders[2], *pool);
     
     EXPECT_TRUE(level->empty());
     EXPECT_EQ(level->total_volume, 0);
-    EXPECT_EQ(level->head, nullptr);
-    EXPECT_EQ(level->tail, nullptr);
+    EXPECT_EQ(level->head, NULL_ORDER);
+    EXPECT_EQ(level->tail, NULL_ORDER);
 }
\ No newline at end of file
@@ -0,0 +1,174 @@
+#include <gtest/gtest.h>
+#include "risk_manager.hpp"
+#include "multi_instrument_engine.hpp"
+#include "tsc_clock.hpp"
+#include <memory>
+
+using namespace OrderBook;
+
+namespace {
+
+Command make_order(AccountId account, Side side, int32_t price, uint32_t quantity,
+                   uint64_t timestamp = 1) {
+    Command cmd{};
+    cmd.type = CommandType::NEW;
+    cmd.order_type = OrderType::LIMIT;
+    cmd.side = side;
+    cmd.price = price;
+    cmd.quantity = quantity;
+    cmd.account_id = account;
+    cmd.producer_timestamp = timestamp;
+    return cmd;
+}
+
+RiskLimits unlimited_rate() {
+    RiskLimits limits;
+    limits.max_orders_per_second = 0;
+    limits.max_cancels_per_second = 0;
+    return limits;
+}
+
+} // namespace
+
+TEST(RiskManagerTest, LogonAssignsDenseIds) {
+    RiskManager risk;
+    const AccountId a = risk.logon("ALPHA", RiskLimits{});
+    const AccountId b = risk.logon("BETA", RiskLimits{});
+
+    EXPECT_EQ(a, 1u);
+    EXPECT_EQ(b, 2u);
+    EXPECT_EQ(risk.logon("ALPHA", RiskLimits{}), NO_ACCOUNT);
+    EXPECT_EQ(risk.find_account("BETA"), b);
+    EXPECT_EQ(risk.find_account("GAMMA"), NO_ACCOUNT);
+    EXPECT_EQ(risk.account_count(), 2u);
+    EXPECT_EQ(*risk.account_name(a), "ALPHA");
+    EXPECT_EQ(risk.get_account(NO_ACCOUNT), nullptr);
+    EXPECT_EQ(alignof(TradingAccount), CACHE_LINE_SIZE);
+}
+
+TEST(RiskManagerTest, RejectsOrdersBreachingLimits) {
+    RiskManager risk;
+    RiskLimits limits = unlimited_rate();
+    limits.max_order_size = 1000;
+    limits.max_order_value = 4'000'000;
+    limits.max_position = 1500;
+    const AccountId id = risk.logon("ALPHA", limits);
+
+    EXPECT_EQ(risk.check_new_order(make_order(id, Side::BUY, 5000, 100)), RiskCheckResult::ACCEPTED);
+    EXPECT_EQ(risk.check_new_order(make_order(id, Side::BUY, 5000, 1001)), RiskCheckResult::REJECTED_ORDER_SIZE);
+    EXPECT_EQ(risk.check_new_order(make_order(id, Side::BUY, 5000, 900)), RiskCheckResult::REJECTED_ORDER_VALUE);
+    EXPECT_EQ(risk.check_new_order(make_order(id, Side::BUY, 6000, 10)), RiskCheckResult::REJECTED_PRICE_DEVIATION);
+    EXPECT_EQ(risk.check_new_order(make_order(NO_ACCOUNT, Side::BUY, 5000, 10)),
+              RiskCheckResult::REJECTED_UNKNOWN_ACCOUNT);
+
+    risk.on_fill(id, Side::BUY, 1000);
+    EXPECT_EQ(risk.get_account(id)->net_position, 1000);
+    EXPECT_EQ(risk.check_new_order(make_order(id, Side::BUY, 5000, 100)), RiskCheckResult::ACCEPTED);
+    EXPECT_EQ(risk.check_new_order(make_order(id, Side::BUY, 5000, 600)), RiskCheckResult::REJECTED_POSITION_LIMIT);
+    EXPECT_EQ(risk.check_new_order(make_order(id, Side::SELL, 5000, 100)), RiskCheckResult::ACCEPTED);
+
+    risk.enable_account(id, false);
+    EXPECT_EQ(risk.check_new_order(make_order(id, Side::SELL, 5000, 100)),
+              RiskCheckResult::REJECTED_ACCOUNT_DISABLED);
+}
+
+TEST(RiskManagerTest, RateLimitRefillsWithTimestamps) {
+    TscClock::calibrate();
+    RiskManager risk;
+    RiskLimits limits;
+    limits.max_orders_per_second = 10;
+    const AccountId id = risk.logon("ALPHA", limits);
+    const uint64_t per_token = risk.get_account(id)->orders.ticks_per_token;
+    ASSERT_GT(per_token, 0u);
+
+    // A full bucket's burst, then nothing until a token's worth of time passes
+    const uint64_t start = 1'000'000;
+    for (int i = 0; i < 10; ++i) {
+        EXPECT_EQ(risk.check_new_order(make_order(id, Side::BUY, 5000, 1, start)), RiskCheckResult::ACCEPTED);
+    }
+    EXPECT_EQ(risk.check_new_order(make_order(id, Side::BUY, 5000, 1, start)), RiskCheckResult::REJECTED_RATE_LIMIT);
+    EXPECT_EQ(risk.check_new_order(make_order(id, Side::BUY, 5000, 1, start + per_token)),
+              RiskCheckResult::ACCEPTED);
+    EXPECT_EQ(risk.check_new_order(make_order(id, Side::BUY, 5000, 1, start + per_token)),
+              RiskCheckResult::REJECTED_RATE_LIMIT);
+}
+
+TEST(RiskManagerTest, ChecksEachCommandTypeAsOrderOrCancel) {
+    RiskManager risk;
+    RiskLimits limits = unlimited_rate();
+    limits.max_order_size = 100;
+    const AccountId id = risk.logon("ALPHA", limits);
+
+    Command cmd = make_order(id, Side::BUY, 5000, 500);
+    for (CommandType type : {CommandType::NEW, CommandType::REPLACE, CommandType::QUOTE_LEG}) {
+        cmd.type = type;
+        EXPECT_EQ(risk.check_command(cmd), RiskCheckResult::REJECTED_ORDER_SIZE);
+    }
+
+    // Pulling quantity, mass cancels and quote headers are never sized
+    cmd.type = CommandType::QUOTE_LEG;
+    cmd.quantity = 0;
+    EXPECT_EQ(risk.check_command(cmd), RiskCheckResult::ACCEPTED);
+    cmd.type = CommandType::MASS_CANCEL;
+    EXPECT_EQ(risk.check_command(cmd), RiskCheckResult::ACCEPTED);
+    cmd.type = CommandType::MASS_QUOTE;
+    cmd.quantity = 500;
+    EXPECT_EQ(risk.check_command(cmd), RiskCheckResult::ACCEPTED);
+}
+
+TEST(RiskManagerTest, StatisticsAreVisibleOnlyOncePublished) {
+    RiskManager risk;
+    const AccountId id = risk.logon("ALPHA", unlimited_rate());
+    risk.check_new_order(make_order(id, Side::BUY, 5000, 10));
+    risk.check_new_order(make_order(id, Side::BUY, 5000, 1'000'000));
+
+    EXPECT_EQ(risk.total_orders_checked(), 0u);
+    risk.publish_statistics();
+
+    const RiskStatistics stats = risk.statistics();
+    EXPECT_EQ(stats.orders_checked, 2u);
+    EXPECT_EQ(stats.orders_rejected, 1u);
+    EXPECT_EQ(risk.rejection_count(RiskCheckResult::REJECTED_ORDER_SIZE), 1u);
+    EXPECT_DOUBLE_EQ(risk.rejection_rate(), 50.0);
+}
+
+TEST(RiskManagerTest, EngineChecksOrdersAndTracksFills) {
+    auto ring = std::make_unique<MultiInstrumentRingBuffer>(1024);
+    auto engine = std::make_unique<MultiInstrumentEngine>(ring.get(), 1024);
+    ASSERT_TRUE(engine->add_instrument(Instrument(DEFAULT_INSTRUMENT_ID, "DEF")));
+
+    RiskManager risk;
+    RiskLimits limits = unlimited_rate();
+    limits.max_position = 100;
+    const AccountId buyer = risk.logon("BUYER", limits);
+    const AccountId seller = risk.logon("SELLER", limits);
+    engine->set_risk_manager(&risk);
+
+    auto push = [&](Command cmd, uint64_t order_id) {
+        cmd.order_id = order_id;
+        cmd.instrument_id = DEFAULT_INSTRUMENT_ID;
+        ASSERT_TRUE(ring->enqueue(cmd));
+    };
+    push(make_order(seller, Side::SELL, 5000, 80), 1);
+    push(make_order(buyer, Side::BUY, 5000, 50), 2);
+    push(make_order(buyer, Side::BUY, 5000, 60), 3);   // Would take the buyer to 110
+    push(make_order(NO_ACCOUNT, Side::BUY, 5000, 10), 4);
+
+    Command cancel{};
+    cancel.type = CommandType::CANCEL;
+    cancel.account_id = buyer;                          // Not the owner: ignored
+    push(cancel, 1);
+
+    while (engine->process_burst() > 0) {}
+
+    EXPECT_EQ(engine->total_trades_executed(), 1u);
+    EXPECT_EQ(engine->orders_processed(), 5u);
+    EXPECT_EQ(risk.get_account(buyer)->net_position, 50);
+    EXPECT_EQ(risk.get_account(seller)->net_position, -50);
+    EXPECT_EQ(engine->get_book(DEFAULT_INSTRUMENT_ID)->best_ask(), 5000);
+
+    const RiskStatistics stats = risk.statistics();
+    EXPECT_EQ(stats.orders_checked, 4u);
+    EXPECT_EQ(stats.orders_rejected, 2u);
+    EXPECT_EQ(stats.cancels_checked, 1u);
+}
@@ -0,0 +1,110 @@
+#include <gtest/gtest.h>
+#include "risk_stage.hpp"
+#include "multi_instrument_engine.hpp"
+#include <memory>
+#include <thread>
+
+using namespace OrderBook;
+
+namespace {
+
+Command make_order(uint64_t order_id, AccountId account, Side side, int32_t price, uint32_t quantity) {
+    Command cmd{};
+    cmd.type = CommandType::NEW;
+    cmd.order_type = OrderType::LIMIT;
+    cmd.order_id = order_id;
+    cmd.instrument_id = DEFAULT_INSTRUMENT_ID;
+    cmd.side = side;
+    cmd.price = price;
+    cmd.quantity = quantity;
+    cmd.account_id = account;
+    return cmd;
+}
+
+RiskLimits position_limit(int64_t max_position) {
+    RiskLimits limits;
+    limits.max_orders_per_second = 0;
+    limits.max_cancels_per_second = 0;
+    limits.max_position = max_position;
+    return limits;
+}
+
+} // namespace
+
+TEST(RiskStageTest, ParsesTopology) {
+    RiskTopology topology = RiskTopology::INLINE;
+    EXPECT_TRUE(parse_risk_topology("staged", topology));
+    EXPECT_EQ(topology, RiskTopology::STAGED);
+    EXPECT_TRUE(parse_risk_topology("inline", topology));
+    EXPECT_EQ(topology, RiskTopology::INLINE);
+    EXPECT_FALSE(parse_risk_topology("remote", topology));
+    EXPECT_STREQ(to_string(RiskTopology::STAGED), "staged");
+}
+
+TEST(RiskStageTest, ForwardsAcceptedAndAppliesFillsBack) {
+    MultiInstrumentRingBuffer gateway(1024);
+    MultiInstrumentRingBuffer engine_ring(1024);
+    auto engine = std::make_unique<MultiInstrumentEngine>(&engine_ring, 1024);
+    ASSERT_TRUE(engine->add_instrument(Instrument(DEFAULT_INSTRUMENT_ID, "DEF")));
+
+    RiskManager risk;
+    const AccountId buyer = risk.logon("BUYER", position_limit(100));
+    const AccountId seller = risk.logon("SELLER", position_limit(100));
+    RiskStage stage(risk, gateway, engine_ring);
+    engine->set_risk_stage(&stage);
+
+    ASSERT_TRUE(gateway.enqueue(make_order(1, seller, Side::SELL, 5000, 80)));
+    ASSERT_TRUE(gateway.enqueue(make_order(2, buyer, Side::BUY, 5000, 60)));
+    ASSERT_TRUE(gateway.enqueue(make_order(3, buyer, Side::BUY, 5000, 200)));  // Over the limit on its own
+    EXPECT_EQ(stage.process_burst(), 3u);
+    EXPECT_EQ(stage.commands_forwarded(), 2u);
+    EXPECT_EQ(stage.commands_rejected(), 1u);
+
+    while (engine->process_burst() > 0) {}
+    EXPECT_EQ(engine->total_trades_executed(), 1u);
+    EXPECT_EQ(risk.get_account(buyer)->net_position, 0);  // Fill still on the ring
+
+    // The next burst applies the fill before checking, so 60 + 50 is refused
+    ASSERT_TRUE(gateway.enqueue(make_order(4, buyer, Side::BUY, 5000, 50)));
+    EXPECT_EQ(stage.process_burst(), 1u);
+    EXPECT_EQ(risk.get_account(buyer)->net_position, 60);
+    EXPECT_EQ(risk.get_account(seller)->net_position, -60);
+    EXPECT_EQ(stage.commands_forwarded(), 2u);
+    EXPECT_EQ(stage.commands_consumed(), 4u);
+
+    const RiskStatistics stats = risk.statistics();
+    EXPECT_EQ(stats.orders_checked, 4u);
+    EXPECT_EQ(stats.orders_rejected, 2u);
+}
+
+TEST(RiskStageTest, ThreadedPipelineDoesNotDeadlockOnSmallRings) {
+    MultiInstrumentRingBuffer gateway(64);
+    MultiInstrumentRingBuffer engine_ring(16);
+    auto engine = std::make_unique<MultiInstrumentEngine>(&engine_ring, 4096);
+    ASSERT_TRUE(engine->add_instrument(Instrument(DEFAULT_INSTRUMENT_ID, "DEF")));
+
+    RiskManager risk;
+    const AccountId buyer = risk.logon("BUYER", position_limit(1'000'000));
+    const AccountId seller = risk.logon("SELLER", position_limit(1'000'000));
+    RiskStage stage(risk, gateway, engine_ring, WaitConfig(WaitPolicy::YIELD), 8);
+    engine->set_risk_stage(&stage);
+    stage.start();
+
+    // Every pair trades, so fills outrun the tiny fill ring
+    constexpr uint64_t PAIRS = 2000;
+    std::thread feed([&] {
+        for (uint64_t i = 0; i < PAIRS; ++i) {
+            while (!gateway.enqueue(make_order(2 * i + 1, seller, Side::SELL, 5000, 1))) std::this_thread::yield();
+            while (!gateway.enqueue(make_order(2 * i + 2, buyer, Side::BUY, 5000, 1))) std::this_thread::yield();
+        }
+    });
+    while (stage.commands_consumed() < 2 * PAIRS || engine->orders_processed() < stage.commands_forwarded()) {
+        if (engine->process_burst() == 0) std::this_thread::yield();
+    }
+    feed.join();
+    stage.stop();
+
+    EXPECT_EQ(engine->total_trades_executed(), PAIRS);
+    EXPECT_EQ(risk.get_account(buyer)->net_position, static_cast<int64_t>(PAIRS));
+    EXPECT_EQ(risk.get_account(seller)->net_position, -static_cast<int64_t>(PAIRS));
+}
@@ -0,0 +1,142 @@
+#include <gtest/gtest.h>
+#include "shared_ring.hpp"
+#include "spsc_ring_buffer.hpp"
+#include "output_stage.hpp"
+#include <string>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace OrderBook;
+
+class SharedRingTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        name = "ome_test_ring_" + std::to_string(getpid());
+    }
+
+    void TearDown() override {
+        SharedRingSegment::remove(name);
+    }
+
+    static Command createCommand(uint64_t id) {
+        Command cmd{};
+        cmd.type = CommandType::NEW;
+        cmd.order_id = id;
+        cmd.side = Side::BUY;
+        cmd.price = 5000;
+        cmd.quantity = 10;
+        return cmd;
+    }
+
+    std::string name;
+};
+
+TEST_F(SharedRingTest, CarriesCommandsBetweenEnds) {
+    SharedRing<SPSCRingBuffer> engine_end(name, RingEnd::CONSUMER, 1024);
+    ASSERT_TRUE(engine_end.is_open()) << engine_end.error();
+    EXPECT_FALSE(engine_end.peer_attached());
+
+    SharedRing<SPSCRingBuffer> gateway_end(name, RingEnd::PRODUCER);
+    ASSERT_TRUE(gateway_end.is_open()) << gateway_end.error();
+    EXPECT_TRUE(engine_end.peer_attached());
+    EXPECT_EQ(gateway_end.queue().capacity(), 1024u);
+
+    // Indices and slots on lines of their own
+    const SharedRingSegment& segment = engine_end.segment();
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(segment.indices()) % CACHE_LINE_SIZE, 0u);
+    EXPECT_NE(reinterpret_cast<uintptr_t>(&segment.indices()->head) / CACHE_LINE_SIZE,
+              reinterpret_cast<uintptr_t>(&segment.indices()->tail) / CACHE_LINE_SIZE);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(segment.slots()) % CACHE_LINE_SIZE, 0u);
+
+    for (uint64_t id = 1; id <= 100; ++id) {
+        Command* slot = gateway_end.queue().try_claim();
+        ASSERT_NE(slot, nullptr);
+        *slot = createCommand(id);
+        gateway_end.queue().commit();
+    }
+    EXPECT_EQ(engine_end.queue().size(), 100u);
+
+    uint64_t expected = 1;
+    EXPECT_EQ(engine_end.queue().consume_bulk(1000, [&](const Command& cmd) {
+        EXPECT_EQ(cmd.order_id, expected++);
+    }), 100u);
+}
+
+TEST_F(SharedRingTest, RefusesMismatchedOrHeldEnds) {
+    SharedRing<SPSCRingBuffer> engine_end(name, RingEnd::CONSUMER, 1024);
+    ASSERT_TRUE(engine_end.is_open());
+
+    // A build with a different record type is turned away
+    SharedRing<SPSCQueue<OutputEvent>> wrong_record(name, RingEnd::PRODUCER);
+    EXPECT_FALSE(wrong_record.is_open());
+
+    // A live process keeps its end
+    SharedRing<SPSCRingBuffer> second_consumer(name, RingEnd::CONSUMER);
+    EXPECT_FALSE(second_consumer.is_open());
+    EXPECT_NE(second_consumer.error().find("held by pid"), std::string::npos);
+
+    SharedRing<SPSCRingBuffer> missing(name + "_missing", RingEnd::PRODUCER);
+    EXPECT_FALSE(missing.is_open());
+
+    SharedRing<SPSCRingBuffer> odd_capacity(name + "_odd", RingEnd::CONSUMER, 1000);
+    EXPECT_FALSE(odd_capacity.is_open());
+}
+
+TEST_F(SharedRingTest, RestartedProducerTakesOverACrashedOnesEnd) {
+    SharedRing<SPSCRingBuffer> engine_end(name, RingEnd::CONSUMER, 1024);
+    ASSERT_TRUE(engine_end.is_open());
+
+    // Child gateway publishes 10 commands, claims an 11th and dies without detaching
+    const pid_t child = fork();
+    ASSERT_GE(child, 0);
+    if (child == 0) {
+        SharedRing<SPSCRingBuffer> gateway_end(name, RingEnd::PRODUCER);
+        if (!gateway_end.is_open()) _exit(1);
+        for (uint64_t id = 1; id <= 10; ++id) gateway_end.queue().enqueue(createCommand(id));
+        *gateway_end.queue().try_claim() = createCommand(11);
+        _exit(0);
+    }
+    int status = 0;
+    ASSERT_EQ(waitpid(child, &status, 0), child);
+    ASSERT_TRUE(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    EXPECT_FALSE(engine_end.peer_attached());
+
+    SharedRing<SPSCRingBuffer> restarted(name, RingEnd::PRODUCER);
+    ASSERT_TRUE(restarted.is_open()) << restarted.error();
+    EXPECT_EQ(engine_end.segment().attach_count(RingEnd::PRODUCER), 2u);
+    restarted.queue().enqueue(createCommand(12));
+
+    // Committed commands survive, the uncommitted claim is overwritten
+    std::vector<uint64_t> ids;
+    engine_end.queue().consume_bulk(100, [&](const Command& cmd) { ids.push_back(cmd.order_id); });
+    ASSERT_EQ(ids.size(), 11u);
+    EXPECT_EQ(ids.front(), 1u);
+    EXPECT_EQ(ids.back(), 12u);
+}
+
+TEST_F(SharedRingTest, PeersSeeTheCreatorLeaveOrBeReplaced) {
+    auto engine_end = std::make_unique<SharedRing<SPSCQueue<OutputEvent>>>(name, RingEnd::PRODUCER, 256);
+    ASSERT_TRUE(engine_end->is_open());
+    SharedRing<SPSCQueue<OutputEvent>> consumer(name, RingEnd::CONSUMER);
+    ASSERT_TRUE(consumer.is_open());
+    EXPECT_FALSE(consumer.closed());
+
+    // A restarted engine replaces the segment; the old one reads closed
+    SharedRing<SPSCQueue<OutputEvent>> replacement(name, RingEnd::PRODUCER, 256);
+    ASSERT_TRUE(replacement.is_open()) << replacement.error();
+    EXPECT_TRUE(consumer.closed());
+    EXPECT_FALSE(replacement.peer_attached());
+
+    // The old creator leaving doesn't unlink its replacement
+    engine_end.reset();
+    SharedRing<SPSCQueue<OutputEvent>> reattached(name, RingEnd::CONSUMER);
+    ASSERT_TRUE(reattached.is_open()) << reattached.error();
+    EXPECT_TRUE(replacement.peer_attached());
+
+    // An output stage on each side of the shared ring
+    OutputStage producer(nullptr, &replacement.queue());
+    OutputStage publisher(nullptr, &reattached.queue());
+    producer.publish_trade(DEFAULT_INSTRUMENT_ID, 1, 2, Side::BUY, 5000, 10);
+    producer.publish_level2_update(DEFAULT_INSTRUMENT_ID, Side::SELL, 5000, 0, 0);
+    EXPECT_EQ(publisher.drain(), 2u);
+}
@@ -1,6 +1,7 @@
 #include <gtest/gtest.h>
 #include "spsc_ring_buffer.hpp"
 #include "types.hpp"
+#include "tsc_clock.hpp"
 #include <thread>
 #include <vector>
 #include <chrono>
@@ -20,7 +21,7 @@ protected:
         cmd.side = Side::BUY;
         cmd.price = 5000;
         cmd.quantity = 100;
-        cmd.producer_timestamp = std::chrono::high_resolution_clock::now();
+        cmd.producer_timestamp = rdtsc();
         return cmd;
     }
 
@@ -133,4 +134,121 @@ TEST_F(SPSCRingBufferTest, OrderPreservation) {
         EXPECT_TRUE(buffer->dequeue(cmd));
         EXPECT_EQ(cmd.order_id, i);
     }
-}
\ No newline at end of file
+}
+TEST_F(SPSCRingBufferTest, BulkEnqueueDequeue) {
+    std::vector<Command> commands;
+    for (uint64_t i = 0; i < 100; ++i) {
+        commands.push_back(createTestCommand(i));
+    }
+    
+    EXPECT_EQ(buffer->enqueue_bulk(commands), 100u);
+    
+    // Drain in uneven chunks and verify FIFO order is preserved
+    std::vector<Command> out(64);
+    EXPECT_EQ(buffer->dequeue_bulk(out), 64u);
+    for (uint64_t i = 0; i < 64; ++i) {
+        EXPECT_EQ(out[i].order_id, i);
+    }
+    
+    EXPECT_EQ(buffer->dequeue_bulk(out), 36u);
+    for (uint64_t i = 0; i < 36; ++i) {
+        EXPECT_EQ(out[i].order_id, 64 + i);
+    }
+    
+    EXPECT_EQ(buffer->dequeue_bulk(out), 0u);
+}
+
+TEST_F(SPSCRingBufferTest, BulkEnqueueStopsWhenFull) {
+    std::vector<Command> commands(1024, createTestCommand(1));
+    
+    uint64_t enqueued = 0;
+    while (true) {
+        const size_t count = buffer->enqueue_bulk(commands);
+        if (count == 0) break;
+        enqueued += count;
+    }
+    
+    // One slot is reserved to distinguish full from empty
+    EXPECT_EQ(enqueued, RING_BUFFER_SIZE - 1);
+    EXPECT_FALSE(buffer->enqueue(createTestCommand(2)));
+    
+    Command cmd;
+    EXPECT_TRUE(buffer->dequeue(cmd));
+    EXPECT_TRUE(buffer->enqueue(createTestCommand(3)));
+}
+
+TEST_F(SPSCRingBufferTest, BulkWrapAround) {
+    // Move the indices close to the end of the ring, then cross it with one bulk call
+    std::vector<Command> filler(1024, createTestCommand(0));
+    std::vector<Command> sink(1024);
+    uint64_t moved = 0;
+    while (moved < RING_BUFFER_SIZE - 10) {
+        const size_t count = buffer->enqueue_bulk(std::span<const Command>(filler).first(
+            std::min<uint64_t>(filler.size(), RING_BUFFER_SIZE - 10 - moved)));
+        EXPECT_EQ(buffer->dequeue_bulk(std::span<Command>(sink).first(count)), count);
+        moved += count;
+    }
+    
+    std::vector<Command> commands;
+    for (uint64_t i = 0; i < 20; ++i) {
+        commands.push_back(createTestCommand(i));
+    }
+    EXPECT_EQ(buffer->enqueue_bulk(commands), 20u);
+    
+    std::vector<Command> out(20);
+    EXPECT_EQ(buffer->dequeue_bulk(out), 20u);
+    for (uint64_t i = 0; i < 20; ++i) {
+        EXPECT_EQ(out[i].order_id, i);
+    }
+}
+
+TEST_F(SPSCRingBufferTest, ClaimCommitInPlace) {
+    Command* slot = buffer->try_claim();
+    ASSERT_NE(slot, nullptr);
+    
+    // Claiming again before commit hands back the same slot
+    EXPECT_EQ(buffer->try_claim(), slot);
+    
+    slot->type = CommandType::NEW;
+    slot->order_id = 77;
+    slot->price = 4321;
+    
+    // Nothing is visible to the consumer until commit
+    EXPECT_EQ(buffer->front(), nullptr);
+    buffer->commit();
+    
+    Command* head = buffer->front();
+    ASSERT_NE(head, nullptr);
+    EXPECT_EQ(head, slot);  // Consumer sees the very same slot, no copy
+    EXPECT_EQ(head->order_id, 77u);
+    EXPECT_EQ(head->price, 4321);
+    
+    buffer->pop();
+    EXPECT_EQ(buffer->front(), nullptr);
+}
+
+TEST_F(SPSCRingBufferTest, ConsumeBulkInPlace) {
+    for (uint64_t i = 0; i < 10; ++i) {
+        EXPECT_TRUE(buffer->enqueue(createTestCommand(i)));
+    }
+    
+    std::vector<uint64_t> seen;
+    EXPECT_EQ(buffer->consume_bulk(4, [&seen](const Command& cmd) { seen.push_back(cmd.order_id); }), 4u);
+    EXPECT_EQ(buffer->consume_bulk(100, [&seen](const Command& cmd) { seen.push_back(cmd.order_id); }), 6u);
+    
+    ASSERT_EQ(seen.size(), 10u);
+    for (uint64_t i = 0; i < 10; ++i) {
+        EXPECT_EQ(seen[i], i);
+    }
+    EXPECT_EQ(buffer->consume_bulk(100, [](const Command&) {}), 0u);
+}
+
+TEST_F(SPSCRingBufferTest, CommandsPackTwoPerCacheLine) {
+    Command* first = buffer->try_claim();
+    buffer->commit();
+    Command* second = buffer->try_claim();
+    
+    EXPECT_EQ(sizeof(Command), 32u);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(first) % sizeof(Command), 0u);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(second) - reinterpret_cast<uintptr_t>(first), sizeof(Command));
+}
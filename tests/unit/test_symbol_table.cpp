@@ -0,0 +1,46 @@
+#include <gtest/gtest.h>
+#include "instrument.hpp"
+#include "market_data.hpp"
+#include <sstream>
+
+using namespace OrderBook;
+
+TEST(SymbolTableTest, ResolvesRegisteredIds) {
+    SymbolTable table;
+    table.add(DEFAULT_INSTRUMENT_ID, "DEFAULT");
+    table.add(Instrument(7, "AAPL", 1, 1));
+
+    EXPECT_EQ(table.size(), 2u);
+    EXPECT_EQ(table.symbol(7), "AAPL");
+    EXPECT_EQ(table.symbol(DEFAULT_INSTRUMENT_ID), "DEFAULT");
+    EXPECT_TRUE(table.symbol(3).empty());
+    EXPECT_TRUE(table.symbol(1000).empty());
+
+    EXPECT_EQ(table.find("AAPL"), 7u);
+    EXPECT_EQ(table.find("MSFT"), 0u);
+}
+
+TEST(SymbolTableTest, SymbolRefFallsBackToId) {
+    SymbolTable table;
+    table.add(7, "AAPL");
+
+    std::ostringstream known, unknown;
+    known << SymbolRef{table.symbol(7), 7};
+    unknown << SymbolRef{table.symbol(99), 99};
+
+    EXPECT_EQ(known.str(), "AAPL");
+    EXPECT_EQ(unknown.str(), "#99");
+}
+
+TEST(SymbolTableTest, RecordsStayPlainData) {
+    // Snapshots and trades are copied across threads without touching the heap
+    EXPECT_TRUE(std::is_trivially_copyable_v<Level2Snapshot>);
+    EXPECT_TRUE(std::is_trivially_copyable_v<Trade>);
+
+    Level2Snapshot snapshot(7);
+    for (uint32_t i = 0; i < MARKET_DEPTH_LEVELS; ++i) {
+        EXPECT_TRUE(snapshot.bids.emplace_back(5000 - i, 100, 1));
+    }
+    EXPECT_FALSE(snapshot.bids.emplace_back(4000, 100, 1));  // Capped at the published depth
+    EXPECT_EQ(snapshot.bids.size(), MARKET_DEPTH_LEVELS);
+}
@@ -0,0 +1,97 @@
+#include <gtest/gtest.h>
+#include "wait_strategy.hpp"
+#include "spsc_queue.hpp"
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+using namespace OrderBook;
+
+TEST(WaitStrategyTest, PolicyNamesRoundTrip) {
+    for (const WaitPolicy policy : {WaitPolicy::BUSY_SPIN, WaitPolicy::SPIN_PAUSE, WaitPolicy::YIELD,
+                                    WaitPolicy::SPIN_PARK, WaitPolicy::TIMED_PARK}) {
+        WaitPolicy parsed = WaitPolicy::BUSY_SPIN;
+        EXPECT_TRUE(parse_wait_policy(to_string(policy), parsed));
+        EXPECT_EQ(parsed, policy);
+    }
+    WaitPolicy unchanged = WaitPolicy::YIELD;
+    EXPECT_FALSE(parse_wait_policy("sleepy", unchanged));
+    EXPECT_EQ(unchanged, WaitPolicy::YIELD);
+}
+
+TEST(WaitStrategyTest, DoorbellSkipsSleepWhenAlreadyReady) {
+    Doorbell bell;
+    const auto start = std::chrono::steady_clock::now();
+    EXPECT_TRUE(bell.wait([] { return true; }, 5'000'000'000));
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(1));
+    EXPECT_EQ(bell.waiters(), 0u);
+}
+
+TEST(WaitStrategyTest, RingWakesParkedWaiter) {
+    Doorbell bell;
+    std::atomic<bool> ready{false};
+
+    std::thread waiter([&] {
+        // Backstop far beyond the test timeout - only a ring() gets us out quickly
+        while (!bell.wait([&] { return ready.load(); }, 5'000'000'000)) {}
+    });
+
+    while (bell.waiters() == 0) std::this_thread::yield();
+    const auto start = std::chrono::steady_clock::now();
+    ready.store(true);
+    bell.ring();
+    waiter.join();
+
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(1));
+}
+
+TEST(WaitStrategyTest, TimedParkWithoutDoorbellSleeps) {
+    WaitConfig config(WaitPolicy::TIMED_PARK);
+    config.spin_polls = 2;
+    config.timed_park_ns = 2'000'000;
+    WaitStrategy wait(config);
+
+    const auto not_ready = [] { return false; };
+    wait.idle(not_ready);
+    wait.idle(not_ready);  // Still spinning
+
+    const auto start = std::chrono::steady_clock::now();
+    wait.idle(not_ready);
+    EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(2));
+}
+
+TEST(WaitStrategyTest, ParkingProducerAndConsumerDeliverEverything) {
+    // Tiny ring and a short spin, so both sides park over and over
+    SPSCQueue<uint64_t> queue(16);
+    WaitSignals signals;
+    WaitConfig config(WaitPolicy::SPIN_PARK);
+    config.spin_polls = 8;
+    constexpr uint64_t count = 100000;
+
+    std::thread producer([&] {
+        WaitStrategy wait = WaitStrategy::producer(config, &signals);
+        for (uint64_t i = 0; i < count; ++i) {
+            while (!queue.enqueue(i)) {
+                wait.idle([&] { return queue.try_claim() != nullptr; });
+            }
+            wait.reset();
+            wait.notify();
+        }
+    });
+
+    WaitStrategy wait = WaitStrategy::consumer(config, &signals);
+    uint64_t expected = 0;
+    while (expected < count) {
+        const size_t taken = queue.consume_bulk(8, [&](const uint64_t& value) {
+            EXPECT_EQ(value, expected++);
+        });
+        if (taken > 0) {
+            wait.reset();
+            wait.notify();
+        } else {
+            wait.idle([&] { return queue.front() != nullptr; });
+        }
+    }
+    producer.join();
+    EXPECT_EQ(expected, count);
+}
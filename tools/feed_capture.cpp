@@ -0,0 +1,163 @@
+#include "feed_capture.hpp"
+#include "feed_handler.hpp"
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+using namespace OrderBook;
+
+namespace {
+
+/**
+ * One order event per line: offset_ns,action,order_id,side,price,quantity[,instrument]
+ * action is A (add) or D (delete), side B or S, price in ticks. Lines
+ * starting with # are skipped. This is the shape an ITCH add/delete
+ * stream reduces to once symbols are mapped to instrument ids.
+ */
+bool parse_event(const std::string& line, Command& cmd, uint64_t& offset_ns) {
+    std::istringstream in(line);
+    std::string field[7];
+    int fields = 0;
+    while (fields < 7 && std::getline(in, field[fields], ',')) ++fields;
+    if (fields < 3) return false;
+
+    cmd = Command{};
+    cmd.order_type = OrderType::LIMIT;
+    offset_ns = std::strtoull(field[0].c_str(), nullptr, 10);
+    cmd.order_id = std::strtoull(field[2].c_str(), nullptr, 10);
+
+    if (field[1] == "D") {
+        cmd.type = CommandType::CANCEL;
+        return true;
+    }
+    if (field[1] != "A" || fields < 6) return false;
+
+    cmd.type = CommandType::NEW;
+    cmd.side = (field[3] == "S") ? Side::SELL : Side::BUY;
+    cmd.price = static_cast<int32_t>(std::strtol(field[4].c_str(), nullptr, 10));
+    cmd.quantity = static_cast<uint32_t>(std::strtoul(field[5].c_str(), nullptr, 10));
+    if (fields > 6) cmd.instrument_id = static_cast<uint32_t>(std::strtoul(field[6].c_str(), nullptr, 10));
+    return true;
+}
+
+int import_csv(const char* csv_path, const char* capture_path) {
+    std::ifstream csv(csv_path);
+    if (!csv) {
+        std::cerr << "Cannot read " << csv_path << "\n";
+        return 1;
+    }
+
+    FeedCaptureWriter capture(capture_path);
+    std::string line;
+    uint64_t line_number = 0;
+    uint64_t skipped = 0;
+    while (std::getline(csv, line)) {
+        ++line_number;
+        if (line.empty() || line[0] == '#') continue;
+
+        Command cmd;
+        uint64_t offset_ns = 0;
+        if (!parse_event(line, cmd, offset_ns)) {
+            if (skipped++ < 10) std::cerr << "Skipping line " << line_number << ": " << line << "\n";
+            continue;
+        }
+        capture.append(cmd, offset_ns);
+    }
+
+    const uint64_t count = capture.command_count();
+    if (!capture.finish()) {
+        std::cerr << "Failed writing " << capture_path << "\n";
+        return 1;
+    }
+    std::cout << "Imported " << count << " commands (" << skipped << " lines skipped) into " << capture_path << "\n";
+    return 0;
+}
+
+int print_info(const char* capture_path) {
+    FeedCapture capture(capture_path);
+    if (!capture.is_open()) {
+        std::cerr << "Not a feed capture: " << capture_path << "\n";
+        return 1;
+    }
+
+    uint64_t buys = 0, sells = 0, cancels = 0;
+    for (uint64_t i = 0; i < capture.size(); ++i) {
+        const Command& cmd = capture[i];
+        if (cmd.type == CommandType::CANCEL) {
+            ++cancels;
+        } else if (cmd.side == Side::BUY) {
+            ++buys;
+        } else {
+            ++sells;
+        }
+    }
+
+    std::cout << "Commands: " << capture.size() << "\n";
+    std::cout << "New buy / sell / cancel: " << buys << " / " << sells << " / " << cancels << "\n";
+    std::cout << "Recorded duration: " << capture.duration_ns() / 1'000'000 << " ms\n";
+    std::cout << "Seed: " << capture.seed() << "\n";
+    return 0;
+}
+
+} // namespace
+
+/**
+ * Build and inspect feed captures for order_matching_engine --replay.
+ *
+ * Usage:
+ *   feed_capture generate <capture> [--count N] [--seed S] [--rate R]
+ *       synthetic FeedHandler flow with a fixed seed (default 1); --rate
+ *       stamps a steady R orders/s for --pacing recorded
+ *   feed_capture import <events.csv> <capture>
+ *       convert recorded add/delete events (see parse_event)
+ *   feed_capture info <capture>
+ */
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        std::cerr << "Usage: " << argv[0] << " generate <capture> [--count N] [--seed S] [--rate R]\n"
+                  << "       " << argv[0] << " import <events.csv> <capture>\n"
+                  << "       " << argv[0] << " info <capture>\n";
+        return 1;
+    }
+
+    const std::string mode = argv[1];
+    if (mode == "info") return print_info(argv[2]);
+    if (mode == "import") {
+        if (argc < 4) {
+            std::cerr << "import needs <events.csv> <capture>\n";
+            return 1;
+        }
+        return import_csv(argv[2], argv[3]);
+    }
+    if (mode != "generate") {
+        std::cerr << "Unknown mode " << mode << "\n";
+        return 1;
+    }
+
+    uint64_t count = TOTAL_ORDERS_TO_GENERATE;
+    uint64_t seed = 1;
+    uint64_t rate = 0;
+    for (int i = 3; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--count") == 0 && i + 1 < argc) {
+            count = std::strtoull(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = std::strtoull(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--rate") == 0 && i + 1 < argc) {
+            rate = std::strtoull(argv[++i], nullptr, 10);
+        }
+    }
+    if (seed == FeedHandler::RANDOM_SEED) {
+        std::cerr << "Seed " << FeedHandler::RANDOM_SEED << " means random - pick another for a reproducible capture\n";
+        return 1;
+    }
+
+    if (!FeedHandler::record(argv[2], count, seed, rate)) {
+        std::cerr << "Failed writing " << argv[2] << "\n";
+        return 1;
+    }
+    std::cout << "Generated " << count << " commands (seed " << seed << ") into " << argv[2] << "\n";
+    return 0;
+}
@@ -0,0 +1,57 @@
+#include "market_data.hpp"
+#include "market_data_journal.hpp"
+#include <iostream>
+#include <cstring>
+
+using namespace OrderBook;
+
+/**
+ * Replay a binary market data journal recorded by FileMarketDataPublisher.
+ *
+ * Usage: md_replay <journal_base> [--csv <output_base>] [--summary]
+ *   default    print every trade, L2 update and snapshot to stdout
+ *   --csv      re-record the session as CSV files under output_base
+ *   --summary  only count records by type
+ */
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <journal_base> [--csv <output_base>] [--summary]\n";
+        return 1;
+    }
+    
+    const std::string journal_base = argv[1];
+    std::string csv_base;
+    bool summary = false;
+    for (int i = 2; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--summary") == 0) {
+            summary = true;
+        } else if (std::strcmp(argv[i], "--csv") == 0 && i + 1 < argc) {
+            csv_base = argv[++i];
+        }
+    }
+    
+    MarketDataJournalReader reader(journal_base);
+    
+    if (summary) {
+        uint64_t counts[6] = {};
+        JournalRecord record;
+        while (reader.next(record)) {
+            ++counts[static_cast<size_t>(record.type) % 6];
+        }
+        std::cout << "Trades: " << counts[static_cast<size_t>(JournalRecordType::TRADE)] << "\n";
+        std::cout << "L2 updates: " << counts[static_cast<size_t>(JournalRecordType::LEVEL2_UPDATE)] << "\n";
+        std::cout << "Snapshots: " << counts[static_cast<size_t>(JournalRecordType::SNAPSHOT_BEGIN)] << "\n";
+        return 0;
+    }
+    
+    MarketDataManager manager;
+    if (csv_base.empty()) {
+        manager.add_publisher(std::make_unique<ConsoleMarketDataPublisher>(true));
+    } else {
+        manager.add_publisher(std::make_unique<FileMarketDataPublisher>(csv_base));
+    }
+    
+    const uint64_t replayed = reader.replay(manager);
+    std::cerr << "Replayed " << replayed << " records from " << journal_base << "\n";
+    return 0;
+}
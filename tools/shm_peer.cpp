@@ -0,0 +1,146 @@
+#include "shared_ring.hpp"
+#include "spsc_ring_buffer.hpp"
+#include "output_stage.hpp"
+#include "feed_handler.hpp"
+#include "feed_capture.hpp"
+#include "market_data.hpp"
+#include "instrument.hpp"
+#include "numa_placement.hpp"
+#include "tsc_clock.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+
+using namespace OrderBook;
+
+namespace {
+
+/**
+ * Attach to the engine's ring, retrying while it isn't up yet
+ */
+template <typename Queue>
+std::unique_ptr<SharedRing<Queue>> attach(const std::string& name, RingEnd end) {
+    for (int attempt = 0; attempt < 100; ++attempt) {
+        auto ring = std::make_unique<SharedRing<Queue>>(name, end);
+        if (ring->is_open()) return ring;
+        if (attempt == 0) std::cerr << "Waiting for /dev/shm" << ring->segment().name() << ": " << ring->error() << "\n";
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+    return nullptr;
+}
+
+/**
+ * Gateway process: generate (or replay) the order flow into the engine's command ring
+ */
+int run_feed(const std::string& name, uint64_t count, uint64_t seed, const char* replay_path) {
+    std::unique_ptr<FeedCapture> capture;
+    if (replay_path) {
+        capture = std::make_unique<FeedCapture>(replay_path);
+        if (!capture->is_open()) {
+            std::cerr << "Cannot read feed capture " << replay_path << "\n";
+            return 1;
+        }
+    }
+
+    auto ring = attach<SPSCRingBuffer>(name + ".in", RingEnd::PRODUCER);
+    if (!ring) return 1;
+
+    const auto start = std::chrono::steady_clock::now();
+    if (capture) {
+        count = FeedHandler::replay(&ring->queue(), *capture);
+    } else {
+        FeedHandler::run(&ring->queue(), count, WaitConfig(WaitPolicy::YIELD), nullptr, seed);
+    }
+    const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    std::cout << "Fed " << count << " commands in " << elapsed.count() << " ms\n";
+    return 0;
+}
+
+/**
+ * Consumer process: publish the engine's execution reports and L2 updates
+ */
+int run_consume(const std::string& name, const char* record_base) {
+    auto ring = attach<SPSCQueue<OutputEvent>>(name + ".out", RingEnd::CONSUMER);
+    if (!ring) return 1;
+
+    SymbolTable symbols;
+    symbols.add(DEFAULT_INSTRUMENT_ID, "DEFAULT");
+    MarketDataManager market_data(&symbols);
+    market_data.set_conflation(true);
+    if (record_base) {
+        market_data.add_publisher(std::make_unique<FileMarketDataPublisher>(record_base, true));
+    } else {
+        market_data.add_publisher(std::make_unique<ConsoleMarketDataPublisher>());
+    }
+
+    // Drain until the engine has gone and everything it left is published
+    OutputStage output(&market_data, &ring->queue());
+    while (true) {
+        const bool engine_gone = ring->closed();
+        if (output.drain() == 0) {
+            if (engine_gone) break;
+            std::this_thread::yield();
+        }
+    }
+    market_data.flush_all();
+
+    std::cout << "Output events published: " << output.events_published() << "\n";
+    const LatencyHistogram& latency = output.publish_latency();
+    std::cout << "Publish (emit -> publisher): P50 " << latency.percentile(50.0) << " / P99 "
+              << latency.percentile(99.0) << " / max " << latency.max() << " ns\n";
+    return 0;
+}
+
+void usage() {
+    std::cerr << "Usage:\n"
+              << "  shm_peer feed <name> [--count n] [--seed n] [--replay capture] [--cpu n]\n"
+              << "  shm_peer consume <name> [--record base] [--cpu n]\n"
+              << "Peers of order_matching_engine --shm <name>\n";
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        usage();
+        return 1;
+    }
+    const std::string mode = argv[1];
+    const std::string name = argv[2];
+
+    uint64_t count = TOTAL_ORDERS_TO_GENERATE;
+    uint64_t seed = FeedHandler::RANDOM_SEED;
+    const char* replay_path = nullptr;
+    const char* record_base = nullptr;
+    int cpu = -1;
+    for (int i = 3; i < argc; ++i) {
+        const bool has_value = i + 1 < argc;
+        if (std::strcmp(argv[i], "--count") == 0 && has_value) {
+            count = std::strtoull(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--seed") == 0 && has_value) {
+            seed = std::strtoull(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--replay") == 0 && has_value) {
+            replay_path = argv[++i];
+        } else if (std::strcmp(argv[i], "--record") == 0 && has_value) {
+            record_base = argv[++i];
+        } else if (std::strcmp(argv[i], "--cpu") == 0 && has_value) {
+            cpu = std::atoi(argv[++i]);
+        } else {
+            usage();
+            return 1;
+        }
+    }
+
+    // Commands are stamped with the TSC, which the engine's process shares
+    TscClock::calibrate();
+    if (cpu >= 0) NumaPlacement::pin_current_thread(cpu);
+
+    if (mode == "feed") return run_feed(name, count, seed, replay_path);
+    if (mode == "consume") return run_consume(name, record_base);
+    usage();
+    return 1;
+}